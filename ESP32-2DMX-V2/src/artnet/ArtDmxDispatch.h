@@ -0,0 +1,27 @@
+#pragma once
+
+// ArtDmx 接收分发（纯 C++，不依赖 Arduino，可在主机上测试）
+//
+// 就地解析（packet.data 直接指向接收缓冲区，不做中间拷贝）→ 按完整 15 位 Port-Address 查表
+// → 丢弃重复和乱序到达的旧帧 → sink.output(route, packet) 合并并写入输出。
+// ArtnetNode::handleArtDmx 和主机测试走同一个流程，只是 sink 不同。
+
+#include <stdint.h>
+#include "ArtnetPacket.h"
+#include "UniverseRouter.h"
+#include "SequenceTracker.h"
+
+// 返回写入了输出的路由；解析失败、未订阅、被序号检查丢弃或 sink 不接受（第三个合并源）时返回 nullptr
+template <typename Sink>
+const UniverseRoute* dispatchArtDmx(const uint8_t* data, uint16_t length, uint32_t sourceIp, uint32_t nowMs,
+                                    const UniverseRouter& router, SequenceTracker& sequences, Sink& sink) {
+    ArtDmxPacket packet;
+    if (!ArtnetPacket::parseArtDmx(data, length, packet)) return nullptr;
+
+    const UniverseRoute* route = router.lookup(packet.portAddress);
+    if (!route) return nullptr;
+
+    if (!sequences.check(route->slot, sourceIp, packet.sequence, nowMs)) return nullptr;
+
+    return sink.output(*route, packet) ? route : nullptr;
+}
@@ -0,0 +1,164 @@
+#include "ArtPollReplyBuilder.h"
+#include <stdio.h>
+#include <string.h>
+
+// NodeReport 中 "[0000]" 计数器的位置
+static const uint8_t REPORT_COUNTER_OFFSET = ApNodeReport + 7;
+
+// 节点状态码：RcPowerOk
+static const uint16_t REPORT_CODE_OK = 0x0001;
+
+ArtPollReplyBuilder::ArtPollReplyBuilder()
+    : replyCount(0)
+    , reportCounter(0)
+    , dirty(true) {
+    memset(replies, 0, sizeof(replies));
+    memset(slots, NO_SLOT, sizeof(slots));
+    memset(inputs, NO_SLOT, sizeof(inputs));
+    memset(portAddresses, 0, sizeof(portAddresses));
+    memset(portCounts, 0, sizeof(portCounts));
+}
+
+void ArtPollReplyBuilder::rebuild(const ArtPollReplyInfo& info, const UniverseRouter& router,
+                                  const uint16_t* inputAddresses, uint8_t inputCount) {
+    memset(slots, NO_SLOT, sizeof(slots));
+    memset(inputs, NO_SLOT, sizeof(inputs));
+    memset(portAddresses, 0, sizeof(portAddresses));
+    memset(portCounts, 0, sizeof(portCounts));
+
+    // 端口依次为路由表中的宇宙和输入端口的宇宙。按 Net/SubNet 分组，
+    // 每组每 4 个端口一个回复，组内保持订阅顺序，输入端口排在输出端口之后
+    uint8_t routeCount = router.getRouteCount();
+    if (!inputAddresses) inputCount = 0;
+    if (inputCount > MAX_INPUTS) inputCount = MAX_INPUTS;
+    uint8_t total = routeCount + inputCount;
+    bool assigned[UniverseRouter::MAX_ROUTES + MAX_INPUTS] = {false};
+    replyCount = 0;
+
+    for (uint8_t first = 0; first < total; first++) {
+        if (assigned[first]) continue;
+        uint16_t page = (first < routeCount ? router.getPortAddress(first)
+                                            : inputAddresses[first - routeCount]) >> 4;
+        bool open = false;
+
+        for (uint8_t port = first; port < total; port++) {
+            uint16_t address = port < routeCount ? router.getPortAddress(port)
+                                                 : inputAddresses[port - routeCount];
+            if (assigned[port] || (address >> 4) != page) continue;
+
+            if (!open || portCounts[replyCount - 1] == ART_POLL_REPLY_PORTS) {
+                if (replyCount >= MAX_REPLIES) break;
+                replyCount++;
+                open = true;
+            }
+            uint8_t reply = replyCount - 1;
+            if (port < routeCount) {
+                slots[reply][portCounts[reply]] = port;
+            } else {
+                inputs[reply][portCounts[reply]] = port - routeCount;
+            }
+            portAddresses[reply][portCounts[reply]] = address;
+            portCounts[reply]++;
+            assigned[port] = true;
+        }
+    }
+
+    // 没有任何路由时仍回复一次，让控台能发现节点
+    if (replyCount == 0) {
+        replyCount = 1;
+    }
+
+    for (uint8_t i = 0; i < replyCount; i++) {
+        uint8_t* reply = replies[i];
+        memset(reply, 0, ART_POLL_REPLY_SIZE);
+
+        memcpy(reply, ArtnetPacket::ID, 8);
+        reply[8] = OpPollReply & 0xFF;
+        reply[9] = OpPollReply >> 8;
+        memcpy(reply + ApIp, info.ip, 4);
+
+        // 端口号低字节在前
+        reply[ApPort] = ARTNET_PORT & 0xFF;
+        reply[ApPort + 1] = ARTNET_PORT >> 8;
+
+        reply[ApVersInfoH] = info.firmware >> 8;
+        reply[ApVersInfoH + 1] = info.firmware & 0xFF;
+
+        uint16_t page = portAddresses[i][0] >> 4;
+        reply[ApNetSwitch] = (page >> 4) & 0x7F;
+        reply[ApSubSwitch] = page & 0x0F;
+
+        reply[ApOemHi] = info.oem >> 8;
+        reply[ApOemHi + 1] = info.oem & 0xFF;
+        reply[ApStatus1] = info.status1;
+        reply[ApEstaManLo] = info.estaMan & 0xFF;
+        reply[ApEstaManLo + 1] = info.estaMan >> 8;
+
+        strncpy((char*)reply + ApShortName, info.shortName ? info.shortName : "", 17);
+        strncpy((char*)reply + ApLongName, info.longName ? info.longName : "", 63);
+        snprintf((char*)reply + ApNodeReport, 64, "#%04x [0000] OK", REPORT_CODE_OK);
+
+        reply[ApNumPortsHi + 1] = portCounts[i];
+        for (uint8_t port = 0; port < portCounts[i]; port++) {
+            if (inputs[i][port] != NO_SLOT) {
+                reply[ApPortTypes + port] = PORT_TYPE_INPUT;    // 输入端口，DMX512
+                reply[ApSwIn + port] = portAddresses[i][port] & 0x0F;
+            } else {
+                reply[ApPortTypes + port] = PORT_TYPE_OUTPUT;   // 输出端口，DMX512
+                reply[ApGoodInput + port] = GOOD_INPUT_DISABLED;
+                reply[ApSwOut + port] = portAddresses[i][port] & 0x0F;
+            }
+        }
+
+        reply[ApStyle] = 0x00;                  // StNode
+        memcpy(reply + ApMac, info.mac, 6);
+        memcpy(reply + ApBindIp, info.ip, 4);
+        reply[ApBindIndex] = i + 1;
+        reply[ApStatus2] = info.status2;
+    }
+
+    dirty = false;
+}
+
+const uint8_t* ArtPollReplyBuilder::prepare(uint8_t index, const uint8_t* goodOutput, const uint8_t* goodInput) {
+    if (index >= replyCount) return nullptr;
+    uint8_t* reply = replies[index];
+
+    // NodeReport 计数器：每发送一个 ArtPollReply 加 1，0 - 9999 循环
+    uint16_t counter = reportCounter;
+    for (int8_t digit = 3; digit >= 0; digit--) {
+        reply[REPORT_COUNTER_OFFSET + digit] = '0' + counter % 10;
+        counter /= 10;
+    }
+    reportCounter = (reportCounter + 1) % 10000;
+
+    if (goodOutput) {
+        for (uint8_t port = 0; port < ART_POLL_REPLY_PORTS; port++) {
+            uint8_t slot = slots[index][port];
+            reply[ApGoodOutput + port] = slot != NO_SLOT ? goodOutput[slot] : 0;
+        }
+    }
+    if (goodInput) {
+        for (uint8_t port = 0; port < ART_POLL_REPLY_PORTS; port++) {
+            uint8_t input = inputs[index][port];
+            if (input != NO_SLOT) reply[ApGoodInput + port] = goodInput[input];
+        }
+    }
+    return reply;
+}
+
+bool ArtPollReplyBuilder::matchesTarget(uint8_t index, uint16_t bottom, uint16_t top) const {
+    if (index >= replyCount) return false;
+    for (uint8_t port = 0; port < portCounts[index]; port++) {
+        uint16_t address = portAddresses[index][port];
+        if (address >= bottom && address <= top) return true;
+    }
+    return false;
+}
+
+int16_t ArtPollReplyBuilder::slotOf(uint8_t bindIndex, uint8_t port) const {
+    uint8_t index = bindIndex > 0 ? bindIndex - 1 : 0;
+    if (index >= replyCount || port >= ART_POLL_REPLY_PORTS) return -1;
+    uint8_t slot = slots[index][port];
+    return slot != NO_SLOT ? slot : -1;
+}
@@ -0,0 +1,130 @@
+#pragma once
+
+// ArtPollReply 预生成（纯 C++，不依赖 Arduino，可在主机上测试）
+//
+// 每个 ArtPollReply 最多描述 4 个共用 Net/SubNet 的端口。路由表中的宇宙（输出端口）
+// 和 DMX 输入端口发送用的宇宙（输入端口）按 Net/SubNet 分组、每 4 个一组生成一个回复，
+// BindIndex 从 1 开始依次编号。
+// 回复模板只在配置或 IP 变化后重建；每次发送只改写 NodeReport 计数器和
+// GoodInput / GoodOutput 这几个字节。
+
+#include <stdint.h>
+#include "ArtnetPacket.h"
+#include "UniverseRouter.h"
+
+#define ART_POLL_REPLY_SIZE 239
+#define ART_POLL_REPLY_PORTS 4
+
+// ArtPollReply 字段偏移（Art-Net 4）
+enum ArtPollReplyOffsets {
+    ApIp = 10,
+    ApPort = 14,
+    ApVersInfoH = 16,
+    ApNetSwitch = 18,
+    ApSubSwitch = 19,
+    ApOemHi = 20,
+    ApUbeaVersion = 22,
+    ApStatus1 = 23,
+    ApEstaManLo = 24,
+    ApShortName = 26,
+    ApLongName = 44,
+    ApNodeReport = 108,
+    ApNumPortsHi = 172,
+    ApPortTypes = 174,
+    ApGoodInput = 178,
+    ApGoodOutput = 182,
+    ApSwIn = 186,
+    ApSwOut = 190,
+    ApStyle = 200,
+    ApMac = 201,
+    ApBindIp = 207,
+    ApBindIndex = 211,
+    ApStatus2 = 212
+};
+
+// ArtPoll 字段（Art-Net 4）
+#define ART_POLL_FLAGS 12
+#define ART_POLL_TARGET_TOP 14
+#define ART_POLL_TARGET_BOTTOM 16
+#define ART_POLL_TARGETED_SIZE 18
+#define ART_POLL_FLAG_TARGETED 0x20
+
+// GoodInput 位
+#define GOOD_INPUT_DATA 0x80       // 正在接收数据
+#define GOOD_INPUT_DISABLED 0x08   // 输入未启用
+
+// PortTypes：输出 / 输入端口，低 6 位为协议（0 = DMX512）
+#define PORT_TYPE_OUTPUT 0x80
+#define PORT_TYPE_INPUT 0x40
+
+// GoodOutput 位
+#define GOOD_OUTPUT_DATA 0x80      // 正在输出数据
+#define GOOD_OUTPUT_MERGING 0x08   // 正在合并两个源
+#define GOOD_OUTPUT_LTP 0x02       // LTP 合并模式
+
+// Status2：支持 15 位 Port-Address、DHCP 能力
+#define STATUS2_PORT_ADDRESS_15BIT 0x08
+#define STATUS2_DHCP_CAPABLE 0x04
+#define STATUS2_DHCP 0x02
+
+// 回复中与端口无关的节点信息
+struct ArtPollReplyInfo {
+    uint8_t ip[4];
+    uint8_t mac[6];
+    uint16_t firmware;
+    uint16_t oem;
+    uint16_t estaMan;
+    uint8_t status1;
+    uint8_t status2;
+    const char* shortName;
+    const char* longName;
+};
+
+class ArtPollReplyBuilder {
+public:
+    static const uint8_t MAX_INPUTS = ART_POLL_REPLY_PORTS;
+    static const uint8_t MAX_REPLIES = UniverseRouter::MAX_ROUTES + MAX_INPUTS;
+    static const uint8_t NO_SLOT = 0xFF;
+
+    ArtPollReplyBuilder();
+
+    // 配置、路由或 IP 变化后调用，下一次发送前重建
+    void invalidate() { dirty = true; }
+    bool isDirty() const { return dirty; }
+    // inputAddresses：各 DMX 输入端口发送用的宇宙，按输入序号排列（最多 MAX_INPUTS 个）
+    void rebuild(const ArtPollReplyInfo& info, const UniverseRouter& router,
+                 const uint16_t* inputAddresses = nullptr, uint8_t inputCount = 0);
+
+    uint8_t getReplyCount() const { return replyCount; }
+
+    // 取第 index 个回复并写入本次的计数器与端口状态；goodOutput 按路由 slot 索引，
+    // goodInput 按 rebuild() 时的输入序号索引
+    const uint8_t* prepare(uint8_t index, const uint8_t* goodOutput, const uint8_t* goodInput = nullptr);
+
+    // 定向 ArtPoll：该回复是否有端口落在 [bottom, top] 内
+    bool matchesTarget(uint8_t index, uint16_t bottom, uint16_t top) const;
+
+    // ArtAddress 的 BindIndex + 端口号换算为路由 slot，输入端口或无效时返回 -1
+    int16_t slotOf(uint8_t bindIndex, uint8_t port) const;
+
+    uint16_t getReportCounter() const { return reportCounter; }
+
+    // Art-Net 4 回复方式：控台与节点同网段时定向广播，让所有控台都能看到；
+    // 否则单播给控台。地址均为网络字节序
+    static uint32_t replyAddress(uint32_t controllerIp, uint32_t localIp, uint32_t netmask) {
+        if (netmask != 0 && (controllerIp & netmask) == (localIp & netmask)) {
+            return localIp | ~netmask;
+        }
+        return controllerIp;
+    }
+
+private:
+    uint8_t replies[MAX_REPLIES][ART_POLL_REPLY_SIZE];
+    uint8_t slots[MAX_REPLIES][ART_POLL_REPLY_PORTS];       // 输出端口的路由 slot
+    uint8_t inputs[MAX_REPLIES][ART_POLL_REPLY_PORTS];      // 输入端口的输入序号
+    uint16_t portAddresses[MAX_REPLIES][ART_POLL_REPLY_PORTS];
+    uint8_t portCounts[MAX_REPLIES];
+    uint8_t replyCount;
+    uint16_t reportCounter;
+    bool dirty;
+};
@@ -1,19 +1,46 @@
 #include "ArtnetNode.h"
+#include <esp_timer.h>
 
 // 静态成员初始化
 const uint8_t ArtnetNode::ARTNET_ID[8] = {'A', 'r', 't', '-', 'N', 'e', 't', 0};
 
 ArtnetNode::ArtnetNode()
-    : dmx(nullptr)
-    , pixels(nullptr)
+    : pixels(nullptr)
+    , patchCount(0)
+    , customPatch(false)
+    , routeLock(xSemaphoreCreateMutex())
+    , routesPending(false)
+    , configPending(false)
+    , packetSourceIp(0)
+    , packetSourcePort(ARTNET_PORT)
+    , eventRx(ARTNET_RX_EVENT)
+    , sacnRx(RX_PROTOCOL_E131)
+    , sacnRunning(false)
+    , sacnGroupsDirty(true)
+    , sacnSyncUniverse(0)
+    , sacnSyncSeenMs(0)
+    , sacnGroupCount(0)
     , dmxCallback(nullptr)
-    , rdmCallback(nullptr)
-    , pixelCallback(nullptr) {
+    , rdmCallback(nullptr) {
+    memset(dmxPorts, 0, sizeof(dmxPorts));
+    memset(dmxInputs, 0, sizeof(dmxInputs));
+    memset(staged.inputAddress, 0, sizeof(staged.inputAddress));
+    for (uint8_t port = 0; port < DMX_PORT_COUNT; port++) {
+        inputSenders[port].setPhysical(port);
+        inputSenders[port].setKeepalive(DMX_INPUT_KEEPALIVE_MS);
+        inputSenders[port].setMinInterval(DMX_INPUT_MIN_INTERVAL_MS);
+    }
+    memset(&rxLatency, 0, sizeof(rxLatency));
+    memset(&pollStats, 0, sizeof(pollStats));
     initializeDefaults();
+    applyRoutes();
 }
 
 ArtnetNode::~ArtnetNode() {
+    lwipRx.stop();
+    sacnRx.stop();
     udp.stop();
+    vSemaphoreDelete(routeLock);
 }
 
 void ArtnetNode::initializeDefaults() {
@@ -28,6 +55,7 @@ void ArtnetNode::initializeDefaults() {
     config.pixelCount = 170;
     config.pixelType = 0;
     config.mergeMode = true;
+    config.dhcp = true;
 
     // 状态初始化
     memset(&status, 0, sizeof(Status));
@@ -35,6 +63,8 @@ void ArtnetNode::initializeDefaults() {
     status.ports = 1;
     status.portTypes[0] = 0x80;  // 输出端口
     status.version = ARTNET_VERSION;
+
+    rebuildRoutes();
 }
 
 bool ArtnetNode::begin() {
@@ -42,46 +72,147 @@ bool ArtnetNode::begin() {
     IPAddress localIP = WiFi.localIP();
     uint32_t ip = localIP;
     memcpy(status.ip, &ip, 4);
+    WiFi.macAddress(status.mac);
+    pollReplies.invalidate();
+
+    // sACN 总是走 lwIP 回调；组播在网络任务的 update() 中加入
+    if (SACN_ENABLED) {
+        sacnRunning = sacnRx.begin(E131_PORT, &rxQueue, &router);
+        sacnGroupsDirty = true;
+    }
 
     // 启动UDP
+    if (eventRx) {
+        return lwipRx.begin(ARTNET_PORT, &rxQueue, &router);
+    }
     if (!udp.begin(ARTNET_PORT)) {
         return false;
     }
 
-    // 初始化缓冲区
-    memset(dmxBuffer, 0, sizeof(dmxBuffer));
-    memset(pixelBuffer, 0, sizeof(pixelBuffer));
-
     return true;
 }
 
+void ArtnetNode::waitForPacket(uint32_t timeoutMs) {
+    if (!eventRx) {
+        vTaskDelay(1);
+        return;
+    }
+
+    // 由调用 update() 的任务接收通知；DMX 输入每收到一帧也通知一次
+    TaskHandle_t self = xTaskGetCurrentTaskHandle();
+    lwipRx.setNotifyTask(self);
+    sacnRx.setNotifyTask(self);
+    for (uint8_t port = 0; port < DMX_PORT_COUNT; port++) {
+        if (dmxInputs[port]) {
+            dmxInputs[port]->setInputNotifyTask(self);
+            // 被推迟的变化在最小间隔到期时发出
+            if (inputSenders[port].hasPending() && timeoutMs > DMX_INPUT_MIN_INTERVAL_MS) {
+                timeoutMs = DMX_INPUT_MIN_INTERVAL_MS;
+            }
+        }
+    }
+    if (rxQueue.empty() && !inputPending()) {
+        ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(timeoutMs));
+    }
+}
+
 void ArtnetNode::update() {
-    int packetSize = udp.parsePacket();
-    if (packetSize == 0) return;
+    // 其他任务提交的配置和重建的路由表在处理数据包之前换入
+    if (configPending) {
+        applyPendingConfig();
+    }
+    if (routesPending) {
+        applyRoutes();
+    }
+
+    // ArtSync / sACN 同步超时后回到非同步模式，提交滞留的数据
+    uint32_t now = millis();
+    commitOutputs(sync.poll(now) | sacnSync.poll(now));
+
+    // 同步超时内没有数据包再指定同步宇宙（控台停用同步）：退出它的组播
+    if (sacnSyncUniverse != 0 && now - sacnSyncSeenMs >= SyncController::SYNC_TIMEOUT_MS) {
+        sacnSyncUniverse = 0;
+        sacnGroupsDirty = true;
+    }
+
+    if (sacnRunning && sacnGroupsDirty) {
+        updateSacnGroups();
+    }
 
-    // 读取数据包
-    int length = udp.read(artnetBuffer, sizeof(artnetBuffer));
+    sendInputs();
+
+    // 一次处理完队列中所有的包，突发的多个宇宙不必等下一个节拍
+    ArtnetRxPacket* packet;
+    while ((packet = rxQueue.front()) != nullptr) {
+        packetSourceIp = packet->sourceIp;
+        packetSourcePort = packet->sourcePort;
+        if (packet->protocol == RX_PROTOCOL_E131) {
+            handleE131(packet->data, packet->length);
+        } else {
+            processPacket(packet->data, packet->length);
+        }
+
+        uint32_t latency = (uint32_t)esp_timer_get_time() - packet->arrivalUs;
+        rxQueue.pop();
+        rxLatency.frames++;
+        rxLatency.lastUs = latency;
+        rxLatency.totalUs += latency;
+        if (latency > rxLatency.maxUs) rxLatency.maxUs = latency;
+    }
+
+    if (eventRx) return;
+
+    // 轮询模式：先只读 18 字节包头判断，其他节点的宇宙不进入 processPacket()。
+    // parsePacket() 已经把整个数据报拷进 WiFiUDP 的缓冲，这里省不掉那次拷贝，
+    // 只省掉拷进 artnetBuffer 和后面的处理；拷贝前按包头丢弃只在事件模式（LwipUdpReceiver 读 pbuf）下成立
+    for (uint8_t i = 0; i < ARTNET_POLL_BURST; i++) {
+        int packetSize = udp.parsePacket();
+        if (packetSize <= 0) return;
+        pollStats.received++;
+
+        int length = udp.read(artnetBuffer, ART_DMX_HEADER_SIZE);
+        if (length <= 0 || !artnetRxWanted(artnetBuffer, packetSize, router)) {
+            udp.flush();
+            pollStats.filtered++;
+            continue;
+        }
+
+        packetSourceIp = udp.remoteIP();
+        packetSourcePort = udp.remotePort();
+
+        // 读取剩余部分
+        if (packetSize > length) {
+            int rest = udp.read(artnetBuffer + length, sizeof(artnetBuffer) - length);
+            if (rest > 0) length += rest;
+        }
+        udp.flush();
+        pollStats.queued++;
+        processPacket(artnetBuffer, length);
+    }
+}
+
+void ArtnetNode::processPacket(uint8_t* data, uint16_t length) {
     if (length < 10) return;
 
     // 验证Art-Net包
-    if (!validatePacket(artnetBuffer, length)) return;
+    if (!validatePacket(data, length)) return;
 
     // 解析操作码
-    uint16_t opcode = artnetBuffer[8] | (artnetBuffer[9] << 8);
+    uint16_t opcode = ArtnetPacket::getOpCode(data);
 
     // 处理不同类型的Art-Net包
     switch (opcode) {
         case OpPoll:
-            handleArtPoll();
+            handleArtPoll(data, length);
             break;
         case OpDmx:
-            handleArtDmx(artnetBuffer, length);
+            handleArtDmx(data, length);
             break;
         case OpAddress:
-            handleArtAddress(artnetBuffer, length);
+            handleArtAddress(data, length);
             break;
         case OpRdm:
-            handleArtRdm(artnetBuffer, length);
+            handleArtRdm(data, length);
             break;
         case OpSync:
             handleArtSync();
@@ -89,114 +220,507 @@ void ArtnetNode::update() {
     }
 }
 
-void ArtnetNode::handleArtDmx(uint8_t* data, uint16_t length) {
-    if (length < 18) return;  // DMX数据包最小长度
+struct ArtnetNode::ArtDmxSink {
+    ArtnetNode& node;
 
-    uint8_t sequence = data[12];
-    uint8_t physical = data[13];
-    uint8_t subnet = data[14] >> 4;
-    uint8_t universe = data[14] & 0x0F;
-    uint16_t dmxLength = (data[16] << 8) | data[17];
+    bool output(const UniverseRoute& route, const ArtDmxPacket& packet) {
+        return node.outputUniverse(route, packet.portAddress, node.packetSourceIp, packet.data, packet.length);
+    }
+};
 
-    // 检查是否是目标宇宙
-    if (subnet != config.subnet || universe != config.universe) {
+void ArtnetNode::handleArtDmx(uint8_t* data, uint16_t length) {
+    // 解析、查表、序号检查和合并输出见 dispatchArtDmx()
+    ArtDmxSink sink = {*this};
+    const UniverseRoute* route = dispatchArtDmx(data, length, packetSourceIp, millis(), router, sequences, sink);
+    if (!route) {
         return;
     }
 
-    // 限制DMX数据长度
-    if (dmxLength > ARTNET_DMX_LENGTH) {
-        dmxLength = ARTNET_DMX_LENGTH;
-    }
+    // 非同步模式立即提交；同步模式等待 ArtSync
+    commitOutputs(sync.onArtDmx(packetSourceIp, outputMaskOf(*route), millis()));
+}
 
-    // 复制DMX数据
-    memcpy(dmxBuffer, &data[18], dmxLength);
+// Art-Net 与 sACN 共用：合并后写入输出的后台缓冲，由调用方决定何时提交。
+// sourceKey 为合并引擎区分源的键：Art-Net 为源 IP，sACN 为 CID 对应的键
+bool ArtnetNode::outputUniverse(const UniverseRoute& route, uint16_t portAddress, uint32_t sourceKey,
+                                const uint8_t* data, uint16_t length) {
+    // 双源合并：单源时返回的就是接收缓冲中的数据
+    const uint8_t* slots = merger.process(route.slot, sourceKey, data, length, millis());
+    if (!slots) {
+        return false;
+    }
 
     // 调用DMX回调
     if (dmxCallback) {
-        dmxCallback(universe, dmxBuffer, dmxLength);
+        dmxCallback(portAddress, slots, length);
+    }
+
+    routeUniverse(route, slots, length);
+    return true;
+}
+
+void ArtnetNode::handleE131(uint8_t* data, uint16_t length) {
+    switch (E131Packet::classify(data, length)) {
+        case E131_DATA:
+            handleE131Data(data, length);
+            break;
+
+        case E131_SYNC: {
+            // 只响应数据包中指定的同步宇宙
+            E131SyncPacket packet;
+            if (E131Packet::parseSync(data, length, packet) && packet.syncAddress == sacnSyncUniverse) {
+                commitOutputs(sacnSync.onArtSync(packetSourceIp, millis()));
+            }
+            break;
+        }
+
+        default:
+            break;
+    }
+}
+
+void ArtnetNode::handleE131Data(uint8_t* data, uint16_t length) {
+    E131DataPacket packet;
+    if (!E131Packet::parseData(data, length, packet)) return;
+    if (packet.startCode != 0 || (packet.options & E131_OPT_PREVIEW)) return;
+
+    uint16_t portAddress;
+    if (!E131Packet::universeToPortAddress(packet.universe, portAddress)) return;
+    const UniverseRoute* route = router.lookup(portAddress);
+    if (!route) return;
+
+    // 优先级选源：低优先级、乱序的包被丢弃。
+    // 超时、结束或被更高优先级压制的源同时退出合并，合并引擎只保留选源结果中的源
+    uint32_t now = millis();
+    E131ArbiterResult result = sacnArbiter.process(route->slot, packet.cid, packet.priority,
+                                                   packet.sequence, packet.options, now);
+    for (uint8_t source = 0; source < E131Arbiter::MAX_SOURCES; source++) {
+        if (!sacnArbiter.isSelected(route->slot, source)) {
+            merger.removeSource(route->slot, E131Arbiter::mergeKey(source));
+        }
+    }
+    if (result != E131_ACCEPT) return;
+
+    // 新的同步宇宙需要加入组播才能收到同步包，换掉的旧同步宇宙由 updateSacnGroups() 退出
+    if (packet.syncAddress != 0) {
+        if (packet.syncAddress != sacnSyncUniverse) {
+            sacnSyncUniverse = packet.syncAddress;
+            sacnGroupsDirty = true;
+        }
+        sacnSyncSeenMs = now;
+    }
+
+    uint32_t sourceKey = E131Arbiter::mergeKey(sacnArbiter.getLastSource());
+    if (!outputUniverse(*route, portAddress, sourceKey, packet.data, packet.length)) {
+        return;
+    }
+
+    uint32_t mask = outputMaskOf(*route);
+    commitOutputs(packet.syncAddress != 0 ? sacnSync.onArtDmx(packetSourceIp, mask, now) : mask);
+}
+
+// 按路由表和同步宇宙调整 IGMP 组播成员：先退出不再需要的，再加入新的
+void ArtnetNode::updateSacnGroups() {
+    uint16_t wanted[MAX_SACN_GROUPS];
+    uint8_t wantedCount = 0;
+    for (uint8_t slot = 0; slot < router.getRouteCount(); slot++) {
+        wanted[wantedCount++] = E131Packet::portAddressToUniverse(router.getPortAddress(slot));
+    }
+    if (sacnSyncUniverse != 0) {
+        wanted[wantedCount++] = sacnSyncUniverse;
     }
 
-    // 更新DMX输出
-    if (dmx) {
-        dmx->write(dmxBuffer, dmxLength);
+    for (uint8_t i = 0; i < sacnGroupCount; i++) {
+        bool keep = false;
+        for (uint8_t j = 0; j < wantedCount && !keep; j++) {
+            keep = sacnGroups[i] == wanted[j];
+        }
+        if (!keep) {
+            sacnRx.leaveGroup(E131Packet::multicastAddress(sacnGroups[i]));
+        }
     }
 
-    // 处理像素数据
-    if (pixels && config.pixelCount > 0) {
-        uint16_t pixelLength = config.pixelCount * 3;
-        if (pixelLength > dmxLength) {
-            pixelLength = dmxLength;
+    uint8_t joined = 0;
+    for (uint8_t j = 0; j < wantedCount; j++) {
+        bool member = false;
+        for (uint8_t i = 0; i < sacnGroupCount && !member; i++) {
+            member = sacnGroups[i] == wanted[j];
         }
-        memcpy(pixelBuffer, dmxBuffer, pixelLength);
-        if (pixelCallback) {
-            pixelCallback(pixelBuffer, pixelLength);
+        if (member || sacnRx.joinGroup(E131Packet::multicastAddress(wanted[j]))) {
+            sacnGroups[joined++] = wanted[j];
         }
-        pixels->update();
-    }
-}
-
-void ArtnetNode::handleArtPoll() {
-    sendArtPollReply();
-}
-
-void ArtnetNode::sendArtPollReply() {
-    uint8_t reply[239];
-    memset(reply, 0, sizeof(reply));
-
-    // ID
-    memcpy(reply, ARTNET_ID, 8);
-    
-    // OpCode
-    reply[8] = OpPollReply & 0xFF;
-    reply[9] = (OpPollReply >> 8) & 0xFF;
-    
-    // IP地址
-    memcpy(reply + 10, status.ip, 4);
-    
-    // 端口
-    reply[14] = (ARTNET_PORT >> 8) & 0xFF;
-    reply[15] = ARTNET_PORT & 0xFF;
-    
-    // 版本信息
-    reply[16] = status.version >> 8;
-    reply[17] = status.version & 0xFF;
-    
-    // 网络设置
-    reply[18] = config.subnet;
-    reply[19] = status.firmware;
-    
-    // 状态
-    reply[21] = status.status1;
-    reply[22] = status.status2;
-    
-    // 名称
-    memcpy(reply + 26, config.shortName, 18);
-    memcpy(reply + 44, config.longName, 64);
-    
-    // 发送回复
-    udp.beginPacket(udp.remoteIP(), udp.remotePort());
-    udp.write(reply, sizeof(reply));
+    }
+    sacnGroupCount = joined;
+    sacnGroupsDirty = false;
+}
+
+// 配接计划的输出：DMX 直接写入端口的后台帧，像素直接写入 PixelDriver 的 DMX 输入缓冲。
+// 像素缓冲在第一次写像素时才取，没有像素段的宇宙不会让渲染任务多画一帧
+struct ArtnetNode::PatchSink {
+    ArtnetNode& node;
+    uint8_t* rgb;
+    uint16_t rgbBytes;
+
+    void write(uint8_t target, uint16_t dest, const uint8_t* src, uint16_t length) {
+        if (target == PatchPlan::PIXEL_TARGET) {
+            if (!rgb) {
+                if (!node.pixels || !(rgb = node.pixels->editDmx())) return;
+                rgbBytes = node.pixels->getDmxBytes();
+            }
+            if (dest >= rgbBytes) return;
+            if (length > rgbBytes - dest) length = rgbBytes - dest;
+            memcpy(rgb + dest, src, length);
+        } else if (target < DMX_PORT_COUNT && node.dmxPorts[target]) {
+            node.dmxPorts[target]->writeSlots(src, length, dest);
+        }
+    }
+};
+
+void ArtnetNode::routeUniverse(const UniverseRoute& route, const uint8_t* data, uint16_t length) {
+    // 按编译好的拷贝段写入各输出，由 commitOutputs() 提交
+    PatchSink sink = {*this, nullptr, 0};
+    patchPlan.apply(route.slot, data, length, sink);
+}
+
+void ArtnetNode::handleArtPoll(uint8_t* data, uint16_t length) {
+    // 定向 ArtPoll：只回复端口落在 [Bottom, Top] 内的绑定
+    bool targeted = length >= ART_POLL_TARGETED_SIZE && (data[ART_POLL_FLAGS] & ART_POLL_FLAG_TARGETED);
+    uint16_t top = ((data[ART_POLL_TARGET_TOP] << 8) | data[ART_POLL_TARGET_TOP + 1]) & 0x7FFF;
+    uint16_t bottom = ((data[ART_POLL_TARGET_BOTTOM] << 8) | data[ART_POLL_TARGET_BOTTOM + 1]) & 0x7FFF;
+    sendArtPollReply(targeted, bottom, top);
+}
+
+// IP 可能由 DHCP 更新；模板只在配置或 IP 变化后重建
+void ArtnetNode::refreshPollReplies() {
+    uint32_t localIp = WiFi.localIP();
+    if (localIp == 0) {
+        localIp = WiFi.softAPIP();
+    }
+    if (memcmp(status.ip, &localIp, 4) != 0) {
+        memcpy(status.ip, &localIp, 4);
+        pollReplies.invalidate();
+    }
+    if (!pollReplies.isDirty()) return;
+
+    ArtPollReplyInfo info;
+    memcpy(info.ip, status.ip, 4);
+    memcpy(info.mac, status.mac, 6);
+    info.firmware = status.firmware;
+    info.oem = OEM_CODE;
+    info.estaMan = 0;
+    info.status1 = status.status1;
+    info.status2 = status.status2;
+    info.shortName = config.shortName;
+    info.longName = config.longName;
+
+    // DMX 输入端口按端口顺序作为输入端口列出，发送时的 GoodInput 用同样的顺序
+    uint16_t inputAddresses[DMX_PORT_COUNT];
+    uint8_t inputCount = 0;
+    for (uint8_t port = 0; port < DMX_PORT_COUNT; port++) {
+        if (dmxInputs[port]) inputAddresses[inputCount++] = inputSenders[port].getPortAddress();
+    }
+    pollReplies.rebuild(info, router, inputAddresses, inputCount);
+}
+
+void ArtnetNode::sendArtPollReply(bool targeted, uint16_t targetBottom, uint16_t targetTop) {
+    refreshPollReplies();
+
+    // 每个宇宙的输出状态随数据变化，发送时写入。Art-Net 和 sACN 的数据都经过合并引擎，
+    // 按它记录的最近一帧判断是否正在输出
+    uint32_t now = millis();
+    uint8_t goodOutput[UniverseRouter::MAX_ROUTES];
+    for (uint8_t slot = 0; slot < UniverseRouter::MAX_ROUTES; slot++) {
+        uint8_t flags = 0;
+        if (slot < router.getRouteCount()) {
+            if (merger.hasRecentData(slot, now)) flags |= GOOD_OUTPUT_DATA;
+            if (merger.isMerging(slot)) flags |= GOOD_OUTPUT_MERGING;
+            if (merger.getMode(slot) == MERGE_LTP) flags |= GOOD_OUTPUT_LTP;
+        }
+        goodOutput[slot] = flags;
+    }
+    uint8_t goodInput[DMX_PORT_COUNT];
+    uint8_t inputCount = 0;
+    for (uint8_t port = 0; port < DMX_PORT_COUNT; port++) {
+        if (!dmxInputs[port]) continue;
+        goodInput[inputCount++] = inputSenders[port].isReceiving(now) ? GOOD_INPUT_DATA : 0;
+    }
+
+    uint32_t localIp;
+    memcpy(&localIp, status.ip, 4);
+    uint32_t netmask = WiFi.localIP() != 0 ? (uint32_t)WiFi.subnetMask() : (uint32_t)IPAddress(255, 255, 255, 0);
+    uint32_t destination = ArtPollReplyBuilder::replyAddress(packetSourceIp, localIp, netmask);
+
+    for (uint8_t i = 0; i < pollReplies.getReplyCount(); i++) {
+        if (targeted && !pollReplies.matchesTarget(i, targetBottom, targetTop)) continue;
+        sendPacket(destination, ARTNET_PORT, pollReplies.prepare(i, goodOutput, goodInput), ART_POLL_REPLY_SIZE);
+    }
+}
+
+void ArtnetNode::sendPacket(uint32_t ip, uint16_t port, const uint8_t* data, uint16_t length) {
+    if (eventRx) {
+        lwipRx.sendTo(ip, port, data, length);
+        return;
+    }
+    udp.beginPacket(IPAddress(ip), port);
+    udp.write(data, length);
     udp.endPacket();
 }
 
 bool ArtnetNode::validatePacket(uint8_t* data, uint16_t length) {
     // 检查Art-Net ID
-    return (length >= 10) && (memcmp(data, ARTNET_ID, 8) == 0);
+    return ArtnetPacket::hasValidId(data, length);
 }
 
+// 网页任务只登记新配置；合并模式、路由重建和状态重置都在网络任务中进行，不与数据包处理并发
 void ArtnetNode::setConfig(const Config& config) {
-    this->config = config;
+    xSemaphoreTake(routeLock, portMAX_DELAY);
+    pendingConfig = config;
+    configPending = true;
+    xSemaphoreGive(routeLock);
+}
+
+// 网络任务：应用 setConfig() 登记的配置，路由表立即换入
+void ArtnetNode::applyPendingConfig() {
+    if (xSemaphoreTake(routeLock, 0) != pdTRUE) return;
+    config = pendingConfig;
+    configPending = false;
+    merger.setDefaultMode(config.mergeMode ? MERGE_HTP : MERGE_LTP);
+    buildRoutes();
+    xSemaphoreGive(routeLock);
+
+    applyRoutes();
     updateStatus();
+    pollReplies.invalidate();
+}
+
+void ArtnetNode::attachDmxOutput(uint8_t port, ESP32DMX* output) {
+    if (port < DMX_PORT_COUNT) {
+        dmxPorts[port] = output;
+    }
+}
+
+void ArtnetNode::attachDmxInput(uint8_t port, ESP32DMX* input) {
+    if (port < DMX_PORT_COUNT) {
+        dmxInputs[port] = input;
+        inputSenders[port].reset();
+        rebuildRoutes();
+    }
+}
+
+bool ArtnetNode::inputPending() const {
+    for (uint8_t port = 0; port < DMX_PORT_COUNT; port++) {
+        if (dmxInputs[port] && dmxInputs[port]->hasInputFrame()) return true;
+    }
+    return false;
+}
+
+// DMX 输入 -> ArtDmx：只有内容变化或 keepalive 到期时才发送
+void ArtnetNode::sendInputs() {
+    uint32_t now = millis();
+    for (uint8_t port = 0; port < DMX_PORT_COUNT; port++) {
+        ESP32DMX* input = dmxInputs[port];
+        if (!input) continue;
+
+        DmxInputSender& sender = inputSenders[port];
+        uint16_t length;
+        if (input->acquireInputFrame()) {
+            const DmxFrame& frame = input->getInputFrame();
+            length = sender.onFrame(frame.slots(), frame.length, now);
+        } else {
+            length = sender.poll(now);
+        }
+        if (length > 0) {
+            sendPacket(inputDestination(), ARTNET_PORT, sender.packet(), length);
+        }
+    }
+}
+
+// 配置的目标 IP，未配置时发到本子网的定向广播地址
+uint32_t ArtnetNode::inputDestination() {
+    if (DMX_INPUT_DEST_IP != 0) return DMX_INPUT_DEST_IP;
+    uint32_t localIp;
+    memcpy(&localIp, status.ip, 4);
+    uint32_t netmask = (uint32_t)WiFi.subnetMask();
+    return (localIp & netmask) | ~netmask;
+}
+
+void ArtnetNode::attachPixelDriver(PixelDriver* driver) {
+    pixels = driver;
+    rebuildRoutes();
+}
+
+bool ArtnetNode::addRoute(uint16_t portAddress, OutputType type, uint8_t index) {
+    xSemaphoreTake(routeLock, portMAX_DELAY);
+    if (!staged.router.addRoute(portAddress, type, index)) {
+        xSemaphoreGive(routeLock);
+        return false;
+    }
+
+    if (patchCount < MAX_PATCH_ENTRIES) {
+        PatchEntry& entry = patchEntries[patchCount++];
+        entry.portAddress = portAddress;
+        entry.source = 0;
+        entry.count = PatchPlan::SOURCE_SLOTS;
+        entry.type = type;
+        entry.index = index;
+        entry.offset = 0;
+        entry.repeat = 1;
+        entry.stride = 0;
+    }
+    compilePatch();
+    xSemaphoreGive(routeLock);
+    return true;
+}
+
+bool ArtnetNode::setPatch(const PatchEntry* entries, uint8_t count) {
+    if (count > MAX_PATCH_ENTRIES) return false;
+    xSemaphoreTake(routeLock, portMAX_DELAY);
+    if (count > 0) memcpy(patchEntries, entries, count * sizeof(PatchEntry));
+    patchCount = count;
+    customPatch = count > 0;
+
+    buildRoutes();
+    bool complete = staged.plan.getStats().overflow == false;
+    xSemaphoreGive(routeLock);
+    return complete;
+}
+
+void ArtnetNode::rebuildRoutes() {
+    xSemaphoreTake(routeLock, portMAX_DELAY);
+    buildRoutes();
+    xSemaphoreGive(routeLock);
+}
+
+// 按配置生成默认路由：
+//   基准宇宙 -> DMX A，基准 + 1 -> DMX B（双端口模式），输入端口保留自己的宇宙用于发送，
+//   随后每个宇宙对应一段像素。默认配接从 dmxStartAddress 起取通道，像素段按剩余通道数分配。
+// 设置了配接表时，路由改为表中出现的宇宙（输出类型取该宇宙的第一项）。
+// 结果写入暂存副本，调用方持有 routeLock
+void ArtnetNode::buildRoutes() {
+    staged.router.clear();
+
+    uint16_t portAddress = ArtnetPacket::makePortAddress(config.net, config.subnet, config.universe);
+    uint8_t dmxPortCount = config.dmxMode ? DMX_PORT_COUNT : 1;
+    for (uint8_t port = dmxPortCount; port < DMX_PORT_COUNT; port++) {
+        if (dmxInputs[port]) dmxPortCount = port + 1;
+    }
+
+    if (customPatch) {
+        for (uint8_t port = 0; port < dmxPortCount; port++) {
+            staged.inputAddress[port] = portAddress++;
+        }
+        for (uint8_t e = 0; e < patchCount; e++) {
+            const PatchEntry& entry = patchEntries[e];
+            if (entry.type == OUTPUT_DMX && entry.index < DMX_PORT_COUNT && dmxInputs[entry.index]) continue;
+            if (!staged.router.lookup(entry.portAddress)) {
+                staged.router.addRoute(entry.portAddress, (OutputType)entry.type, entry.index);
+            }
+        }
+        compilePatch();
+        return;
+    }
+
+    uint16_t start = config.dmxStartAddress < 1 ? 0 : config.dmxStartAddress - 1;
+    if (start >= PatchPlan::SOURCE_SLOTS) start = PatchPlan::SOURCE_SLOTS - 1;
+    patchCount = 0;
+
+    for (uint8_t port = 0; port < dmxPortCount; port++) {
+        // 输入端口占用原来的宇宙，但不再接收输出
+        staged.inputAddress[port] = portAddress;
+        if (dmxInputs[port]) {
+            portAddress++;
+            continue;
+        }
+        if (staged.router.addRoute(portAddress, OUTPUT_DMX, port)) {
+            PatchEntry& entry = patchEntries[patchCount++];
+            entry = {portAddress, start, (uint16_t)(PatchPlan::SOURCE_SLOTS - start),
+                     OUTPUT_DMX, port, 0, 1, 0};
+        }
+        portAddress++;
+    }
+
+    // 多条灯带时每条从新的宇宙开始，单条时按配置的像素数
+    PixelStripLayout strips;
+    if (pixels && pixels->getStripCount() > 1) {
+        strips = pixels->getLayout();
+    } else {
+        strips.addStrip(pixelTotal());
+    }
+
+    uint16_t perUniverse = (PatchPlan::SOURCE_SLOTS - start) / 3;
+    if (perUniverse > PIXELS_PER_UNIVERSE) perUniverse = PIXELS_PER_UNIVERSE;
+    uint8_t segment = 0;
+    for (uint8_t strip = 0; strip < strips.getStripCount() && perUniverse > 0; strip++) {
+        uint8_t segments = strips.universeCount(strip, perUniverse);
+        for (uint8_t i = 0; i < segments && patchCount < MAX_PATCH_ENTRIES; i++) {
+            if (!staged.router.addRoute(portAddress, OUTPUT_PIXEL, segment++)) break;
+            // 像素按字节连续排列，灯带内第 N 段从第 N * perUniverse 个像素起，不跨到下一条
+            uint16_t first = i * perUniverse;
+            uint16_t count = strips.getCount(strip) - first;
+            if (count > perUniverse) count = perUniverse;
+            PatchEntry& entry = patchEntries[patchCount++];
+            entry = {portAddress, start, (uint16_t)(count * 3), OUTPUT_PIXEL, 0,
+                     (uint16_t)((strips.getStart(strip) + first) * 3), 1, 0};
+            portAddress++;
+        }
+    }
+    compilePatch();
+}
+
+// 像素总数：多条灯带时取驱动的布局，否则按配置
+uint16_t ArtnetNode::pixelTotal() const {
+    if (pixels && pixels->getStripCount() > 1) return pixels->getLayout().getTotal();
+    return config.pixelCount > MAX_PIXELS ? MAX_PIXELS : config.pixelCount;
+}
+
+// 配接表编译为拷贝计划：输入端口不作为目标。编译完成后等待网络任务换入
+void ArtnetNode::compilePatch() {
+    static_assert(DMX_PORT_COUNT <= PatchPlan::MAX_DMX_TARGETS, "PatchPlan has too few DMX targets");
+    uint8_t dmxTargets = 0;
+    for (uint8_t port = 0; port < DMX_PORT_COUNT; port++) {
+        if (!dmxInputs[port]) dmxTargets |= 1 << port;
+    }
+    staged.plan.compile(patchEntries, patchCount, staged.router, dmxTargets, pixelTotal() * 3);
+    routesPending = true;
+}
+
+// 网络任务：换入暂存的路由表和拷贝计划。其他任务正在重建时留到下一次 update()。
+// lwIP 回调在拷贝期间仍可能读到新旧混合的订阅位图，最多误收 / 误丢一个包
+void ArtnetNode::applyRoutes() {
+    if (xSemaphoreTake(routeLock, 0) != pdTRUE) return;
+    if (routesPending) {
+        router = staged.router;
+        patchPlan = staged.plan;
+        for (uint8_t port = 0; port < DMX_PORT_COUNT; port++) {
+            inputSenders[port].setPortAddress(staged.inputAddress[port]);
+        }
+        // 路由序号可能已经改变，按序号保存的合并 / 序号 / 选源状态全部作废。
+        // 同步宇宙由新路由上的数据包重新指定，旧的随组播更新退出
+        merger.reset();
+        sequences.reset();
+        sacnArbiter.reset();
+        pollReplies.invalidate();
+        sacnSyncUniverse = 0;
+        sacnGroupsDirty = true;
+        routesPending = false;
+    }
+    xSemaphoreGive(routeLock);
 }
 
 void ArtnetNode::updateStatus() {
     status.goodInput = 0x80;  // 数据是好的
     status.goodOutput = 0x80; // 输出是好的
     status.status1 = 0x80;    // 显示正常运行
+    status.status2 = STATUS2_PORT_ADDRESS_15BIT | STATUS2_DHCP_CAPABLE;
+    // 只有实际使用 DHCP 时才报告 IP 由 DHCP 分配；配置变化后由 applyPendingConfig() 重新生成
+    status.dhcp = config.dhcp;
+    if (config.dhcp) {
+        status.status2 |= STATUS2_DHCP;
+    }
 }
 
 // 回调设置方法
-void ArtnetNode::setDMXCallback(void (*callback)(uint16_t, uint8_t*, uint16_t)) {
+void ArtnetNode::setDMXCallback(void (*callback)(uint16_t, const uint8_t*, uint16_t)) {
     dmxCallback = callback;
 }
 
@@ -204,10 +728,6 @@ void ArtnetNode::setRDMCallback(void (*callback)(uint8_t*, uint16_t)) {
     rdmCallback = callback;
 }
 
-void ArtnetNode::setPixelCallback(void (*callback)(uint8_t*, uint16_t)) {
-    pixelCallback = callback;
-}
-
 void ArtnetNode::handleArtRdm(uint8_t* data, uint16_t size) {
     // 处理 Art-Net RDM 包
     if (!data || size < ART_RDM_MIN_SIZE) {
@@ -230,44 +750,89 @@ void ArtnetNode::handleArtAddress(uint8_t* data, uint16_t size) {
         return;
     }
 
-    // 解析地址配置
+    // 解析地址配置（Art-Net 4 布局）
     uint8_t netSwitch = data[12];
-    uint8_t subSwitch = data[13];
-    uint8_t universe = data[14];
-    uint8_t commandResponse = data[15];
-
-    // 更新配置
-    if (netSwitch != 0x7f) {
-        config.net = netSwitch;
+    uint8_t bindIndex = data[13];
+    uint8_t swOut = data[100];
+    uint8_t subSwitch = data[104];
+    uint8_t command = data[106];
+
+    // 最高位为 1 表示写入新值，0x7F 表示不变
+    bool addressChanged = false;
+    if (netSwitch & 0x80) {
+        config.net = netSwitch & 0x7F;
+        addressChanged = true;
+    }
+    if (subSwitch & 0x80) {
+        config.subnet = subSwitch & 0x0F;
+        addressChanged = true;
+    }
+    if (swOut & 0x80) {
+        config.universe = swOut & 0x0F;
+        addressChanged = true;
     }
-    if (subSwitch != 0x7f) {
-        config.subnet = subSwitch;
+    if (data[14] != 0) {
+        strlcpy(config.shortName, (const char*)&data[14], sizeof(config.shortName));
+        pollReplies.invalidate();
     }
-    if (universe != 0x7f) {
-        config.universe = universe;
+    if (data[32] != 0) {
+        strlcpy(config.longName, (const char*)&data[32], sizeof(config.longName));
+        pollReplies.invalidate();
     }
 
-    // TODO: 处理其他地址配置
-    // 这里添加额外的地址处理代码
+    if (addressChanged) {
+        // 本身就在网络任务中，立即换入
+        rebuildRoutes();
+        applyRoutes();
+    }
+
+    // 合并命令
+    if (command == AcCancelMerge) {
+        merger.cancelMerge();
+    } else if (command >= AcMergeLtp0 && command <= AcMergeLtp0 + 3) {
+        int16_t slot = portToSlot(bindIndex, command - AcMergeLtp0);
+        if (slot >= 0) merger.setMode(slot, MERGE_LTP);
+    } else if (command >= AcMergeHtp0 && command <= AcMergeHtp0 + 3) {
+        int16_t slot = portToSlot(bindIndex, command - AcMergeHtp0);
+        if (slot >= 0) merger.setMode(slot, MERGE_HTP);
+    }
+}
+
+// ArtAddress 的端口号换算为路由序号：与 ArtPollReply 中的 BindIndex 分组一致
+int16_t ArtnetNode::portToSlot(uint8_t bindIndex, uint8_t port) {
+    refreshPollReplies();
+    return pollReplies.slotOf(bindIndex, port);
 }
 
 void ArtnetNode::handleArtSync() {
-    // 处理 Art-Net Sync 包
-    // 通常用于同步多个节点的输出
+    // 同步模式下一次性提交所有已暂存的宇宙
+    commitOutputs(sync.onArtSync(packetSourceIp, millis()));
+}
 
-    // 设置同步标志
-    syncReceived = true;
+// 提交输出：DMX 端口发布后台帧，像素每次提交只刷新一次
+void ArtnetNode::commitOutputs(uint32_t outputMask) {
+    if (outputMask == 0) return;
 
-    // 如果启用了同步模式，则在收到同步包时更新输出
-    if (syncMode) {
-        // 更新 DMX 输出
-        updateDmxOutput();
+    for (uint8_t port = 0; port < DMX_PORT_COUNT; port++) {
+        if ((outputMask & (1UL << port)) && dmxPorts[port]) {
+            dmxPorts[port]->commitFrame();
+        }
+    }
+
+    if ((outputMask & OUTPUT_MASK_PIXELS) && pixels) {
+        pixels->show();
     }
 }
 
-void ArtnetNode::updateDmxOutput() {
-    // 实际的 DMX 输出更新逻辑
-    // 这个方法应该在您的代码中已经实现
+// 该宇宙的配接写入的输出
+uint32_t ArtnetNode::outputMaskOf(const UniverseRoute& route) const {
+    uint8_t targets = patchPlan.targetMask(route.slot);
+    uint32_t mask = 0;
+    for (uint8_t port = 0; port < DMX_PORT_COUNT; port++) {
+        if (targets & (1 << port)) mask |= 1UL << port;
+    }
+    if (targets & (1 << PatchPlan::PIXEL_TARGET)) mask |= OUTPUT_MASK_PIXELS;
+    return mask;
 }
 
 // 如果需要，添加其他辅助方法
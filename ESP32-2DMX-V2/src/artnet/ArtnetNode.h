@@ -3,34 +3,24 @@
 #include <Arduino.h>
 #include <WiFi.h>
 #include <WiFiUdp.h>
+#include <freertos/semphr.h>
 #include "config.h"
 #include "dmx/ESP32DMX.h"
 #include "pixels/PixelDriver.h"
 #include "rdm/RDMHandler.h"
-
-// Art-Net 包大小常量定义
-#define ART_NET_MIN_SIZE 12
-#define ART_RDM_MIN_SIZE 14
-#define ART_ADDRESS_MIN_SIZE 16
-
-// Art-Net 协议常量
-#define ARTNET_PORT 6454
-#define ARTNET_DMX_LENGTH 512
-#define ARTNET_VERSION 14
-
-// Art-Net包类型
-enum ArtNetOpCodes {
-    OpPoll = 0x2000,
-    OpPollReply = 0x2100,
-    OpDmx = 0x5000,
-    OpNzs = 0x5100,
-    OpSync = 0x5200,
-    OpAddress = 0x6000,
-    OpInput = 0x7000,
-    OpRdm = 0x8400,
-    OpIpProg = 0xF800,
-    OpIpProgReply = 0xF900
-};
+#include "ArtnetPacket.h"
+#include "UniverseRouter.h"
+#include "PatchPlan.h"
+#include "SyncController.h"
+#include "MergeEngine.h"
+#include "SequenceTracker.h"
+#include "ArtDmxDispatch.h"
+#include "ArtnetRxQueue.h"
+#include "LwipUdpReceiver.h"
+#include "ArtPollReplyBuilder.h"
+#include "DmxInputSender.h"
+#include "sacn/E131Packet.h"
+#include "sacn/E131Arbiter.h"
 
 class ArtnetNode {
 public:
@@ -46,6 +36,7 @@ public:
         uint16_t pixelCount;
         uint8_t pixelType;
         bool mergeMode;  // HTP = true, LTP = false
+        bool dhcp;       // IP 由 DHCP 分配（ArtPollReply Status2 的 DHCP 位），false 为静态 IP
     };
 
     // 节点状态结构体
@@ -72,19 +63,78 @@ public:
     bool begin();
     void update();
 
-    // 配置方法
+    // 网络任务在两次 update() 之间调用：事件模式下等待任务通知，轮询模式下延时 1 个节拍
+    void waitForPacket(uint32_t timeoutMs);
+
+    // 配置方法：可在任意任务调用，新配置由网络任务在下一次 update() 中生效
     void setConfig(const Config& config);
     const Config& getConfig() const { return config; }
     const Status& getStatus() const { return status; }
 
+    // 输出绑定
+    void attachDmxOutput(uint8_t port, ESP32DMX* output);
+    ESP32DMX* getDmxOutput(uint8_t port) const { return port < DMX_PORT_COUNT ? dmxPorts[port] : nullptr; }
+    void attachPixelDriver(PixelDriver* driver);
+
+    // DMX 输入：该端口不再输出，收到的帧以 ArtDmx 发到该端口原来的宇宙
+    void attachDmxInput(uint8_t port, ESP32DMX* input);
+    ESP32DMX* getDmxInput(uint8_t port) const { return port < DMX_PORT_COUNT ? dmxInputs[port] : nullptr; }
+    const DmxInputSender& getInputSender(uint8_t port) const { return inputSenders[port < DMX_PORT_COUNT ? port : 0]; }
+
+    // 宇宙路由：setConfig 时按配置重建，也可手动添加（整个宇宙从输出的起点写入）。
+    // 可在任意任务调用：新表建在暂存副本中，由网络任务的 update() 换入
+    bool addRoute(uint16_t portAddress, OutputType type, uint8_t index);
+    void rebuildRoutes();
+    const UniverseRouter& getRouter() const { return router; }
+
+    // 通道配接：未设置时按配置生成默认配接（每个宇宙从 dmxStartAddress 起写入对应输出），
+    // 设置后按表中出现的宇宙建立路由。count 为 0 恢复默认配接
+    static const uint8_t MAX_PATCH_ENTRIES = 32;
+    bool setPatch(const PatchEntry* entries, uint8_t count);
+    bool hasCustomPatch() const { return customPatch; }
+    const PatchEntry* getPatchEntries() const { return patchEntries; }
+    uint8_t getPatchCount() const { return patchCount; }
+    const PatchPlan& getPatchPlan() const { return patchPlan; }
+
+    // ArtSync 同步状态
+    bool isSyncMode() const { return sync.isSyncMode(); }
+    const SyncController& getSyncController() const { return sync; }
+
+    // 双源合并状态
+    const MergeEngine& getMergeEngine() const { return merger; }
+
+    const PixelDriver* getPixelDriver() const { return pixels; }
+
+    // 序号检查与丢包统计（按路由 slot）
+    const SequenceStats& getUniverseStats(uint8_t slot) const { return sequences.getStats(slot); }
+    void resetUniverseStats() {
+        sequences.resetStats();
+        sacnArbiter.resetStats();
+        if (pixels) pixels->resetShowStats();
+    }
+
+    // 接收统计：回调收到 / 过滤 / 队列溢出，以及到达到输出提交的延迟
+    struct RxLatency {
+        uint32_t frames;
+        uint32_t lastUs;
+        uint32_t maxUs;
+        uint64_t totalUs;
+    };
+    bool isEventRx() const { return eventRx; }
+    // sACN 源选择状态（按路由 slot）
+    bool isSacnEnabled() const { return sacnRunning; }
+    const E131Arbiter& getSacnArbiter() const { return sacnArbiter; }
+
+    const ArtnetRxStats& getRxStats() const { return eventRx ? rxQueue.getStats() : pollStats; }
+    const RxLatency& getRxLatency() const { return rxLatency; }
+
     // DMX输出控制
     void setDMXOutput(uint8_t* data, uint16_t length);
     void setPixelOutput(uint8_t* data, uint16_t length);
 
     // 回调函数设置
-    void setDMXCallback(void (*callback)(uint16_t universe, uint8_t* data, uint16_t length));
+    void setDMXCallback(void (*callback)(uint16_t universe, const uint8_t* data, uint16_t length));
     void setRDMCallback(void (*callback)(uint8_t* data, uint16_t length));
-    void setPixelCallback(void (*callback)(uint8_t* data, uint16_t length));
 
 protected:
     bool validatePacket(uint8_t* data, uint16_t length);
@@ -94,35 +144,104 @@ private:
     Config config;
     Status status;
     WiFiUDP udp;
-    ESP32DMX* dmx;
+    ESP32DMX* dmxPorts[DMX_PORT_COUNT];
+    ESP32DMX* dmxInputs[DMX_PORT_COUNT];
+    DmxInputSender inputSenders[DMX_PORT_COUNT];
     PixelDriver* pixels;
-    bool syncMode;
-    bool syncReceived;
-
-    // 数据缓冲区
+    UniverseRouter router;
+    SyncController sync;
+    MergeEngine merger;
+    SequenceTracker sequences;
+    PatchEntry patchEntries[MAX_PATCH_ENTRIES];
+    uint8_t patchCount;
+    bool customPatch;
+    PatchPlan patchPlan;
+
+    // 路由表和拷贝计划的暂存副本：配置 / 配接改变时在持有 routeLock 的任务中重建，
+    // 网络任务在 update() 中整表换入，处理数据包时看到的总是完整的一张表
+    struct RouteTable {
+        UniverseRouter router;
+        PatchPlan plan;
+        uint16_t inputAddress[DMX_PORT_COUNT];   // DMX 输入端口发送用的宇宙
+    };
+    RouteTable staged;
+    SemaphoreHandle_t routeLock;
+    volatile bool routesPending;
+    Config pendingConfig;                    // setConfig() 交给网络任务的配置，同样由 routeLock 保护
+    volatile bool configPending;
+    uint32_t packetSourceIp;   // 当前处理的数据包的源 IP
+    uint16_t packetSourcePort;
+
+    // 事件驱动接收：lwIP 回调过滤后入队，网络任务被通知后批量处理
+    bool eventRx;
+    ArtnetRxQueue rxQueue;
+    LwipUdpReceiver lwipRx;
+
+    // sACN：独立的 pcb 收包进入同一个队列，源选择后走与 ArtDmx 相同的输出路径
+    static const uint8_t MAX_SACN_GROUPS = UniverseRouter::MAX_ROUTES + 1;  // 订阅宇宙 + 同步宇宙
+    LwipUdpReceiver sacnRx;
+    E131Arbiter sacnArbiter;
+    SyncController sacnSync;
+    bool sacnRunning;
+    bool sacnGroupsDirty;
+    uint16_t sacnSyncUniverse;               // 数据包指定的同步宇宙，0 表示无
+    uint32_t sacnSyncSeenMs;                 // 最近一个指定该同步宇宙的数据包
+    uint16_t sacnGroups[MAX_SACN_GROUPS];    // 已加入组播的宇宙
+    uint8_t sacnGroupCount;
+
+    // ArtPollReply 模板，配置 / 路由 / IP 变化时标记重建
+    ArtPollReplyBuilder pollReplies;
+    RxLatency rxLatency;
+    ArtnetRxStats pollStats;
+
+    // 接收缓冲区：ArtDmx 通道数据直接从这里写入各输出的帧缓冲
     uint8_t artnetBuffer[1024];
-    uint8_t dmxBuffer[DMX_UNIVERSE_SIZE];
-    uint8_t pixelBuffer[MAX_PIXELS * 3];
+
+    // 配接计划的写入目标：像素直接写入 PixelDriver 的 DMX 输入缓冲，不经中间暂存
+    struct PatchSink;
+    // ArtDmx 分发的输出：合并后按配接计划写入
+    struct ArtDmxSink;
 
     // 回调函数指针
-    void (*dmxCallback)(uint16_t universe, uint8_t* data, uint16_t length);
+    void (*dmxCallback)(uint16_t universe, const uint8_t* data, uint16_t length);
     void (*rdmCallback)(uint8_t* data, uint16_t length);
-    void (*pixelCallback)(uint8_t* data, uint16_t length);
 
     // Art-Net包处理方法
+    void processPacket(uint8_t* data, uint16_t length);
+    void sendPacket(uint32_t ip, uint16_t port, const uint8_t* data, uint16_t length);
     void handleArtDmx(uint8_t* data, uint16_t length);
-    void handleArtPoll();
+    void handleArtPoll(uint8_t* data, uint16_t length);
     void handleArtAddress(uint8_t* data, uint16_t length);
     void handleArtRdm(uint8_t* data, uint16_t length);
     void handleArtSync();
+    void handleE131(uint8_t* data, uint16_t length);
+    void handleE131Data(uint8_t* data, uint16_t length);
+    void updateSacnGroups();
+    bool outputUniverse(const UniverseRoute& route, uint16_t portAddress, uint32_t sourceKey,
+                        const uint8_t* data, uint16_t length);
+    void commitOutputs(uint32_t outputMask);
+    uint32_t outputMaskOf(const UniverseRoute& route) const;
+    void buildRoutes();
+    void compilePatch();
+    void applyRoutes();
+    void applyPendingConfig();
+    uint16_t pixelTotal() const;
+    int16_t portToSlot(uint8_t bindIndex, uint8_t port);
+    void routeUniverse(const UniverseRoute& route, const uint8_t* data, uint16_t length);
+    void sendInputs();
+    bool inputPending() const;
+    uint32_t inputDestination();
 
     // 辅助方法
-    void sendArtPollReply();
+    void sendArtPollReply(bool targeted, uint16_t targetBottom, uint16_t targetTop);
+    void refreshPollReplies();
     void updateStatus();
     void initializeDefaults();
-    void updateDmxOutput();
     bool isValidArtNet(uint8_t* data, uint16_t size);
 
     // Art-Net ID
     static const uint8_t ARTNET_ID[8];
+
+    // 同步提交掩码：bit0..n 为 DMX 端口，最高位为像素输出
+    static const uint32_t OUTPUT_MASK_PIXELS = 0x80000000;
 };
\ No newline at end of file
@@ -0,0 +1,111 @@
+#pragma once
+
+// Art-Net 报文解析（纯 C++，不依赖 Arduino，可在主机上测试）
+
+#include <stdint.h>
+#include <string.h>
+
+// Art-Net 包大小常量定义
+#define ART_NET_MIN_SIZE 12
+#define ART_RDM_MIN_SIZE 14
+#define ART_ADDRESS_MIN_SIZE 107
+#define ART_DMX_HEADER_SIZE 18
+
+// Art-Net 协议常量
+#define ARTNET_PORT 6454
+#define ARTNET_DMX_LENGTH 512
+#define ARTNET_VERSION 14
+
+// Art-Net包类型
+enum ArtNetOpCodes {
+    OpPoll = 0x2000,
+    OpPollReply = 0x2100,
+    OpDmx = 0x5000,
+    OpNzs = 0x5100,
+    OpSync = 0x5200,
+    OpAddress = 0x6000,
+    OpInput = 0x7000,
+    OpRdm = 0x8400,
+    OpIpProg = 0xF800,
+    OpIpProgReply = 0xF900
+};
+
+// ArtAddress 命令（Command 字段）
+enum ArtAddressCommands {
+    AcNone = 0x00,
+    AcCancelMerge = 0x01,
+    AcMergeLtp0 = 0x10,   // 0x10 - 0x13：端口 0 - 3 设为 LTP
+    AcMergeHtp0 = 0x50,   // 0x50 - 0x53：端口 0 - 3 设为 HTP
+};
+
+// ArtDmx 包解析结果
+struct ArtDmxPacket {
+    uint8_t sequence;
+    uint8_t physical;
+    uint16_t portAddress;   // Net(7位) : SubNet(4位) : Universe(4位)
+    uint16_t length;
+    const uint8_t* data;    // 指向接收缓冲区内的通道数据
+};
+
+namespace ArtnetPacket {
+
+static const uint8_t ID[8] = {'A', 'r', 't', '-', 'N', 'e', 't', 0};
+
+// 由 Net/SubNet/Universe 组合 15 位 Port-Address
+inline uint16_t makePortAddress(uint8_t net, uint8_t subnet, uint8_t universe) {
+    return ((uint16_t)(net & 0x7F) << 8) | ((subnet & 0x0F) << 4) | (universe & 0x0F);
+}
+
+inline bool hasValidId(const uint8_t* data, uint16_t length) {
+    return data && length >= 10 && memcmp(data, ID, 8) == 0;
+}
+
+inline uint16_t getOpCode(const uint8_t* data) {
+    return data[8] | (data[9] << 8);
+}
+
+// 解析 ArtDmx 包：SubUni 在 data[14]，Net 在 data[15]
+inline bool parseArtDmx(const uint8_t* data, uint16_t size, ArtDmxPacket& packet) {
+    if (!data || size < ART_DMX_HEADER_SIZE) return false;
+
+    packet.sequence = data[12];
+    packet.physical = data[13];
+    packet.portAddress = ((data[15] & 0x7F) << 8) | data[14];
+    packet.length = (data[16] << 8) | data[17];
+
+    // 限制DMX数据长度
+    if (packet.length > ARTNET_DMX_LENGTH) {
+        packet.length = ARTNET_DMX_LENGTH;
+    }
+    if (packet.length > size - ART_DMX_HEADER_SIZE) {
+        packet.length = size - ART_DMX_HEADER_SIZE;
+    }
+
+    packet.data = data + ART_DMX_HEADER_SIZE;
+    return true;
+}
+
+// 构造 ArtDmx 包，返回包长。Art-Net 要求通道数为 2..512 的偶数，不足时补 0
+inline uint16_t buildArtDmx(uint8_t* buffer, uint8_t sequence, uint8_t physical,
+                            uint16_t portAddress, const uint8_t* data, uint16_t length) {
+    if (length > ARTNET_DMX_LENGTH) length = ARTNET_DMX_LENGTH;
+    uint16_t padded = (length + 1) & ~1;
+    if (padded < 2) padded = 2;
+
+    memcpy(buffer, ID, 8);
+    buffer[8] = OpDmx & 0xFF;
+    buffer[9] = OpDmx >> 8;
+    buffer[10] = 0;
+    buffer[11] = ARTNET_VERSION;
+    buffer[12] = sequence;
+    buffer[13] = physical;
+    buffer[14] = portAddress & 0xFF;
+    buffer[15] = (portAddress >> 8) & 0x7F;
+    buffer[16] = padded >> 8;
+    buffer[17] = padded & 0xFF;
+    memcpy(buffer + ART_DMX_HEADER_SIZE, data, length);
+    memset(buffer + ART_DMX_HEADER_SIZE + length, 0, padded - length);
+    return ART_DMX_HEADER_SIZE + padded;
+}
+
+} // namespace ArtnetPacket
@@ -0,0 +1,50 @@
+#pragma once
+
+// Art-Net 包头预过滤（纯 C++，主机和 ESP32 通用）
+//
+// 只看前 18 个字节：ID、OpCode、Port-Address。
+// ArtDmx 只保留订阅位图中的宇宙，ArtPoll / ArtSync / ArtAddress / ArtRdm 全部保留，
+// 其他包直接丢弃。事件模式下直接看 pbuf，被丢弃的包不会拷出；轮询模式下 WiFiUDP 已拷贝整个数据报，
+// 只是不再读入接收缓冲。
+
+#include <stdint.h>
+#include "ArtnetPacket.h"
+#include "UniverseRouter.h"
+
+// header 至少包含 min(length, 18) 个字节；length 为数据报总长度
+inline bool artnetRxWanted(const uint8_t* header, uint16_t length, const UniverseRouter& router) {
+    if (!ArtnetPacket::hasValidId(header, length)) return false;
+
+    switch (ArtnetPacket::getOpCode(header)) {
+        case OpDmx:
+            if (length < ART_DMX_HEADER_SIZE) return false;
+            return router.isSubscribed(((header[15] & 0x7F) << 8) | header[14]);
+        case OpPoll:
+        case OpSync:
+        case OpAddress:
+        case OpRdm:
+            return true;
+        default:
+            return false;
+    }
+}
+
+// 接收队列中的包来自哪个协议
+enum RxProtocol : uint8_t {
+    RX_PROTOCOL_ARTNET = 0,
+    RX_PROTOCOL_E131 = 1
+};
+
+// 接收队列用的过滤器：PEEK_LENGTH 为判断所需的包头长度
+struct ArtnetRxFilter {
+    static const uint16_t PEEK_LENGTH = ART_DMX_HEADER_SIZE;
+    static const RxProtocol PROTOCOL = RX_PROTOCOL_ARTNET;
+
+    const UniverseRouter& router;
+
+    explicit ArtnetRxFilter(const UniverseRouter& routes) : router(routes) {}
+
+    bool operator()(const uint8_t* header, uint16_t length) const {
+        return artnetRxWanted(header, length, router);
+    }
+};
@@ -0,0 +1,125 @@
+#pragma once
+
+// Art-Net 接收队列（纯 C++，主机和 ESP32 通用）
+//
+// lwIP 的 udp_recv 回调（tcpip 线程）是唯一的生产者，网络任务是唯一的消费者。
+// Art-Net 和 sACN 两个 pcb 的回调都在 tcpip 线程中执行，共用一个队列仍是单生产者。
+// 回调里先从 pbuf 中只拷出包头，由协议对应的过滤器判断是否需要；
+// 不需要的包不占队列、不唤醒网络任务。
+// 需要的包整包拷入固定槽位，消费者处理完后 pop() 归还。
+
+#include <stdint.h>
+#include <string.h>
+#include <atomic>
+#include "ArtnetPacket.h"
+#include "UniverseRouter.h"
+#include "ArtnetRxFilter.h"
+
+// 一个槽位可容纳最大的 E1.31 数据包（126 字节包头 + 512 通道）；ArtDmx 最长 530 字节
+#define ARTNET_RX_PACKET_SIZE 638
+
+struct ArtnetRxPacket {
+    uint32_t sourceIp;
+    uint16_t sourcePort;
+    uint16_t length;
+    RxProtocol protocol;
+    uint32_t arrivalUs;     // 回调收到时的时间戳，用于统计延迟
+    uint8_t data[ARTNET_RX_PACKET_SIZE];
+};
+
+struct ArtnetRxStats {
+    uint32_t received;      // 回调收到的数据报
+    uint32_t filtered;      // 包头判断后丢弃
+    uint32_t overflow;      // 队列满丢弃
+    uint32_t queued;        // 进入队列
+};
+
+class ArtnetRxQueue {
+public:
+    static const uint32_t CAPACITY = 8;   // 2 的幂；一次突发 8 个宇宙不丢包
+
+    ArtnetRxQueue() : head(0), tail(0) {
+        resetStats();
+    }
+
+    // ---- 生产者（lwIP 回调） ----
+
+    // copy(dst, len, offset) 从数据报的 offset 处拷出 len 字节，返回实际拷贝数。
+    // 返回 true 表示包已入队，需要唤醒消费者。
+    template <typename Filter, typename CopyFn>
+    bool offer(uint16_t length, uint32_t sourceIp, uint16_t sourcePort, uint32_t nowUs,
+               const Filter& filter, CopyFn copy) {
+        stats.received++;
+
+        uint8_t header[Filter::PEEK_LENGTH];
+        uint16_t headerLength = length < Filter::PEEK_LENGTH ? length : Filter::PEEK_LENGTH;
+        if (copy(header, headerLength, 0) != headerLength || !filter(header, length)) {
+            stats.filtered++;
+            return false;
+        }
+
+        uint32_t h = head.load(std::memory_order_relaxed);
+        if (h - tail.load(std::memory_order_acquire) >= CAPACITY) {
+            stats.overflow++;
+            return false;
+        }
+
+        ArtnetRxPacket& slot = slots[h & (CAPACITY - 1)];
+        if (length > ARTNET_RX_PACKET_SIZE) length = ARTNET_RX_PACKET_SIZE;
+        memcpy(slot.data, header, headerLength);
+        if (length > headerLength) {
+            copy(slot.data + headerLength, length - headerLength, headerLength);
+        }
+        slot.length = length;
+        slot.sourceIp = sourceIp;
+        slot.sourcePort = sourcePort;
+        slot.protocol = Filter::PROTOCOL;
+        slot.arrivalUs = nowUs;
+
+        head.store(h + 1, std::memory_order_release);
+        stats.queued++;
+        return true;
+    }
+
+    // 直接从 lwIP pbuf 链入队；pbuf_copy_partial 由 lwIP 或主机模拟层提供
+    template <typename Pbuf, typename Filter>
+    bool offerPbuf(const Pbuf* p, uint32_t sourceIp, uint16_t sourcePort, uint32_t nowUs,
+                   const Filter& filter) {
+        return offer(p->tot_len, sourceIp, sourcePort, nowUs, filter,
+                     [p](uint8_t* dst, uint16_t len, uint16_t offset) -> uint16_t {
+                         return pbuf_copy_partial(p, dst, len, offset);
+                     });
+    }
+
+    // Art-Net 包
+    template <typename Pbuf>
+    bool offerPbuf(const Pbuf* p, uint32_t sourceIp, uint16_t sourcePort, uint32_t nowUs,
+                   const UniverseRouter& router) {
+        return offerPbuf(p, sourceIp, sourcePort, nowUs, ArtnetRxFilter(router));
+    }
+
+    // ---- 消费者（网络任务） ----
+    ArtnetRxPacket* front() {
+        uint32_t t = tail.load(std::memory_order_relaxed);
+        if (t == head.load(std::memory_order_acquire)) return nullptr;
+        return &slots[t & (CAPACITY - 1)];
+    }
+
+    void pop() {
+        tail.store(tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    }
+
+    bool empty() const {
+        return tail.load(std::memory_order_relaxed) == head.load(std::memory_order_acquire);
+    }
+
+    // 统计由生产者写，读者只做展示，允许读到稍旧的值
+    const ArtnetRxStats& getStats() const { return stats; }
+    void resetStats() { memset(&stats, 0, sizeof(stats)); }
+
+private:
+    ArtnetRxPacket slots[CAPACITY];
+    std::atomic<uint32_t> head;   // 生产者写
+    std::atomic<uint32_t> tail;   // 消费者写
+    ArtnetRxStats stats;
+};
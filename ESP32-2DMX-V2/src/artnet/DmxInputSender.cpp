@@ -0,0 +1,70 @@
+#include "DmxInputSender.h"
+#include <string.h>
+
+DmxInputSender::DmxInputSender()
+    : portAddress(0)
+    , physical(0)
+    , keepaliveMs(DEFAULT_KEEPALIVE_MS)
+    , minIntervalMs(DEFAULT_MIN_INTERVAL_MS) {
+    reset();
+}
+
+void DmxInputSender::reset() {
+    sequence = 0;
+    hasSent = false;
+    pending = false;
+    lastSentMs = 0;
+    lastFrameMs = 0;
+    latestLength = 0;
+    sentLength = 0;
+    memset(latest, 0, sizeof(latest));
+    memset(sent, 0, sizeof(sent));
+    memset(&stats, 0, sizeof(stats));
+}
+
+uint16_t DmxInputSender::onFrame(const uint8_t* slots, uint16_t length, uint32_t nowMs) {
+    if (length > ARTNET_DMX_LENGTH) length = ARTNET_DMX_LENGTH;
+    stats.frames++;
+    lastFrameMs = nowMs;
+
+    // 与最近一帧比较；未发出的变化被新的内容覆盖
+    bool changed = length != latestLength || memcmp(slots, latest, length) != 0;
+    if (changed) {
+        memcpy(latest, slots, length);
+        latestLength = length;
+        pending = !hasSent || length != sentLength || memcmp(latest, sent, length) != 0;
+    }
+
+    if (pending) {
+        if (hasSent && nowMs - lastSentMs < minIntervalMs) {
+            if (changed) stats.deferred++;
+            return 0;
+        }
+        stats.changes++;
+        return send(nowMs);
+    }
+
+    if (hasSent && nowMs - lastSentMs >= keepaliveMs) {
+        stats.keepalives++;
+        return send(nowMs);
+    }
+    return 0;
+}
+
+uint16_t DmxInputSender::poll(uint32_t nowMs) {
+    if (!pending || nowMs - lastSentMs < minIntervalMs) return 0;
+    stats.changes++;
+    return send(nowMs);
+}
+
+uint16_t DmxInputSender::send(uint32_t nowMs) {
+    // 序号在 1..255 之间循环，0 表示不使用序号
+    sequence = sequence == 255 ? 1 : sequence + 1;
+    memcpy(sent, latest, latestLength);
+    sentLength = latestLength;
+    hasSent = true;
+    pending = false;
+    lastSentMs = nowMs;
+    stats.sent++;
+    return ArtnetPacket::buildArtDmx(packetBuffer, sequence, physical, portAddress, latest, latestLength);
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+// DMX 输入 -> ArtDmx 发送决策（纯 C++，不依赖 Arduino，可在主机上测试）
+//
+// 每收到一帧 DMX 输入调用 onFrame()：
+//   内容与上次发出的不同        发送（距上次发送不足 minInterval 时推迟，由 poll() 补发最新的一帧）
+//   内容相同                    只在 keepalive 到期时重发，接收端不会超时
+// 没有变化的帧只做一次比较，不拷贝、不组包，不会让 Wi-Fi 被重复的帧占满。
+
+#include <stdint.h>
+#include "ArtnetPacket.h"
+
+struct DmxInputSenderStats {
+    uint32_t frames;        // 收到的输入帧
+    uint32_t sent;          // 发出的 ArtDmx
+    uint32_t changes;       // 因内容变化发出
+    uint32_t keepalives;    // 因 keepalive 发出
+    uint32_t deferred;      // 变化被推迟到最小间隔之后
+};
+
+class DmxInputSender {
+public:
+    static const uint32_t DEFAULT_KEEPALIVE_MS = 1000;
+    static const uint32_t DEFAULT_MIN_INTERVAL_MS = 23;    // 约 44 Hz
+    static const uint16_t MAX_PACKET_SIZE = ART_DMX_HEADER_SIZE + ARTNET_DMX_LENGTH;
+    static const uint32_t RECEIVE_TIMEOUT_MS = 2000;        // 超过这么久没有输入帧视为无信号
+
+    DmxInputSender();
+
+    void setPortAddress(uint16_t address) { portAddress = address; }
+    uint16_t getPortAddress() const { return portAddress; }
+    void setPhysical(uint8_t port) { physical = port; }
+    void setKeepalive(uint32_t ms) { keepaliveMs = ms; }
+    void setMinInterval(uint32_t ms) { minIntervalMs = ms; }
+
+    // 新的输入帧（不含起始码）。需要发送时返回包长，包内容在 packet() 中；否则返回 0
+    uint16_t onFrame(const uint8_t* slots, uint16_t length, uint32_t nowMs);
+
+    // 没有新帧时调用：被推迟的变化到时间后发出
+    uint16_t poll(uint32_t nowMs);
+
+    bool hasPending() const { return pending; }
+    // 最近 RECEIVE_TIMEOUT_MS 内收到过输入帧（ArtPollReply 的 GoodInput）
+    bool isReceiving(uint32_t nowMs) const { return stats.frames > 0 && nowMs - lastFrameMs < RECEIVE_TIMEOUT_MS; }
+    const uint8_t* packet() const { return packetBuffer; }
+    const DmxInputSenderStats& getStats() const { return stats; }
+    void reset();
+
+private:
+    uint16_t portAddress;
+    uint8_t physical;
+    uint32_t keepaliveMs;
+    uint32_t minIntervalMs;
+
+    uint8_t sequence;
+    bool hasSent;
+    bool pending;               // latest 中有尚未发出的变化
+    uint32_t lastSentMs;
+    uint32_t lastFrameMs;
+    uint16_t latestLength;
+    uint16_t sentLength;
+    uint8_t latest[ARTNET_DMX_LENGTH];
+    uint8_t sent[ARTNET_DMX_LENGTH];
+    uint8_t packetBuffer[MAX_PACKET_SIZE];
+    DmxInputSenderStats stats;
+
+    uint16_t send(uint32_t nowMs);
+};
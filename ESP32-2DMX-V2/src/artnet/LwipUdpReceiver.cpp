@@ -0,0 +1,167 @@
+#include "LwipUdpReceiver.h"
+#include <esp_timer.h>
+#include "sacn/E131RxFilter.h"
+
+extern "C" {
+#include "lwip/udp.h"
+#include "lwip/pbuf.h"
+#include "lwip/ip_addr.h"
+#include "lwip/igmp.h"
+}
+#include "lwip/priv/tcpip_priv.h"
+
+// tcpip_api_call 的参数，与 AsyncUDP 的做法相同
+struct UdpApiCall {
+    struct tcpip_api_call_data call;
+    LwipUdpReceiver* receiver;
+    struct udp_pcb* pcb;
+    const ip_addr_t* addr;
+    uint16_t port;
+    struct pbuf* pb;
+    udp_recv_fn recv;
+    err_t err;
+};
+
+LwipUdpReceiver::LwipUdpReceiver(RxProtocol rxProtocol)
+    : protocol(rxProtocol)
+    , pcb(nullptr)
+    , queue(nullptr)
+    , router(nullptr)
+    , notifyTask(nullptr) {
+}
+
+LwipUdpReceiver::~LwipUdpReceiver() {
+    stop();
+}
+
+static err_t bindApi(struct tcpip_api_call_data* data) {
+    UdpApiCall* msg = (UdpApiCall*)data;
+    msg->pcb = udp_new();
+    if (!msg->pcb) {
+        msg->err = ERR_MEM;
+        return msg->err;
+    }
+    msg->err = udp_bind(msg->pcb, IP_ADDR_ANY, msg->port);
+    if (msg->err != ERR_OK) {
+        udp_remove(msg->pcb);
+        msg->pcb = nullptr;
+        return msg->err;
+    }
+    ip_set_option(msg->pcb, SOF_BROADCAST);
+    udp_recv(msg->pcb, msg->recv, msg->receiver);
+    return ERR_OK;
+}
+
+static err_t removeApi(struct tcpip_api_call_data* data) {
+    UdpApiCall* msg = (UdpApiCall*)data;
+    udp_remove(msg->pcb);
+    msg->err = ERR_OK;
+    return ERR_OK;
+}
+
+static err_t joinApi(struct tcpip_api_call_data* data) {
+    UdpApiCall* msg = (UdpApiCall*)data;
+    msg->err = igmp_joingroup(IP4_ADDR_ANY4, ip_2_ip4(msg->addr));
+    return msg->err;
+}
+
+static err_t leaveApi(struct tcpip_api_call_data* data) {
+    UdpApiCall* msg = (UdpApiCall*)data;
+    msg->err = igmp_leavegroup(IP4_ADDR_ANY4, ip_2_ip4(msg->addr));
+    return msg->err;
+}
+
+static err_t sendApi(struct tcpip_api_call_data* data) {
+    UdpApiCall* msg = (UdpApiCall*)data;
+    msg->err = udp_sendto(msg->pcb, msg->pb, msg->addr, msg->port);
+    return msg->err;
+}
+
+bool LwipUdpReceiver::begin(uint16_t port, ArtnetRxQueue* rxQueue, const UniverseRouter* routes) {
+    stop();
+    queue = rxQueue;
+    router = routes;
+
+    UdpApiCall msg;
+    msg.receiver = this;
+    msg.port = port;
+    msg.recv = &LwipUdpReceiver::onReceive;
+    tcpip_api_call(bindApi, &msg.call);
+    if (msg.err != ERR_OK) {
+        return false;
+    }
+    pcb = msg.pcb;
+    return true;
+}
+
+void LwipUdpReceiver::stop() {
+    if (!pcb) return;
+    UdpApiCall msg;
+    msg.pcb = pcb;
+    tcpip_api_call(removeApi, &msg.call);
+    pcb = nullptr;
+}
+
+bool LwipUdpReceiver::joinGroup(uint32_t group) {
+    ip_addr_t addr;
+    IP_ADDR4(&addr, group & 0xFF, (group >> 8) & 0xFF, (group >> 16) & 0xFF, (group >> 24) & 0xFF);
+
+    UdpApiCall msg;
+    msg.addr = &addr;
+    tcpip_api_call(joinApi, &msg.call);
+    return msg.err == ERR_OK;
+}
+
+bool LwipUdpReceiver::leaveGroup(uint32_t group) {
+    ip_addr_t addr;
+    IP_ADDR4(&addr, group & 0xFF, (group >> 8) & 0xFF, (group >> 16) & 0xFF, (group >> 24) & 0xFF);
+
+    UdpApiCall msg;
+    msg.addr = &addr;
+    tcpip_api_call(leaveApi, &msg.call);
+    return msg.err == ERR_OK;
+}
+
+bool LwipUdpReceiver::sendTo(uint32_t ip, uint16_t port, const uint8_t* data, uint16_t length) {
+    if (!pcb) return false;
+
+    struct pbuf* pb = pbuf_alloc(PBUF_TRANSPORT, length, PBUF_RAM);
+    if (!pb) return false;
+    memcpy(pb->payload, data, length);
+
+    ip_addr_t addr;
+    IP_ADDR4(&addr, ip & 0xFF, (ip >> 8) & 0xFF, (ip >> 16) & 0xFF, (ip >> 24) & 0xFF);
+
+    UdpApiCall msg;
+    msg.pcb = pcb;
+    msg.addr = &addr;
+    msg.port = port;
+    msg.pb = pb;
+    tcpip_api_call(sendApi, &msg.call);
+    pbuf_free(pb);
+    return msg.err == ERR_OK;
+}
+
+// tcpip 线程：只拷贝需要的包，拷完立即释放 pbuf
+void LwipUdpReceiver::onReceive(void* arg, struct udp_pcb* pcb, struct pbuf* p,
+                                const ip_addr_t* addr, uint16_t port) {
+    LwipUdpReceiver* self = (LwipUdpReceiver*)arg;
+    if (!p) return;
+
+    uint32_t sourceIp = ip_addr_get_ip4_u32(addr);
+    uint32_t nowUs = (uint32_t)esp_timer_get_time();
+    bool queued = false;
+    if (self->queue && self->router) {
+        if (self->protocol == RX_PROTOCOL_E131) {
+            queued = self->queue->offerPbuf(p, sourceIp, port, nowUs, E131RxFilter(*self->router));
+        } else {
+            queued = self->queue->offerPbuf(p, sourceIp, port, nowUs, ArtnetRxFilter(*self->router));
+        }
+    }
+    pbuf_free(p);
+
+    TaskHandle_t task = self->notifyTask;
+    if (queued && task) {
+        xTaskNotifyGive(task);
+    }
+}
@@ -0,0 +1,44 @@
+#pragma once
+
+// 基于 lwIP 原始 API 的 Art-Net UDP 收发
+//
+// udp_recv 回调运行在 tcpip 线程中：直接从 pbuf 读包头过滤，需要的包拷入
+// ArtnetRxQueue 后用任务通知唤醒网络任务，不经过 socket 层，也不需要轮询。
+// 所有 pcb 操作都通过 tcpip_api_call 在 tcpip 线程中执行。
+// Art-Net（6454）和 sACN（5568）各用一个实例，按协议选择包头过滤器。
+
+#include <Arduino.h>
+#include "ArtnetRxQueue.h"
+#include "UniverseRouter.h"
+#include "ArtnetRxFilter.h"
+
+struct udp_pcb;
+
+class LwipUdpReceiver {
+public:
+    explicit LwipUdpReceiver(RxProtocol protocol = RX_PROTOCOL_ARTNET);
+    ~LwipUdpReceiver();
+
+    bool begin(uint16_t port, ArtnetRxQueue* queue, const UniverseRouter* router);
+    void stop();
+
+    // 收到数据后通知的任务；为空时只入队不通知
+    void setNotifyTask(TaskHandle_t task) { notifyTask = task; }
+
+    // IGMP 组播成员；group 为网络字节序
+    bool joinGroup(uint32_t group);
+    bool leaveGroup(uint32_t group);
+
+    // 从绑定的端口发送；ip 为网络字节序
+    bool sendTo(uint32_t ip, uint16_t port, const uint8_t* data, uint16_t length);
+
+private:
+    RxProtocol protocol;
+    struct udp_pcb* pcb;
+    ArtnetRxQueue* queue;
+    const UniverseRouter* router;
+    volatile TaskHandle_t notifyTask;
+
+    static void onReceive(void* arg, struct udp_pcb* pcb, struct pbuf* p,
+                          const struct ip_addr* addr, uint16_t port);
+};
@@ -0,0 +1,251 @@
+#include "MergeEngine.h"
+#include <string.h>
+
+// 每个字节的最高位
+static const uint32_t HIGH_BITS = 0x80808080UL;
+static const uint32_t LOW_BITS = 0x7F7F7F7FUL;
+
+MergeEngine::MergeEngine() : defaultMode(MERGE_HTP) {
+    reset();
+}
+
+void MergeEngine::reset() {
+    memset(universes, 0, sizeof(universes));
+    memset(buffers, 0, sizeof(buffers));
+    for (uint8_t i = 0; i < MAX_SLOTS; i++) {
+        universes[i].mode = defaultMode;
+        universes[i].buffer = -1;
+    }
+}
+
+void MergeEngine::setDefaultMode(MergeMode mode) {
+    defaultMode = mode;
+    for (uint8_t i = 0; i < MAX_SLOTS; i++) {
+        universes[i].mode = mode;
+    }
+}
+
+void MergeEngine::setMode(uint8_t slot, MergeMode mode) {
+    if (slot < MAX_SLOTS) {
+        universes[slot].mode = mode;
+    }
+}
+
+MergeMode MergeEngine::getMode(uint8_t slot) const {
+    return slot < MAX_SLOTS ? universes[slot].mode : defaultMode;
+}
+
+void MergeEngine::cancelMerge() {
+    for (uint8_t i = 0; i < MAX_SLOTS; i++) {
+        if (activeSourceCount(universes[i]) > 1) {
+            universes[i].cancelPending = true;
+        }
+    }
+}
+
+const uint8_t* MergeEngine::process(uint8_t slot, uint32_t sourceIp, const uint8_t* data,
+                                    uint16_t& length, uint32_t nowMs) {
+    if (slot >= MAX_SLOTS) return data;
+    UniverseState& state = universes[slot];
+
+    // 取消合并：只保留这个源
+    if (state.cancelPending) {
+        memset(state.sources, 0, sizeof(state.sources));
+        state.cancelPending = false;
+    }
+
+    expireSources(state, nowMs);
+
+    int8_t source = findOrAddSource(state, sourceIp, nowMs);
+    if (source < 0) {
+        return nullptr;  // 已有两个活动源，忽略第三个
+    }
+
+    if (length > FRAME_SIZE) length = FRAME_SIZE;
+    uint8_t other = source ^ 1;
+
+    // 单源：直接输出，不占用合并缓冲；保留这一帧，第二个源加入时要和它合并
+    if (activeSourceCount(state) < 2) {
+        releaseBuffer(state);
+        memset(state.last, 0, sizeof(state.last));
+        memcpy(state.last, data, length);
+        state.lastLength = length;
+        state.lastIp = sourceIp;
+        return data;
+    }
+
+    if (state.buffer < 0) {
+        state.buffer = acquireBuffer();
+        if (state.buffer < 0) {
+            return data;  // 合并缓冲用尽，退化为 LTP（整帧跟随最新的包）
+        }
+        // 先到的源还没有新帧，用它单源时的最后一帧，否则第一次 HTP 输出会缺少它的通道
+        const Source& previous = state.sources[other];
+        if (state.lastLength > 0 && previous.ip == state.lastIp) {
+            MergeBuffer& fresh = buffers[state.buffer];
+            memcpy(fresh.source[other], state.last, sizeof(state.last));
+            memcpy(fresh.output, state.last, sizeof(state.last));
+            fresh.length[other] = state.lastLength;
+            fresh.valid[other] = true;
+        }
+    }
+
+    MergeBuffer& buffer = buffers[state.buffer];
+    uint32_t* frame = buffer.source[source];
+
+    if (state.mode == MERGE_LTP && buffer.valid[source]) {
+        // 新帧和该源上一帧对比，只有变化的通道覆盖输出
+        uint32_t next[FRAME_WORDS];
+        memset(next, 0, sizeof(next));
+        memcpy(next, data, length);
+        mergeLtp(buffer.output, frame, next, FRAME_WORDS);
+        memcpy(frame, next, sizeof(next));
+    } else {
+        memset(frame, 0, sizeof(buffer.source[source]));
+        memcpy(frame, data, length);
+        if (state.mode == MERGE_LTP || !buffer.valid[other]) {
+            // 合并刚开始，以当前帧作为输出起点
+            memcpy(buffer.output, frame, sizeof(buffer.output));
+        }
+    }
+    buffer.length[source] = length;
+    buffer.valid[source] = true;
+
+    // 另一个源还没有数据进入合并缓冲时直接输出当前源
+    if (!buffer.valid[other]) {
+        return data;
+    }
+
+    if (state.mode == MERGE_HTP) {
+        mergeHtp(buffer.output, buffer.source[0], buffer.source[1], FRAME_WORDS);
+    }
+
+    length = buffer.length[0] > buffer.length[1] ? buffer.length[0] : buffer.length[1];
+    return (const uint8_t*)buffer.output;
+}
+
+// HTP：每个 32 位字同时比较 4 个通道
+void MergeEngine::mergeHtp(uint32_t* out, const uint32_t* a, const uint32_t* b, uint16_t words) {
+    for (uint16_t i = 0; i < words; i++) {
+        uint32_t x = a[i];
+        uint32_t y = b[i];
+        // 低 7 位逐字节相减，最高位预置 1 防止借位跨字节
+        uint32_t diff = (x | HIGH_BITS) - (y & LOW_BITS);
+        // 最高位不同时由最高位决定，相同时由低 7 位的比较结果决定
+        uint32_t ge = ((x & ~y) | (~(x ^ y) & diff)) & HIGH_BITS;
+        uint32_t mask = (ge >> 7) * 0xFF;
+        out[i] = (x & mask) | (y & ~mask);
+    }
+}
+
+// LTP：next 与 previous 不同的通道写入输出
+void MergeEngine::mergeLtp(uint32_t* out, const uint32_t* previous, const uint32_t* next, uint16_t words) {
+    for (uint16_t i = 0; i < words; i++) {
+        uint32_t changed = previous[i] ^ next[i];
+        if (changed == 0) continue;
+        // 每个非零字节的最高位置 1
+        uint32_t nonzero = (((changed & LOW_BITS) + LOW_BITS) | changed) & HIGH_BITS;
+        uint32_t mask = (nonzero >> 7) * 0xFF;
+        out[i] = (out[i] & ~mask) | (next[i] & mask);
+    }
+}
+
+bool MergeEngine::isMerging(uint8_t slot) const {
+    return slot < MAX_SLOTS && activeSourceCount(universes[slot]) > 1;
+}
+
+uint8_t MergeEngine::getSourceCount(uint8_t slot) const {
+    return slot < MAX_SLOTS ? activeSourceCount(universes[slot]) : 0;
+}
+
+uint32_t MergeEngine::getSourceIp(uint8_t slot, uint8_t source) const {
+    if (slot >= MAX_SLOTS || source >= MAX_SOURCES) return 0;
+    const Source& s = universes[slot].sources[source];
+    return s.active ? s.ip : 0;
+}
+
+bool MergeEngine::hasRecentData(uint8_t slot, uint32_t nowMs) const {
+    if (slot >= MAX_SLOTS) return false;
+    for (uint8_t i = 0; i < MAX_SOURCES; i++) {
+        const Source& source = universes[slot].sources[i];
+        if (source.active && nowMs - source.lastMs < DATA_TIMEOUT_MS) return true;
+    }
+    return false;
+}
+
+void MergeEngine::removeSource(uint8_t slot, uint32_t sourceIp) {
+    if (slot >= MAX_SLOTS) return;
+    UniverseState& state = universes[slot];
+    for (uint8_t i = 0; i < MAX_SOURCES; i++) {
+        Source& source = state.sources[i];
+        if (source.active && source.ip == sourceIp) {
+            source.active = false;
+            if (state.buffer >= 0) {
+                buffers[state.buffer].valid[i] = false;
+            }
+        }
+    }
+}
+
+void MergeEngine::expireSources(UniverseState& state, uint32_t nowMs) {
+    for (uint8_t i = 0; i < MAX_SOURCES; i++) {
+        Source& source = state.sources[i];
+        if (source.active && nowMs - source.lastMs >= SOURCE_TIMEOUT_MS) {
+            source.active = false;
+            if (state.buffer >= 0) {
+                buffers[state.buffer].valid[i] = false;
+            }
+        }
+    }
+}
+
+int8_t MergeEngine::findOrAddSource(UniverseState& state, uint32_t sourceIp, uint32_t nowMs) {
+    int8_t freeSource = -1;
+    for (uint8_t i = 0; i < MAX_SOURCES; i++) {
+        Source& source = state.sources[i];
+        if (source.active && source.ip == sourceIp) {
+            source.lastMs = nowMs;
+            return i;
+        }
+        if (!source.active && freeSource < 0) {
+            freeSource = i;
+        }
+    }
+
+    if (freeSource >= 0) {
+        Source& source = state.sources[freeSource];
+        source.ip = sourceIp;
+        source.lastMs = nowMs;
+        source.active = true;
+        if (state.buffer >= 0) {
+            buffers[state.buffer].valid[freeSource] = false;
+        }
+    }
+    return freeSource;
+}
+
+uint8_t MergeEngine::activeSourceCount(const UniverseState& state) const {
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < MAX_SOURCES; i++) {
+        if (state.sources[i].active) count++;
+    }
+    return count;
+}
+
+int8_t MergeEngine::acquireBuffer() {
+    for (uint8_t i = 0; i < MAX_MERGE_BUFFERS; i++) {
+        if (!buffers[i].inUse) {
+            memset(&buffers[i], 0, sizeof(MergeBuffer));
+            buffers[i].inUse = true;
+            return i;
+        }
+    }
+    return -1;
+}
+
+void MergeEngine::releaseBuffer(UniverseState& state) {
+    if (state.buffer >= 0) {
+        buffers[state.buffer].inUse = false;
+        state.buffer = -1;
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+// 双源 HTP/LTP 合并（纯 C++，不依赖 Arduino，可在主机上测试）
+//
+// 每个订阅的宇宙最多跟踪两个源，超过 10 秒没有数据的源被移除。
+// 源的键：Art-Net 为源 IP；sACN 为 E131Arbiter::mergeKey()，即按 CID 区分，由选源结果随时移除。
+// 只有一个源时直接返回输入数据，同时把这一帧留在宇宙自己的 last 中（每宇宙 512 字节），
+// 第二个源加入时用它填充合并缓冲，第一次合并就包含两个源的数据；两个源时在合并缓冲中合并：
+//   HTP：逐通道取最大值，每次处理一个 32 位字（4 个通道）
+//   LTP：逐通道跟随最近一次发生变化的源
+
+#include <stdint.h>
+#include "UniverseRouter.h"
+
+enum MergeMode : uint8_t {
+    MERGE_HTP = 0,
+    MERGE_LTP = 1
+};
+
+class MergeEngine {
+public:
+    static const uint8_t MAX_SLOTS = UniverseRouter::MAX_ROUTES;   // 按路由序号索引
+    static const uint8_t MAX_SOURCES = 2;
+    static const uint8_t MAX_MERGE_BUFFERS = 4;   // 同时处于合并状态的宇宙上限
+    static const uint32_t SOURCE_TIMEOUT_MS = 10000;
+    static const uint32_t DATA_TIMEOUT_MS = 2500;     // 超过这么久没有数据视为不在输出（与 sACN 的源超时相同）
+    static const uint16_t FRAME_SIZE = 512;
+    static const uint16_t FRAME_WORDS = FRAME_SIZE / 4;
+
+    MergeEngine();
+
+    void reset();
+
+    // 合并模式
+    void setDefaultMode(MergeMode mode);
+    void setMode(uint8_t slot, MergeMode mode);
+    MergeMode getMode(uint8_t slot) const;
+
+    // AcCancelMerge：每个宇宙收到的下一个 ArtDmx 的源成为唯一的源
+    void cancelMerge();
+
+    // 源主动结束发送（sACN Stream_Terminated）：立即移除，不等超时
+    void removeSource(uint8_t slot, uint32_t sourceIp);
+
+    // 处理一帧数据。返回要输出的通道数据，length 同时返回输出长度；
+    // 返回 nullptr 表示丢弃（第三个源）。
+    const uint8_t* process(uint8_t slot, uint32_t sourceIp, const uint8_t* data,
+                           uint16_t& length, uint32_t nowMs);
+
+    // 状态查询
+    bool isMerging(uint8_t slot) const;
+    uint8_t getSourceCount(uint8_t slot) const;
+    uint32_t getSourceIp(uint8_t slot, uint8_t source) const;
+    // 最近 DATA_TIMEOUT_MS 内有源（Art-Net 或 sACN）的数据被输出（ArtPollReply 的 GoodOutput）
+    bool hasRecentData(uint8_t slot, uint32_t nowMs) const;
+
+    // SWAR 合并内核，words 为 32 位字数
+    static void mergeHtp(uint32_t* out, const uint32_t* a, const uint32_t* b, uint16_t words);
+    static void mergeLtp(uint32_t* out, const uint32_t* previous, const uint32_t* next, uint16_t words);
+
+private:
+    struct Source {
+        uint32_t ip;
+        uint32_t lastMs;
+        bool active;
+    };
+
+    struct UniverseState {
+        Source sources[MAX_SOURCES];
+        MergeMode mode;
+        bool cancelPending;
+        int8_t buffer;          // 合并缓冲编号，-1 表示未在合并
+        uint32_t lastIp;        // 最近一次单源输出的源和数据
+        uint16_t lastLength;
+        uint32_t last[FRAME_WORDS];
+    };
+
+    struct MergeBuffer {
+        uint32_t source[MAX_SOURCES][FRAME_WORDS];
+        uint32_t output[FRAME_WORDS];
+        uint16_t length[MAX_SOURCES];
+        bool valid[MAX_SOURCES];
+        bool inUse;
+    };
+
+    UniverseState universes[MAX_SLOTS];
+    MergeBuffer buffers[MAX_MERGE_BUFFERS];
+    MergeMode defaultMode;
+
+    void expireSources(UniverseState& state, uint32_t nowMs);
+    int8_t findOrAddSource(UniverseState& state, uint32_t sourceIp, uint32_t nowMs);
+    uint8_t activeSourceCount(const UniverseState& state) const;
+    int8_t acquireBuffer();
+    void releaseBuffer(UniverseState& state);
+};
@@ -0,0 +1,168 @@
+#include "PatchPlan.h"
+
+// 窗口中每个目标字节的来源：路由序号 << 9 | 通道，NO_SOURCE 表示不写
+static const uint16_t NO_SOURCE = 0xFFFF;
+static const uint16_t SOURCE_MASK = 0x1FF;
+
+PatchPlan::PatchPlan() {
+    clear();
+}
+
+void PatchPlan::clear() {
+    memset(first, 0, sizeof(first));
+    memset(masks, 0, sizeof(masks));
+    memset(&stats, 0, sizeof(stats));
+    spanCount = 0;
+}
+
+bool PatchPlan::compile(const PatchEntry* entries, uint8_t count, const UniverseRouter& router,
+                        uint8_t dmxTargets, uint16_t pixelBytes) {
+    clear();
+
+    // 每项对应的路由序号，无效项一次性剔除
+    uint8_t slots[256];
+    for (uint8_t e = 0; e < count; e++) {
+        const PatchEntry& entry = entries[e];
+        const UniverseRoute* route = router.lookup(entry.portAddress);
+        uint8_t target = targetOf(entry.type, entry.index);
+        bool valid = route && entry.count > 0 && entry.source < SOURCE_SLOTS &&
+                     (target == PIXEL_TARGET ? pixelBytes > 0 : target != 0xFF && (dmxTargets >> target & 1));
+        slots[e] = valid ? route->slot : 0xFF;
+        if (valid) {
+            stats.entries++;
+        } else {
+            stats.skipped++;
+        }
+    }
+
+    uint16_t window[WINDOW];
+    for (uint8_t target = 0; target < TARGET_COUNT; target++) {
+        uint16_t size = target == PIXEL_TARGET ? pixelBytes : DMX_TARGET_BYTES;
+        if (target != PIXEL_TARGET && !(dmxTargets >> target & 1)) continue;
+
+        for (uint32_t winStart = 0; winStart < size; winStart += WINDOW) {
+            uint32_t winEnd = winStart + WINDOW < size ? winStart + WINDOW : size;
+            memset(window, 0xFF, sizeof(window));
+            bool used = false;
+
+            // 按表中顺序写入来源，后面的项覆盖前面的
+            for (uint8_t e = 0; e < count; e++) {
+                const PatchEntry& entry = entries[e];
+                if (slots[e] == 0xFF || targetOf(entry.type, entry.index) != target) continue;
+                uint32_t base = entry.offset;
+                if (target == PIXEL_TARGET) base += (uint32_t)entry.index * PATCH_PIXEL_SEGMENT_BYTES;
+                uint16_t length = entry.count;
+                if (entry.source + length > SOURCE_SLOTS) length = SOURCE_SLOTS - entry.source;
+                uint16_t repeat = entry.repeat ? entry.repeat : 1;
+                uint32_t stride = entry.stride ? entry.stride : length;
+
+                for (uint16_t r = 0; r < repeat; r++) {
+                    uint32_t dest = base + r * stride;
+                    if (dest >= winEnd) break;
+                    uint32_t from = dest > winStart ? dest : winStart;
+                    uint32_t to = dest + length < winEnd ? dest + length : winEnd;
+                    for (uint32_t d = from; d < to; d++) {
+                        window[d - winStart] = (uint16_t)(slots[e] << 9 | (entry.source + (d - dest)));
+                    }
+                    used = used || from < to;
+                }
+            }
+            if (!used) continue;
+
+            // 来源和目标都连续的字节合并成一段
+            for (uint32_t d = 0; d < winEnd - winStart;) {
+                uint16_t src = window[d];
+                if (src == NO_SOURCE) {
+                    d++;
+                    continue;
+                }
+                uint32_t run = 1;
+                while (d + run < winEnd - winStart && window[d + run] == src + run &&
+                       ((src + run) & SOURCE_MASK) != 0) {
+                    run++;
+                }
+                if (!emit(src >> 9, target, src & SOURCE_MASK, winStart + d, run)) {
+                    stats.overflow = true;
+                    groupBySlot();
+                    return false;
+                }
+                d += run;
+            }
+        }
+    }
+
+    groupBySlot();
+    return true;
+}
+
+// 追加一段；与上一段首尾相接（跨窗口）时延长，来源相同、目标等间隔时合并为重复
+bool PatchPlan::emit(uint8_t slot, uint8_t target, uint16_t source, uint16_t dest, uint16_t length) {
+    stats.bytes += length;
+    masks[slot] |= 1 << target;
+
+    if (spanCount > 0) {
+        PatchSpan& last = spans[spanCount - 1];
+        if (last.slot == slot && last.target == target) {
+            if (last.repeat == 1 && last.dest + last.length == dest && last.source + last.length == source) {
+                last.length += length;
+                // 被窗口切开的一份重复拼完整后并回前一段
+                if (spanCount > 1 && extendRepeat(spans[spanCount - 2], last.slot, last.target, last.source,
+                                                  last.dest, last.length)) {
+                    spanCount--;
+                }
+                return true;
+            }
+            if (extendRepeat(last, slot, target, source, dest, length)) return true;
+        }
+    }
+
+    if (spanCount >= MAX_SPANS) return false;
+    PatchSpan& span = spans[spanCount++];
+    span.source = source;
+    span.dest = dest;
+    span.length = length;
+    span.stride = length;
+    span.repeat = 1;
+    span.target = target;
+    span.slot = slot;
+    return true;
+}
+
+// 来源和长度相同、目标按等间隔排在 span 之后时，并为 span 的下一次重复
+bool PatchPlan::extendRepeat(PatchSpan& span, uint8_t slot, uint8_t target, uint16_t source,
+                             uint16_t dest, uint16_t length) {
+    if (span.slot != slot || span.target != target || span.source != source || span.length != length) {
+        return false;
+    }
+    if (span.repeat == 1 && dest > span.dest) {
+        span.stride = dest - span.dest;
+        span.repeat = 2;
+        return true;
+    }
+    if (span.repeat > 1 && dest == span.dest + span.repeat * span.stride) {
+        span.repeat++;
+        return true;
+    }
+    return false;
+}
+
+// 按路由序号稳定排序，执行时每个宇宙只遍历自己的段
+void PatchPlan::groupBySlot() {
+    for (uint16_t i = 1; i < spanCount; i++) {
+        PatchSpan span = spans[i];
+        uint16_t j = i;
+        while (j > 0 && spans[j - 1].slot > span.slot) {
+            spans[j] = spans[j - 1];
+            j--;
+        }
+        spans[j] = span;
+    }
+
+    uint16_t i = 0;
+    for (uint8_t slot = 0; slot < UniverseRouter::MAX_ROUTES; slot++) {
+        first[slot] = i;
+        while (i < spanCount && spans[i].slot == slot) i++;
+    }
+    first[UniverseRouter::MAX_ROUTES] = spanCount;
+    stats.spans = spanCount;
+}
@@ -0,0 +1,108 @@
+#pragma once
+
+// 通道配接表与拷贝计划（纯 C++，不依赖 Arduino，可在主机上测试）
+//
+// 配接表的每一项把某个输入宇宙的一段通道映射到某个输出（DMX 端口 / 像素缓冲）的一段位置，
+// 可带偏移和重复。配置变化时编译成拷贝计划：按输出逐字节求出最终来源（后面的项覆盖前面的），
+// 再把来源和目标都连续的字节合并成一段 memcpy，来源相同、目标等间隔的段合并成一段重复拷贝。
+// 每个数据包只按所属宇宙执行几次块拷贝，不做逐通道查表。
+
+#include <stdint.h>
+#include <string.h>
+#include "UniverseRouter.h"
+
+// 配接表项。像素输出是一整块字节缓冲，位置 = index * PATCH_PIXEL_SEGMENT_BYTES + offset
+struct PatchEntry {
+    uint16_t portAddress;   // 输入宇宙（15 位 Port-Address）
+    uint16_t source;        // 起始通道，0 起
+    uint16_t count;         // 通道数
+    uint8_t type;           // OutputType
+    uint8_t index;          // DMX 端口号 / 像素段号
+    uint16_t offset;        // 输出内的起始位置，0 起
+    uint16_t repeat;        // 重复次数，0 视同 1
+    uint16_t stride;        // 每次重复的输出间隔，0 表示紧接上一份（= count）
+};
+
+// 编译后的一段拷贝：data[source..] -> 目标 dest 起，共 length 字节，重复 repeat 次，每次目标后移 stride
+struct PatchSpan {
+    uint16_t source;
+    uint16_t dest;
+    uint16_t length;
+    uint16_t stride;
+    uint16_t repeat;
+    uint8_t target;         // 0..MAX_DMX_TARGETS-1 为 DMX 端口，PIXEL_TARGET 为像素缓冲
+    uint8_t slot;           // 路由序号
+};
+
+struct PatchPlanStats {
+    uint16_t entries;       // 参与编译的配接项
+    uint16_t skipped;       // 宇宙未订阅、输出不存在或超出范围的项
+    uint16_t spans;         // 编译出的拷贝段
+    uint16_t bytes;         // 每轮所有宇宙都到达时拷贝的字节数
+    bool overflow;          // 拷贝段超出上限，计划不完整
+};
+
+#define PATCH_PIXEL_SEGMENT_BYTES 510   // 像素段号按 170 个 RGB 像素换算
+
+class PatchPlan {
+public:
+    static const uint8_t MAX_DMX_TARGETS = 4;
+    static const uint8_t PIXEL_TARGET = MAX_DMX_TARGETS;
+    static const uint8_t TARGET_COUNT = MAX_DMX_TARGETS + 1;
+    static const uint16_t MAX_SPANS = 128;
+    static const uint16_t SOURCE_SLOTS = 512;      // 输入宇宙的通道数
+    static const uint16_t DMX_TARGET_BYTES = 512;
+    static const uint16_t WINDOW = 512;     // 编译时逐窗口求来源，栈上只需 1KB
+
+    PatchPlan();
+
+    void clear();
+
+    // 按配接表和路由表编译。dmxTargets 为存在的 DMX 端口位图，pixelBytes 为像素缓冲大小。
+    // 拷贝段超出 MAX_SPANS 时返回 false（已编译的部分仍然有效）
+    bool compile(const PatchEntry* entries, uint8_t count, const UniverseRouter& router,
+                 uint8_t dmxTargets, uint16_t pixelBytes);
+
+    // 执行一个宇宙的拷贝：sink.write(target, dest, src, length)。只拷贝数据包中实际收到的通道
+    template <typename Sink>
+    void apply(uint8_t slot, const uint8_t* data, uint16_t length, Sink& sink) const {
+        if (slot >= UniverseRouter::MAX_ROUTES) return;
+        for (uint16_t i = first[slot]; i < first[slot + 1]; i++) {
+            const PatchSpan& span = spans[i];
+            if (span.source >= length) continue;
+            uint16_t bytes = span.length;
+            if (span.source + bytes > length) bytes = length - span.source;
+            uint16_t dest = span.dest;
+            for (uint16_t r = 0; r < span.repeat; r++, dest += span.stride) {
+                sink.write(span.target, dest, data + span.source, bytes);
+            }
+        }
+    }
+
+    // 该宇宙写入的目标位图（bit = target）
+    uint8_t targetMask(uint8_t slot) const { return slot < UniverseRouter::MAX_ROUTES ? masks[slot] : 0; }
+
+    uint16_t getSpanCount() const { return spanCount; }
+    uint16_t getSpanCount(uint8_t slot) const {
+        return slot < UniverseRouter::MAX_ROUTES ? first[slot + 1] - first[slot] : 0;
+    }
+    const PatchSpan& getSpan(uint16_t i) const { return spans[i]; }
+    const PatchPlanStats& getStats() const { return stats; }
+
+    static uint8_t targetOf(uint8_t type, uint8_t index) {
+        if (type == OUTPUT_PIXEL) return PIXEL_TARGET;
+        return type == OUTPUT_DMX && index < MAX_DMX_TARGETS ? index : 0xFF;
+    }
+
+private:
+    PatchSpan spans[MAX_SPANS];
+    uint16_t first[UniverseRouter::MAX_ROUTES + 1];     // 按路由序号分组：[first[s], first[s+1])
+    uint8_t masks[UniverseRouter::MAX_ROUTES];
+    uint16_t spanCount;
+    PatchPlanStats stats;
+
+    bool emit(uint8_t slot, uint8_t target, uint16_t source, uint16_t dest, uint16_t length);
+    static bool extendRepeat(PatchSpan& span, uint8_t slot, uint8_t target, uint16_t source,
+                             uint16_t dest, uint16_t length);
+    void groupBySlot();
+};
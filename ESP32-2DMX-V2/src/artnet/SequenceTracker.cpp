@@ -0,0 +1,98 @@
+#include "SequenceTracker.h"
+#include <string.h>
+
+// 序号 1..255 循环，共 255 个值
+static const uint16_t SEQUENCE_SPAN = 255;
+
+SequenceTracker::SequenceTracker() {
+    reset();
+}
+
+void SequenceTracker::reset() {
+    memset(sources, 0, sizeof(sources));
+    resetStats();
+}
+
+void SequenceTracker::resetStats() {
+    memset(stats, 0, sizeof(stats));
+}
+
+bool SequenceTracker::check(uint8_t slot, uint32_t sourceIp, uint8_t sequence, uint32_t nowMs) {
+    if (slot >= MAX_SLOTS) return true;
+
+    SequenceStats& stat = stats[slot];
+    stat.received++;
+
+    bool isNew;
+    Source& source = findSource(slot, sourceIp, nowMs, isNew);
+
+    // 未启用序号，或新源 / 上次为 0：直接接受
+    if (sequence == 0 || isNew || source.lastSequence == 0) {
+        source.lastSequence = sequence;
+        source.lastMs = nowMs;
+        source.rejects = 0;
+        stat.accepted++;
+        return true;
+    }
+
+    // 前进距离，0..254
+    uint16_t distance = (sequence + SEQUENCE_SPAN - source.lastSequence) % SEQUENCE_SPAN;
+
+    if (distance > 0 && distance <= SEQUENCE_SPAN - REORDER_WINDOW) {
+        stat.lost += distance - 1;
+        source.lastSequence = sequence;
+        source.lastMs = nowMs;
+        source.rejects = 0;
+        stat.accepted++;
+        return true;
+    }
+
+    // 源空闲太久或连续被拒绝：认为发送端重启，重新同步
+    if (nowMs - source.lastMs >= RESYNC_IDLE_MS || source.rejects >= RESYNC_REJECTS) {
+        source.lastSequence = sequence;
+        source.lastMs = nowMs;
+        source.rejects = 0;
+        stat.resync++;
+        stat.accepted++;
+        return true;
+    }
+
+    source.rejects++;
+    if (distance == 0) {
+        stat.duplicate++;
+    } else {
+        // 迟到的帧之前已被计为丢失
+        stat.reordered++;
+        if (stat.lost > 0) stat.lost--;
+    }
+    return false;
+}
+
+const SequenceStats& SequenceTracker::getStats(uint8_t slot) const {
+    static const SequenceStats empty = {0, 0, 0, 0, 0, 0};
+    return slot < MAX_SLOTS ? stats[slot] : empty;
+}
+
+SequenceTracker::Source& SequenceTracker::findSource(uint8_t slot, uint32_t sourceIp, uint32_t nowMs, bool& isNew) {
+    Source* entries = sources[slot];
+    Source* oldest = &entries[0];
+
+    for (uint8_t i = 0; i < MAX_SOURCES; i++) {
+        if (entries[i].active && entries[i].ip == sourceIp) {
+            isNew = false;
+            return entries[i];
+        }
+        if (!entries[i].active) {
+            oldest = &entries[i];
+        } else if (oldest->active && nowMs - entries[i].lastMs > nowMs - oldest->lastMs) {
+            oldest = &entries[i];
+        }
+    }
+
+    // 占用空位或替换最久未出现的源
+    memset(oldest, 0, sizeof(Source));
+    oldest->ip = sourceIp;
+    oldest->active = true;
+    isNew = true;
+    return *oldest;
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+// ArtDmx 序号跟踪（纯 C++，不依赖 Arduino，可在主机上测试）
+//
+// Art-Net 序号在 1..255 之间循环，0 表示发送端未启用序号。
+// 按宇宙、按源分别跟踪：
+//   前进 1..(255 - 窗口)    接受，跳过的序号计为丢失
+//   相同                     重复，丢弃
+//   落后窗口以内             乱序到达的旧帧，丢弃
+// 源长时间无数据或连续被拒绝时重新同步，避免发送端重启后一直被丢弃。
+
+#include <stdint.h>
+#include "UniverseRouter.h"
+
+struct SequenceStats {
+    uint32_t received;     // 收到的 ArtDmx 数
+    uint32_t accepted;     // 通过检查的帧数
+    uint32_t lost;         // 未收到的序号数
+    uint32_t duplicate;    // 重复帧
+    uint32_t reordered;    // 乱序到达、被丢弃的旧帧
+    uint32_t resync;       // 重新同步次数
+};
+
+class SequenceTracker {
+public:
+    static const uint8_t MAX_SLOTS = UniverseRouter::MAX_ROUTES;   // 按路由序号索引
+    static const uint8_t MAX_SOURCES = 2;
+    static const uint8_t REORDER_WINDOW = 64;     // 落后这么多以内视为乱序
+    static const uint32_t RESYNC_IDLE_MS = 1000;  // 源空闲这么久后无条件接受
+    static const uint8_t RESYNC_REJECTS = 8;      // 连续拒绝这么多次后重新同步
+
+    SequenceTracker();
+
+    void reset();
+    void resetStats();
+
+    // 返回 true 表示这一帧应该被使用
+    bool check(uint8_t slot, uint32_t sourceIp, uint8_t sequence, uint32_t nowMs);
+
+    const SequenceStats& getStats(uint8_t slot) const;
+
+private:
+    struct Source {
+        uint32_t ip;
+        uint32_t lastMs;
+        uint8_t lastSequence;
+        uint8_t rejects;
+        bool active;
+    };
+
+    Source sources[MAX_SLOTS][MAX_SOURCES];
+    SequenceStats stats[MAX_SLOTS];
+
+    Source& findSource(uint8_t slot, uint32_t sourceIp, uint32_t nowMs, bool& isNew);
+};
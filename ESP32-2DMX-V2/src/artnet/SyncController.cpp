@@ -0,0 +1,55 @@
+#include "SyncController.h"
+
+SyncController::SyncController() {
+    reset();
+}
+
+void SyncController::reset() {
+    syncMode = false;
+    lastSyncMs = 0;
+    dmxSourceIp = 0;
+    pendingMask = 0;
+    syncCount = 0;
+    timeoutCount = 0;
+}
+
+uint32_t SyncController::onArtDmx(uint32_t sourceIp, uint32_t outputMask, uint32_t nowMs) {
+    dmxSourceIp = sourceIp;
+
+    // 先检查超时，避免控制台停发 ArtSync 后数据一直滞留
+    uint32_t expired = poll(nowMs);
+    if (!syncMode) {
+        return expired | outputMask;
+    }
+
+    pendingMask |= outputMask;
+    return expired;
+}
+
+uint32_t SyncController::onArtSync(uint32_t sourceIp, uint32_t nowMs) {
+    // 只接受当前 ArtDmx 源发出的 ArtSync
+    if (dmxSourceIp != 0 && sourceIp != dmxSourceIp) {
+        return 0;
+    }
+
+    syncMode = true;
+    lastSyncMs = nowMs;
+    syncCount++;
+
+    uint32_t mask = pendingMask;
+    pendingMask = 0;
+    return mask;
+}
+
+uint32_t SyncController::poll(uint32_t nowMs) {
+    if (!syncMode || nowMs - lastSyncMs < SYNC_TIMEOUT_MS) {
+        return 0;
+    }
+
+    syncMode = false;
+    timeoutCount++;
+
+    uint32_t mask = pendingMask;
+    pendingMask = 0;
+    return mask;
+}
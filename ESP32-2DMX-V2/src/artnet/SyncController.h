@@ -0,0 +1,43 @@
+#pragma once
+
+// ArtSync 同步输出控制（纯 C++，不依赖 Arduino，可在主机上测试）
+//
+// 非同步模式：每个 ArtDmx 立即提交到输出
+// 同步模式：ArtDmx 只写入后台缓冲并记录待提交的输出，收到 ArtSync 时一起提交
+// 收到 ArtSync 即进入同步模式，4 秒内没有 ArtSync 则回到非同步模式（Art-Net 4）
+
+#include <stdint.h>
+
+class SyncController {
+public:
+    static const uint32_t SYNC_TIMEOUT_MS = 4000;
+
+    SyncController();
+
+    void reset();
+
+    // ArtDmx 写入了 outputMask 对应的输出；返回需要立即提交的输出
+    uint32_t onArtDmx(uint32_t sourceIp, uint32_t outputMask, uint32_t nowMs);
+
+    // 收到 ArtSync；返回需要提交的输出，非当前 ArtDmx 源发出的 ArtSync 被忽略
+    uint32_t onArtSync(uint32_t sourceIp, uint32_t nowMs);
+
+    // 周期调用：同步超时后回到非同步模式，返回滞留的待提交输出
+    uint32_t poll(uint32_t nowMs);
+
+    // 状态查询
+    bool isSyncMode() const { return syncMode; }
+    uint32_t getPendingMask() const { return pendingMask; }
+    uint32_t getSyncCount() const { return syncCount; }
+    uint32_t getTimeoutCount() const { return timeoutCount; }
+
+private:
+    bool syncMode;
+    uint32_t lastSyncMs;
+    uint32_t dmxSourceIp;
+    uint32_t pendingMask;
+
+    // 统计信息
+    uint32_t syncCount;
+    uint32_t timeoutCount;
+};
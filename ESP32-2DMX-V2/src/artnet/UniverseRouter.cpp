@@ -0,0 +1,41 @@
+#include "UniverseRouter.h"
+#include <string.h>
+
+UniverseRouter::UniverseRouter() {
+    clear();
+}
+
+void UniverseRouter::clear() {
+    memset(subscribed, 0, sizeof(subscribed));
+    memset(pageOf, NO_PAGE, sizeof(pageOf));
+    memset(pages, 0, sizeof(pages));
+    memset(slotAddress, 0, sizeof(slotAddress));
+    pageCount = 0;
+    routeCount = 0;
+}
+
+bool UniverseRouter::addRoute(uint16_t portAddress, OutputType type, uint8_t index) {
+    if (type == OUTPUT_NONE) return false;
+    portAddress &= 0x7FFF;
+
+    // 分配或查找页
+    uint16_t pageKey = portAddress >> 4;
+    uint8_t page = pageOf[pageKey];
+    if (page == NO_PAGE) {
+        if (pageCount >= MAX_PAGES) return false;
+        page = pageCount++;
+        pageOf[pageKey] = page;
+    }
+
+    UniverseRoute& route = pages[page][portAddress & 0x0F];
+    if (route.type == OUTPUT_NONE) {
+        if (routeCount >= MAX_ROUTES) return false;
+        route.slot = routeCount;
+        slotAddress[routeCount++] = portAddress;
+        subscribed[portAddress >> 5] |= 1UL << (portAddress & 31);
+    }
+
+    route.type = type;
+    route.index = index;
+    return true;
+}
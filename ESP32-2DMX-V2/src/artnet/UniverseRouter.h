@@ -0,0 +1,72 @@
+#pragma once
+
+// Art-Net 宇宙路由表（纯 C++，不依赖 Arduino，可在主机上测试）
+//
+// 以完整的 15 位 Port-Address 为索引做两级查表：
+//   第一级：Net + SubNet（高 11 位）-> 页号，2KB
+//   第二级：每页 16 个 Universe -> 输出
+// 每个数据包的分发都是 O(1)。
+// 另有一张 32768 位的订阅位图（4KB），供接收端只看包头就丢弃无关宇宙。
+
+#include <stdint.h>
+
+// 输出类型
+enum OutputType : uint8_t {
+    OUTPUT_NONE = 0,
+    OUTPUT_DMX = 1,     // DMX 端口（index: 0 = A, 1 = B）
+    OUTPUT_PIXEL = 2    // 像素段（index: 第 N 段，每段 170 像素）
+};
+
+// 路由表项
+struct UniverseRoute {
+    uint8_t type;       // OutputType
+    uint8_t index;      // 输出端口号 / 像素段号
+    uint8_t slot;       // 订阅序号，用于索引按宇宙保存的状态
+};
+
+class UniverseRouter {
+public:
+    static const uint16_t PORT_ADDRESS_COUNT = 0x8000;
+    static const uint16_t PAGE_COUNT = PORT_ADDRESS_COUNT >> 4;  // Net + SubNet 组合数
+    static const uint8_t MAX_PAGES = 8;      // 同时订阅的 Net/SubNet 组合上限
+    static const uint8_t MAX_ROUTES = 16;    // 同时订阅的宇宙上限
+    static const uint8_t NO_PAGE = 0xFF;
+
+    UniverseRouter();
+
+    // 清空全部路由
+    void clear();
+
+    // 添加路由，同一 Port-Address 重复添加时覆盖输出
+    bool addRoute(uint16_t portAddress, OutputType type, uint8_t index);
+
+    // 查找路由，未订阅时返回 nullptr
+    const UniverseRoute* lookup(uint16_t portAddress) const {
+        uint8_t page = pageOf[(portAddress & 0x7FFF) >> 4];
+        if (page == NO_PAGE) return nullptr;
+        const UniverseRoute* route = &pages[page][portAddress & 0x0F];
+        return route->type != OUTPUT_NONE ? route : nullptr;
+    }
+
+    // 只判断是否订阅：一次位测试，用于包头预过滤
+    bool isSubscribed(uint16_t portAddress) const {
+        portAddress &= 0x7FFF;
+        return (subscribed[portAddress >> 5] >> (portAddress & 31)) & 1;
+    }
+
+    // 状态查询
+    uint8_t getRouteCount() const { return routeCount; }
+    uint16_t getPortAddress(uint8_t slot) const { return slot < routeCount ? slotAddress[slot] : 0; }
+    const UniverseRoute* getRoute(uint8_t slot) const {
+        return slot < routeCount ? lookup(slotAddress[slot]) : nullptr;
+    }
+
+private:
+    uint32_t subscribed[PORT_ADDRESS_COUNT / 32];
+    uint8_t pageOf[PAGE_COUNT];
+    UniverseRoute pages[MAX_PAGES][16];
+    uint8_t pageCount;
+
+    uint16_t slotAddress[MAX_ROUTES];
+    uint8_t routeCount;
+};
@@ -19,6 +19,37 @@
 #ifndef DMX_BUFFER_SIZE
 #define DMX_BUFFER_SIZE 512  // 仅当未定义时才定义
 #endif
+#define DMX_TX_BUFFER_SIZE 1024    // UART 发送环形缓冲，大于一帧 (513 字节)，写入不阻塞
+#define DMX_REFRESH_HZ 0           // DMX 输出刷新率上限，0 表示按帧长尽快刷新（512 通道约 44 Hz）；没有新数据时重复上一帧
+#define DMX_PHASE_OFFSET_US 11000  // 相邻端口帧起点错开的时间（约半个 512 通道帧）
+#define DMX_MIN_SLOTS 24           // 自适应帧长时最少发送的通道数
+#define DMX_REFRESH_MODE 1         // 0 = 固定 DMX_REFRESH_HZ，1 = 跟随输入帧率，2 = 只在变化时发送 + 保活
+#define DMX_KEEPALIVE_HZ 4         // 输入空闲时的最低刷新率（部分灯具约 1 秒收不到信号即进入失控状态）
+#define DMX_SOURCE_IDLE_MS 1000    // 超过这么久没有新帧视为输入空闲，降到保活频率
+#define DMX_OUTPUT_CURVE 0         // 输出端口全部通道的响应曲线：0 线性，1 平方，2 反平方，3 S 曲线
+#define DMX_FINE_CHANNEL -1        // 生成 16 位细调值的粗调通道（1 起，细调为下一个通道），-1 不生成
+#define DMX_FINE_INTERPOLATE 1     // 细调值在粗调的两级之间按帧插值
+#define DMX_STATS_INTERVAL_MS 1000 // DMX 任务刷新帧率统计的间隔；发送由定时器驱动，任务不需要频繁唤醒
+#define DMX_HARDWARE_BREAK 1       // 由 UART 在帧尾生成 Break / MAB，0 则用定时器 + 反相输出
+#define DMX_PORT_A_RMT 0           // 1 = A 口用 RMT 输出，不占用 UART（RDM 需要 UART，A 口保持 0）
+#define DMX_PORT_B_RMT 0           // 1 = B 口用 RMT 输出
+#define DMX_RMT_CHANNEL_A 0        // RMT 通道号
+#define DMX_RMT_CHANNEL_B 1
+
+// DMX 输入（无线 DMX -> Art-Net 桥）：输入端口收到的帧以 ArtDmx 发出，只在变化时发送，另加 keepalive
+#define DMX_INPUT_ENABLED 0        // 1 = DMX_INPUT_PORT 作为输入，不再输出
+#define DMX_INPUT_PORT 1           // 0 = A 口，1 = B 口；宇宙沿用该端口原来的宇宙
+#define DMX_RX_B_PIN GPIO_NUM_4    // B 口收发器 RO
+#define DMX_RX_A_PIN GPIO_NUM_21   // A 口收发器 RO
+#define DMX_RX_BUFFER_SIZE 1024    // UART 接收环形缓冲
+#define DMX_RX_QUEUE_SIZE 32       // UART 事件队列
+#define DMX_RX_FIFO_THRESHOLD 64   // FIFO 中攒够这么多字节交给接收任务
+#define DMX_RX_TASK_STACK_SIZE 3072
+#define DMX_RX_TASK_PRIORITY 3     // 高于 DMX / 网络任务，Break 事件及时处理
+#define DMX_RX_TIMING 1            // 在 RX 引脚的边沿中断中测量 Break / MAB（每帧几次中断）
+#define DMX_INPUT_KEEPALIVE_MS 1000       // 输入没有变化时重发的间隔
+#define DMX_INPUT_MIN_INTERVAL_MS 23      // 两次 ArtDmx 之间的最小间隔（约 44 Hz）
+#define DMX_INPUT_DEST_IP 0              // 0 = 子网定向广播，否则为目标 IP（uint32，网络字节序）
 
 #define DMX_BAUD_RATE 250000       // DMX波特率
 #define DMX_MAX_CHANNELS 512
@@ -33,10 +64,29 @@
 
 // 像素LED配置
 #define PIXEL_PIN GPIO_NUM_5
+#define PIXEL_CLOCK_PIN GPIO_NUM_22         // APA102 的 SPI 时钟（数据用 PIXEL_PIN）
+// 多条灯带：大于 1 时单线灯珠走 I2S1 的 8 路并行输出，各条同时发送，每条从新的宇宙开始
+#define PIXEL_STRIP_COUNT 1
+#define PIXEL_STRIP_PINS {GPIO_NUM_5, GPIO_NUM_13, GPIO_NUM_14, GPIO_NUM_23, GPIO_NUM_25, GPIO_NUM_26, GPIO_NUM_27, GPIO_NUM_32}
+#define PIXEL_STRIP_PIXELS {170, 170, 170, 170, 170, 170, 170, 170}   // 每条灯带的像素数
 #define MAX_PIXELS 1360
+// 像素输出任务：show() 只发布帧并唤醒它，线路发送不阻塞网络任务（核心 1）
+#define PIXEL_ASYNC_SHOW 1                  // 0 = show() 在调用者中同步发送
+#define PIXEL_OUTPUT_TASK_STACK_SIZE 3072
+#define PIXEL_OUTPUT_TASK_PRIORITY 2        // 高于网络任务，新帧到达后及时送出
+#define PIXEL_OUTPUT_CORE 0
+// 像素渲染任务：按固定帧率出帧（DMX 像素交给发送的任务直接编码，效果编码成整帧），没有变化的格子跳过
+#define PIXEL_RENDER_FPS 40
+#define PIXEL_RENDER_SOURCE 0               // 0 = DMX，1 = 效果，2 = 混合（DMX 空闲时跑效果）
+#define PIXEL_DMX_IDLE_MS 2000              // 混合模式下超过这么久没有 DMX 像素数据改跑效果
+#define PIXEL_RENDER_TASK_STACK_SIZE 4096
+#define PIXEL_RENDER_TASK_PRIORITY 2
+#define PIXEL_RENDER_CORE 0
 #define DEFAULT_PIXELS 170
 #define PIXEL_COUNT 170
 #define PIXEL_TYPE (NEO_GRB + NEO_KHZ800)  // 添加像素类型定义
+#define PIXELS_PER_UNIVERSE 170             // 每个宇宙承载的 RGB 像素数 (510 通道)
+#define MAX_PIXEL_UNIVERSES ((MAX_PIXELS + PIXELS_PER_UNIVERSE - 1) / PIXELS_PER_UNIVERSE)
 
 // WiFi配置
 #define WIFI_SSID "542628277"
@@ -57,9 +107,21 @@
 #define ARTNET_PORT 6454
 #define START_UNIVERSE 0
 #define START_SUBNET 0
-#define MAX_UNIVERSES 4            // 最大支持的宇宙数
+#define MAX_UNIVERSES (DMX_PORT_COUNT + MAX_PIXEL_UNIVERSES)  // 最大支持的宇宙数: 2 路 DMX + 8 段像素
 #define ARTNET_POLL_TIMEOUT 5000   // Art-Net轮询超时时间(ms)
 
+// Art-Net 接收方式：1 = lwIP udp_recv 回调 + 任务通知，0 = WiFiUDP 轮询
+#ifndef ARTNET_RX_EVENT
+#define ARTNET_RX_EVENT 1
+#endif
+#define ARTNET_RX_WAIT_MS 10       // 网络任务无数据时最长等待(ms)，保证 Web 和超时检查照常运行
+#define ARTNET_POLL_BURST 16       // 轮询模式下每次 update() 最多读取的包数
+
+// sACN (E1.31) 接收：与 Art-Net 共用路由表，sACN 宇宙 N 对应 Port-Address N - 1
+#ifndef SACN_ENABLED
+#define SACN_ENABLED 1
+#endif
+
 // 设备配置
 #define DEVICE_NAME "HuBo-ArtNode"
 #define DEVICE_LONG_NAME "HuBo Art-Net Node"
@@ -118,10 +180,13 @@ enum NetworkStatus {
 // DMX端口定义
 enum DMXPorts {
     DMX_PORT_A = 0,
-    DMX_PORT_B = 1
+    DMX_PORT_B = 1,
+    DMX_PORT_COUNT = 2
 };
 
 // 确保关键配置值有效
 static_assert(UART_BUFFER_SIZE >= DMX_BUFFER_SIZE, "UART buffer size must be >= DMX buffer size");
 static_assert(MAX_PIXELS <= 1360, "MAX_PIXELS exceeds hardware limit");
-static_assert(PIXEL_COUNT <= MAX_PIXELS, "PIXEL_COUNT exceeds MAX_PIXELS");
\ No newline at end of file
+static_assert(PIXEL_COUNT <= MAX_PIXELS, "PIXEL_COUNT exceeds MAX_PIXELS");
+static_assert(PIXEL_STRIP_COUNT >= 1 && PIXEL_STRIP_COUNT <= 8, "PIXEL_STRIP_COUNT must be 1..8");
+static_assert(MAX_UNIVERSES <= 16, "MAX_UNIVERSES exceeds UniverseRouter::MAX_ROUTES");
\ No newline at end of file
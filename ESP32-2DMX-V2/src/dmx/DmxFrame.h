@@ -0,0 +1,42 @@
+#pragma once
+
+// DMX 帧缓冲（纯 C++，不依赖 Arduino，可在主机上测试）
+
+#include <stdint.h>
+#include <string.h>
+
+#define DMX_SLOT_COUNT 512            // 每帧最多 512 个通道
+#define DMX_START_CODE 0x00
+
+struct DmxFrame {
+    uint8_t data[DMX_SLOT_COUNT + 1]; // data[0] 为起始码
+    uint16_t length;                  // 有效通道数，不含起始码
+
+    void clear() {
+        memset(data, 0, sizeof(data));
+        data[0] = DMX_START_CODE;
+        length = 0;
+    }
+
+    // 需要发送的通道数：收到过的最高通道，不少于 minimum
+    uint16_t activeSlots(uint16_t minimum) const {
+        uint16_t count = length > minimum ? length : minimum;
+        return count < DMX_SLOT_COUNT ? count : DMX_SLOT_COUNT;
+    }
+
+    uint8_t* slots() { return data + 1; }
+    const uint8_t* slots() const { return data + 1; }
+
+    // 把通道数据一次性写入帧，start 从 0 开始；返回实际写入的字节数
+    uint16_t writeSlots(const uint8_t* src, uint16_t count, uint16_t start = 0) {
+        if (!src || start >= DMX_SLOT_COUNT) return 0;
+        if (count > DMX_SLOT_COUNT - start) {
+            count = DMX_SLOT_COUNT - start;
+        }
+        memcpy(data + 1 + start, src, count);
+        if (start + count > length) {
+            length = start + count;
+        }
+        return count;
+    }
+};
@@ -0,0 +1,88 @@
+#pragma once
+
+// DMX 端口的帧交接缓冲（纯 C++，主机和 ESP32 通用）
+//
+// 网络任务写入后台帧并 commit()，DMX 任务在帧边界 acquire() 最新的完整帧。
+// 只更新部分通道时，先从上一次发布的帧补齐其余通道，保证每帧都完整。
+// 同一帧可以分几次写入不相连的几段（配接计划），中间跳过的通道同样沿用上一次发布的值。
+// 带 DmxOutputTransform 的写入在同一遍中完成曲线查表和细调通道。
+
+#include <stdint.h>
+#include <string.h>
+#include "DmxFrame.h"
+#include "TripleBuffer.h"
+#include "DmxOutputTransform.h"
+
+class DmxFrameBuffer {
+public:
+    DmxFrameBuffer() : writing(false) {
+        for (uint8_t i = 0; i < 3; i++) {
+            frames.at(i).clear();
+        }
+    }
+
+    // ---- 网络任务（写者） ----
+    uint16_t writeSlots(const uint8_t* data, uint16_t length, uint16_t startSlot = 0) {
+        return prepare(length, startSlot).writeSlots(data, length, startSlot);
+    }
+
+    uint16_t writeSlots(const uint8_t* data, uint16_t length, uint16_t startSlot,
+                        DmxOutputTransform& transform) {
+        DmxFrame& back = prepare(length, startSlot);
+        if (transform.isIdentity()) return back.writeSlots(data, length, startSlot);
+        return transform.write(back, data, length, startSlot);
+    }
+
+    // 发布已写入的帧，没有写入时什么也不做
+    bool commit() {
+        if (!writing) return false;
+        frames.publish();
+        writing = false;
+        return true;
+    }
+
+    // 带 DmxOutputTransform 写入的帧：同时把细调插值推进到这一帧
+    bool commit(DmxOutputTransform& transform) {
+        if (!commit()) return false;
+        transform.commit();
+        return true;
+    }
+
+    bool hasUncommitted() const { return writing; }
+
+    // ---- DMX 任务（读者） ----
+    bool acquire() { return frames.consume(); }
+    bool hasNewFrame() const { return frames.hasNewFrame(); }
+    const DmxFrame& front() const { return frames.readBuffer(); }
+
+private:
+    TripleBuffer<DmxFrame> frames;
+    bool writing;
+
+    // 取后台帧准备写入 [startSlot, startSlot + length)：本帧第一次写入时从上一次发布的帧补齐
+    DmxFrame& prepare(uint16_t length, uint16_t startSlot) {
+        DmxFrame& back = frames.writeBuffer();
+        if (!writing) {
+            const DmxFrame& last = frames.lastPublished();
+            if (startSlot > 0 || startSlot + length < last.length) {
+                memcpy(&back, &last, sizeof(DmxFrame));
+            } else {
+                back.data[0] = last.data[0];
+                back.length = 0;
+            }
+            writing = true;
+        }
+        if (startSlot > back.length && startSlot <= DMX_SLOT_COUNT) {
+            fillGap(back, back.length, startSlot);
+        }
+        return back;
+    }
+
+    // [from, to) 沿用上一次发布的帧，超出其长度的部分清零
+    void fillGap(DmxFrame& back, uint16_t from, uint16_t to) {
+        const DmxFrame& last = frames.lastPublished();
+        uint16_t copied = last.length > from ? (last.length < to ? last.length : to) - from : 0;
+        memcpy(back.slots() + from, last.slots() + from, copied);
+        memset(back.slots() + from + copied, 0, to - from - copied);
+    }
+};
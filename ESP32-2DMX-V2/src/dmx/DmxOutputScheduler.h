@@ -0,0 +1,144 @@
+#pragma once
+
+// DMX 输出刷新调度（纯 C++，主机和 ESP32 通用）
+//
+// 每个输出端口记录输入帧（commitFrame）的到达间隔，每帧开始时按策略决定到下一帧的周期：
+//   FIXED      固定刷新率（setRefreshRate），与输入无关
+//   MATCH      跟随输入：新帧到达后尽快发出，输入停止后降到保活频率
+//   KEEPALIVE  有新数据时尽快发出，其余时间只按保活频率重发
+// MATCH / KEEPALIVE 下新帧到达会把等待中的发送定时器提前，输出与输入同相；
+// 没有新数据时只按保活频率唤醒，空闲节点每秒只有几次定时器中断。
+
+#include <stdint.h>
+#include <string.h>
+
+#define DMX_SCHED_DEFAULT_KEEPALIVE_HZ 4
+#define DMX_SCHED_DEFAULT_IDLE_US 1000000
+
+enum DmxRefreshMode : uint8_t {
+    DMX_REFRESH_FIXED = 0,
+    DMX_REFRESH_MATCH,
+    DMX_REFRESH_KEEPALIVE
+};
+
+// 每帧开始时的调度决定
+enum DmxScheduleReason : uint8_t {
+    DMX_SCHED_FIXED = 0,    // 固定周期
+    DMX_SCHED_MATCH,        // 输入活跃，按输入间隔
+    DMX_SCHED_KEEPALIVE     // 输入空闲（或保活模式），按保活周期
+};
+
+struct DmxScheduleStats {
+    uint32_t inputFrames;       // 提交的输入帧
+    uint32_t inputPeriodUs;     // 输入间隔（1/8 指数平均）
+    uint32_t periodUs;          // 最近一次决定的输出周期
+    uint32_t fixedFrames;       // 按各决定开始的帧
+    uint32_t matchFrames;
+    uint32_t keepaliveFrames;
+    uint32_t kicks;             // 因新数据提前开始的帧
+    uint32_t freshFrames;       // 开始时有新数据的帧
+    uint32_t repeatFrames;      // 重复上一帧
+    DmxScheduleReason lastReason;
+};
+
+class DmxOutputScheduler {
+public:
+    // DMX512-A 要求 Break 到 Break 不超过 1 秒，保活周期留出余量
+    static const uint32_t MAX_KEEPALIVE_US = 800000;
+
+    DmxOutputScheduler()
+        : mode(DMX_REFRESH_FIXED)
+        , keepaliveUs(1000000 / DMX_SCHED_DEFAULT_KEEPALIVE_HZ)
+        , idleUs(DMX_SCHED_DEFAULT_IDLE_US)
+        , lastInputUs(0)
+        , pending(false) {
+        memset(&stats, 0, sizeof(stats));
+    }
+
+    void setMode(DmxRefreshMode refreshMode) { mode = refreshMode; }
+    DmxRefreshMode getMode() const { return mode; }
+
+    // 保活频率：输入空闲时的最低刷新率，0 或过低时按 MAX_KEEPALIVE_US
+    void setKeepaliveRate(uint32_t hz) {
+        keepaliveUs = hz ? 1000000 / hz : MAX_KEEPALIVE_US;
+        if (keepaliveUs > MAX_KEEPALIVE_US) keepaliveUs = MAX_KEEPALIVE_US;
+    }
+    uint32_t getKeepaliveUs() const { return keepaliveUs; }
+
+    // 超过这么久没有新帧视为输入停止
+    void setIdleTimeout(uint32_t us) { idleUs = us; }
+    uint32_t getIdleTimeout() const { return idleUs; }
+
+    // 新的输入帧已提交（网络任务）。返回 true 表示策略要求尽快发出
+    bool onInput(uint32_t nowUs) {
+        if (stats.inputFrames > 0) {
+            uint32_t interval = nowUs - lastInputUs;
+            // 空闲后恢复的第一帧不计入间隔
+            if (interval < idleUs) {
+                stats.inputPeriodUs = stats.inputPeriodUs
+                    ? stats.inputPeriodUs - stats.inputPeriodUs / 8 + interval / 8
+                    : interval;
+            }
+        }
+        stats.inputFrames++;
+        lastInputUs = nowUs;
+        pending = true;
+        return mode != DMX_REFRESH_FIXED;
+    }
+
+    // 有尚未发出的新数据，且策略要求尽快发出
+    bool wantsFrame() const { return pending && mode != DMX_REFRESH_FIXED; }
+
+    bool isInputActive(uint32_t nowUs) const {
+        return stats.inputFrames > 0 && nowUs - lastInputUs < idleUs;
+    }
+    float inputHz() const { return stats.inputPeriodUs ? 1e6f / stats.inputPeriodUs : 0.0f; }
+
+    // 帧开始（发送定时器）：返回到下一帧的周期。early 表示本帧因新数据提前开始
+    uint32_t onFrame(uint32_t nowUs, uint32_t fixedPeriodUs, bool early) {
+        if (pending) {
+            stats.freshFrames++;
+        } else {
+            stats.repeatFrames++;
+        }
+        pending = false;
+        if (early) stats.kicks++;
+
+        uint32_t period;
+        if (mode == DMX_REFRESH_FIXED) {
+            period = fixedPeriodUs;
+            stats.lastReason = DMX_SCHED_FIXED;
+            stats.fixedFrames++;
+        } else if (mode == DMX_REFRESH_MATCH && isInputActive(nowUs) && stats.inputPeriodUs) {
+            // 正常情况下下一个输入帧先到并提前唤醒；多留 1/4 周期，定时器不会抢在输入之前重复上一帧
+            period = stats.inputPeriodUs + stats.inputPeriodUs / 4;
+            if (period > keepaliveUs) period = keepaliveUs;
+            stats.lastReason = DMX_SCHED_MATCH;
+            stats.matchFrames++;
+        } else {
+            period = keepaliveUs;
+            stats.lastReason = DMX_SCHED_KEEPALIVE;
+            stats.keepaliveFrames++;
+        }
+        stats.periodUs = period;
+        return period;
+    }
+
+    const DmxScheduleStats& getStats() const { return stats; }
+    void resetStats() {
+        uint32_t inputPeriodUs = stats.inputPeriodUs;
+        uint32_t inputFrames = stats.inputFrames;
+        memset(&stats, 0, sizeof(stats));
+        // 输入间隔是调度状态的一部分，重置统计时保留
+        stats.inputPeriodUs = inputPeriodUs;
+        stats.inputFrames = inputFrames;
+    }
+
+private:
+    DmxRefreshMode mode;
+    uint32_t keepaliveUs;
+    uint32_t idleUs;
+    uint32_t lastInputUs;
+    volatile bool pending;      // 上一帧开始后有新的输入帧
+    DmxScheduleStats stats;
+};
@@ -0,0 +1,177 @@
+#include "DmxOutputTransform.h"
+
+DmxOutputTransform::DmxOutputTransform() {
+    for (uint8_t curve = 0; curve < DMX_CURVE_COUNT; curve++) {
+        for (uint16_t input = 0; input < 256; input++) {
+            uint16_t value = curveAt((DmxCurve)curve, (uint8_t)input);
+            table16[curve][input] = value;
+            table8[curve][input] = (uint8_t)((value + 128) / 257);
+        }
+    }
+    clear();
+}
+
+void DmxOutputTransform::clear() {
+    memset(slotCurves, DMX_CURVE_LINEAR, sizeof(slotCurves));
+    runCount = 0;
+    fineCount = 0;
+}
+
+bool DmxOutputTransform::setCurve(uint16_t startSlot, uint16_t count, DmxCurve curve) {
+    if (startSlot >= DMX_SLOT_COUNT || curve >= DMX_CURVE_COUNT) return false;
+    if (count > DMX_SLOT_COUNT - startSlot) count = DMX_SLOT_COUNT - startSlot;
+
+    uint8_t saved[DMX_SLOT_COUNT];
+    memcpy(saved, slotCurves, sizeof(saved));
+    memset(slotCurves + startSlot, curve, count);
+    if (!rebuild()) {
+        memcpy(slotCurves, saved, sizeof(saved));
+        return false;
+    }
+    return true;
+}
+
+bool DmxOutputTransform::addFineChannel(uint16_t coarseSlot, bool interpolate) {
+    if (coarseSlot + 1 >= DMX_SLOT_COUNT) return false;
+
+    uint8_t i = 0;
+    while (i < fineCount && fines[i].coarse != coarseSlot) i++;
+    if (i == fineCount) {
+        if (fineCount >= MAX_FINE) return false;
+        fineCount++;
+    }
+    FineChannel& fine = fines[i];
+    fine.coarse = coarseSlot;
+    fine.interpolate = interpolate;
+    fine.written = false;
+    fine.state.last = 0;
+    fine.state.from = 0;
+    fine.state.since = 255;
+    fine.state.run = 0;
+    fine.next = fine.state;
+    return true;
+}
+
+// 按通道曲线表重建非线性区间，区间按起点排序
+bool DmxOutputTransform::rebuild() {
+    CurveRun built[MAX_RUNS];
+    uint8_t count = 0;
+    for (uint16_t slot = 0; slot < DMX_SLOT_COUNT;) {
+        uint8_t curve = slotCurves[slot];
+        uint16_t end = slot + 1;
+        while (end < DMX_SLOT_COUNT && slotCurves[end] == curve) end++;
+        if (curve != DMX_CURVE_LINEAR) {
+            if (count >= MAX_RUNS) return false;
+            built[count].start = slot;
+            built[count].end = end;
+            built[count].curve = curve;
+            count++;
+        }
+        slot = end;
+    }
+    memcpy(runs, built, count * sizeof(CurveRun));
+    runCount = count;
+    return true;
+}
+
+uint16_t DmxOutputTransform::write(DmxFrame& frame, const uint8_t* src, uint16_t count, uint16_t start) {
+    if (!src || start >= DMX_SLOT_COUNT) return 0;
+    if (count > DMX_SLOT_COUNT - start) count = DMX_SLOT_COUNT - start;
+
+    // 线性部分整段拷贝，曲线区间逐字节查表
+    uint8_t* out = frame.slots();
+    uint16_t end = start + count;
+    uint16_t pos = start;
+    for (uint8_t r = 0; r < runCount && pos < end; r++) {
+        const CurveRun& run = runs[r];
+        if (run.end <= pos) continue;
+        if (run.start >= end) break;
+        uint16_t from = run.start > pos ? run.start : pos;
+        uint16_t to = run.end < end ? run.end : end;
+        memcpy(out + pos, src + (pos - start), from - pos);
+        const uint8_t* table = table8[run.curve];
+        for (uint16_t slot = from; slot < to; slot++) {
+            out[slot] = table[src[slot - start]];
+        }
+        pos = to;
+    }
+    memcpy(out + pos, src + (pos - start), end - pos);
+
+    // 细调通道对：粗调 / 细调取曲线 16 位结果的高低字节
+    uint16_t length = end;
+    for (uint8_t i = 0; i < fineCount; i++) {
+        FineChannel& fine = fines[i];
+        if (fine.coarse < start || fine.coarse >= end) continue;
+        uint16_t value = fineValue(fine, src[fine.coarse - start]);
+        out[fine.coarse] = value >> 8;
+        out[fine.coarse + 1] = value & 0xFF;
+        if (fine.coarse + 2 > length) length = fine.coarse + 2;
+    }
+
+    if (length > frame.length) frame.length = length;
+    return count;
+}
+
+void DmxOutputTransform::commit() {
+    for (uint8_t i = 0; i < fineCount; i++) {
+        FineChannel& fine = fines[i];
+        if (!fine.written) continue;
+        fine.state = fine.next;
+        fine.written = false;
+    }
+}
+
+// 已发布状态加上本帧的粗调输入。同一帧重复写入总是从已发布状态算起，结果相同
+DmxOutputTransform::FineRamp DmxOutputTransform::advance(const FineRamp& ramp, uint8_t input) {
+    FineRamp next = ramp;
+    int16_t step = (int16_t)input - ramp.last;
+    if (step == 1 || step == -1) {
+        next.run = ramp.since < 255 ? ramp.since + 1 : 0;
+        next.since = 0;
+        next.from = ramp.last;
+    } else if (step != 0) {
+        next.since = 0;
+        next.run = 0;
+        next.from = input;
+    } else if (ramp.since < 255) {
+        next.since++;
+    }
+    next.last = input;
+    return next;
+}
+
+// 粗调输入每隔 run 帧变化一级时，按经过的帧数从上一级插值到当前级（落后最多一级，不越过控台的值）；
+// 超过上一级的间隔（渐变停止）或发生跳变时就是当前级
+uint16_t DmxOutputTransform::fineValue(FineChannel& fine, uint8_t input) {
+    fine.next = advance(fine.state, input);
+    fine.written = true;
+
+    const FineRamp& ramp = fine.next;
+    const uint16_t* table = table16[slotCurves[fine.coarse]];
+    uint16_t value = table[input];
+    if (fine.interpolate && ramp.run > 1 && ramp.since < ramp.run) {
+        int32_t from = table[ramp.from];
+        value = (uint16_t)(from + ((int32_t)value - from) * ramp.since / ramp.run);
+    }
+    return value;
+}
+
+// 曲线的 16 位结果，输入和输出都按满量程归一化
+uint16_t DmxOutputTransform::curveAt(DmxCurve curve, uint8_t input) {
+    uint32_t x = input;
+    switch (curve) {
+        case DMX_CURVE_SQUARE:
+            return (uint16_t)((x * x * 65535 + 32512) / 65025);
+        case DMX_CURVE_INV_SQUARE: {
+            uint32_t y = 255 - x;
+            return (uint16_t)(65535 - (y * y * 65535 + 32512) / 65025);
+        }
+        case DMX_CURVE_S: {
+            // 3x^2 - 2x^3
+            uint64_t num = (uint64_t)x * x * (3 * 255 - 2 * x);
+            return (uint16_t)((num * 65535 + 16581375 / 2) / 16581375);
+        }
+        default:
+            return (uint16_t)(x * 257);
+    }
+}
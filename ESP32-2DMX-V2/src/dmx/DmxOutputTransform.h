@@ -0,0 +1,92 @@
+#pragma once
+
+// DMX 输出的响应曲线与 16 位细调通道（纯 C++，主机和 ESP32 通用）
+//
+// 每个输出端口按通道区间指定曲线（线性 / 平方 / 反平方 / S 曲线），配置变化时重建 256 项查找表
+// 和曲线区间表；写入后台帧时线性区间直接 memcpy，曲线区间逐字节查表，不额外遍历整帧。
+// 细调通道：只发 8 位的控台驱动 16 位灯具时，由粗调通道按曲线的 16 位结果生成下一个通道的细调值；
+// 打开插值后，慢速渐变中粗调每隔几帧才变化一级，细调值按上一级的间隔从上一级推进到当前级，
+// 输出不会越过控台的值。插值状态每个输出帧推进一次：write() 只计算，commit() 时才生效。
+
+#include <stdint.h>
+#include <string.h>
+#include "DmxFrame.h"
+
+enum DmxCurve : uint8_t {
+    DMX_CURVE_LINEAR = 0,
+    DMX_CURVE_SQUARE,           // 平方律：低端更细，常用于白炽灯调光
+    DMX_CURVE_INV_SQUARE,       // 反平方：低端更快
+    DMX_CURVE_S,                // S 曲线（smoothstep）：两端平缓
+    DMX_CURVE_COUNT
+};
+
+class DmxOutputTransform {
+public:
+    static const uint8_t MAX_RUNS = 32;     // 非线性曲线区间
+    static const uint8_t MAX_FINE = 16;     // 细调通道对
+
+    DmxOutputTransform();
+
+    // 恢复全部线性、无细调通道
+    void clear();
+
+    // [startSlot, startSlot + count) 使用 curve，后设置的覆盖之前的。区间过多时返回 false 且不生效
+    bool setCurve(uint16_t startSlot, uint16_t count, DmxCurve curve);
+    DmxCurve getCurve(uint16_t slot) const {
+        return slot < DMX_SLOT_COUNT ? (DmxCurve)slotCurves[slot] : DMX_CURVE_LINEAR;
+    }
+
+    // coarseSlot 的下一个通道改为生成的细调值（输入中该通道的数据被忽略）
+    bool addFineChannel(uint16_t coarseSlot, bool interpolate);
+    uint8_t getFineCount() const { return fineCount; }
+
+    bool isIdentity() const { return runCount == 0 && fineCount == 0; }
+    uint8_t getRunCount() const { return runCount; }
+
+    // 把 src 写入帧的 [start, start + count)：拷贝、查表和细调在同一遍完成。返回写入的通道数
+    uint16_t write(DmxFrame& frame, const uint8_t* src, uint16_t count, uint16_t start);
+
+    // 帧边界：本帧写过的细调通道的插值状态推进一帧（同一帧多次写入只算一次）
+    void commit();
+
+    // 曲线在 8 位输入上的 16 位结果
+    uint16_t value16(DmxCurve curve, uint8_t input) const { return table16[curve][input]; }
+    uint8_t value8(DmxCurve curve, uint8_t input) const { return table8[curve][input]; }
+
+private:
+    struct CurveRun {
+        uint16_t start;
+        uint16_t end;
+        uint8_t curve;
+    };
+
+    // 细调插值状态
+    struct FineRamp {
+        uint8_t last;           // 上一帧的粗调输入
+        uint8_t from;           // 最近一次单级变化之前的一级，插值从这里推进到 last
+        uint8_t since;          // 上一次变化一级后经过的帧数
+        uint8_t run;            // 上一级持续的帧数，0 表示跳变或间隔未知，不插值
+    };
+
+    // 细调通道对：state 为上一个已发布帧的状态，next 为本帧写入后的状态
+    struct FineChannel {
+        uint16_t coarse;
+        bool interpolate;
+        bool written;
+        FineRamp state;
+        FineRamp next;
+    };
+
+    uint8_t slotCurves[DMX_SLOT_COUNT];
+    CurveRun runs[MAX_RUNS];
+    uint8_t runCount;
+    FineChannel fines[MAX_FINE];
+    uint8_t fineCount;
+    uint16_t table16[DMX_CURVE_COUNT][256];
+    uint8_t table8[DMX_CURVE_COUNT][256];
+
+    bool rebuild();
+    uint16_t fineValue(FineChannel& fine, uint8_t input);
+    static FineRamp advance(const FineRamp& ramp, uint8_t input);
+    static uint16_t curveAt(DmxCurve curve, uint8_t input);
+};
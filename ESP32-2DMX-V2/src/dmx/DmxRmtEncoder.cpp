@@ -0,0 +1,113 @@
+#include "DmxRmtEncoder.h"
+
+// 两位组成一个 item：下标 = 第一位 | 第二位 << 1
+static const uint32_t BIT_PAIR[4] = {
+    DmxRmtEncoder::makeItem(0, DmxRmtEncoder::TICKS_PER_BIT, 0, DmxRmtEncoder::TICKS_PER_BIT),
+    DmxRmtEncoder::makeItem(1, DmxRmtEncoder::TICKS_PER_BIT, 0, DmxRmtEncoder::TICKS_PER_BIT),
+    DmxRmtEncoder::makeItem(0, DmxRmtEncoder::TICKS_PER_BIT, 1, DmxRmtEncoder::TICKS_PER_BIT),
+    DmxRmtEncoder::makeItem(1, DmxRmtEncoder::TICKS_PER_BIT, 1, DmxRmtEncoder::TICKS_PER_BIT)
+};
+
+// 一对字节中间的 item：前一字节的第二个停止位 + 后一字节的起始位
+static const uint32_t PAIR_JOIN = DmxRmtEncoder::makeItem(1, DmxRmtEncoder::TICKS_PER_BIT, 0, DmxRmtEncoder::TICKS_PER_BIT);
+
+// 奇数个字节时最后一个字节的第二个停止位，后半段时长为 0 即结束标记
+static const uint32_t LAST_STOP = DmxRmtEncoder::makeItem(1, DmxRmtEncoder::TICKS_PER_BIT, 1, 0);
+
+static const uint32_t END_MARKER = 0;
+
+DmxRmtEncoder::DmxRmtEncoder()
+    : bytesEncoded(0)
+    , count(0)
+    , valid(false) {
+    memset(itemBuffer, 0, sizeof(itemBuffer));
+    memset(shadow, 0, sizeof(shadow));
+    setTiming(176, 12);
+}
+
+void DmxRmtEncoder::setTiming(uint32_t breakUs, uint32_t mabUs) {
+    itemBuffer[0] = makeItem(0, breakUs, 1, mabUs);
+}
+
+// 字节 index 在一对中的位置决定它占用的 5 个 item：
+//   偶数（前）：起始位 d0 | d1 d2 | d3 d4 | d5 d6 | d7 停止位1
+//   奇数（后）：d0 d1 | d2 d3 | d4 d5 | d6 d7 | 停止位1 停止位2（起始位在 PAIR_JOIN 中）
+void DmxRmtEncoder::encodeByte(uint16_t index, uint8_t value) {
+    uint32_t* item = itemBuffer + 1 + (index >> 1) * ITEMS_PER_PAIR;
+    if ((index & 1) == 0) {
+        item[0] = BIT_PAIR[(value & 0x01) << 1];
+        item[1] = BIT_PAIR[(value >> 1) & 0x03];
+        item[2] = BIT_PAIR[(value >> 3) & 0x03];
+        item[3] = BIT_PAIR[(value >> 5) & 0x03];
+        item[4] = BIT_PAIR[(value >> 7) | 0x02];
+    } else {
+        item[6] = BIT_PAIR[value & 0x03];
+        item[7] = BIT_PAIR[(value >> 2) & 0x03];
+        item[8] = BIT_PAIR[(value >> 4) & 0x03];
+        item[9] = BIT_PAIR[(value >> 6) & 0x03];
+        item[10] = BIT_PAIR[3];
+    }
+    shadow[index] = value;
+}
+
+// 从 first（偶数）起重新编码到帧尾，并写入结束标记
+void DmxRmtEncoder::encodeTail(uint16_t first, const uint8_t* data, uint16_t bytes) {
+    for (uint16_t i = first; i < bytes; i++) {
+        encodeByte(i, data[i]);
+        if ((i & 1) == 1) {
+            itemBuffer[1 + (i >> 1) * ITEMS_PER_PAIR + 5] = PAIR_JOIN;
+        }
+    }
+
+    uint16_t pairs = bytes >> 1;
+    if (bytes & 1) {
+        itemBuffer[1 + pairs * ITEMS_PER_PAIR + 5] = LAST_STOP;
+        count = 1 + pairs * ITEMS_PER_PAIR + 6;
+    } else {
+        itemBuffer[1 + pairs * ITEMS_PER_PAIR] = END_MARKER;
+        count = 1 + pairs * ITEMS_PER_PAIR + 1;
+    }
+    bytesEncoded = bytes;
+}
+
+uint16_t DmxRmtEncoder::encode(const uint8_t* data, uint16_t bytes) {
+    if (bytes > MAX_BYTES) bytes = MAX_BYTES;
+    if (bytes == 0) return 0;
+
+    if (!valid) {
+        encodeTail(0, data, bytes);
+        valid = true;
+        return bytes;
+    }
+
+    // 长度不变的部分逐字节比较，按 4 字节一组跳过没有变化的区域
+    uint16_t common = bytes < bytesEncoded ? bytes : bytesEncoded;
+    uint16_t changed = 0;
+    uint16_t i = 0;
+    for (; i + 4 <= common; i += 4) {
+        uint32_t a, b;
+        memcpy(&a, data + i, 4);
+        memcpy(&b, shadow + i, 4);
+        if (a == b) continue;
+        for (uint16_t j = i; j < i + 4; j++) {
+            if (data[j] != shadow[j]) {
+                encodeByte(j, data[j]);
+                changed++;
+            }
+        }
+    }
+    for (; i < common; i++) {
+        if (data[i] != shadow[i]) {
+            encodeByte(i, data[i]);
+            changed++;
+        }
+    }
+
+    // 长度变化：从最后一个完整的对开始重写帧尾
+    if (bytes != bytesEncoded) {
+        uint16_t first = common & ~1;
+        encodeTail(first, data, bytes);
+        changed += bytes - first;
+    }
+    return changed;
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+// DMX 帧的 RMT 编码（纯 C++，不依赖 ESP-IDF，可在主机上测试）
+//
+// RMT 时钟 1 MHz（APB 80 MHz / 80），DMX 一位 = 4 个 tick。
+// 每个 RMT item 是两段 (电平, 时长)，这里每段固定表示一位，布局固定：
+//   item 0                     Break（低）+ MAB（高）
+//   每两个字节 11 个 item       22 位 = 两个完整的 11 位字节（起始位 + 8 数据位 + 2 停止位）
+//   结束                       时长为 0 的一段
+// 布局固定，某个字节变化时只需改写它对应的 5 个 item，整帧不必重新编码。
+// item 的位布局与 ESP32 的 rmt_item32_t 相同：
+//   bit 0-14 duration0, bit 15 level0, bit 16-30 duration1, bit 31 level1
+
+#include <stdint.h>
+#include <string.h>
+
+class DmxRmtEncoder {
+public:
+    static const uint32_t TICKS_PER_BIT = 4;         // 1 MHz 时钟下 250 kbaud 的一位
+    static const uint16_t MAX_BYTES = 513;           // 起始码 + 512 通道
+    static const uint16_t ITEMS_PER_PAIR = 11;
+    // 513 字节：256 对 + 最后一个字节的 5 个 item 和带结束标记的停止位
+    static const uint16_t MAX_ITEMS = 1 + MAX_BYTES / 2 * ITEMS_PER_PAIR + 6;
+    static const uint32_t MAX_DURATION = 0x7FFF;
+
+    DmxRmtEncoder();
+
+    // Break / MAB 时长（微秒 = tick）
+    void setTiming(uint32_t breakUs, uint32_t mabUs);
+
+    // 编码一帧，data[0] 为起始码。与上一帧相同的字节不再编码；
+    // 返回重新编码的字节数
+    uint16_t encode(const uint8_t* data, uint16_t bytes);
+
+    // 下一次 encode() 整帧重新编码
+    void invalidate() { valid = false; }
+
+    const uint32_t* items() const { return itemBuffer; }
+    uint16_t itemCount() const { return count; }
+    uint16_t encodedBytes() const { return bytesEncoded; }
+
+    static uint32_t makeItem(uint8_t level0, uint32_t duration0, uint8_t level1, uint32_t duration1) {
+        return (duration0 & MAX_DURATION) | ((uint32_t)(level0 & 1) << 15) |
+               ((duration1 & MAX_DURATION) << 16) | ((uint32_t)(level1 & 1) << 31);
+    }
+
+private:
+    uint32_t itemBuffer[MAX_ITEMS];
+    uint8_t shadow[MAX_BYTES];      // 已编码的字节
+    uint16_t bytesEncoded;
+    uint16_t count;
+    bool valid;
+
+    void encodeByte(uint16_t index, uint8_t value);
+    void encodeTail(uint16_t first, const uint8_t* data, uint16_t bytes);
+};
@@ -0,0 +1,233 @@
+#pragma once
+
+// DMX 输入分帧与时序测量（纯 C++，主机和 ESP32 通用）
+//
+// 接收任务把 UART 事件交给 DmxRxFramer：
+//   onData()   收到的字节追加到采集缓冲
+//   onBreak()  Break 标志上一帧结束：完整的帧发布给读者，开始采集下一帧
+//   onError()  帧错误 / FIFO 溢出：丢弃正在采集的帧，直到下一个 Break。
+//              Break 本身在 UART 看来也是一个帧错误的 0x00，紧跟 Break、还没有数据时的帧错误忽略
+//   dropBreakByte()  Break 产生的那个 0x00 还在 UART 里，排在下一帧的起始码前面：
+//              只丢掉它一个字节，同一批读到的起始码和通道留给下一帧
+// 采集缓冲和已发布的帧分开（TripleBuffer 的写端和读端），网络任务读到的永远是完整的一帧。
+//
+// Break / MAB 宽度由 DmxBreakSniffer 在 RX 引脚的边沿中断里测量。只在一帧的数据收齐后
+// 打开中断，捕获下一帧的 Break 下降沿、Break 结束和起始码的下降沿后立即关闭，
+// 每帧只有几次中断，不必对每个数据位响应。
+
+#include <stdint.h>
+#include <string.h>
+#include "DmxFrame.h"
+#include "TripleBuffer.h"
+
+#define DMX_RX_BREAK_MIN_US 88          // DMX512-A 接收端：低电平至少 88 us 视为 Break
+
+struct DmxRxStats {
+    uint32_t frames;                // 发布的 DMX 帧（起始码 0）
+    uint32_t alternateFrames;       // 非 0 起始码（RDM、文本等），不发布
+    uint32_t emptyBreaks;           // Break 之间没有数据
+    uint32_t errors;                // 帧错误 / 溢出导致丢弃的帧
+    uint32_t overlong;              // 超过 513 字节的帧（多余部分丢弃）
+    uint32_t lastPeriodUs;          // 相邻两个 Break 的间隔
+    uint32_t minPeriodUs;
+    uint32_t maxPeriodUs;
+    uint32_t avgPeriodUs;           // 指数平均，用于刷新率
+    uint32_t breakUs;               // 最近一次测得的 Break / MAB
+    uint32_t mabUs;
+    uint32_t minBreakUs;
+    uint32_t minMabUs;
+    uint32_t timedFrames;           // 测到 Break / MAB 的帧数
+    uint16_t lastSlots;
+};
+
+// RX 引脚边沿 -> Break / MAB 宽度
+class DmxBreakSniffer {
+public:
+    DmxBreakSniffer() : state(SNIFF_IDLE), edgeUs(0), lowUs(0), breakUs(0), mabUs(0), ready(false) {}
+
+    // 打开边沿中断前调用
+    void arm() {
+        state = SNIFF_WAIT_FALL;
+        ready = false;
+    }
+    bool isArmed() const { return state != SNIFF_IDLE; }
+
+    // 中断中调用，返回 true 表示已测完，可以关闭中断
+    bool onEdge(uint8_t level, uint32_t nowUs) {
+        switch (state) {
+            case SNIFF_WAIT_FALL:
+                if (level == 0) {
+                    edgeUs = nowUs;
+                    state = SNIFF_BREAK;
+                }
+                return false;
+            case SNIFF_BREAK:
+                if (level == 0) return false;
+                // 数据位的低电平不够 Break，继续等下一个下降沿
+                if (nowUs - edgeUs < DMX_RX_BREAK_MIN_US) {
+                    state = SNIFF_WAIT_FALL;
+                    return false;
+                }
+                lowUs = nowUs - edgeUs;
+                edgeUs = nowUs;
+                state = SNIFF_MAB;
+                return false;
+            case SNIFF_MAB:
+                if (level != 0) return false;
+                breakUs = lowUs;
+                mabUs = nowUs - edgeUs;
+                ready = true;
+                state = SNIFF_IDLE;
+                return true;
+            default:
+                return true;
+        }
+    }
+
+    // 取走一次结果
+    bool take(uint32_t& breakOut, uint32_t& mabOut) {
+        if (!ready) return false;
+        breakOut = breakUs;
+        mabOut = mabUs;
+        ready = false;
+        return true;
+    }
+
+private:
+    enum State : uint8_t { SNIFF_IDLE, SNIFF_WAIT_FALL, SNIFF_BREAK, SNIFF_MAB };   // 避开 Arduino 的 LOW 宏
+    volatile State state;
+    uint32_t edgeUs;
+    uint32_t lowUs;
+    uint32_t breakUs;
+    uint32_t mabUs;
+    volatile bool ready;
+};
+
+class DmxRxFramer {
+public:
+    static const uint16_t MAX_BYTES = DMX_SLOT_COUNT + 1;
+
+    DmxRxFramer() {
+        for (uint8_t i = 0; i < 3; i++) {
+            frames.at(i).clear();
+        }
+        reset();
+    }
+
+    void reset() {
+        captured = 0;
+        discarding = true;      // 第一个 Break 之前的数据不完整
+        overflowed = false;
+        breakBytePending = false;
+        hasBreak = false;
+        lastBreakUs = 0;
+        expectedBytes = 0;
+        memset(&stats, 0, sizeof(stats));
+        stats.minPeriodUs = 0xFFFFFFFF;
+        stats.minBreakUs = 0xFFFFFFFF;
+        stats.minMabUs = 0xFFFFFFFF;
+    }
+
+    // ---- 接收任务 ----
+    void onData(const uint8_t* data, uint16_t length) {
+        if (discarding) return;
+        if (breakBytePending && length > 0) {
+            // 第一个字节不是 0x00 说明 Break 字节已经随上一帧读走了，原样保留
+            breakBytePending = false;
+            if (data[0] == 0x00) {
+                data++;
+                length--;
+            }
+        }
+        uint16_t room = MAX_BYTES - captured;
+        if (length > room) {
+            overflowed = true;
+            length = room;
+        }
+        memcpy(frames.writeBuffer().data + captured, data, length);
+        captured += length;
+    }
+
+    void onBreak(uint32_t nowUs) {
+        if (!discarding) {
+            publishCapture();
+        }
+
+        if (hasBreak) {
+            uint32_t period = nowUs - lastBreakUs;
+            stats.lastPeriodUs = period;
+            if (period < stats.minPeriodUs) stats.minPeriodUs = period;
+            if (period > stats.maxPeriodUs) stats.maxPeriodUs = period;
+            // 1/8 权重的指数平均，平滑任务调度带来的抖动
+            stats.avgPeriodUs = stats.avgPeriodUs ? stats.avgPeriodUs - stats.avgPeriodUs / 8 + period / 8 : period;
+        }
+        hasBreak = true;
+        lastBreakUs = nowUs;
+        captured = 0;
+        overflowed = false;
+        breakBytePending = false;
+        discarding = false;
+    }
+
+    // 在 onBreak() 之后调用：下一次 onData() 开头的 0x00 是 Break 本身
+    void dropBreakByte() { breakBytePending = true; }
+
+    void onError() {
+        if (!discarding && captured == 0) return;
+        if (!discarding) stats.errors++;
+        discarding = true;
+        captured = 0;
+    }
+
+    void onTiming(uint32_t breakUs, uint32_t mabUs) {
+        stats.breakUs = breakUs;
+        stats.mabUs = mabUs;
+        if (breakUs < stats.minBreakUs) stats.minBreakUs = breakUs;
+        if (mabUs < stats.minMabUs) stats.minMabUs = mabUs;
+        stats.timedFrames++;
+    }
+
+    // 本帧已收到与上一帧一样多的字节：下一个 Break 快到了，可以打开 Break 测量
+    bool captureComplete() const {
+        return !discarding && expectedBytes > 0 && captured >= expectedBytes;
+    }
+    uint16_t capturedBytes() const { return captured; }
+
+    // ---- 读者（网络任务）----
+    bool acquire() { return frames.consume(); }
+    bool hasNewFrame() const { return frames.hasNewFrame(); }
+    const DmxFrame& front() const { return frames.readBuffer(); }
+
+    const DmxRxStats& getStats() const { return stats; }
+    float refreshHz() const { return stats.avgPeriodUs ? 1e6f / stats.avgPeriodUs : 0.0f; }
+
+private:
+    TripleBuffer<DmxFrame> frames;
+    uint16_t captured;              // 采集缓冲中的字节数（含起始码）
+    uint16_t expectedBytes;         // 上一帧的字节数
+    bool discarding;
+    bool overflowed;
+    bool breakBytePending;
+    bool hasBreak;
+    uint32_t lastBreakUs;
+    DmxRxStats stats;
+
+    void publishCapture() {
+        if (captured == 0) {
+            stats.emptyBreaks++;
+            return;
+        }
+        expectedBytes = captured;
+        if (overflowed) stats.overlong++;
+
+        DmxFrame& frame = frames.writeBuffer();
+        if (frame.data[0] != DMX_START_CODE) {
+            stats.alternateFrames++;
+            return;
+        }
+        frame.length = captured - 1;
+        stats.lastSlots = frame.length;
+        stats.frames++;
+        frames.publish();
+    }
+};
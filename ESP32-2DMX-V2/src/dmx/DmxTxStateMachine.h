@@ -0,0 +1,323 @@
+#pragma once
+
+// DMX 发送状态机（纯 C++，主机和 ESP32 通用）
+//
+// 一帧：Break -> MAB -> 起始码 + 通道 -> 等待下一帧。每个状态只在定时器到期时
+// 推进一步，做完一个动作后重新定时，调用方任务从不阻塞。
+// 没有新帧时重复发送上一帧，保持 DMX 连续刷新。
+//
+// 硬件 Break 模式：UART 在每帧数据之后自动发出 Break，再保持 MAB 长度的空闲，
+// 紧接着就是下一帧的数据，每帧只需唤醒一次。只有启动后的第一帧用软件 Break。
+// 帧比刷新周期短时，帧间的空闲会落在 MAB 中；预计超过 MAX_IDLE_MAB_US 时（固定低刷新率、
+// 输入比线路慢、保活）本帧不带帧尾 Break，下一帧改用软件 Break，MAB 保持设定值。
+// 预计错了（跟随输入时输入没有按时到达）也最晚在空闲达到 MAX_IDLE_MAB_US 时重发一帧。
+//
+// 编码 Break 模式（RMT）：Break + MAB + 数据预先编码成一整段波形，每帧同样只唤醒一次，
+// 第一帧也不需要软件 Break。
+//
+// 刷新周期由 DmxOutputScheduler 按策略逐帧决定（固定 / 跟随输入 / 保活）。
+// 调用方提交新帧后调用 onInput()，返回 true 时用 armDelay() 重新定时，把等待中的下一帧提前；
+// 提前唤醒时 WAIT 状态会检查线路允许的最早时刻，不会违反最短帧间隔。
+//
+// 硬件操作由 Port 提供（ESP32 上是 UART + esp_timer，主机上是模拟器）：
+//   bool txIdle()          UART 是否已发完（FIFO 和移位寄存器都空）
+//   void breakBegin()      把 TX 线拉低
+//   void breakEnd()        释放 TX 线，进入 MAB
+//   uint16_t sendFrame()   取最新帧写入发送缓冲，返回字节数（含起始码）
+//   uint16_t sendFrameWithBreak(uint32_t breakBits)
+//                          同上，数据之后由 UART 发出 breakBits 位长的 Break（硬件 Break 模式）；
+//                          编码 Break 模式下 Break + MAB + 数据作为一整段发出
+//   void arm(uint32_t us)  us 微秒后再次调用 onTimer()
+
+#include <stdint.h>
+#include "DmxOutputScheduler.h"
+
+#define DMX_TX_BIT_US 4                // 250 kbaud
+#define DMX_TX_BYTE_US 44              // 1 起始位 + 8 数据位 + 2 停止位 @ 250 kbaud
+#define DMX_TX_DEFAULT_REFRESH_HZ 44
+
+enum DmxBreakMode : uint8_t {
+    DMX_BREAK_TIMER = 0,    // 定时器 + TX 反相
+    DMX_BREAK_UART,         // UART 在帧尾发出 Break，空闲位作为 MAB
+    DMX_BREAK_ENCODED       // Break / MAB 和数据一起编码（RMT）
+};
+
+enum DmxTxState : uint8_t {
+    DMX_TX_IDLE = 0,
+    DMX_TX_WAIT,        // 等待下一帧开始（或等 UART 发完）
+    DMX_TX_BREAK,
+    DMX_TX_MAB
+};
+
+struct DmxTxStats {
+    uint32_t frames;
+    uint32_t lastPeriodUs;      // 相邻两帧 Break 起点的间隔
+    uint32_t minPeriodUs;
+    uint32_t maxPeriodUs;
+    uint32_t busyRetries;       // 到点时 UART 还没发完，推迟一次
+    uint16_t lastBytes;         // 上一帧的字节数（起始码 + 有效通道）
+};
+
+class DmxTxStateMachine {
+public:
+    static const uint32_t MIN_BREAK_US = 92;
+    static const uint32_t MIN_MAB_US = 12;
+    static const uint32_t TX_POLL_US = DMX_TX_BYTE_US;
+    static const uint32_t MAX_REFRESH_HZ = 830;     // 24 通道短帧的上限
+    static const uint32_t MIN_FRAME_US = 1204;      // DMX512-A：Break 到 Break 至少 1204 us
+    static const uint16_t FULL_FRAME_BYTES = 513;
+    static const uint32_t MAX_BREAK_BITS = 255;     // uart_write_bytes_with_break 的上限
+    static const uint32_t MAX_MAB_BITS = 1023;      // tx_idle_num 的上限
+    static const uint32_t MAX_IDLE_MAB_US = 2000;   // 硬件 Break 下允许落进 MAB 的帧间空闲
+
+    DmxTxStateMachine()
+        : state(DMX_TX_IDLE)
+        , running(false)
+        , breakUs(176)
+        , mabUs(12)
+        , periodUs(1000000 / DMX_TX_DEFAULT_REFRESH_HZ)
+        , frameStartUs(0)
+        , nextFrameUs(0)
+        , busyUntilUs(0)
+        , phaseOffsetUs(0)
+        , breakMode(DMX_BREAK_TIMER)
+        , leadingBreak(true)
+        , frameFresh(false) {
+        resetStats();
+    }
+
+    // Break / MAB 低于 DMX512-A 下限时按下限处理，超出 UART 能力时按上限处理
+    void setTiming(uint32_t breakTimeUs, uint32_t mabTimeUs) {
+        breakUs = breakTimeUs < MIN_BREAK_US ? MIN_BREAK_US : breakTimeUs;
+        mabUs = mabTimeUs < MIN_MAB_US ? MIN_MAB_US : mabTimeUs;
+        if (breakUs > MAX_BREAK_BITS * DMX_TX_BIT_US) breakUs = MAX_BREAK_BITS * DMX_TX_BIT_US;
+        if (mabUs > MAX_MAB_BITS * DMX_TX_BIT_US) mabUs = MAX_MAB_BITS * DMX_TX_BIT_US;
+    }
+    uint32_t getBreakUs() const { return breakUs; }
+    uint32_t getMabUs() const { return mabUs; }
+
+    // 硬件 Break 以位为单位，向上取整保证不短于设定值
+    uint32_t getBreakBits() const { return (breakUs + DMX_TX_BIT_US - 1) / DMX_TX_BIT_US; }
+    uint32_t getMabBits() const { return (mabUs + DMX_TX_BIT_US - 1) / DMX_TX_BIT_US; }
+
+    void setBreakMode(DmxBreakMode mode) { breakMode = mode; }
+    DmxBreakMode getBreakMode() const { return breakMode; }
+    void setHardwareBreak(bool enable) { breakMode = enable ? DMX_BREAK_UART : DMX_BREAK_TIMER; }
+    bool isHardwareBreak() const { return breakMode != DMX_BREAK_TIMER; }
+
+    // 一帧在线上的时长：Break + MAB + 起始码和通道
+    uint32_t frameTimeUs(uint16_t bytes) const {
+        if (breakMode == DMX_BREAK_UART) {
+            return (getBreakBits() + getMabBits()) * DMX_TX_BIT_US + bytes * DMX_TX_BYTE_US;
+        }
+        return breakUs + mabUs + bytes * DMX_TX_BYTE_US;
+    }
+
+    // 按上一帧长度能达到的最高刷新率，以及相对 512 通道整帧的提升倍数
+    float maxRefreshHz() const {
+        uint32_t frameUs = frameTimeUs(stats.lastBytes ? stats.lastBytes : FULL_FRAME_BYTES);
+        return 1e6f / (frameUs > MIN_FRAME_US ? frameUs : MIN_FRAME_US);
+    }
+    float refreshGain() const {
+        return maxRefreshHz() * frameTimeUs(FULL_FRAME_BYTES) / 1e6f;
+    }
+
+    // FIXED 模式的刷新率；帧本身比周期长时按帧长背靠背发送。0 表示始终背靠背（按帧长尽快刷新）
+    void setRefreshRate(uint32_t hz) {
+        if (hz > MAX_REFRESH_HZ) hz = MAX_REFRESH_HZ;
+        periodUs = hz ? 1000000 / hz : 0;
+    }
+    uint32_t getPeriodUs() const { return periodUs; }
+
+    DmxOutputScheduler& getScheduler() { return scheduler; }
+    const DmxOutputScheduler& getScheduler() const { return scheduler; }
+
+    // 新帧已提交（调用方与 Port::arm 互斥）。返回 true 表示正在等待下一帧且策略要求尽快发出，
+    // 调用方应以 armDelay() 重新定时
+    bool onInput(uint32_t nowUs) {
+        return scheduler.onInput(nowUs) && running && state == DMX_TX_WAIT && stats.frames > 0;
+    }
+
+    // 等待下一帧时的定时：有待发的新数据时不晚于线路允许的最早时刻
+    uint32_t armDelay(uint32_t delayUs, uint32_t nowUs) const {
+        if (state != DMX_TX_WAIT || stats.frames == 0 || !scheduler.wantsFrame()) return delayUs;
+        uint32_t dueUs = kickDueUs();
+        uint32_t untilDue = (int32_t)(dueUs - nowUs) > 0 ? dueUs - nowUs : 0;
+        return untilDue < delayUs ? untilDue : delayUs;
+    }
+
+    // 启动后第一帧推迟的时间。多个端口错开帧起点，定时器回调和取帧不会挤在同一时刻
+    void setPhaseOffset(uint32_t offsetUs) { phaseOffsetUs = offsetUs; }
+    uint32_t getPhaseOffset() const { return phaseOffsetUs; }
+
+    template <typename Port>
+    void start(Port& port, uint32_t nowUs) {
+        if (running) return;
+        running = true;
+        leadingBreak = (breakMode != DMX_BREAK_ENCODED);
+        state = DMX_TX_WAIT;
+        nextFrameUs = nowUs + phaseOffsetUs;
+        port.arm(phaseOffsetUs);
+    }
+
+    // 停止后下一次定时器到期时不再重新定时
+    void stop() { running = false; }
+    bool isRunning() const { return running; }
+    DmxTxState getState() const { return state; }
+
+    template <typename Port>
+    void onTimer(Port& port, uint32_t nowUs) {
+        if (!running) {
+            if (state == DMX_TX_BREAK) port.breakEnd();
+            state = DMX_TX_IDLE;
+            return;
+        }
+
+        switch (state) {
+            case DMX_TX_WAIT: {
+                // 新数据提前唤醒：还没到线路允许的最早时刻时补足剩余时间
+                uint32_t dueUs = dueTimeUs();
+                if (stats.frames > 0 && (int32_t)(dueUs - nowUs) > 0) {
+                    port.arm(dueUs - nowUs);
+                    return;
+                }
+                // 上一帧的最后几个字节可能还在 FIFO 中
+                if (!port.txIdle()) {
+                    stats.busyRetries++;
+                    port.arm(TX_POLL_US);
+                    return;
+                }
+                beginFrame(nowUs);
+                if (breakMode != DMX_BREAK_TIMER && !leadingBreak) {
+                    // UART：上一帧末尾已经发出 Break 和 MAB；RMT：Break 和 MAB 在本帧波形的开头
+                    if (!trailingBreak()) {
+                        stats.lastBytes = port.sendFrame();
+                        leadingBreak = true;
+                        port.arm(nextDelay(nowUs, (uint32_t)stats.lastBytes * DMX_TX_BYTE_US));
+                        break;
+                    }
+                    uint16_t bytes = port.sendFrameWithBreak(getBreakBits());
+                    stats.lastBytes = bytes;
+                    port.arm(nextDelay(nowUs, frameTimeUs(bytes)));
+                    break;
+                }
+                port.breakBegin();
+                state = DMX_TX_BREAK;
+                port.arm(breakUs);
+                break;
+            }
+
+            case DMX_TX_BREAK:
+                port.breakEnd();
+                state = DMX_TX_MAB;
+                port.arm(mabUs);
+                break;
+
+            case DMX_TX_MAB:
+                if (breakMode != DMX_BREAK_TIMER && trailingBreak()) {
+                    uint16_t bytes = port.sendFrameWithBreak(getBreakBits());
+                    stats.lastBytes = bytes;
+                    leadingBreak = false;
+                    state = DMX_TX_WAIT;
+                    port.arm(nextDelay(nowUs, frameTimeUs(bytes)));
+                    break;
+                }
+                stats.lastBytes = port.sendFrame();
+                state = DMX_TX_WAIT;
+                port.arm(nextDelay(nowUs, (uint32_t)stats.lastBytes * DMX_TX_BYTE_US));
+                break;
+
+            default:
+                state = DMX_TX_IDLE;
+                break;
+        }
+    }
+
+    const DmxTxStats& getStats() const { return stats; }
+    void resetStats() {
+        stats.frames = 0;
+        stats.lastPeriodUs = 0;
+        stats.minPeriodUs = 0xFFFFFFFF;
+        stats.maxPeriodUs = 0;
+        stats.busyRetries = 0;
+        stats.lastBytes = 0;
+    }
+
+private:
+    DmxTxState state;
+    volatile bool running;
+    uint32_t breakUs;
+    uint32_t mabUs;
+    uint32_t periodUs;
+    uint32_t frameStartUs;
+    uint32_t nextFrameUs;       // 按名义周期推进，偶尔的定时延迟不会累积成漂移
+    uint32_t busyUntilUs;       // 本帧在线上发完的时刻
+    uint32_t phaseOffsetUs;
+    DmxBreakMode breakMode;
+    bool leadingBreak;          // 下一帧前需要软件 Break（启动后的第一帧，或上一帧没有帧尾 Break）
+    bool frameFresh;            // 本帧开始时有新数据
+    DmxTxStats stats;
+    DmxOutputScheduler scheduler;
+
+    // UART 硬件 Break 模式下本帧是否带帧尾 Break：按上一帧的长度（第一帧按整帧）估计本帧发完的时刻，
+    // 到下一帧预计开始的空闲不超过 MAX_IDLE_MAB_US。输入正按节奏到达（跟随输入且本帧是新数据）时
+    // 下一帧按输入间隔开始，其余按下一帧的定时。RMT 的 Break 在帧头，总是整段发送
+    bool trailingBreak() const {
+        if (breakMode != DMX_BREAK_UART) return true;
+        const DmxScheduleStats& sched = scheduler.getStats();
+        uint32_t expectedUs = sched.lastReason == DMX_SCHED_MATCH && frameFresh
+            ? frameStartUs + sched.inputPeriodUs
+            : nextFrameUs;
+        uint32_t busyUs = frameTimeUs(stats.lastBytes ? stats.lastBytes : FULL_FRAME_BYTES);
+        return (int32_t)(expectedUs - (frameStartUs + busyUs)) <= (int32_t)MAX_IDLE_MAB_US;
+    }
+
+    // 上一帧在线上发完、且满足最短帧间隔的时刻
+    uint32_t kickDueUs() const {
+        uint32_t earliestUs = frameStartUs + MIN_FRAME_US;
+        return (int32_t)(busyUntilUs - earliestUs) > 0 ? busyUntilUs : earliestUs;
+    }
+
+    // 下一帧的开始时刻：有待发的新数据时为线路允许的最早时刻
+    uint32_t dueTimeUs() const {
+        uint32_t dueUs = scheduler.wantsFrame() ? kickDueUs() : nextFrameUs;
+        return idleMabCapped(dueUs);
+    }
+
+    // 上一帧带了帧尾 Break 时线路停在 MAB 中：下一帧最晚在空闲达到 MAX_IDLE_MAB_US 时开始
+    uint32_t idleMabCapped(uint32_t dueUs) const {
+        if (breakMode != DMX_BREAK_UART || leadingBreak) return dueUs;
+        uint32_t latestUs = busyUntilUs + MAX_IDLE_MAB_US;
+        return (int32_t)(dueUs - latestUs) > 0 ? latestUs : dueUs;
+    }
+
+    // 下一帧不早于本帧在线上发完（busyUs 之后），也不早于刷新周期和最短帧间隔
+    uint32_t nextDelay(uint32_t nowUs, uint32_t busyUs) {
+        busyUntilUs = nowUs + busyUs;
+        uint32_t earliestUs = frameStartUs + MIN_FRAME_US;
+        if ((int32_t)(nextFrameUs - earliestUs) > 0) earliestUs = idleMabCapped(nextFrameUs);
+        return (int32_t)(earliestUs - (nowUs + busyUs)) > 0 ? earliestUs - nowUs : busyUs;
+    }
+
+    void beginFrame(uint32_t nowUs) {
+        if (stats.frames > 0) {
+            uint32_t period = nowUs - frameStartUs;
+            stats.lastPeriodUs = period;
+            if (period < stats.minPeriodUs) stats.minPeriodUs = period;
+            if (period > stats.maxPeriodUs) stats.maxPeriodUs = period;
+        }
+        // 早于名义时刻开始的帧是新数据提前唤醒的，下一帧从现在起算；
+        // 为限制 MAB 提前重发的帧不算，下一帧仍按原来的节奏
+        frameFresh = scheduler.wantsFrame();
+        bool early = frameFresh && stats.frames > 0 && (int32_t)(nextFrameUs - nowUs) > 0;
+        uint32_t nextPeriodUs = scheduler.onFrame(nowUs, periodUs, early);
+        stats.frames++;
+        frameStartUs = nowUs;
+
+        // 落后超过一个周期（帧比周期长或定时器被长时间推迟）时重新对齐
+        nextFrameUs = early ? nowUs + nextPeriodUs : nextFrameUs + nextPeriodUs;
+        if ((int32_t)(nowUs - nextFrameUs) > 0) {
+            nextFrameUs = nowUs + nextPeriodUs;
+        }
+    }
+};
@@ -3,17 +3,26 @@
 // 构造函数，初始化成员变量
 ESP32DMX::ESP32DMX(uart_port_t uartNum)
     : uartNum(uartNum)
+    , backend(DMX_BACKEND_UART)
+    , rmtChannel(RMT_CHANNEL_0)
+    , rmtEncoder(nullptr)
+    , inputMode(false)
+    , rxPin(GPIO_NUM_NC)
+    , rxQueue(nullptr)
+    , rxTask(nullptr)
+    , rxNotifyTask(nullptr)
     , enabled(false)
     , outputting(false)
     , transmitting(false)
-    , frameCount(0)
+    , minSlots(DMX_MIN_SLOTS)
+    , txTimer(nullptr)
+    , txLock(portMUX_INITIALIZER_UNLOCKED)
     , lastFrameTime(0)
-    , frameErrors(0) {
-    
-    // 初始化DMX缓冲区
-    memset(dmxBuffer, 0, DMX_BUFFER_SIZE);
-    dmxBuffer[0] = 0;  // DMX起始码
-    
+    , frameErrors(0)
+    , lastFrameCount(0)
+    , lastFrameRate(0)
+    , lastUpdate(0) {
+
     // 配置UART参数
     uart_config.baud_rate = DMX_BAUDRATE;
     uart_config.data_bits = UART_DATA_8_BITS;
@@ -25,7 +34,7 @@ ESP32DMX::ESP32DMX(uart_port_t uartNum)
 
 // 发送RDM数据
 void ESP32DMX::sendRDM(uint8_t* data, uint16_t length) {
-    if (!enabled || !data || length == 0) return;
+    if (!enabled || inputMode || backend != DMX_BACKEND_UART || !data || length == 0) return;
 
     // 保存当前状态
     bool wasOutputting = outputting;
@@ -33,13 +42,10 @@ void ESP32DMX::sendRDM(uint8_t* data, uint16_t length) {
         stopOutput();
     }
 
-    // 发送RDM帧
+    // 发送RDM帧：Break 不改波特率，无需再切换
     sendBreak(176);  // RDM break time = 176µs
     sendMAB();       // Mark After Break
 
-    // 设置RDM波特率 (250kbps)
-    uart_set_baudrate(uartNum, 250000);
-
     // 设置DE引脚为发送模式
     if (dirPin != GPIO_NUM_NC) {
         gpio_set_level(dirPin, 1);
@@ -57,9 +63,6 @@ void ESP32DMX::sendRDM(uint8_t* data, uint16_t length) {
         gpio_set_level(dirPin, 0);
     }
 
-    // 恢复DMX波特率
-    uart_set_baudrate(uartNum, DMX_BAUDRATE);
-
     // 恢复之前的状态
     if (wasOutputting) {
         startOutput();
@@ -86,8 +89,8 @@ bool ESP32DMX::begin(gpio_num_t txPin, gpio_num_t dirPin) {
         return false;
     }
 
-    // 安装UART驱动
-    err = uart_driver_install(uartNum, DMX_BUFFER_SIZE, 0, 0, NULL, 0);
+    // 安装UART驱动：发送环形缓冲能放下整帧，写入后由驱动的 TX 中断填充 FIFO
+    err = uart_driver_install(uartNum, DMX_BUFFER_SIZE, DMX_TX_BUFFER_SIZE, 0, NULL, 0);
     if (err != ESP_OK) {
         log_e("UART driver install failed");
         return false;
@@ -100,10 +103,234 @@ bool ESP32DMX::begin(gpio_num_t txPin, gpio_num_t dirPin) {
         return false;
     }
 
+    if (!createTimer()) {
+        return false;
+    }
+
+    // 硬件 Break：数据后自动发 Break，空闲 MAB 位长后再发下一帧
+    backend = DMX_BACKEND_UART;
+    tx.setHardwareBreak(DMX_HARDWARE_BREAK);
+    uart_set_tx_idle_num(uartNum, tx.getMabBits());
+
+    enabled = true;
+    return true;
+}
+
+// 初始化RMT通道：1 MHz 时钟，空闲电平为高（Mark），不使用载波
+bool ESP32DMX::beginRmt(gpio_num_t txPin, gpio_num_t dirPin, rmt_channel_t channel) {
+    this->txPin = txPin;
+    this->dirPin = dirPin;
+    rmtChannel = channel;
+
+    configurePins();
+
+    rmt_config_t config = {};
+    config.rmt_mode = RMT_MODE_TX;
+    config.channel = channel;
+    config.gpio_num = txPin;
+    config.clk_div = 80;                // APB 80 MHz / 80 = 1 us 每 tick
+    config.mem_block_num = 1;           // 帧比通道内存长，由驱动中断从 item 缓冲续填
+    config.tx_config.carrier_en = false;
+    config.tx_config.loop_en = false;
+    config.tx_config.idle_output_en = true;
+    config.tx_config.idle_level = RMT_IDLE_LEVEL_HIGH;
+
+    esp_err_t err = rmt_config(&config);
+    if (err != ESP_OK) {
+        log_e("RMT config failed");
+        return false;
+    }
+
+    err = rmt_driver_install(channel, 0, 0);
+    if (err != ESP_OK) {
+        log_e("RMT driver install failed");
+        return false;
+    }
+
+    if (!rmtEncoder) {
+        rmtEncoder = new DmxRmtEncoder();
+    }
+    rmtEncoder->setTiming(tx.getBreakUs(), tx.getMabUs());
+    rmtEncoder->invalidate();
+
+    if (!createTimer()) {
+        return false;
+    }
+
+    // Break / MAB 编码在每帧波形的开头，每帧唤醒一次
+    backend = DMX_BACKEND_RMT;
+    tx.setBreakMode(DMX_BREAK_ENCODED);
+
+    enabled = true;
+    return true;
+}
+
+// 初始化DMX输入：UART 只接收，Break 和数据通过事件队列交给接收任务
+bool ESP32DMX::beginInput(gpio_num_t rxPin, gpio_num_t dirPin) {
+    this->txPin = GPIO_NUM_NC;
+    this->rxPin = rxPin;
+    this->dirPin = dirPin;
+
+    // DE 低电平：收发器接收
+    configurePins();
+
+    esp_err_t err = uart_param_config(uartNum, &uart_config);
+    if (err != ESP_OK) {
+        log_e("UART config failed");
+        return false;
+    }
+
+    err = uart_driver_install(uartNum, DMX_RX_BUFFER_SIZE, 0, DMX_RX_QUEUE_SIZE, &rxQueue, 0);
+    if (err != ESP_OK) {
+        log_e("UART driver install failed");
+        return false;
+    }
+
+    err = uart_set_pin(uartNum, UART_PIN_NO_CHANGE, rxPin, UART_PIN_NO_CHANGE, UART_PIN_NO_CHANGE);
+    if (err != ESP_OK) {
+        log_e("UART pin config failed");
+        return false;
+    }
+
+    // 线路空闲 1 个字节时间就把 FIFO 交给任务，帧尾的通道在下一个 Break 之前到达
+    uart_set_rx_timeout(uartNum, 1);
+    uart_set_rx_full_threshold(uartNum, DMX_RX_FIFO_THRESHOLD);
+
+    rxFramer.reset();
+
+#if DMX_RX_TIMING
+    // Break / MAB 测量：边沿中断平时关闭，一帧收齐后才打开
+    gpio_install_isr_service(0);    // 已安装时返回错误，可以忽略
+    gpio_set_intr_type(rxPin, GPIO_INTR_ANYEDGE);
+    gpio_isr_handler_add(rxPin, &ESP32DMX::rxEdgeIsr, this);
+    gpio_intr_disable(rxPin);
+#endif
+
+    BaseType_t created = xTaskCreatePinnedToCore(&ESP32DMX::rxTaskEntry, "dmx_rx", DMX_RX_TASK_STACK_SIZE,
+                                                 this, DMX_RX_TASK_PRIORITY, &rxTask, 0);
+    if (created != pdPASS) {
+        log_e("DMX RX task create failed");
+        return false;
+    }
+
+    inputMode = true;
     enabled = true;
     return true;
 }
 
+// 接收任务：只处理 UART 事件，不做网络发送
+void ESP32DMX::rxTaskEntry(void* arg) {
+    ESP32DMX* dmx = static_cast<ESP32DMX*>(arg);
+    uart_event_t event;
+    while (true) {
+        if (xQueueReceive(dmx->rxQueue, &event, portMAX_DELAY) == pdTRUE) {
+            dmx->handleRxEvent(event);
+        }
+    }
+}
+
+void ESP32DMX::handleRxEvent(const uart_event_t& event) {
+    switch (event.type) {
+        case UART_DATA:
+            drainRx();
+#if DMX_RX_TIMING
+            if (!rxSniffer.isArmed() && rxFramer.captureComplete()) {
+                armBreakSniffer();
+            }
+#endif
+            break;
+
+        case UART_BREAK: {
+            // 驱动缓冲中的数据属于上一帧。Break 产生的 0x00 还在硬件 FIFO 中（驱动处理 Break
+            // 中断时不读 FIFO），后面可能已经跟着下一帧的起始码和通道：不能清空 FIFO，
+            // 只让分帧器丢掉下一批数据开头的这一个字节
+            drainRx();
+
+            uint32_t breakUs, mabUs;
+            if (rxSniffer.take(breakUs, mabUs)) {
+                rxFramer.onTiming(breakUs, mabUs);
+            }
+
+            uint32_t published = rxFramer.getStats().frames;
+            rxFramer.onBreak((uint32_t)esp_timer_get_time());
+            rxFramer.dropBreakByte();
+            TaskHandle_t notify = rxNotifyTask;
+            if (notify && rxFramer.getStats().frames != published) {
+                xTaskNotifyGive(notify);
+            }
+            break;
+        }
+
+        case UART_FIFO_OVF:
+        case UART_BUFFER_FULL:
+            uart_flush_input(uartNum);
+            xQueueReset(rxQueue);
+            rxFramer.onError();
+            break;
+
+        case UART_FRAME_ERR:
+        case UART_PARITY_ERR:
+            rxFramer.onError();
+            break;
+
+        default:
+            break;
+    }
+}
+
+// 把驱动缓冲中已有的字节追加到采集缓冲
+void ESP32DMX::drainRx() {
+    uint8_t chunk[128];
+    size_t buffered = 0;
+    uart_get_buffered_data_len(uartNum, &buffered);
+    while (buffered > 0) {
+        int length = uart_read_bytes(uartNum, chunk, buffered < sizeof(chunk) ? buffered : sizeof(chunk), 0);
+        if (length <= 0) break;
+        rxFramer.onData(chunk, length);
+        buffered -= length;
+    }
+}
+
+void ESP32DMX::armBreakSniffer() {
+    rxSniffer.arm();
+    gpio_intr_enable(rxPin);
+}
+
+// RX 引脚边沿：Break 下降沿、Break 结束、起始码下降沿，测完即关闭中断
+void IRAM_ATTR ESP32DMX::rxEdgeIsr(void* arg) {
+    ESP32DMX* dmx = static_cast<ESP32DMX*>(arg);
+    if (dmx->rxSniffer.onEdge(gpio_get_level(dmx->rxPin), (uint32_t)esp_timer_get_time())) {
+        gpio_intr_disable(dmx->rxPin);
+    }
+}
+
+// 发送定时器
+bool ESP32DMX::createTimer() {
+    esp_timer_create_args_t timerArgs = {};
+    timerArgs.callback = &ESP32DMX::txTimerCallback;
+    timerArgs.arg = this;
+    timerArgs.dispatch_method = ESP_TIMER_TASK;
+    timerArgs.name = "dmx_tx";
+    esp_err_t err = esp_timer_create(&timerArgs, &txTimer);
+    if (err != ESP_OK) {
+        log_e("DMX timer create failed");
+        return false;
+    }
+    return true;
+}
+
+// 修改 Break / MAB 长度，下一帧生效
+void ESP32DMX::setBreakTiming(uint32_t breakUs, uint32_t mabUs) {
+    tx.setTiming(breakUs, mabUs);
+    if (!enabled) return;
+    if (backend == DMX_BACKEND_RMT) {
+        // 只改写 item 0，下一帧随帧一起发出
+        rmtEncoder->setTiming(tx.getBreakUs(), tx.getMabUs());
+    } else {
+        uart_set_tx_idle_num(uartNum, tx.getMabBits());
+    }
+}
+
 // 配置GPIO引脚
 void ESP32DMX::configurePins() {
     gpio_config_t io_conf = {};
@@ -120,101 +347,204 @@ void ESP32DMX::configurePins() {
 
 // 启动DMX输出
 void ESP32DMX::startOutput() {
-    if (!enabled) return;
+    if (!enabled || outputting || inputMode) return;
     
     gpio_set_level(dirPin, 1);  // 设置为输出模式
     outputting = true;
+
+    TxPort port = {*this};
+    portENTER_CRITICAL(&txLock);
+    tx.start(port, (uint32_t)esp_timer_get_time());
+    portEXIT_CRITICAL(&txLock);
 }
 
 // 停止DMX输出
 void ESP32DMX::stopOutput() {
-    if (!enabled) return;
+    if (!enabled || !outputting) return;
+
+    // 先让状态机停下，再停定时器；回调中检查 running 与重新定时在同一临界区内
+    portENTER_CRITICAL(&txLock);
+    tx.stop();
+    esp_timer_stop(txTimer);
+    portEXIT_CRITICAL(&txLock);
+    if (backend == DMX_BACKEND_RMT) {
+        rmt_wait_tx_done(rmtChannel, pdMS_TO_TICKS(30));
+    } else {
+        uart_set_line_inverse(uartNum, UART_SIGNAL_INV_DISABLE);
+        uart_wait_tx_done(uartNum, pdMS_TO_TICKS(30));
+    }
     
     gpio_set_level(dirPin, 0);  // 设置为接收模式
     outputting = false;
 }
 
-// 设置DMX通道数据
-void ESP32DMX::setChannel(uint16_t channel, uint8_t value) {
-    if (validateChannel(channel)) {
-        dmxBuffer[channel] = value;
+// 定时器回调（esp_timer 任务）：推进一步状态机
+void ESP32DMX::txTimerCallback(void* arg) {
+    ESP32DMX* dmx = static_cast<ESP32DMX*>(arg);
+    TxPort port = {*dmx};
+    portENTER_CRITICAL(&dmx->txLock);
+    bool running = dmx->tx.isRunning();
+    portEXIT_CRITICAL(&dmx->txLock);
+    if (!running) return;
+    dmx->tx.onTimer(port, (uint32_t)esp_timer_get_time());
+}
+
+bool ESP32DMX::TxPort::txIdle() {
+    if (dmx.backend == DMX_BACKEND_RMT) {
+        return rmt_wait_tx_done(dmx.rmtChannel, 0) == ESP_OK;
+    }
+    return uart_wait_tx_done(dmx.uartNum, 0) == ESP_OK;
+}
+
+// Break：反相 TX 输出，空闲的高电平变为低电平
+void ESP32DMX::TxPort::breakBegin() {
+    uart_set_line_inverse(dmx.uartNum, UART_SIGNAL_TXD_INV);
+}
+
+void ESP32DMX::TxPort::breakEnd() {
+    uart_set_line_inverse(dmx.uartNum, UART_SIGNAL_INV_DISABLE);
+}
+
+// 帧边界：取最新的完整帧，发送期间网络任务写入的是另一块缓冲
+uint16_t ESP32DMX::TxPort::sendFrame() {
+    dmx.frames.acquire();
+    const DmxFrame& frame = dmx.frames.front();
+    uint16_t bytes = frame.activeSlots(dmx.minSlots) + 1;
+    uart_write_bytes(dmx.uartNum, (const char*)frame.data, bytes);
+    dmx.lastFrameTime = millis();
+    return bytes;
+}
+
+// UART：数据之后由 UART 发出 Break，随后的 tx_idle_num 空闲即下一帧的 MAB
+// RMT：上一帧已发完，item 缓冲空闲；只重新编码与上一帧不同的通道，驱动中断从缓冲续填
+uint16_t ESP32DMX::TxPort::sendFrameWithBreak(uint32_t breakBits) {
+    dmx.frames.acquire();
+    const DmxFrame& frame = dmx.frames.front();
+    uint16_t bytes = frame.activeSlots(dmx.minSlots) + 1;
+    if (dmx.backend == DMX_BACKEND_RMT) {
+        dmx.rmtEncoder->encode(frame.data, bytes);
+        rmt_write_items(dmx.rmtChannel, (const rmt_item32_t*)dmx.rmtEncoder->items(),
+                        dmx.rmtEncoder->itemCount(), false);
+    } else {
+        uart_write_bytes_with_break(dmx.uartNum, (const char*)frame.data, bytes, breakBits);
+    }
+    dmx.lastFrameTime = millis();
+    return bytes;
+}
+
+void ESP32DMX::setMinimumSlots(uint16_t slots) {
+    if (slots < 1) slots = 1;
+    if (slots > DMX_SLOT_COUNT) slots = DMX_SLOT_COUNT;
+    minSlots = slots;
+}
+
+// 与 commitFrame() 互斥：在这里重新检查待发的新数据，回调计算延迟之后才提交的帧也不会被推迟
+void ESP32DMX::TxPort::arm(uint32_t delayUs) {
+    portENTER_CRITICAL(&dmx.txLock);
+    if (dmx.tx.isRunning()) {
+        esp_timer_start_once(dmx.txTimer, dmx.tx.armDelay(delayUs, (uint32_t)esp_timer_get_time()));
     }
+    portEXIT_CRITICAL(&dmx.txLock);
 }
 
 // 获取DMX通道数据
 uint8_t ESP32DMX::getChannel(uint16_t channel) const {
     if (validateChannel(channel)) {
-        return dmxBuffer[channel];
+        return frames.front().data[channel];
     }
     return 0;
 }
 
-// 清空DMX通道数据
-void ESP32DMX::clearChannels() {
-    memset(dmxBuffer + 1, 0, DMX_BUFFER_SIZE - 1);
-}
-
-// 开始DMX帧
-void ESP32DMX::startFrame() {
-    if (!enabled || !outputting) return;
-    
-    sendBreak(DMX_BREAK_US);
-    sendMAB();
+// 写入通道数据
+uint16_t ESP32DMX::writeSlots(const uint8_t* data, uint16_t length, uint16_t startSlot) {
+    return frames.writeSlots(data, length, startSlot, transform);
 }
 
-// 结束DMX帧
-void ESP32DMX::endFrame() {
-    if (!enabled || !outputting) return;
-    
-    waitForTransmitComplete();
-    frameCount++;
-    lastFrameTime = millis();
+// 发布后台帧，DMX任务在下一个帧边界取用。跟随输入 / 保活模式下把等待中的下一帧提前；
+// 定时器回调正在执行时 esp_timer_stop 失败，由回调中的 arm() 取用新数据
+bool ESP32DMX::commitFrame() {
+    if (!frames.commit(transform)) return false;
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    portENTER_CRITICAL(&txLock);
+    if (tx.onInput(now) && esp_timer_stop(txTimer) == ESP_OK) {
+        esp_timer_start_once(txTimer, tx.armDelay(DmxOutputScheduler::MAX_KEEPALIVE_US, now));
+    }
+    portEXIT_CRITICAL(&txLock);
+    return true;
 }
 
-// 发送Break信号
+// 发送Break信号（RDM）：反相 TX 输出拉低线路，不再切换波特率
 void ESP32DMX::sendBreak(uint32_t breakTime) {
-    uart_set_baudrate(uartNum, 1000000 / breakTime);
-    uart_write_bytes(uartNum, "\0", 1);
+    if (backend != DMX_BACKEND_UART) return;
     uart_wait_tx_done(uartNum, portMAX_DELAY);
-    uart_set_baudrate(uartNum, DMX_BAUDRATE);
+    uart_set_line_inverse(uartNum, UART_SIGNAL_TXD_INV);
+    delayMicroseconds(breakTime);
+    uart_set_line_inverse(uartNum, UART_SIGNAL_INV_DISABLE);
 }
 
 // 发送MAB信号
 void ESP32DMX::sendMAB() {
-    delayMicroseconds(DMX_MAB_US);
+    delayMicroseconds(tx.getMabUs());
 }
 
-// 更新DMX数据
+// 每秒统计一次实际帧率
 void ESP32DMX::update() {
     if (!enabled || !outputting) return;
 
-    startFrame();
-    write(dmxBuffer, DMX_BUFFER_SIZE);
-    endFrame();
+    uint32_t now = millis();
+    if (now - lastUpdate >= 1000) {
+        uint32_t frames = tx.getStats().frames;
+        lastFrameRate = (frames - lastFrameCount) * 1000.0f / (now - lastUpdate);
+        lastFrameCount = frames;
+        lastUpdate = now;
+    }
 }
 
 // 等待传输完成
 void ESP32DMX::waitForTransmitComplete() {
+    if (backend == DMX_BACKEND_RMT) {
+        rmt_wait_tx_done(rmtChannel, portMAX_DELAY);
+        return;
+    }
     uart_wait_tx_done(uartNum, portMAX_DELAY);
 }
 
 // 验证通道号是否合法
 bool ESP32DMX::validateChannel(uint16_t channel) const {
-    return channel < DMX_BUFFER_SIZE;
+    return channel > 0 && channel <= DMX_SLOT_COUNT;
 }
 
 // 结束DMX
 void ESP32DMX::end() {
     if (enabled) {
         stopOutput();
-        uart_driver_delete(uartNum);
+        if (txTimer) {
+            esp_timer_delete(txTimer);
+            txTimer = nullptr;
+        }
+        if (inputMode) {
+            vTaskDelete(rxTask);
+            rxTask = nullptr;
+#if DMX_RX_TIMING
+            gpio_intr_disable(rxPin);
+            gpio_isr_handler_remove(rxPin);
+#endif
+            uart_driver_delete(uartNum);
+            inputMode = false;
+        } else if (backend == DMX_BACKEND_RMT) {
+            rmt_driver_uninstall(rmtChannel);
+        } else {
+            uart_driver_delete(uartNum);
+        }
         enabled = false;
     }
+    delete rmtEncoder;
+    rmtEncoder = nullptr;
 }
 
 // 实现write函数
-void ESP32DMX::write(uint8_t* data, uint16_t length) {
-    if (enabled) {
+void ESP32DMX::write(const uint8_t* data, uint16_t length) {
+    if (enabled && backend == DMX_BACKEND_UART) {
         uart_write_bytes(uartNum, (const char*)data, length);
     }
 }
\ No newline at end of file
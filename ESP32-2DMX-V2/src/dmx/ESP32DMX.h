@@ -3,16 +3,28 @@
 #include <Arduino.h>
 #include <driver/uart.h>
 #include <driver/gpio.h>
+#include <driver/rmt.h>
 #include <freertos/FreeRTOS.h>
 #include <freertos/task.h>
 #include <freertos/queue.h>
+#include <esp_timer.h>
 #include "config.h"  // 包含配置文件
+#include "DmxFrameBuffer.h"
+#include "DmxTxStateMachine.h"
+#include "DmxRmtEncoder.h"
+#include "DmxRxFramer.h"
 
 #define DMX_MAX_CHANNELS 512  // 定义DMX的最大通道数
 #ifndef DMX_BUFFER_SIZE
 #define DMX_BUFFER_SIZE (DMX_MAX_CHANNELS + 1)  // 仅当未定义时才定义
 #endif
 
+// 输出后端：UART 数量有限（ESP32 上可用两个），RMT 通道可以驱动更多宇宙
+enum DmxBackend : uint8_t {
+    DMX_BACKEND_UART = 0,
+    DMX_BACKEND_RMT
+};
+
 class ESP32DMX {
 public:
     ESP32DMX(uart_port_t uartNum = UART_NUM_1);
@@ -24,67 +36,134 @@ public:
     static const uint32_t DMX_MAB_US = 12;
 
     void end();
-    void update();
+    void update();      // 刷新统计；发送由定时器驱动，不在调用方任务中进行
 
     // RDM相关方法
     void sendRDM(uint8_t* data, uint16_t length);
     void sendBreak(uint32_t breakTime = 176); // 默认176微秒
     void sendMAB();  // 声明sendMAB函数
+
+    // 每个端口独立的 Break / MAB 长度（微秒），由 UART 硬件按位时间生成
+    void setBreakTiming(uint32_t breakUs, uint32_t mabUs);
+    uint32_t getBreakUs() const { return tx.getBreakUs(); }
+    uint32_t getMabUs() const { return tx.getMabUs(); }
     bool begin(gpio_num_t txPin, gpio_num_t dirPin);
-    void write(uint8_t* data, uint16_t length);  // 声明write函数
+    // RMT 后端：Break / MAB / 通道预先编码成 RMT item，只重新编码变化的通道。不支持 RDM
+    bool beginRmt(gpio_num_t txPin, gpio_num_t dirPin, rmt_channel_t channel);
+    DmxBackend getBackend() const { return backend; }
+
+    // DMX 输入：rxPin 接 RS-485 收发器的 RO，dirPin 保持低电平（接收）。
+    // 接收任务按 Break 分帧，完整的帧交给网络任务；输入端口不发送
+    bool beginInput(gpio_num_t rxPin, gpio_num_t dirPin);
+    bool isInput() const { return inputMode; }
+    bool acquireInputFrame() { return rxFramer.acquire(); }
+    bool hasInputFrame() const { return rxFramer.hasNewFrame(); }
+    const DmxFrame& getInputFrame() const { return rxFramer.front(); }
+    const DmxRxStats& getRxStats() const { return rxFramer.getStats(); }
+    float getInputRate() const { return rxFramer.refreshHz(); }     // 输入的刷新率
+    // 每收到一帧通知该任务（xTaskNotifyGive）
+    void setInputNotifyTask(TaskHandle_t task) { rxNotifyTask = task; }
+    void write(const uint8_t* data, uint16_t length);  // 直接写入UART
     void clearBuffer();
 
     // 获取DMX数据的方法
-    uint8_t* getDMXData() { return buffer + 1; }  // +1 跳过起始码
+    const uint8_t* getDMXData() const { return frames.front().slots(); }  // 跳过起始码
+    const DmxFrame& getFrame() const { return frames.front(); }
+
+    // 网络任务：把通道数据直接写入后台帧（唯一一次拷贝），commitFrame() 后对 DMX 任务可见
+    uint16_t writeSlots(const uint8_t* data, uint16_t length, uint16_t startSlot = 0);
+    bool commitFrame();
+
+    // 输出曲线和 16 位细调通道：在写入后台帧的同一遍中完成，配置变化时重建区间表。
+    // 通道号从 0 起，配置应在输出开始前或同一任务中设置
+    bool setCurve(uint16_t startSlot, uint16_t count, DmxCurve curve) { return transform.setCurve(startSlot, count, curve); }
+    bool addFineChannel(uint16_t coarseSlot, bool interpolate) { return transform.addFineChannel(coarseSlot, interpolate); }
+    void clearTransform() { transform.clear(); }
+    const DmxOutputTransform& getTransform() const { return transform; }
 
-    // DMX控制
+    // DMX控制：startOutput() 后按刷新率持续发送最新的帧（没有新帧时重复上一帧）
     void startOutput();
     void stopOutput();
     bool isOutputting() const { return outputting; }
-
-    // DMX数据操作
-    void setChannel(uint16_t channel, uint8_t value);
+    // 每个端口独立的定时器：各自的刷新率，相位错开后多个端口并行发送
+    void setRefreshRate(uint32_t hz) { tx.setRefreshRate(hz); }
+    uint32_t getRefreshPeriodUs() const { return tx.getPeriodUs(); }
+    void setPhaseOffset(uint32_t offsetUs) { tx.setPhaseOffset(offsetUs); }
+    uint32_t getPhaseOffset() const { return tx.getPhaseOffset(); }
+    const DmxTxStats& getTxStats() const { return tx.getStats(); }
+
+    // 刷新策略：固定刷新率 / 跟随输入帧率 / 只在变化时发送 + 保活。后两种模式下
+    // commitFrame() 提前唤醒等待中的定时器，输入空闲时只按保活频率发送
+    void setRefreshMode(DmxRefreshMode mode) { tx.getScheduler().setMode(mode); }
+    DmxRefreshMode getRefreshMode() const { return tx.getScheduler().getMode(); }
+    void setKeepaliveRate(uint32_t hz) { tx.getScheduler().setKeepaliveRate(hz); }
+    void setSourceIdleTimeout(uint32_t ms) { tx.getScheduler().setIdleTimeout(ms * 1000); }
+    const DmxScheduleStats& getScheduleStats() const { return tx.getScheduler().getStats(); }
+    float getSourceRate() const { return tx.getScheduler().inputHz(); }     // 提交新帧的频率
+    float getFrameRate() const { return lastFrameRate; }   // 最近一秒实际发出的帧率
+
+    // 有效通道数：只发送到收到过的最高通道，短宇宙的帧更短、刷新更快。
+    // 部分灯具要求至少 24 个通道，最少发送 minSlots 个
+    void setMinimumSlots(uint16_t slots);
+    uint16_t getMinimumSlots() const { return minSlots; }
+    uint16_t getActiveSlots() const { return frames.front().activeSlots(minSlots); }
+    float getMaxRefreshRate() const { return tx.maxRefreshHz(); }
+    float getRefreshGain() const { return tx.refreshGain(); }      // 相对 512 通道整帧
+
+    // DMX数据操作：写入只经 writeSlots() + commitFrame()（网络任务），这里只读 DMX 任务正在发送的帧
     uint8_t getChannel(uint16_t channel) const;
-    void clearChannels();
-
-    // DMX帧控制
-    void startFrame();
-    void endFrame();
-    bool write(const uint8_t* data, size_t length);
 
     // 状态查询
     bool isEnabled() const { return enabled; }
-    uint32_t getFrameCount() const { return frameCount; }
+    uint32_t getFrameCount() const { return tx.getStats().frames; }
     uint32_t getLastFrameTime() const { return lastFrameTime; }
 
 private:
     uart_port_t uartNum;
+    DmxBackend backend;
+    rmt_channel_t rmtChannel;
+    DmxRmtEncoder* rmtEncoder;      // 仅 RMT 后端分配（约 12 KB）
     gpio_num_t txPin;
     gpio_num_t dirPin;
     uart_config_t uart_config;
 
-    uint8_t buffer[DMX_MAX_CHANNELS + 1];  // +1 for start code
+    // DMX 输入
+    bool inputMode;
+    gpio_num_t rxPin;
+    QueueHandle_t rxQueue;
+    TaskHandle_t rxTask;
+    volatile TaskHandle_t rxNotifyTask;
+    DmxRxFramer rxFramer;
+    DmxBreakSniffer rxSniffer;
 
     // 状态标志
     bool enabled;
     bool outputting;
     volatile bool transmitting;
 
-    // DMX缓冲区
-    uint8_t dmxBuffer[DMX_BUFFER_SIZE];
+    // DMX输出帧：三缓冲，网络任务写、发送定时器读
+    DmxFrameBuffer frames;
+    DmxOutputTransform transform;
+
+    uint16_t minSlots;
+
+    // 发送状态机，由 esp_timer 回调推进
+    DmxTxStateMachine tx;
+    esp_timer_handle_t txTimer;
+    portMUX_TYPE txLock;
 
     // 统计信息
-    uint32_t frameCount;
     uint32_t lastFrameTime;
     uint32_t frameErrors;
 
     // 性能统计
     uint32_t lastFrameCount;
-    uint32_t lastFrameRate;
+    float lastFrameRate;
     uint32_t lastUpdate;
 
     // 内部方法
     void configurePins();
+    bool createTimer();
     void waitForTransmitComplete();
     bool validateChannel(uint16_t channel) const;  // 声明validateChannel函数
 
@@ -92,7 +171,22 @@ private:
     ESP32DMX(const ESP32DMX&) = delete;
     ESP32DMX& operator=(const ESP32DMX&) = delete;
 
-    // UART中断处理
-    static void IRAM_ATTR uartEventHandler(void *arg);
-    void handleUARTEvent(uart_event_t& event);
+    // 状态机使用的硬件操作
+    struct TxPort {
+        ESP32DMX& dmx;
+        bool txIdle();
+        void breakBegin();
+        void breakEnd();
+        uint16_t sendFrame();
+        uint16_t sendFrameWithBreak(uint32_t breakBits);
+        void arm(uint32_t delayUs);
+    };
+
+    static void txTimerCallback(void* arg);
+
+    static void rxTaskEntry(void* arg);
+    static void rxEdgeIsr(void* arg);
+    void handleRxEvent(const uart_event_t& event);
+    void drainRx();
+    void armBreakSniffer();
 };
\ No newline at end of file
@@ -0,0 +1,64 @@
+#pragma once
+
+// 无锁三缓冲（纯 C++，主机和 ESP32 通用）
+//
+// 单写者 / 单读者：
+//   写者在 writeBuffer() 中填好完整一帧后调用 publish()
+//   读者在帧边界调用 consume()，有新帧时切换到最新的一帧
+// 两端都只做一次原子交换，互不等待；读者拿到的永远是完整的帧。
+
+#include <stdint.h>
+#include <atomic>
+
+template <typename T>
+class TripleBuffer {
+public:
+    TripleBuffer()
+        : state(1)
+        , writeIndex(0)
+        , readIndex(2)
+        , publishedIndex(2) {
+    }
+
+    // ---- 写者端 ----
+    T& writeBuffer() { return buffers[writeIndex]; }
+
+    // 最近一次发布的帧；在写者下一次 publish() 之前内容保持不变
+    const T& lastPublished() const { return buffers[publishedIndex]; }
+
+    // 返回 true 表示上一次发布的帧读者还没取走，被这一帧替换
+    bool publish() {
+        publishedIndex = writeIndex;
+        uint32_t previous = state.exchange(writeIndex | FRESH_BIT, std::memory_order_acq_rel);
+        writeIndex = previous & INDEX_MASK;
+        return (previous & FRESH_BIT) != 0;
+    }
+
+    // ---- 读者端 ----
+    bool hasNewFrame() const {
+        return (state.load(std::memory_order_relaxed) & FRESH_BIT) != 0;
+    }
+
+    // 有新帧时切换读缓冲并返回 true
+    bool consume() {
+        if (!hasNewFrame()) return false;
+        uint32_t previous = state.exchange(readIndex, std::memory_order_acq_rel);
+        readIndex = previous & INDEX_MASK;
+        return true;
+    }
+
+    const T& readBuffer() const { return buffers[readIndex]; }
+
+    // 初始化用：只能在两端都未开始工作时调用
+    T& at(uint8_t index) { return buffers[index]; }
+
+private:
+    static const uint32_t INDEX_MASK = 0x03;
+    static const uint32_t FRESH_BIT = 0x04;
+
+    T buffers[3];
+    std::atomic<uint32_t> state;   // 中间缓冲的索引 + 是否有未读的新帧
+    uint8_t writeIndex;            // 只由写者访问
+    uint8_t readIndex;             // 只由读者访问
+    uint8_t publishedIndex;        // 只由写者访问
+};
@@ -76,16 +76,17 @@ bool setupHardware();
 bool createTasks();
 bool startAPMode();
 void loadConfig();
-void validatePacket(uint8_t* dmxAData, uint8_t* dmxBData);
+void validatePacket(const uint8_t* dmxAData, const uint8_t* dmxBData);
 void stringToIP(const char* str, uint8_t* ip);
 
 
 // DMX处理任务
 void dmxTaskFunction(void *parameter) {
-    const TickType_t xDelay = pdMS_TO_TICKS(1);
+    const TickType_t xDelay = pdMS_TO_TICKS(DMX_STATS_INTERVAL_MS);
     
     while (true) {
         esp_task_wdt_reset();
+        // 两个端口由各自的定时器并行发送，这里只刷新帧率统计，不再每毫秒唤醒
         dmxA.update();
         dmxB.update();
         rdmHandler.update();
@@ -102,11 +103,16 @@ void networkTaskFunction(void *parameter) {
         validatePacket(dmxA.getDMXData(), dmxB.getDMXData());
         if (artnetNode) artnetNode->update();
         if (webServer) webServer->update();
-        vTaskDelay(xDelay);
+        // 事件接收模式下由 lwIP 回调唤醒，不再每毫秒轮询
+        if (artnetNode) {
+            artnetNode->waitForPacket(ARTNET_RX_WAIT_MS);
+        } else {
+            vTaskDelay(xDelay);
+        }
     }
 }
 
-void validatePacket(uint8_t* dmxAData, uint8_t* dmxBData) {
+void validatePacket(const uint8_t* dmxAData, const uint8_t* dmxBData) {
     // 数据包验证逻辑
 }
 
@@ -179,13 +185,12 @@ bool initializeSystem() {
 
     esp_task_wdt_reset();  // 喂狗
 
-    // 配置管理
+    // 配置管理：读入全局 config，后面的网络和硬件初始化都用它
     Serial.println("Loading configuration...");
-    ConfigManager::Config configData;
-    if (!ConfigManager::load(configData)) {
+    if (!ConfigManager::load(config)) {
         Serial.println("Warning: Failed to load configuration, setting defaults");
-        ConfigManager::setDefaults(configData);
-        if (!ConfigManager::save(configData)) {
+        ConfigManager::setDefaults(config);
+        if (!ConfigManager::save(config)) {
             Serial.println("System initialization failed at: Default Config Save");
             return false;
         }
@@ -215,8 +220,8 @@ bool initializeSystem() {
 
     // 更新像素配置
     Serial.println("Initializing pixel configuration...");
-    pixels.updateLength(configData.pixelCount);
-    pixels.updateType(static_cast<neoPixelType>(configData.pixelType));
+    pixels.updateLength(config.pixelCount);
+    pixels.updateType(static_cast<neoPixelType>(config.pixelType));
     Serial.println("Pixel configuration updated");
 
     // 创建Art-Net节点
@@ -278,17 +283,56 @@ bool setupNetwork() {
 }
 
 bool setupHardware() {
-    // 初始化DMX
-    dmxA.begin(DMX_TX_A_PIN, DMX_DIR_A_PIN);
-    dmxB.begin(DMX_TX_B_PIN, DMX_DIR_B_PIN);
-
-    // 配置Art-Net
-    ArtnetNode::Config artnetConfig = {
-        .net = config.artnetNet,
-        .subnet = config.artnetSubnet,
-        .universe = config.artnetUniverse,
-        .dmxStartAddress = config.dmxStartAddress
-    };
+    // 初始化DMX：每个端口可单独选择 UART 或 RMT 后端，或作为输入
+    ESP32DMX* dmxPorts[DMX_PORT_COUNT] = {&dmxA, &dmxB};
+    const gpio_num_t txPins[DMX_PORT_COUNT] = {DMX_TX_A_PIN, DMX_TX_B_PIN};
+    const gpio_num_t rxPins[DMX_PORT_COUNT] = {DMX_RX_A_PIN, DMX_RX_B_PIN};
+    const gpio_num_t dirPins[DMX_PORT_COUNT] = {DMX_DIR_A_PIN, DMX_DIR_B_PIN};
+    const bool useRmt[DMX_PORT_COUNT] = {DMX_PORT_A_RMT, DMX_PORT_B_RMT};
+    const uint8_t rmtChannels[DMX_PORT_COUNT] = {DMX_RMT_CHANNEL_A, DMX_RMT_CHANNEL_B};
+    for (uint8_t port = 0; port < DMX_PORT_COUNT; port++) {
+        if (DMX_INPUT_ENABLED && port == DMX_INPUT_PORT) {
+            dmxPorts[port]->beginInput(rxPins[port], dirPins[port]);
+        } else if (useRmt[port]) {
+            dmxPorts[port]->beginRmt(txPins[port], dirPins[port], (rmt_channel_t)rmtChannels[port]);
+        } else {
+            dmxPorts[port]->begin(txPins[port], dirPins[port]);
+        }
+    }
+
+    // 定时器驱动刷新，DMX 任务不再阻塞在发送上；两个端口并行发送，帧起点错开半个周期。
+    // 刷新周期按策略跟随各端口的输入帧率，输入空闲时降到保活频率
+    for (uint8_t port = 0; port < DMX_PORT_COUNT; port++) {
+        if (dmxPorts[port]->isInput()) continue;
+        dmxPorts[port]->setRefreshRate(DMX_REFRESH_HZ);
+        dmxPorts[port]->setRefreshMode((DmxRefreshMode)DMX_REFRESH_MODE);
+        dmxPorts[port]->setKeepaliveRate(DMX_KEEPALIVE_HZ);
+        dmxPorts[port]->setSourceIdleTimeout(DMX_SOURCE_IDLE_MS);
+        dmxPorts[port]->setPhaseOffset(port * DMX_PHASE_OFFSET_US);
+        // 响应曲线和细调通道：只在这里配置一次，查找表不在输出路径上重建
+        dmxPorts[port]->setCurve(0, DMX_SLOT_COUNT, (DmxCurve)DMX_OUTPUT_CURVE);
+        if (DMX_FINE_CHANNEL > 0) {
+            dmxPorts[port]->addFineChannel(DMX_FINE_CHANNEL - 1, DMX_FINE_INTERPOLATE);
+        }
+        dmxPorts[port]->startOutput();
+    }
+
+    // 配置Art-Net：在默认配置基础上覆盖，保证未设置的字段有效
+    ArtnetNode::Config artnetConfig = artnetNode->getConfig();
+    artnetConfig.net = config.artnetNet;
+    artnetConfig.subnet = config.artnetSubnet;
+    artnetConfig.universe = config.artnetUniverse;
+    artnetConfig.dmxStartAddress = config.dmxStartAddress;
+    artnetConfig.dmxMode = 1;  // 双端口：DMX A / DMX B 各占一个宇宙
+    artnetConfig.pixelCount = config.pixelEnabled ? config.pixelCount : 0;
+    artnetConfig.dhcp = config.dhcpEnabled;
+    for (uint8_t port = 0; port < DMX_PORT_COUNT; port++) {
+        if (dmxPorts[port]->isInput()) {
+            artnetNode->attachDmxInput(port, dmxPorts[port]);
+        } else {
+            artnetNode->attachDmxOutput(port, dmxPorts[port]);
+        }
+    }
     artnetNode->setConfig(artnetConfig);
     
     if (!artnetNode->begin()) {
@@ -300,13 +344,22 @@ bool setupHardware() {
     if (config.pixelEnabled) {
         pixels.begin();
         pixels.setBrightness(config.brightness);
-        if (!pixelDriver.begin(PIXEL_PIN, PIXEL_COUNT)) {
+        pixelDriver.setTargetFps(PIXEL_RENDER_FPS);
+        pixelDriver.setSource((PixelSource)PIXEL_RENDER_SOURCE);
+        pixelDriver.setDmxIdle(PIXEL_DMX_IDLE_MS);
+        const gpio_num_t stripPins[] = PIXEL_STRIP_PINS;
+        const uint16_t stripPixels[] = PIXEL_STRIP_PIXELS;
+        bool pixelsReady = PIXEL_STRIP_COUNT > 1
+            ? pixelDriver.beginStrips(stripPins, stripPixels, PIXEL_STRIP_COUNT, (PixelType)config.pixelType)
+            : pixelDriver.begin(PIXEL_PIN, PIXEL_COUNT, (PixelType)config.pixelType);
+        if (!pixelsReady) {
             Serial.println("Pixel Driver Init Failed");
             return false;
         }
+        artnetNode->attachPixelDriver(&pixelDriver);
     }
 
-    if (config.rdmEnabled) {
+    if (config.rdmEnabled && !dmxA.isInput()) {
         rdmHandler.begin(&dmxA);
     }
 
@@ -0,0 +1,21 @@
+#include "PixelBus.h"
+
+PixelBus* createPixelBus(PixelType type, uint16_t count, gpio_num_t dataPin, gpio_num_t clockPin,
+                         bool parallel) {
+    switch (type) {
+        case TYPE_SK6812:
+            if (parallel) {
+                return new PixelBusT<PixelFeatureGrbw, NeoEsp32I2s1X8Sk6812Method>(type, count, dataPin, clockPin);
+            }
+            return new PixelBusT<PixelFeatureGrbw, NeoSk6812Method>(type, count, dataPin, clockPin);
+        case TYPE_APA102:
+            if (parallel) return nullptr;
+            return new PixelBusT<PixelFeatureApa102, DotStarSpi20MhzMethod>(type, count, dataPin, clockPin);
+        case TYPE_WS2812:
+        default:
+            if (parallel) {
+                return new PixelBusT<PixelFeatureGrb, NeoEsp32I2s1X8Ws2812xMethod>(TYPE_WS2812, count, dataPin, clockPin);
+            }
+            return new PixelBusT<PixelFeatureGrb, Neo800KbpsMethod>(TYPE_WS2812, count, dataPin, clockPin);
+    }
+}
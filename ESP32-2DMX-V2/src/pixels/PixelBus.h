@@ -0,0 +1,121 @@
+#pragma once
+
+// 像素输出总线：按颜色编码（Feature）和输出方式（NeoPixelBus Method）在编译期特化，
+// createPixelBus() 按配置的像素类型在运行时选择。PixelDriver 只通过 PixelBus 接口访问。
+//
+// 效果帧由 PixelDriver 按 Feature 编码好整帧（见 PixelFrameBuffer），用 load() 整段拷进
+// NeoPixelBus 的像素缓冲（Pixels()）；DMX 像素由发送的任务（输出任务，或同步发送时的渲染任务）
+// 用 writeRun() 直接批量编码进 Pixels()，省掉整帧缓冲和一次拷贝。两条路径都不经过 RgbColor 和库的逐像素调用；
+// 缓冲布局与 NeoPixelBus 的 Feature 一致，Show() 仍由库负责发送。
+// 多条灯带时每条一个 PixelBus，单线灯珠用 I2S1 的 8 路并行方式（RMT 通道留给 DMX 输出）。
+
+#include <Arduino.h>
+#include <NeoPixelBus.h>
+#include "PixelFeatures.h"
+
+class PixelBus {
+public:
+    virtual ~PixelBus() {}
+
+    virtual void begin() = 0;
+    virtual void show() = 0;
+    virtual bool canShow() const = 0;
+    // 载入整条灯带已编码的线上字节（getCount() * pixelBytes(getType())）并标记脏
+    virtual void load(const uint8_t* encoded) = 0;
+    // 从灯带内第 start 个像素起，把 count 个 DMX RGB 像素按亮度直接编码进像素缓冲并标记脏
+    virtual void writeRun(uint16_t start, const uint8_t* rgb, uint16_t count, uint8_t brightness) = 0;
+    virtual bool isParallel() const = 0;
+
+    PixelType getType() const { return type; }
+    uint16_t getCount() const { return count; }
+
+protected:
+    PixelBus(PixelType type, uint16_t count) : type(type), count(count) {}
+
+    PixelType type;
+    uint16_t count;
+};
+
+// 本仓库的 Feature 对应的 NeoPixelBus Feature（决定缓冲大小和布局）
+template <typename T_FEATURE> struct NeoFeatureOf;
+template <> struct NeoFeatureOf<PixelFeatureGrb> { typedef NeoGrbFeature Type; };
+template <> struct NeoFeatureOf<PixelFeatureGrbw> { typedef NeoGrbwFeature Type; };
+template <> struct NeoFeatureOf<PixelFeatureApa102> { typedef DotStarBgrFeature Type; };
+
+// 输出方式的构造和启动：单线方式只有数据脚，SPI 方式用数据脚 + 时钟脚
+template <typename T_METHOD> struct PixelMethodTraits {
+    static const bool PARALLEL = false;
+    template <typename T_BUS>
+    static T_BUS* create(uint16_t count, gpio_num_t dataPin) { return new T_BUS(count, dataPin); }
+    template <typename T_BUS>
+    static void begin(T_BUS& bus, gpio_num_t dataPin, gpio_num_t clockPin) { bus.Begin(); }
+};
+
+// I2S 8 路并行：各灯带共用一次 DMA 发送，所有灯带都调用 Show() 后才开始
+template <> struct PixelMethodTraits<NeoEsp32I2s1X8Ws2812xMethod> : PixelMethodTraits<Neo800KbpsMethod> {
+    static const bool PARALLEL = true;
+};
+template <> struct PixelMethodTraits<NeoEsp32I2s1X8Sk6812Method> : PixelMethodTraits<Neo800KbpsMethod> {
+    static const bool PARALLEL = true;
+};
+
+template <> struct PixelMethodTraits<DotStarSpi20MhzMethod> {
+    static const bool PARALLEL = false;
+    template <typename T_BUS>
+    static T_BUS* create(uint16_t count, gpio_num_t dataPin) { return new T_BUS(count); }
+    template <typename T_BUS>
+    static void begin(T_BUS& bus, gpio_num_t dataPin, gpio_num_t clockPin) {
+        bus.Begin(clockPin, -1, dataPin, -1);
+    }
+};
+
+template <typename T_FEATURE, typename T_METHOD>
+class PixelBusT : public PixelBus {
+public:
+    typedef NeoPixelBus<typename NeoFeatureOf<T_FEATURE>::Type, T_METHOD> Bus;
+    static_assert(NeoFeatureOf<T_FEATURE>::Type::PixelSize == T_FEATURE::BYTES,
+                  "PixelFeature layout must match the NeoPixelBus feature");
+
+    PixelBusT(PixelType type, uint16_t count, gpio_num_t dataPin, gpio_num_t clockPin)
+        : PixelBus(type, count)
+        , bus(PixelMethodTraits<T_METHOD>::template create<Bus>(count, dataPin))
+        , dataPin(dataPin)
+        , clockPin(clockPin) {
+    }
+
+    ~PixelBusT() override { delete bus; }
+
+    void begin() override {
+        PixelMethodTraits<T_METHOD>::begin(*bus, dataPin, clockPin);
+    }
+
+    // 并行方式下没有变化的灯带也要参与发送，否则整组不会开始
+    void show() override {
+        if (PixelMethodTraits<T_METHOD>::PARALLEL) bus->Dirty();
+        bus->Show();
+    }
+    bool canShow() const override { return bus->CanShow(); }
+    bool isParallel() const override { return PixelMethodTraits<T_METHOD>::PARALLEL; }
+
+    void load(const uint8_t* encoded) override {
+        memcpy(bus->Pixels(), encoded, count * T_FEATURE::BYTES);
+        bus->Dirty();
+    }
+
+    void writeRun(uint16_t start, const uint8_t* rgb, uint16_t n, uint8_t brightness) override {
+        if (start >= count) return;
+        if (n > count - start) n = count - start;
+        T_FEATURE::encodeRun(bus->Pixels() + start * T_FEATURE::BYTES, rgb, n, brightness);
+        bus->Dirty();
+    }
+
+private:
+    Bus* bus;
+    gpio_num_t dataPin;
+    gpio_num_t clockPin;
+};
+
+// 按像素类型创建总线：WS2812 与 SK6812 走 800 kHz 单线，APA102 走 20 MHz 硬件 SPI。
+// parallel 时单线灯珠改用 I2S 8 路并行方式；APA102 只有一路 SPI，不支持并行，返回 nullptr
+PixelBus* createPixelBus(PixelType type, uint16_t count, gpio_num_t dataPin, gpio_num_t clockPin,
+                         bool parallel = false);
@@ -1,10 +1,13 @@
 #include "PixelDriver.h"
 
 PixelDriver::PixelDriver()
-    : strip(nullptr)
+    : parallel(false)
+    , outputTask(nullptr)
+    , directDmx(false)
+    , renderTask(nullptr)
+    , refresh(false)
     , numPixels(0)
     , enabled(false)
-    , dmxMode(false)
     , currentEffect(EFFECT_NONE)
     , effectSpeed(128)
     , effectStep(0)
@@ -12,55 +15,131 @@ PixelDriver::PixelDriver()
     , brightness(255)
     , param1(0)
     , param2(0) {
+    memset(strips, 0, sizeof(strips));
 }
 
 PixelDriver::~PixelDriver() {
-    if (strip) {
-        delete strip;
-        strip = nullptr;
+    releaseStrips();
+}
+
+void PixelDriver::releaseStrips() {
+    // 渲染任务和输出任务会访问帧缓冲和灯带，先停掉
+    if (renderTask) {
+        vTaskDelete(renderTask);
+        renderTask = nullptr;
+    }
+    if (outputTask) {
+        vTaskDelete(outputTask);
+        outputTask = nullptr;
     }
+    for (uint8_t i = 0; i < PIXEL_MAX_STRIPS; i++) {
+        delete strips[i];
+        strips[i] = nullptr;
+    }
+    layout.clear();
+    numPixels = 0;
+    enabled = false;
 }
 
-bool PixelDriver::begin(gpio_num_t pin, uint16_t count, PixelType type) {
+bool PixelDriver::begin(gpio_num_t pin, uint16_t count, PixelType type, gpio_num_t clock) {
+    releaseStrips();
     dataPin = pin;
-    numPixels = (count > MAX_PIXELS) ? MAX_PIXELS : count;
-    pixelType = type;
+    clockPin = clock;
+    parallel = false;
+    if (!layout.addStrip(count, MAX_PIXELS)) return false;
+    numPixels = layout.getTotal();
     
     // 创建并初始化LED控制对象
-    initializeStrip();
-    
-    if (!strip) {
+    strips[0] = createPixelBus(type, numPixels, dataPin, clockPin);
+    if (!strips[0]) {
         return false;
     }
+    pixelType = strips[0]->getType();
     
-    strip->Begin();
-    clear();
-    show();
-    
+    strips[0]->begin();
+    return startOutput();
+}
+
+bool PixelDriver::beginStrips(const gpio_num_t* pins, const uint16_t* counts, uint8_t stripCount,
+                              PixelType type) {
+    if (stripCount <= 1) {
+        return stripCount == 1 && begin(pins[0], counts[0], type);
+    }
+
+    releaseStrips();
+    dataPin = pins[0];
+    parallel = true;
+    pixelType = type;
+    for (uint8_t i = 0; i < stripCount; i++) {
+        if (!layout.addStrip(counts[i], MAX_PIXELS)) break;
+        strips[i] = createPixelBus(type, layout.getCount(i), pins[i], GPIO_NUM_NC, true);
+        if (!strips[i]) {
+            releaseStrips();
+            return false;
+        }
+        strips[i]->begin();
+    }
+    numPixels = layout.getTotal();
+    return startOutput();
+}
+
+// 清空帧缓冲、发送一帧全黑，再启动输出任务和渲染任务
+bool PixelDriver::startOutput() {
+    frames.setLength(numPixels * pixelBytes(pixelType));
+    dmxInput.setLength(numPixels * 3);
     enabled = true;
+    clear();
+    present();
+
+#if PIXEL_ASYNC_SHOW
+    BaseType_t created = xTaskCreatePinnedToCore(&PixelDriver::outputTaskEntry, "pixel_out",
+                                                 PIXEL_OUTPUT_TASK_STACK_SIZE, this,
+                                                 PIXEL_OUTPUT_TASK_PRIORITY, &outputTask, PIXEL_OUTPUT_CORE);
+    if (created != pdPASS) {
+        // 退回同步发送
+        log_e("Pixel output task create failed");
+        outputTask = nullptr;
+    }
+#endif
+
+    pacer.start((uint32_t)esp_timer_get_time());
+    BaseType_t rendering = xTaskCreatePinnedToCore(&PixelDriver::renderTaskEntry, "pixel_render",
+                                                   PIXEL_RENDER_TASK_STACK_SIZE, this,
+                                                   PIXEL_RENDER_TASK_PRIORITY, &renderTask, PIXEL_RENDER_CORE);
+    if (rendering != pdPASS) {
+        log_e("Pixel render task create failed");
+        renderTask = nullptr;
+        releaseStrips();
+        return false;
+    }
     return true;
 }
 
-void PixelDriver::initializeStrip() {
-    if (strip) {
-        delete strip;
+// 灯带在帧缓冲中首尾相接（同一像素类型），全局像素编号直接对应字节偏移
+void PixelDriver::writePixel(uint16_t index, const RgbColor& color) {
+    pixelEncode(pixelType, frames.edit() + index * pixelBytes(pixelType), color.R, color.G, color.B);
+}
+
+void PixelDriver::fillPixels(uint16_t start, uint16_t count, const RgbColor& color) {
+    if (start >= numPixels) return;
+    if (count > numPixels - start) count = numPixels - start;
+    uint8_t bytes = pixelBytes(pixelType);
+    uint8_t* dst = frames.edit() + start * bytes;
+    for (uint16_t i = 0; i < count; i++, dst += bytes) {
+        pixelEncode(pixelType, dst, color.R, color.G, color.B);
     }
-    
-    strip = new PixelBus(numPixels, dataPin);
 }
 
 void PixelDriver::setPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b) {
     if (!enabled || !validatePixelIndex(index)) return;
     
-    RgbColor color(r, g, b);
-    strip->SetPixelColor(index, applyBrightness(color));
+    writePixel(index, applyBrightness(RgbColor(r, g, b)));
 }
 
 void PixelDriver::setPixelHSV(uint16_t index, float h, float s, float v) {
     if (!enabled || !validatePixelIndex(index)) return;
     
-    RgbColor color = HSVtoRGB(h, s, v);
-    strip->SetPixelColor(index, applyBrightness(color));
+    writePixel(index, applyBrightness(HSVtoRGB(h, s, v)));
 }
 
 void PixelDriver::setRange(uint16_t start, uint16_t count, uint8_t r, uint8_t g, uint8_t b) {
@@ -69,64 +148,145 @@ void PixelDriver::setRange(uint16_t start, uint16_t count, uint8_t r, uint8_t g,
     RgbColor color(r, g, b);
     color = applyBrightness(color);
     
-    uint16_t end = start + count;
-    if (end > numPixels) end = numPixels;
-    
-    for (uint16_t i = start; i < end; i++) {
-        strip->SetPixelColor(i, color);
-    }
+    fillPixels(start, count, color);
 }
 
 void PixelDriver::setBrightness(uint8_t value) {
     brightness = value;
-    if (enabled && !dmxMode) {
-        show();  // 立即更新显示
-    }
+    refresh = true;  // 下一格按新亮度重画
 }
 
 void PixelDriver::clear() {
     if (!enabled) return;
     
-    for (uint16_t i = 0; i < numPixels; i++) {
-        strip->SetPixelColor(i, RgbColor(0));
-    }
+    fillPixels(0, numPixels, RgbColor(0));
 }
 
+// 网络任务：提交本次写入的 DMX 像素，渲染任务在下一格取走
 void PixelDriver::show() {
     if (!enabled) return;
-    strip->Show();
+    uint32_t start = (uint32_t)esp_timer_get_time();
+    dmxInput.publish();
+    frames.recordBlock((uint32_t)esp_timer_get_time() - start);
 }
 
-void PixelDriver::handleDMX(uint8_t* data, uint16_t length) {
-    if (!enabled || !dmxMode || !data) return;
-    
-    uint16_t pixelCount = length / 3;
-    if (pixelCount > numPixels) {
-        pixelCount = numPixels;
+// 渲染任务：发布渲染好的帧并唤醒输出任务，输出任务未运行时同步发送
+void PixelDriver::present() {
+    if (!frames.publish()) return;
+    if (outputTask) {
+        directDmx = false;
+        xTaskNotifyGive(outputTask);
+    } else {
+        flush();
     }
-    
-    for (uint16_t i = 0; i < pixelCount; i++) {
-        uint16_t base = i * 3;
-        setPixel(i, data[base], data[base + 1], data[base + 2]);
+}
+
+// 渲染任务：按固定帧率的格子醒来（等待向上取整到 tick，不早于格子开始），有变化才渲染
+void PixelDriver::renderTaskEntry(void* arg) {
+    PixelDriver* driver = static_cast<PixelDriver*>(arg);
+    const uint32_t tickUs = portTICK_PERIOD_MS * 1000;
+    while (true) {
+        uint32_t waitUs = driver->pacer.waitUs((uint32_t)esp_timer_get_time());
+        if (waitUs > 0) {
+            vTaskDelay((waitUs + tickUs - 1) / tickUs);
+        }
+        driver->renderFrame();
     }
-    
-    show();
 }
 
-void PixelDriver::update() {
-    if (!enabled || dmxMode) return;
-    
-    uint32_t now = millis();
-    if (now - lastUpdate < (256 - effectSpeed)) {
-        return;
+void PixelDriver::renderFrame() {
+    uint32_t now = (uint32_t)esp_timer_get_time();
+    bool redraw = refresh;
+    refresh = false;
+    bool dmxSource = pacer.getSource() == PIXEL_SOURCE_DMX;
+    // 有输出任务时由它取走 DMX 像素，这里只看有没有新的
+    bool dmxNew = outputTask ? dmxInput.hasNewFrame() : dmxInput.acquire();
+    bool dmxFresh = dmxNew || (redraw && dmxSource);
+    bool due = effectDue(millis()) || (redraw && !dmxSource);
+
+    PixelRenderKind kind = pacer.beginFrame(now, dmxFresh, due);
+    if (kind == PIXEL_RENDER_DMX && !outputTask) {
+        showDmxDirect(dmxInput.front());
+    } else if (kind == PIXEL_RENDER_DMX) {
+        // DMX 像素不经过整帧缓冲：输出任务取走最新的 RGB 后直接编码进各灯带
+        directDmx = true;
+        xTaskNotifyGive(outputTask);
+    } else if (kind == PIXEL_RENDER_EFFECT) {
+        // 清屏和各个效果每帧都写满全部像素
+        frames.overwrite();
+        lastUpdate = millis();
+        if (currentEffect == EFFECT_NONE) {
+            clear();
+        } else {
+            updateEffects();
+        }
+        present();
     }
+    pacer.endFrame((uint32_t)esp_timer_get_time(), kind);
+}
+
+// 渲染任务（同步发送）或输出任务：DMX 像素按灯带直接批量编码进各总线的像素缓冲后发送，
+// 不经过整帧缓冲，也没有 load() 的整帧拷贝。后台帧不再跟随 DMX，效果帧总是整帧重画，之后切回效果也不受影响
+void PixelDriver::showDmxDirect(const uint8_t* rgb) {
+    uint32_t start = (uint32_t)esp_timer_get_time();
+    for (uint8_t strip = 0; strip < layout.getStripCount(); strip++) {
+        strips[strip]->writeRun(0, rgb + layout.getStart(strip) * 3, layout.getCount(strip), brightness);
+        strips[strip]->show();
+    }
+    frames.recordOutput((uint32_t)esp_timer_get_time() - start);
+}
+
+// 效果按速度换算的步进间隔前进一步
+bool PixelDriver::effectDue(uint32_t nowMs) const {
+    return currentEffect != EFFECT_NONE && nowMs - lastUpdate >= (uint32_t)(256 - effectSpeed);
+}
+
+// 输出任务：Show() 等待上一帧发完时只阻塞这里；等待期间发布的帧互相替换，醒来后只发最新的。
+// 渲染任务最近一次渲染的是 DMX 时取最新的 DMX 像素（没有新的就按当前亮度重发上一次的），否则发效果帧
+void PixelDriver::outputTaskEntry(void* arg) {
+    PixelDriver* driver = static_cast<PixelDriver*>(arg);
+    while (true) {
+        ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+        if (driver->directDmx) {
+            driver->dmxInput.acquire();
+            driver->showDmxDirect(driver->dmxInput.front());
+        } else {
+            driver->flush();
+        }
+    }
+}
+
+bool PixelDriver::flush() {
+    if (!frames.acquire()) return false;
+    uint32_t start = (uint32_t)esp_timer_get_time();
+    const uint8_t* frame = frames.front();
+    uint8_t bytes = pixelBytes(pixelType);
+    // 并行方式下各灯带都调用后整组一起发送
+    for (uint8_t strip = 0; strip < layout.getStripCount(); strip++) {
+        strips[strip]->load(frame + layout.getStart(strip) * bytes);
+        strips[strip]->show();
+    }
+    frames.recordOutput((uint32_t)esp_timer_get_time() - start);
+    return true;
+}
+
+uint8_t* PixelDriver::editDmx() {
+    if (!enabled || pacer.getSource() == PIXEL_SOURCE_EFFECT) return nullptr;
+    return dmxInput.edit();
+}
+
+void PixelDriver::handleDMX(const uint8_t* data, uint16_t length, uint16_t startPixel) {
+    if (!data || startPixel >= numPixels) return;
+    uint8_t* rgb = editDmx();
+    if (!rgb) return;
     
-    lastUpdate = now;
-    
-    if (currentEffect != EFFECT_NONE) {
-        updateEffects();
-        show();
+    uint16_t pixelCount = length / 3;
+    if (pixelCount > numPixels - startPixel) {
+        pixelCount = numPixels - startPixel;
     }
+    
+    // 只拷贝 RGB，编码由渲染任务按帧率统一完成
+    memcpy(rgb + startPixel * 3, data, pixelCount * 3);
 }
 
 void PixelDriver::updateEffects() {
@@ -174,9 +334,7 @@ void PixelDriver::updateFade() {
         effectColor.B * intensity
     ));
     
-    for (uint16_t i = 0; i < numPixels; i++) {
-        strip->SetPixelColor(i, color);
-    }
+    fillPixels(0, numPixels, color);
     
     effectStep = (effectStep + 1) & 0xFF;
 }
@@ -240,10 +398,7 @@ bool PixelDriver::validatePixelIndex(uint16_t index) const {
 void PixelDriver::setEffect(PixelEffect effect) {
     currentEffect = effect;
     effectStep = 0;
-    if (effect == EFFECT_NONE) {
-        clear();
-        show();
-    }
+    refresh = true;  // EFFECT_NONE 时由渲染任务清屏
 }
 
 void PixelDriver::setEffectSpeed(uint8_t speed) {
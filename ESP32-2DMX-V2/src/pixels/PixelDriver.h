@@ -2,14 +2,17 @@
 
 #include <Arduino.h>
 #include <NeoPixelBus.h>
+#include <freertos/FreeRTOS.h>
+#include <freertos/task.h>
+#include <esp_timer.h>
 #include "config.h"
+#include "PixelBus.h"
+#include "PixelStripLayout.h"
+#include "PixelFrameBuffer.h"
+#include "PixelFramePacer.h"
 
-// 像素类型定义
-enum PixelType {
-    TYPE_WS2812 = 0,
-    TYPE_SK6812 = 1,
-    TYPE_APA102 = 2
-};
+static_assert(MAX_PIXELS * 4 <= PIXEL_FRAME_MAX_BYTES, "PixelFrameBuffer too small for MAX_PIXELS");
+static_assert(MAX_PIXELS * 3 <= PIXEL_RGB_MAX_BYTES, "PixelRgbBuffer too small for MAX_PIXELS");
 
 // 效果类型定义
 enum PixelEffect {
@@ -26,13 +29,19 @@ public:
     PixelDriver();
     ~PixelDriver();
 
-    // 基本功能
-    bool begin(gpio_num_t pin, uint16_t numPixels, PixelType type = TYPE_WS2812);
-    void update();
+    // 基本功能：clockPin 只用于 APA102（SPI 时钟）
+    bool begin(gpio_num_t pin, uint16_t numPixels, PixelType type = TYPE_WS2812,
+               gpio_num_t clockPin = PIXEL_CLOCK_PIN);
+    // 多条灯带并行输出（最多 PIXEL_MAX_STRIPS 条，单线灯珠）：像素按灯带顺序连续编号，
+    // 一帧的时间取决于最长的一条。只有一条时与 begin() 相同
+    bool beginStrips(const gpio_num_t* pins, const uint16_t* counts, uint8_t stripCount,
+                     PixelType type = TYPE_WS2812);
+    // 网络任务提交 editDmx() / handleDMX() 写入的像素后立即返回。渲染任务按固定帧率决定何时出帧，
+    // 输出任务把最新的 DMX 像素直接编码进灯带并负责线路发送（PIXEL_ASYNC_SHOW 0 时都由渲染任务完成）
     void show();
-    void clear();
     
-    // 像素控制
+    // 像素控制：写入正在渲染的帧，只应在渲染任务中（效果）或任务启动前调用
+    void clear();
     void setPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b);
     void setPixelHSV(uint16_t index, float h, float s, float v);
     void setRange(uint16_t start, uint16_t count, uint8_t r, uint8_t g, uint8_t b);
@@ -43,27 +52,65 @@ public:
     void setEffectSpeed(uint8_t speed);
     void setEffectColor(uint8_t r, uint8_t g, uint8_t b);
     void setEffectParams(uint8_t param1, uint8_t param2);
+
+    // 渲染节拍和帧来源（DMX / 效果 / DMX 空闲时跑效果）
+    void setTargetFps(uint16_t fps) { pacer.setTargetFps(fps); }
+    void setSource(PixelSource source) {
+        pacer.setSource(source);
+        refresh = true;
+    }
+    void setDmxIdle(uint32_t ms) { pacer.setDmxIdle(ms * 1000); }
+    PixelSource getSource() const { return pacer.getSource(); }
+    const PixelFramePacer& getPacer() const { return pacer; }
     
-    // DMX控制
-    void handleDMX(uint8_t* data, uint16_t length);
-    void setDMXMode(bool enabled) { dmxMode = enabled; }
+    // DMX控制：只写入像素缓冲，由调用者决定何时 show()
+    void handleDMX(const uint8_t* data, uint16_t length, uint16_t startPixel = 0);
+    // 网络任务：DMX 像素（RGB，每像素 3 字节，共 getDmxBytes() 字节）的写入缓冲，可直接按字节写入。
+    // 未启用或只跑效果时返回 nullptr
+    uint8_t* editDmx();
+    uint16_t getDmxBytes() const { return dmxInput.getLength(); }
+    void setDMXMode(bool enabled) { setSource(enabled ? PIXEL_SOURCE_DMX : PIXEL_SOURCE_EFFECT); }
     
     // 状态查询
     uint16_t getNumPixels() const { return numPixels; }
+    PixelType getType() const { return pixelType; }
+    uint32_t getFrameUs() const { return layout.frameUs(pixelType, parallel); }  // 一帧的线上时间
+    uint8_t getStripCount() const { return layout.getStripCount(); }
+    const PixelStripLayout& getLayout() const { return layout; }
+    bool isParallel() const { return parallel; }
+    bool isAsync() const { return outputTask != nullptr; }
+    const PixelShowStats& getShowStats() const { return frames.getStats(); }
+    void resetShowStats() {
+        frames.resetStats();
+        pacer.resetStats();
+    }
     bool isEnabled() const { return enabled; }
     PixelEffect getCurrentEffect() const { return currentEffect; }
 
 private:
-    // NeoPixelBus对象
-    using PixelBus = NeoPixelBus<NeoGrbFeature, Neo800KbpsMethod>;
-    PixelBus* strip;
+    // 按像素类型特化的输出总线，每条灯带一个
+    PixelBus* strips[PIXEL_MAX_STRIPS];
+    PixelStripLayout layout;
+    bool parallel;
+
+    // 编码好的整帧（效果）：渲染任务写入后台帧，输出任务把最新发布的帧送到各灯带
+    PixelFrameBuffer frames;
+    TaskHandle_t outputTask;
+    volatile bool directDmx;    // 输出任务下一次直接把 DMX 像素编码进各灯带，而不是发送 frames
+
+    // 网络任务写入的 DMX 像素（RGB）。取走最新一次的是发送 DMX 像素的任务：
+    // 有输出任务时是输出任务，否则是渲染任务
+    PixelRgbBuffer dmxInput;
+    PixelFramePacer pacer;
+    TaskHandle_t renderTask;
+    volatile bool refresh;  // 亮度、效果或来源改变，下一格重画
     
     // 配置参数
     uint16_t numPixels;
     gpio_num_t dataPin;
+    gpio_num_t clockPin;
     PixelType pixelType;
     bool enabled;
-    bool dmxMode;
     
     // 效果参数
     PixelEffect currentEffect;
@@ -75,6 +122,13 @@ private:
     uint8_t param1;
     uint8_t param2;
     
+    // 渲染任务
+    static void renderTaskEntry(void* arg);
+    void renderFrame();
+    bool effectDue(uint32_t nowMs) const;
+    void present();
+    void showDmxDirect(const uint8_t* rgb);
+
     // 效果处理方法
     void updateEffects();
     void updateRainbow();
@@ -89,5 +143,12 @@ private:
     
     // 帮助方法
     bool validatePixelIndex(uint16_t index) const;
-    void initializeStrip();
+    void releaseStrips();
+    bool startOutput();
+    void writePixel(uint16_t index, const RgbColor& color);
+    void fillPixels(uint16_t start, uint16_t count, const RgbColor& color);
+
+    // 输出任务：DMX 像素直接编码进各灯带，或取最新的效果帧拷进各灯带，然后 Show()
+    static void outputTaskEntry(void* arg);
+    bool flush();
 };
\ No newline at end of file
@@ -0,0 +1,202 @@
+#pragma once
+
+// 像素颜色编码（纯 C++，不依赖 Arduino，可在主机上测试）
+//
+// 每种灯珠一个 Feature：每像素的字节数、线上字节顺序和编码函数。PixelBus 用它直接写 NeoPixelBus
+// 的像素缓冲，字节布局与对应的 NeoPixelBus Feature 相同（见 PixelBus.h 中的对应关系）。
+//
+// encodeRun() 是整段 DMX RGB 的批量版本：亮度缩放和字节换序在同一个循环里完成，每次处理 4 个像素。
+// 亮度与 PixelDriver::applyBrightness 相同：255 不缩放，否则 (c * brightness) >> 8。
+
+#include <stdint.h>
+#include <string.h>
+
+// 像素类型定义
+enum PixelType {
+    TYPE_WS2812 = 0,
+    TYPE_SK6812 = 1,
+    TYPE_APA102 = 2
+};
+
+#define PIXEL_TYPE_COUNT 3
+
+#define PIXEL_FULL_BRIGHTNESS 255
+
+inline uint8_t pixelScale(uint8_t c, uint8_t brightness) {
+    return (uint8_t)((c * brightness) >> 8);
+}
+
+// 一个 32 位字中的 4 个字节同时缩放：奇偶字节分到 16 位通道里各乘一次，结果与逐字节相同
+inline uint32_t pixelScaleWord(uint32_t w, uint8_t brightness) {
+    uint32_t even = ((w & 0x00FF00FFu) * brightness >> 8) & 0x00FF00FFu;
+    uint32_t odd = ((w >> 8) & 0x00FF00FFu) * brightness & 0xFF00FF00u;
+    return even | odd;
+}
+
+// WS2812：GRB，3 字节
+struct PixelFeatureGrb {
+    static const uint8_t BYTES = 3;
+
+    static inline void encode(uint8_t* dst, uint8_t r, uint8_t g, uint8_t b) {
+        dst[0] = g;
+        dst[1] = r;
+        dst[2] = b;
+    }
+
+    // 4 个像素正好 12 字节 = 3 个字：RGB RGB RGB RGB -> GRB GRB GRB GRB，只交换每个像素的前两字节
+    static void encodeRun(uint8_t* dst, const uint8_t* src, uint16_t count, uint8_t brightness) {
+        bool scale = brightness != PIXEL_FULL_BRIGHTNESS;
+        uint16_t i = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+        for (; i + 4 <= count; i += 4, src += 12, dst += 12) {
+            uint32_t w0, w1, w2;
+            memcpy(&w0, src, 4);
+            memcpy(&w1, src + 4, 4);
+            memcpy(&w2, src + 8, 4);
+            if (scale) {
+                w0 = pixelScaleWord(w0, brightness);
+                w1 = pixelScaleWord(w1, brightness);
+                w2 = pixelScaleWord(w2, brightness);
+            }
+            // 小端：w0 = R0 G0 B0 R1，w1 = G1 B1 R2 G2，w2 = B2 R3 G3 B3
+            uint32_t o0 = ((w0 >> 8) & 0xFFu) | ((w0 & 0xFFu) << 8) | (w0 & 0xFF0000u) | (w1 << 24);
+            uint32_t o1 = (w0 >> 24) | (w1 & 0xFF00u) | ((w1 >> 8) & 0xFF0000u) | ((w1 << 8) & 0xFF000000u);
+            uint32_t o2 = (w2 & 0xFF0000FFu) | ((w2 >> 8) & 0xFF00u) | ((w2 << 8) & 0xFF0000u);
+            memcpy(dst, &o0, 4);
+            memcpy(dst + 4, &o1, 4);
+            memcpy(dst + 8, &o2, 4);
+        }
+#endif
+        for (; i < count; i++, src += 3, dst += BYTES) {
+            if (scale) {
+                encode(dst, pixelScale(src[0], brightness), pixelScale(src[1], brightness),
+                       pixelScale(src[2], brightness));
+            } else {
+                encode(dst, src[0], src[1], src[2]);
+            }
+        }
+    }
+};
+
+// 4 字节的编码没有可合并的换序：按 4 个像素展开，亮度在编码前按字缩放，
+// 每个像素由 T_FEATURE::word() 拼成一个字整字写出（小端下即线上字节顺序）
+template <typename T_FEATURE>
+inline void pixelEncodeRun4(uint8_t* dst, const uint8_t* src, uint16_t count, uint8_t brightness) {
+    bool scale = brightness != PIXEL_FULL_BRIGHTNESS;
+    uint16_t i = 0;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__
+    for (; i + 4 <= count; i += 4, src += 12, dst += 4 * T_FEATURE::BYTES) {
+        uint32_t w0, w1, w2;
+        memcpy(&w0, src, 4);
+        memcpy(&w1, src + 4, 4);
+        memcpy(&w2, src + 8, 4);
+        if (scale) {
+            w0 = pixelScaleWord(w0, brightness);
+            w1 = pixelScaleWord(w1, brightness);
+            w2 = pixelScaleWord(w2, brightness);
+        }
+        // 小端：w0 = R0 G0 B0 R1，w1 = G1 B1 R2 G2，w2 = B2 R3 G3 B3
+        uint32_t o0 = T_FEATURE::word(w0 & 0xFFu, (w0 >> 8) & 0xFFu, (w0 >> 16) & 0xFFu);
+        uint32_t o1 = T_FEATURE::word(w0 >> 24, w1 & 0xFFu, (w1 >> 8) & 0xFFu);
+        uint32_t o2 = T_FEATURE::word((w1 >> 16) & 0xFFu, w1 >> 24, w2 & 0xFFu);
+        uint32_t o3 = T_FEATURE::word((w2 >> 8) & 0xFFu, (w2 >> 16) & 0xFFu, w2 >> 24);
+        memcpy(dst, &o0, 4);
+        memcpy(dst + 4, &o1, 4);
+        memcpy(dst + 8, &o2, 4);
+        memcpy(dst + 12, &o3, 4);
+    }
+#endif
+    for (; i < count; i++, src += 3, dst += T_FEATURE::BYTES) {
+        if (scale) {
+            T_FEATURE::encode(dst, pixelScale(src[0], brightness), pixelScale(src[1], brightness),
+                              pixelScale(src[2], brightness));
+        } else {
+            T_FEATURE::encode(dst, src[0], src[1], src[2]);
+        }
+    }
+}
+
+// SK6812 RGBW：GRBW，4 字节。DMX 数据仍是 RGB，三色共同的部分交给白光灯珠。
+// W = min(R, G, B) 依赖同一像素的三个通道，没法像换序那样按字合并，批量路径只省下缩放和逐字节写入
+struct PixelFeatureGrbw {
+    static const uint8_t BYTES = 4;
+
+    static inline void encode(uint8_t* dst, uint8_t r, uint8_t g, uint8_t b) {
+        uint8_t w = r < g ? r : g;
+        if (b < w) w = b;
+        dst[0] = g - w;
+        dst[1] = r - w;
+        dst[2] = b - w;
+        dst[3] = w;
+    }
+
+    static inline uint32_t word(uint32_t r, uint32_t g, uint32_t b) {
+        uint32_t w = r < g ? r : g;
+        if (b < w) w = b;
+        return (g - w) | (r - w) << 8 | (b - w) << 16 | w << 24;
+    }
+
+    static void encodeRun(uint8_t* dst, const uint8_t* src, uint16_t count, uint8_t brightness) {
+        pixelEncodeRun4<PixelFeatureGrbw>(dst, src, count, brightness);
+    }
+};
+
+// APA102：每像素 4 字节，首字节 0xE0 | 5 位全局亮度（固定最亮），随后 BGR
+struct PixelFeatureApa102 {
+    static const uint8_t BYTES = 4;
+
+    static inline void encode(uint8_t* dst, uint8_t r, uint8_t g, uint8_t b) {
+        dst[0] = 0xFF;
+        dst[1] = b;
+        dst[2] = g;
+        dst[3] = r;
+    }
+
+    static inline uint32_t word(uint32_t r, uint32_t g, uint32_t b) {
+        return 0xFFu | b << 8 | g << 16 | r << 24;
+    }
+
+    static void encodeRun(uint8_t* dst, const uint8_t* src, uint16_t count, uint8_t brightness) {
+        pixelEncodeRun4<PixelFeatureApa102>(dst, src, count, brightness);
+    }
+};
+
+// 线上时间：单线灯珠 800 kHz 每位 1.25 us，帧尾至少 50 us 复位（部分 WS2812B 需要 280 us）；
+// APA102 按 SPI 时钟发送，帧头 4 字节 0，帧尾每 16 个像素至少 1 字节
+#define PIXEL_ONEWIRE_HZ 800000
+#define PIXEL_ONEWIRE_RESET_US 280
+#define PIXEL_SPI_HZ 20000000
+
+inline uint8_t pixelBytes(PixelType type) {
+    switch (type) {
+        case TYPE_SK6812: return PixelFeatureGrbw::BYTES;
+        case TYPE_APA102: return PixelFeatureApa102::BYTES;
+        default: return PixelFeatureGrb::BYTES;
+    }
+}
+
+// 按运行时的像素类型编码：PixelDriver 写入帧缓冲时使用
+inline void pixelEncode(PixelType type, uint8_t* dst, uint8_t r, uint8_t g, uint8_t b) {
+    switch (type) {
+        case TYPE_SK6812: PixelFeatureGrbw::encode(dst, r, g, b); break;
+        case TYPE_APA102: PixelFeatureApa102::encode(dst, r, g, b); break;
+        default: PixelFeatureGrb::encode(dst, r, g, b); break;
+    }
+}
+
+inline void pixelEncodeRun(PixelType type, uint8_t* dst, const uint8_t* src, uint16_t count, uint8_t brightness) {
+    switch (type) {
+        case TYPE_SK6812: PixelFeatureGrbw::encodeRun(dst, src, count, brightness); break;
+        case TYPE_APA102: PixelFeatureApa102::encodeRun(dst, src, count, brightness); break;
+        default: PixelFeatureGrb::encodeRun(dst, src, count, brightness); break;
+    }
+}
+
+inline uint32_t pixelFrameUs(PixelType type, uint16_t count) {
+    if (type == TYPE_APA102) {
+        uint32_t bytes = 4 + (uint32_t)count * PixelFeatureApa102::BYTES + (count + 15) / 16;
+        return (uint32_t)((uint64_t)bytes * 8 * 1000000 / PIXEL_SPI_HZ);
+    }
+    uint32_t bits = (uint32_t)count * pixelBytes(type) * 8;
+    return (uint32_t)((uint64_t)bits * 1000000 / PIXEL_ONEWIRE_HZ) + PIXEL_ONEWIRE_RESET_US;
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+// 像素输出的帧交接缓冲（纯 C++，不依赖 Arduino，可在主机上测试）
+//
+// 网络任务把编码好的线上字节写入后台帧，show() 时 publish()；输出任务 acquire() 最新的一帧，
+// 拷进 NeoPixelBus 的缓冲后 Show()，线路发送和等待上一帧都只阻塞输出任务。
+// 三个缓冲：后台帧（网络任务正在写）、待发帧（已发布未取走）、前台帧（输出任务正在发送）。
+// 输出任务忙时发布的新帧直接替换待发帧，不排队，线上总是最新的一帧。
+// 每帧第一次写入时从上一次发布的帧补齐，只更新部分像素（单个宇宙）时其余像素保持不变；
+// 整帧重画（DMX 批量编码、效果）用 overwrite() 开始新的一帧，省掉这次整帧拷贝。
+// 同一个交接方式也用于网络任务 -> 渲染任务的 DMX 像素（RGB，每像素 3 字节），容量按用途分开。
+
+#include <stdint.h>
+#include <string.h>
+#include "dmx/TripleBuffer.h"
+
+#define PIXEL_FRAME_MAX_BYTES (1360 * 4)   // MAX_PIXELS 个 4 字节像素（编码后的线上字节）
+#define PIXEL_RGB_MAX_BYTES (1360 * 3)     // MAX_PIXELS 个 RGB 像素（DMX 输入）
+
+template <uint16_t MaxBytes>
+struct PixelFrame {
+    uint8_t data[MaxBytes];
+};
+
+struct PixelShowStats {
+    uint32_t published;     // show() 发布的帧
+    uint32_t replaced;      // 输出任务取走之前被新帧替换的帧
+    uint32_t shown;         // 实际送到线路上的帧
+    uint32_t lastBlockUs;   // 调用 show() 的任务（网络任务）在 show() 中停留的时间
+    uint32_t maxBlockUs;
+    uint32_t lastOutputUs;  // 输出任务一帧的拷贝 + Show()，含等待上一帧发送完
+    uint32_t maxOutputUs;
+};
+
+template <uint16_t MaxBytes>
+class PixelFrameBufferT {
+public:
+    PixelFrameBufferT() : length(0), writing(false) {
+        resetStats();
+    }
+
+    // 只能在输出任务未运行时调用：清零所有缓冲
+    void setLength(uint16_t bytes) {
+        length = bytes > MaxBytes ? MaxBytes : bytes;
+        for (uint8_t i = 0; i < 3; i++) {
+            memset(frames.at(i).data, 0, MaxBytes);
+        }
+        writing = false;
+    }
+
+    uint16_t getLength() const { return length; }
+
+    // ---- 写者（网络任务） ----
+    uint8_t* edit() {
+        PixelFrame<MaxBytes>& back = frames.writeBuffer();
+        if (!writing) {
+            memcpy(back.data, frames.lastPublished().data, length);
+            writing = true;
+        }
+        return back.data;
+    }
+
+    // 整帧重写：开始新的一帧但不从上一次发布的帧补齐，调用者必须写满 getLength() 字节。
+    // 之后同一帧内的 edit() 返回同一个缓冲
+    uint8_t* overwrite() {
+        writing = true;
+        return frames.writeBuffer().data;
+    }
+
+    // 发布已写入的帧，没有写入时返回 false
+    bool publish() {
+        if (!writing) return false;
+        if (frames.publish()) stats.replaced++;
+        stats.published++;
+        writing = false;
+        return true;
+    }
+
+    bool hasUnpublished() const { return writing; }
+
+    void recordBlock(uint32_t us) {
+        stats.lastBlockUs = us;
+        if (us > stats.maxBlockUs) stats.maxBlockUs = us;
+    }
+
+    // ---- 读者（输出任务） ----
+    bool acquire() { return frames.consume(); }
+    bool hasNewFrame() const { return frames.hasNewFrame(); }
+    const uint8_t* front() const { return frames.readBuffer().data; }
+
+    void recordOutput(uint32_t us) {
+        stats.shown++;
+        stats.lastOutputUs = us;
+        if (us > stats.maxOutputUs) stats.maxOutputUs = us;
+    }
+
+    // 两端各自只写自己的字段，统计读数允许有一帧的误差
+    const PixelShowStats& getStats() const { return stats; }
+    void resetStats() { memset(&stats, 0, sizeof(stats)); }
+
+private:
+    TripleBuffer<PixelFrame<MaxBytes>> frames;
+    PixelShowStats stats;
+    uint16_t length;
+    bool writing;
+};
+
+typedef PixelFrameBufferT<PIXEL_FRAME_MAX_BYTES> PixelFrameBuffer;   // 编码好的整帧
+typedef PixelFrameBufferT<PIXEL_RGB_MAX_BYTES> PixelRgbBuffer;       // DMX 输入的 RGB 像素
@@ -0,0 +1,162 @@
+#pragma once
+
+// 像素渲染任务的帧节拍（纯 C++，不依赖 Arduino，可在主机上用虚拟时钟测试）
+//
+// 渲染任务按固定帧率的时间格工作：每格开始时决定这一帧渲染什么，没有变化就跳过。
+// 截止时间按格累加，不随实际唤醒时间漂移；落后超过一格时跳过错过的格子，重新对齐到格上。
+// 一帧从它的格子开始算起超过一个周期才完成，记为迟到帧（帧预算 = 周期）。
+//
+// 帧来源：
+//   DMX：只在有新的 DMX 像素数据时渲染
+//   效果：效果到了下一步时渲染
+//   混合：有 DMX 输入时按 DMX，输入空闲超过 dmxIdleUs（或从未收到）时改跑效果
+// 时间用 32 位微秒，按差值比较，回绕后仍然正确。
+
+#include <stdint.h>
+#include <string.h>
+
+enum PixelSource {
+    PIXEL_SOURCE_DMX = 0,
+    PIXEL_SOURCE_EFFECT = 1,
+    PIXEL_SOURCE_MIXED = 2
+};
+
+enum PixelRenderKind {
+    PIXEL_RENDER_SKIP = 0,
+    PIXEL_RENDER_DMX = 1,
+    PIXEL_RENDER_EFFECT = 2
+};
+
+struct PixelPacerStats {
+    uint32_t ticks;         // 经过的时间格
+    uint32_t dmxFrames;     // 按 DMX 渲染的帧
+    uint32_t effectFrames;  // 按效果渲染的帧
+    uint32_t skipped;       // 没有变化而跳过的格
+    uint32_t missed;        // 落后时整格错过的格
+    uint32_t late;          // 超出帧预算的帧
+    uint32_t lastWorkUs;    // 渲染一帧的耗时
+    uint32_t maxWorkUs;
+    uint32_t lastLateUs;    // 迟到帧超出预算的时间
+    uint32_t maxLateUs;
+};
+
+class PixelFramePacer {
+public:
+    static const uint16_t DEFAULT_FPS = 40;
+    static const uint16_t MAX_FPS = 1000;
+
+    PixelFramePacer()
+        : periodUs(1000000 / DEFAULT_FPS)
+        , dmxIdleUs(2000000)
+        , source(PIXEL_SOURCE_DMX)
+        , deadline(0)
+        , slotStart(0)
+        , frameStart(0)
+        , lastDmxUs(0)
+        , dmxSeen(false) {
+        resetStats();
+    }
+
+    // fps 为 0 或超出范围时取默认值 / 上限
+    void setTargetFps(uint16_t fps) {
+        if (fps == 0) fps = DEFAULT_FPS;
+        if (fps > MAX_FPS) fps = MAX_FPS;
+        periodUs = 1000000 / fps;
+    }
+
+    void setSource(PixelSource value) { source = value; }
+    void setDmxIdle(uint32_t us) { dmxIdleUs = us; }
+
+    PixelSource getSource() const { return source; }
+    uint32_t getPeriodUs() const { return periodUs; }   // 也是一帧的预算
+    uint16_t getTargetFps() const { return (uint16_t)(1000000 / periodUs); }
+
+    // 第一格从 now 开始
+    void start(uint32_t now) {
+        deadline = now;
+        dmxSeen = false;
+    }
+
+    // 距离下一格还要等多久，已经到了返回 0
+    uint32_t waitUs(uint32_t now) const {
+        int32_t remaining = (int32_t)(deadline - now);
+        return remaining > 0 ? (uint32_t)remaining : 0;
+    }
+
+    // 一格开始：推进截止时间并决定这一格渲染什么。
+    // dmxFresh：上一格之后有新的 DMX 像素数据；effectDue：效果到了下一步
+    PixelRenderKind beginFrame(uint32_t now, bool dmxFresh, bool effectDue) {
+        stats.ticks++;
+        frameStart = now;
+        slotStart = deadline;
+
+        int32_t lateness = (int32_t)(now - deadline);
+        if (lateness >= (int32_t)periodUs) {
+            // 整格错过：跳到当前所在的格子，之后仍按原来的格子对齐
+            uint32_t skippedSlots = (uint32_t)lateness / periodUs;
+            stats.missed += skippedSlots;
+            slotStart = deadline + skippedSlots * periodUs;
+        }
+        deadline = slotStart + periodUs;
+
+        if (dmxFresh) {
+            lastDmxUs = now;
+            dmxSeen = true;
+        }
+
+        PixelRenderKind kind = decide(now, dmxFresh, effectDue);
+        if (kind == PIXEL_RENDER_DMX) stats.dmxFrames++;
+        else if (kind == PIXEL_RENDER_EFFECT) stats.effectFrames++;
+        else stats.skipped++;
+        return kind;
+    }
+
+    // 一格结束：渲染过的帧统计耗时，从格子开始超过一个周期记为迟到
+    void endFrame(uint32_t now, PixelRenderKind kind) {
+        if (kind == PIXEL_RENDER_SKIP) return;
+        uint32_t work = now - frameStart;
+        stats.lastWorkUs = work;
+        if (work > stats.maxWorkUs) stats.maxWorkUs = work;
+
+        uint32_t elapsed = now - slotStart;
+        if (elapsed > periodUs) {
+            uint32_t over = elapsed - periodUs;
+            stats.late++;
+            stats.lastLateUs = over;
+            if (over > stats.maxLateUs) stats.maxLateUs = over;
+        }
+    }
+
+    // 混合模式下 DMX 输入是否仍然有效
+    bool isDmxActive(uint32_t now) const {
+        return dmxSeen && now - lastDmxUs < dmxIdleUs;
+    }
+
+    const PixelPacerStats& getStats() const { return stats; }
+    void resetStats() { memset(&stats, 0, sizeof(stats)); }
+
+private:
+    uint32_t periodUs;
+    uint32_t dmxIdleUs;
+    PixelSource source;
+    uint32_t deadline;      // 下一格的开始时间
+    uint32_t slotStart;     // 当前格的开始时间
+    uint32_t frameStart;    // 当前格实际开始渲染的时间
+    uint32_t lastDmxUs;
+    bool dmxSeen;
+    PixelPacerStats stats;
+
+    PixelRenderKind decide(uint32_t now, bool dmxFresh, bool effectDue) const {
+        switch (source) {
+            case PIXEL_SOURCE_EFFECT:
+                return effectDue ? PIXEL_RENDER_EFFECT : PIXEL_RENDER_SKIP;
+            case PIXEL_SOURCE_MIXED:
+                if (dmxFresh) return PIXEL_RENDER_DMX;
+                if (!isDmxActive(now) && effectDue) return PIXEL_RENDER_EFFECT;
+                return PIXEL_RENDER_SKIP;
+            case PIXEL_SOURCE_DMX:
+            default:
+                return dmxFresh ? PIXEL_RENDER_DMX : PIXEL_RENDER_SKIP;
+        }
+    }
+};
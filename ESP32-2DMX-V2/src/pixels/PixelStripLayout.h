@@ -0,0 +1,77 @@
+#pragma once
+
+// 多条灯带的像素编号和线上时间（纯 C++，不依赖 Arduino，可在主机上测试）
+//
+// 各灯带按顺序拼成一个全局像素编号空间：灯带 i 从前面各条的像素总数起。每条灯带从新的宇宙开始，
+// 宇宙数按自己的像素数计算。并行输出（I2S 8 路）时所有灯带同时发送，一帧的时间取最长的一条；
+// 单引脚依次发送时是各条之和。
+
+#include <stdint.h>
+#include "PixelFeatures.h"
+
+#define PIXEL_MAX_STRIPS 8
+
+class PixelStripLayout {
+public:
+    PixelStripLayout() { clear(); }
+
+    void clear() {
+        stripCount = 0;
+        total = 0;
+        starts[0] = 0;
+    }
+
+    // 追加一条灯带；总像素数超过 maxTotal 时截短，放不下时返回 false
+    bool addStrip(uint16_t count, uint16_t maxTotal = 0xFFFF) {
+        if (stripCount >= PIXEL_MAX_STRIPS || count == 0 || total >= maxTotal) return false;
+        if (count > maxTotal - total) count = maxTotal - total;
+        counts[stripCount] = count;
+        starts[stripCount] = total;
+        total += count;
+        stripCount++;
+        return true;
+    }
+
+    uint8_t getStripCount() const { return stripCount; }
+    uint16_t getTotal() const { return total; }
+    uint16_t getStart(uint8_t strip) const { return strip < stripCount ? starts[strip] : total; }
+    uint16_t getCount(uint8_t strip) const { return strip < stripCount ? counts[strip] : 0; }
+
+    // 全局像素所在的灯带，超出范围返回 stripCount
+    uint8_t stripOf(uint16_t pixel) const {
+        uint8_t strip = 0;
+        while (strip < stripCount && pixel >= starts[strip] + counts[strip]) strip++;
+        return strip;
+    }
+
+    // 每个宇宙 perUniverse 个像素时该灯带占用的宇宙数
+    uint8_t universeCount(uint8_t strip, uint16_t perUniverse) const {
+        if (strip >= stripCount || perUniverse == 0) return 0;
+        return (uint8_t)((counts[strip] + perUniverse - 1) / perUniverse);
+    }
+
+    // 单条灯带一帧的线上时间
+    uint32_t stripFrameUs(uint8_t strip, PixelType type) const {
+        return strip < stripCount ? pixelFrameUs(type, counts[strip]) : 0;
+    }
+
+    // 整帧时间：并行时取最长的一条，否则依次相加
+    uint32_t frameUs(PixelType type, bool parallel) const {
+        uint32_t result = 0;
+        for (uint8_t strip = 0; strip < stripCount; strip++) {
+            uint32_t us = stripFrameUs(strip, type);
+            if (parallel) {
+                if (us > result) result = us;
+            } else {
+                result += us;
+            }
+        }
+        return result;
+    }
+
+private:
+    uint16_t starts[PIXEL_MAX_STRIPS];
+    uint16_t counts[PIXEL_MAX_STRIPS];
+    uint16_t total;
+    uint8_t stripCount;
+};
@@ -0,0 +1,119 @@
+#include "E131Arbiter.h"
+#include "E131Packet.h"
+#include <string.h>
+
+E131Arbiter::E131Arbiter() : lastSource(NO_SOURCE) {
+    reset();
+}
+
+void E131Arbiter::reset() {
+    memset(sources, 0, sizeof(sources));
+    resetStats();
+}
+
+void E131Arbiter::resetStats() {
+    memset(stats, 0, sizeof(stats));
+}
+
+E131ArbiterResult E131Arbiter::process(uint8_t slot, const uint8_t* cid, uint8_t priority,
+                                       uint8_t sequence, uint8_t options, uint32_t nowMs) {
+    lastSource = NO_SOURCE;
+    if (slot >= MAX_SLOTS) return E131_ACCEPT;
+    E131UniverseStats& stat = stats[slot];
+    Source* entries = sources[slot];
+
+    expireSources(slot, nowMs);
+
+    Source* source = nullptr;
+    Source* freeEntry = nullptr;
+    for (uint8_t i = 0; i < MAX_SOURCES; i++) {
+        if (entries[i].active && memcmp(entries[i].cid, cid, CID_LENGTH) == 0) {
+            source = &entries[i];
+            break;
+        }
+        if (!entries[i].active && !freeEntry) {
+            freeEntry = &entries[i];
+        }
+    }
+
+    // 源结束发送：立即移除，不再等 2.5 秒超时
+    if (options & E131_OPT_TERMINATED) {
+        if (source) {
+            source->active = false;
+            lastSource = source - entries;
+        }
+        stat.terminated++;
+        return E131_TERMINATED;
+    }
+
+    if (source) {
+        // E1.31 6.7.2：(-20, 0] 范围内视为重复或迟到
+        int8_t diff = (int8_t)(sequence - source->sequence);
+        if (diff <= 0 && diff > -20) {
+            stat.outOfSequence++;
+            return E131_OUT_OF_SEQUENCE;
+        }
+    } else {
+        if (!freeEntry) {
+            return E131_TOO_MANY_SOURCES;
+        }
+        source = freeEntry;
+        memcpy(source->cid, cid, CID_LENGTH);
+        source->active = true;
+    }
+
+    source->sequence = sequence;
+    source->priority = priority;
+    source->lastMs = nowMs;
+    lastSource = source - entries;
+
+    if (priority < getActivePriority(slot)) {
+        stat.lowerPriority++;
+        return E131_LOWER_PRIORITY;
+    }
+
+    stat.accepted++;
+    return E131_ACCEPT;
+}
+
+uint8_t E131Arbiter::getActivePriority(uint8_t slot) const {
+    if (slot >= MAX_SLOTS) return 0;
+    uint8_t highest = 0;
+    for (uint8_t i = 0; i < MAX_SOURCES; i++) {
+        const Source& source = sources[slot][i];
+        if (source.active && source.priority > highest) {
+            highest = source.priority;
+        }
+    }
+    return highest;
+}
+
+bool E131Arbiter::isSelected(uint8_t slot, uint8_t source) const {
+    if (slot >= MAX_SLOTS || source >= MAX_SOURCES) return false;
+    const Source& entry = sources[slot][source];
+    return entry.active && entry.priority >= getActivePriority(slot);
+}
+
+uint8_t E131Arbiter::getSourceCount(uint8_t slot) const {
+    if (slot >= MAX_SLOTS) return 0;
+    uint8_t count = 0;
+    for (uint8_t i = 0; i < MAX_SOURCES; i++) {
+        if (sources[slot][i].active) count++;
+    }
+    return count;
+}
+
+const E131UniverseStats& E131Arbiter::getStats(uint8_t slot) const {
+    static const E131UniverseStats empty = {0, 0, 0, 0, 0};
+    return slot < MAX_SLOTS ? stats[slot] : empty;
+}
+
+void E131Arbiter::expireSources(uint8_t slot, uint32_t nowMs) {
+    for (uint8_t i = 0; i < MAX_SOURCES; i++) {
+        Source& source = sources[slot][i];
+        if (source.active && nowMs - source.lastMs >= SOURCE_TIMEOUT_MS) {
+            source.active = false;
+            stats[slot].sourceLost++;
+        }
+    }
+}
@@ -0,0 +1,78 @@
+#pragma once
+
+// sACN 源选择（纯 C++，不依赖 Arduino，可在主机上测试）
+//
+// 每个订阅的宇宙按 CID 跟踪最多 4 个源：
+//   优先级最高的源胜出，低优先级源的数据被丢弃；同为最高优先级的多个源交给合并引擎
+//   序号检查按 E1.31 6.7.2：与上一包相差 (-20, 0] 的包被丢弃
+//   源 2.5 秒没有数据（网络数据丢失）或发出 Stream_Terminated 后移除，
+//   低优先级的源随即可以接管
+// 合并引擎按 mergeKey() 区分 sACN 源（即按 CID，而不是源 IP）；
+// 每次处理后不再 isSelected() 的源要从合并引擎中移除，两边对活动源的判断保持一致
+
+#include <stdint.h>
+#include "UniverseRouter.h"
+
+enum E131ArbiterResult : uint8_t {
+    E131_ACCEPT = 0,
+    E131_LOWER_PRIORITY,
+    E131_OUT_OF_SEQUENCE,
+    E131_TERMINATED,
+    E131_TOO_MANY_SOURCES
+};
+
+struct E131UniverseStats {
+    uint32_t accepted;
+    uint32_t lowerPriority;     // 被更高优先级源压制
+    uint32_t outOfSequence;
+    uint32_t terminated;
+    uint32_t sourceLost;        // 超时移除的源
+};
+
+class E131Arbiter {
+public:
+    static const uint8_t MAX_SLOTS = UniverseRouter::MAX_ROUTES;   // 按路由序号索引
+    static const uint8_t MAX_SOURCES = 4;
+    static const uint32_t SOURCE_TIMEOUT_MS = 2500;
+    static const uint8_t CID_LENGTH = 16;
+    static const uint8_t NO_SOURCE = 0xFF;
+
+    E131Arbiter();
+
+    void reset();
+    void resetStats();
+
+    // 判断一个数据包是否应该输出
+    E131ArbiterResult process(uint8_t slot, const uint8_t* cid, uint8_t priority, uint8_t sequence,
+                              uint8_t options, uint32_t nowMs);
+
+    // 最近一次 process() 的包所属的源在表中的位置，TOO_MANY_SOURCES 时为 NO_SOURCE
+    uint8_t getLastSource() const { return lastSource; }
+
+    // 该源的数据当前是否进入输出：活动且为最高优先级
+    bool isSelected(uint8_t slot, uint8_t source) const;
+
+    // 合并引擎中代表该源的键：源 IP 按网络字节序保存，这个值读作 x.255.255.255，不会与 Art-Net 的单播源 IP 冲突。
+    // 表项被别的 CID 重用之前，旧源总是先被移除，所以同一个键不会混入两个源的数据
+    static uint32_t mergeKey(uint8_t source) { return 0xFFFFFF00UL | source; }
+
+    // 状态查询
+    uint8_t getActivePriority(uint8_t slot) const;
+    uint8_t getSourceCount(uint8_t slot) const;
+    const E131UniverseStats& getStats(uint8_t slot) const;
+
+private:
+    struct Source {
+        uint8_t cid[CID_LENGTH];
+        uint32_t lastMs;
+        uint8_t priority;
+        uint8_t sequence;
+        bool active;
+    };
+
+    Source sources[MAX_SLOTS][MAX_SOURCES];
+    E131UniverseStats stats[MAX_SLOTS];
+    uint8_t lastSource;
+
+    void expireSources(uint8_t slot, uint32_t nowMs);
+};
@@ -0,0 +1,166 @@
+#pragma once
+
+// sACN (ANSI E1.31) 报文解析（纯 C++，不依赖 Arduino，可在主机上测试）
+//
+// 只解析接收 DMX 需要的两种包：
+//   数据包：Root(E131_DATA) + Framing(DATA) + DMP，最长 638 字节
+//   同步包：Root(E131_EXTENDED) + Framing(SYNC)，49 字节
+// 所有多字节字段为大端序。
+
+#include <stdint.h>
+#include <string.h>
+
+#define E131_PORT 5568
+#define E131_MAX_SLOTS 512
+#define E131_MAX_PRIORITY 200
+#define E131_DEFAULT_PRIORITY 100
+#define E131_MIN_UNIVERSE 1
+#define E131_MAX_UNIVERSE 63999
+
+// 字段偏移
+#define E131_ROOT_VECTOR 18
+#define E131_CID 22
+#define E131_FRAMING_VECTOR 40
+#define E131_SOURCE_NAME 44
+#define E131_PRIORITY 108
+#define E131_SYNC_ADDRESS 109
+#define E131_SEQUENCE 111
+#define E131_OPTIONS 112
+#define E131_UNIVERSE 113
+#define E131_DMP_VECTOR 117
+#define E131_ADDRESS_TYPE 118
+#define E131_PROPERTY_COUNT 123
+#define E131_START_CODE 125
+#define E131_DATA_HEADER_SIZE 126          // 到 Start Code 为止
+#define E131_MAX_PACKET_SIZE (E131_DATA_HEADER_SIZE + E131_MAX_SLOTS)
+
+#define E131_SYNC_SEQUENCE 44
+#define E131_SYNC_UNIVERSE 45
+#define E131_SYNC_PACKET_SIZE 49
+
+// 向量
+#define VECTOR_ROOT_E131_DATA 0x00000004
+#define VECTOR_ROOT_E131_EXTENDED 0x00000008
+#define VECTOR_E131_DATA_PACKET 0x00000002
+#define VECTOR_E131_EXTENDED_SYNCHRONIZATION 0x00000001
+#define VECTOR_DMP_SET_PROPERTY 0x02
+
+// Options 位
+#define E131_OPT_PREVIEW 0x80
+#define E131_OPT_TERMINATED 0x40
+#define E131_OPT_FORCE_SYNC 0x20
+
+enum E131PacketType : uint8_t {
+    E131_INVALID = 0,
+    E131_DATA = 1,
+    E131_SYNC = 2
+};
+
+struct E131DataPacket {
+    const uint8_t* cid;         // 16 字节源标识
+    uint8_t priority;
+    uint16_t syncAddress;       // 0 表示不同步
+    uint8_t sequence;
+    uint8_t options;
+    uint16_t universe;
+    uint8_t startCode;
+    uint16_t length;            // 通道数，不含 Start Code
+    const uint8_t* data;        // 指向接收缓冲区内的通道数据
+};
+
+struct E131SyncPacket {
+    const uint8_t* cid;
+    uint8_t sequence;
+    uint16_t syncAddress;
+};
+
+namespace E131Packet {
+
+// ACN 包标识：Preamble Size、Postamble Size、"ASC-E1.17\0\0\0"
+static const uint8_t ROOT_PREAMBLE[16] = {
+    0x00, 0x10, 0x00, 0x00,
+    'A', 'S', 'C', '-', 'E', '1', '.', '1', '7', 0x00, 0x00, 0x00
+};
+
+inline uint16_t read16(const uint8_t* p) {
+    return (p[0] << 8) | p[1];
+}
+
+inline uint32_t read32(const uint8_t* p) {
+    return ((uint32_t)p[0] << 24) | ((uint32_t)p[1] << 16) | ((uint32_t)p[2] << 8) | p[3];
+}
+
+// 宇宙 N 的组播地址 239.255.N高.N低，返回网络字节序
+inline uint32_t multicastAddress(uint16_t universe) {
+    return 239u | (255u << 8) | ((uint32_t)(universe >> 8) << 16) | ((uint32_t)(universe & 0xFF) << 24);
+}
+
+// sACN 宇宙 N 对应 Art-Net Port-Address N - 1，两种协议共用路由表
+inline bool universeToPortAddress(uint16_t universe, uint16_t& portAddress) {
+    if (universe < E131_MIN_UNIVERSE || universe > 0x8000) return false;
+    portAddress = universe - 1;
+    return true;
+}
+
+inline uint16_t portAddressToUniverse(uint16_t portAddress) {
+    return (portAddress & 0x7FFF) + 1;
+}
+
+// 判断包类型，只检查 Root / Framing 层的标识和向量
+inline E131PacketType classify(const uint8_t* data, uint16_t size) {
+    if (!data || size < E131_SYNC_PACKET_SIZE) return E131_INVALID;
+    if (memcmp(data, ROOT_PREAMBLE, sizeof(ROOT_PREAMBLE)) != 0) return E131_INVALID;
+
+    uint32_t rootVector = read32(data + E131_ROOT_VECTOR);
+    uint32_t framingVector = read32(data + E131_FRAMING_VECTOR);
+    if (rootVector == VECTOR_ROOT_E131_DATA && framingVector == VECTOR_E131_DATA_PACKET) {
+        return size >= E131_DATA_HEADER_SIZE ? E131_DATA : E131_INVALID;
+    }
+    if (rootVector == VECTOR_ROOT_E131_EXTENDED && framingVector == VECTOR_E131_EXTENDED_SYNCHRONIZATION) {
+        return E131_SYNC;
+    }
+    return E131_INVALID;
+}
+
+// 解析数据包；调用前 classify() 应返回 E131_DATA
+inline bool parseData(const uint8_t* data, uint16_t size, E131DataPacket& packet) {
+    if (data[E131_DMP_VECTOR] != VECTOR_DMP_SET_PROPERTY || data[E131_ADDRESS_TYPE] != 0xA1) {
+        return false;
+    }
+
+    packet.cid = data + E131_CID;
+    packet.priority = data[E131_PRIORITY];
+    packet.syncAddress = read16(data + E131_SYNC_ADDRESS);
+    packet.sequence = data[E131_SEQUENCE];
+    packet.options = data[E131_OPTIONS];
+    packet.universe = read16(data + E131_UNIVERSE);
+    packet.startCode = data[E131_START_CODE];
+
+    if (packet.priority > E131_MAX_PRIORITY) return false;
+    if (packet.universe < E131_MIN_UNIVERSE || packet.universe > E131_MAX_UNIVERSE) return false;
+
+    // Property Value Count 包含 Start Code
+    uint16_t count = read16(data + E131_PROPERTY_COUNT);
+    if (count < 1) return false;
+    packet.length = count - 1;
+    if (packet.length > E131_MAX_SLOTS) {
+        packet.length = E131_MAX_SLOTS;
+    }
+    if (packet.length > size - E131_DATA_HEADER_SIZE) {
+        packet.length = size - E131_DATA_HEADER_SIZE;
+    }
+
+    packet.data = data + E131_DATA_HEADER_SIZE;
+    return true;
+}
+
+// 解析同步包；不依赖 classify() 先检查过长度，不完整的包直接拒绝
+inline bool parseSync(const uint8_t* data, uint16_t size, E131SyncPacket& packet) {
+    if (!data || size < E131_SYNC_PACKET_SIZE) return false;
+    packet.cid = data + E131_CID;
+    packet.sequence = data[E131_SYNC_SEQUENCE];
+    packet.syncAddress = read16(data + E131_SYNC_UNIVERSE);
+    return packet.syncAddress >= E131_MIN_UNIVERSE && packet.syncAddress <= E131_MAX_UNIVERSE;
+}
+
+} // namespace E131Packet
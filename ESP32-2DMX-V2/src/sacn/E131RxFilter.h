@@ -0,0 +1,42 @@
+#pragma once
+
+// sACN 包头预过滤（纯 C++，主机和 ESP32 通用）
+//
+// 数据包只保留路由表中订阅的宇宙（sACN 宇宙 N = Port-Address N - 1），
+// 同步包全部保留（每帧一个，很小）。预览数据和非零 Start Code 直接丢弃。
+
+#include <stdint.h>
+#include "E131Packet.h"
+#include "UniverseRouter.h"
+#include "ArtnetRxFilter.h"
+
+inline bool e131RxWanted(const uint8_t* header, uint16_t length, const UniverseRouter& router) {
+    switch (E131Packet::classify(header, length)) {
+        case E131_DATA: {
+            if (header[E131_START_CODE] != 0) return false;
+            if (header[E131_OPTIONS] & E131_OPT_PREVIEW) return false;
+            uint16_t portAddress;
+            if (!E131Packet::universeToPortAddress(E131Packet::read16(header + E131_UNIVERSE), portAddress)) {
+                return false;
+            }
+            return router.isSubscribed(portAddress);
+        }
+        case E131_SYNC:
+            return true;
+        default:
+            return false;
+    }
+}
+
+struct E131RxFilter {
+    static const uint16_t PEEK_LENGTH = E131_DATA_HEADER_SIZE;
+    static const RxProtocol PROTOCOL = RX_PROTOCOL_E131;
+
+    const UniverseRouter& router;
+
+    explicit E131RxFilter(const UniverseRouter& routes) : router(routes) {}
+
+    bool operator()(const uint8_t* header, uint16_t length) const {
+        return e131RxWanted(header, length, router);
+    }
+};
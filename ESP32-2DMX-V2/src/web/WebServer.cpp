@@ -94,6 +94,19 @@ void WebServer::begin() {
             handlePixelConfig(request, data, len);
     });
 
+    server->on("/api/patch", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handlePatch(request);
+    });
+    // 空请求体不会进入 body 回调，在请求回调中恢复默认配接
+    server->on("/api/patch", HTTP_POST, [this](AsyncWebServerRequest* request) {
+            if (request->contentLength() == 0) {
+                handlePatchUpdate(request, nullptr, 0, 0, 0);
+            }
+        },
+        NULL, [this](AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total) {
+            handlePatchUpdate(request, data, len, index, total);
+    });
+
     server->on("/api/config", HTTP_GET, [this](AsyncWebServerRequest* request) {
         handleConfig(request);
     });
@@ -102,6 +115,13 @@ void WebServer::begin() {
     request->send(200, "application/json", "{\"success\": true}");
     handleConfigUpdate(request, data, len);
     });
+    server->on("/api/stats", HTTP_GET, [this](AsyncWebServerRequest* request) {
+        handleStats(request);
+    });
+    server->on("/api/stats/reset", HTTP_POST, [this](AsyncWebServerRequest* request) {
+        artnetNode->resetUniverseStats();
+        request->send(200, "application/json", "{\"success\": true}");
+    });
     server->on("/api/reboot", HTTP_POST, [this](AsyncWebServerRequest* request) {
         handleReboot(request);
     });
@@ -189,6 +209,102 @@ void WebServer::handleArtnetConfig(AsyncWebServerRequest* request, uint8_t* data
     }
 }
 
+// 配接表 JSON 的容量：{custom, entries: [每项 8 个字段]}，键和 type 都是常量字符串
+static size_t patchJsonCapacity(size_t entries) {
+    return JSON_OBJECT_SIZE(2) + JSON_ARRAY_SIZE(entries) + entries * JSON_OBJECT_SIZE(8);
+}
+
+// 配接表请求体上限：32 项带缩进的 JSON 也远小于此
+static const size_t PATCH_BODY_MAX = 16384;
+
+// 通道配接表：type 为 "dmx" / "pixel"，通道和位置都从 0 起
+void WebServer::handlePatch(AsyncWebServerRequest* request) {
+    DynamicJsonDocument doc(patchJsonCapacity(artnetNode->getPatchCount()));
+    doc["custom"] = artnetNode->hasCustomPatch();
+    JsonArray entries = doc.createNestedArray("entries");
+    for (uint8_t i = 0; i < artnetNode->getPatchCount(); i++) {
+        const PatchEntry& entry = artnetNode->getPatchEntries()[i];
+        JsonObject item = entries.createNestedObject();
+        item["portAddress"] = entry.portAddress;
+        item["source"] = entry.source;
+        item["count"] = entry.count;
+        item["type"] = entry.type == OUTPUT_PIXEL ? "pixel" : "dmx";
+        item["index"] = entry.index;
+        item["offset"] = entry.offset;
+        item["repeat"] = entry.repeat;
+        item["stride"] = entry.stride;
+    }
+    sendJsonResponse(request, doc);
+}
+
+// 空表或空请求体恢复按配置生成的默认配接。配接表只保存在内存中。
+// 请求体可能分成多块到达：先收齐到 _tempObject（请求结束时由服务器释放），再整体解析
+void WebServer::handlePatchUpdate(AsyncWebServerRequest* request, uint8_t* data, size_t len,
+                                  size_t index, size_t total) {
+    // 空请求体：恢复默认配接，不分配 0 字节的缓冲
+    if (total == 0) {
+        if (artnetNode->setPatch(nullptr, 0)) {
+            request->send(200, "application/json", "{\"status\":\"success\"}");
+        } else {
+            request->send(400, "application/json", "{\"error\":\"Patch too fragmented\"}");
+        }
+        return;
+    }
+    if (index == 0) {
+        if (total > PATCH_BODY_MAX) {
+            request->send(413, "application/json", "{\"error\":\"Patch too large\"}");
+            return;
+        }
+        request->_tempObject = malloc(total);
+        if (!request->_tempObject) {
+            request->send(500, "application/json", "{\"error\":\"Out of memory\"}");
+            return;
+        }
+    }
+    if (!request->_tempObject || index + len > total) return;   // 已经回复过错误
+    uint8_t* body = (uint8_t*)request->_tempObject;
+    memcpy(body + index, data, len);
+    if (index + len < total) return;
+
+    // 按最大项数留出节点，输入中的字符串会被复制，再加上请求体长度
+    DynamicJsonDocument doc(patchJsonCapacity(ArtnetNode::MAX_PATCH_ENTRIES) + total);
+    DeserializationError error = deserializeJson(doc, (const char*)body, total);
+    if (error == DeserializationError::NoMemory) {
+        request->send(400, "application/json", "{\"error\":\"Too many patch entries\"}");
+        return;
+    }
+    if (error) {
+        request->send(400, "application/json", "{\"error\":\"Invalid JSON\"}");
+        return;
+    }
+
+    JsonArray items = doc["entries"];
+    if (items.size() > ArtnetNode::MAX_PATCH_ENTRIES) {
+        request->send(400, "application/json", "{\"error\":\"Too many patch entries\"}");
+        return;
+    }
+
+    PatchEntry entries[ArtnetNode::MAX_PATCH_ENTRIES];
+    uint8_t count = 0;
+    for (JsonObject item : items) {
+        PatchEntry& entry = entries[count++];
+        entry.portAddress = item["portAddress"] | 0;
+        entry.source = item["source"] | 0;
+        entry.count = item["count"] | 512;
+        entry.type = strcmp(item["type"] | "dmx", "pixel") == 0 ? OUTPUT_PIXEL : OUTPUT_DMX;
+        entry.index = item["index"] | 0;
+        entry.offset = item["offset"] | 0;
+        entry.repeat = item["repeat"] | 1;
+        entry.stride = item["stride"] | 0;
+    }
+
+    if (artnetNode->setPatch(entries, count)) {
+        request->send(200, "application/json", "{\"status\":\"success\"}");
+    } else {
+        request->send(400, "application/json", "{\"error\":\"Patch too fragmented\"}");
+    }
+}
+
 void WebServer::handlePixelConfig(AsyncWebServerRequest* request, uint8_t* data, size_t len) {
     DynamicJsonDocument doc(1024);
     DeserializationError error = deserializeJson(doc, data, len);
@@ -658,6 +774,190 @@ void WebServer::sendJsonResponse(AsyncWebServerRequest* request, const JsonDocum
     request->send(200, "application/json", response);
 }
 
+// 运行统计 JSON 的容量，按 createStatsJson 的字段数：固定部分 + 每个 DMX 端口 + 每个宇宙。
+// 键和字符串值都是常量，不占文档空间；改动字段时同步修改这里
+static size_t statsJsonCapacity(size_t routes) {
+    const size_t dmxPort = JSON_OBJECT_SIZE(17) + JSON_OBJECT_SIZE(11);    // 端口 + schedule
+    const size_t inputPort = JSON_OBJECT_SIZE(18);
+    const size_t pixels = JSON_OBJECT_SIZE(11) + JSON_OBJECT_SIZE(13);     // pixels + render
+    const size_t universe = JSON_OBJECT_SIZE(8) + JSON_OBJECT_SIZE(8);     // 宇宙 + sacn
+    return JSON_OBJECT_SIZE(6) + JSON_OBJECT_SIZE(8) + JSON_OBJECT_SIZE(6) + pixels +
+           2 * JSON_ARRAY_SIZE(DMX_PORT_COUNT) + DMX_PORT_COUNT * (dmxPort + inputPort) +
+           JSON_ARRAY_SIZE(routes) + routes * universe;
+}
+
+// 运行统计：DMX 端口帧率，每个已订阅宇宙的序号检查和 sACN 选源结果
+void WebServer::createStatsJson(JsonDocument& doc) {
+    const ArtnetRxStats& rxStats = artnetNode->getRxStats();
+    const ArtnetNode::RxLatency& latency = artnetNode->getRxLatency();
+    JsonObject rx = doc.createNestedObject("rx");
+    rx["mode"] = artnetNode->isEventRx() ? "event" : "poll";
+    rx["received"] = rxStats.received;
+    rx["filtered"] = rxStats.filtered;
+    rx["overflow"] = rxStats.overflow;
+    rx["queued"] = rxStats.queued;
+    rx["latencyLastUs"] = latency.lastUs;
+    rx["latencyMaxUs"] = latency.maxUs;
+    rx["latencyAvgUs"] = latency.frames ? (uint32_t)(latency.totalUs / latency.frames) : 0;
+
+    // 每个 DMX 端口的目标刷新率、实际帧率，以及自适应帧长带来的刷新率提升
+    JsonArray dmx = doc.createNestedArray("dmx");
+    for (uint8_t port = 0; port < DMX_PORT_COUNT; port++) {
+        ESP32DMX* output = artnetNode->getDmxOutput(port);
+        if (!output) continue;
+        const DmxTxStats& txStats = output->getTxStats();
+        JsonObject item = dmx.createNestedObject();
+        item["port"] = port;
+        item["outputting"] = output->isOutputting();
+        item["backend"] = output->getBackend() == DMX_BACKEND_RMT ? "rmt" : "uart";
+        uint32_t periodUs = output->getRefreshPeriodUs();
+        item["targetHz"] = periodUs ? 1000000.0f / periodUs : 0;     // 0：按帧长尽快刷新
+        item["fps"] = output->getFrameRate();
+        item["activeSlots"] = output->getActiveSlots();
+        item["maxHz"] = output->getMaxRefreshRate();
+        item["refreshGain"] = output->getRefreshGain();
+        item["phaseOffsetUs"] = output->getPhaseOffset();
+        item["frames"] = txStats.frames;
+        item["lastPeriodUs"] = txStats.lastPeriodUs;
+        item["minPeriodUs"] = txStats.frames > 1 ? txStats.minPeriodUs : 0;
+        item["maxPeriodUs"] = txStats.maxPeriodUs;
+        item["busyRetries"] = txStats.busyRetries;
+
+        // 刷新调度：策略、输入帧率和每帧的决定
+        // DmxRefreshMode 与 DmxScheduleReason 的取值一一对应
+        static const char* const scheduleNames[] = {"fixed", "match", "keepalive"};
+        const DmxScheduleStats& schedStats = output->getScheduleStats();
+        JsonObject sched = item.createNestedObject("schedule");
+        sched["mode"] = scheduleNames[output->getRefreshMode()];
+        sched["sourceHz"] = output->getSourceRate();
+        sched["sourceFrames"] = schedStats.inputFrames;
+        sched["periodUs"] = schedStats.periodUs;
+        sched["reason"] = scheduleNames[schedStats.lastReason];
+        sched["fixedFrames"] = schedStats.fixedFrames;
+        sched["matchFrames"] = schedStats.matchFrames;
+        sched["keepaliveFrames"] = schedStats.keepaliveFrames;
+        sched["kicks"] = schedStats.kicks;
+        sched["freshFrames"] = schedStats.freshFrames;
+        sched["repeatFrames"] = schedStats.repeatFrames;
+
+        const DmxOutputTransform& transform = output->getTransform();
+        item["curveRuns"] = transform.getRunCount();
+        item["fineChannels"] = transform.getFineCount();
+    }
+
+    // DMX 输入：输入刷新率、Break / MAB 实测值，以及变化检测省下的 ArtDmx
+    JsonArray dmxInput = doc.createNestedArray("dmxInput");
+    for (uint8_t port = 0; port < DMX_PORT_COUNT; port++) {
+        ESP32DMX* input = artnetNode->getDmxInput(port);
+        if (!input) continue;
+        const DmxRxStats& rxStats = input->getRxStats();
+        const DmxInputSenderStats& sendStats = artnetNode->getInputSender(port).getStats();
+        JsonObject item = dmxInput.createNestedObject();
+        item["port"] = port;
+        item["portAddress"] = artnetNode->getInputSender(port).getPortAddress();
+        item["hz"] = input->getInputRate();
+        item["frames"] = rxStats.frames;
+        item["slots"] = rxStats.lastSlots;
+        item["lastPeriodUs"] = rxStats.lastPeriodUs;
+        item["minPeriodUs"] = rxStats.frames > 1 ? rxStats.minPeriodUs : 0;
+        item["maxPeriodUs"] = rxStats.maxPeriodUs;
+        item["breakUs"] = rxStats.breakUs;
+        item["mabUs"] = rxStats.mabUs;
+        item["minBreakUs"] = rxStats.timedFrames ? rxStats.minBreakUs : 0;
+        item["minMabUs"] = rxStats.timedFrames ? rxStats.minMabUs : 0;
+        item["errors"] = rxStats.errors;
+        item["alternateFrames"] = rxStats.alternateFrames;
+        item["sent"] = sendStats.sent;
+        item["changes"] = sendStats.changes;
+        item["keepalives"] = sendStats.keepalives;
+        item["deferred"] = sendStats.deferred;
+    }
+
+    const PatchPlanStats& planStats = artnetNode->getPatchPlan().getStats();
+    JsonObject patch = doc.createNestedObject("patch");
+    patch["custom"] = artnetNode->hasCustomPatch();
+    patch["entries"] = planStats.entries;
+    patch["skipped"] = planStats.skipped;
+    patch["spans"] = planStats.spans;
+    patch["bytes"] = planStats.bytes;
+    patch["overflow"] = planStats.overflow;
+
+    // 像素输出：线上帧时间，以及异步发送时网络任务在 show() 中的最长阻塞
+    const PixelDriver* pixelDriver = artnetNode->getPixelDriver();
+    if (pixelDriver && pixelDriver->isEnabled()) {
+        const PixelShowStats& showStats = pixelDriver->getShowStats();
+        JsonObject pixel = doc.createNestedObject("pixels");
+        pixel["strips"] = pixelDriver->getStripCount();
+        pixel["async"] = pixelDriver->isAsync();
+        pixel["frameUs"] = pixelDriver->getFrameUs();
+        pixel["published"] = showStats.published;
+        pixel["replaced"] = showStats.replaced;
+        pixel["shown"] = showStats.shown;
+        pixel["blockLastUs"] = showStats.lastBlockUs;
+        pixel["blockMaxUs"] = showStats.maxBlockUs;
+        pixel["outputLastUs"] = showStats.lastOutputUs;
+        pixel["outputMaxUs"] = showStats.maxOutputUs;
+
+        // 渲染节拍：目标帧率、各来源渲染的帧、没有变化跳过的格子和超出帧预算的帧
+        static const char* const sourceNames[] = {"dmx", "effect", "mixed"};
+        const PixelFramePacer& pacer = pixelDriver->getPacer();
+        const PixelPacerStats& paceStats = pacer.getStats();
+        JsonObject render = pixel.createNestedObject("render");
+        render["source"] = sourceNames[pacer.getSource()];
+        render["targetFps"] = pacer.getTargetFps();
+        render["budgetUs"] = pacer.getPeriodUs();
+        render["ticks"] = paceStats.ticks;
+        render["dmxFrames"] = paceStats.dmxFrames;
+        render["effectFrames"] = paceStats.effectFrames;
+        render["skipped"] = paceStats.skipped;
+        render["missed"] = paceStats.missed;
+        render["late"] = paceStats.late;
+        render["workLastUs"] = paceStats.lastWorkUs;
+        render["workMaxUs"] = paceStats.maxWorkUs;
+        render["lateLastUs"] = paceStats.lastLateUs;
+        render["lateMaxUs"] = paceStats.maxLateUs;
+    }
+
+    const UniverseRouter& router = artnetNode->getRouter();
+    JsonArray universes = doc.createNestedArray("universes");
+    for (uint8_t slot = 0; slot < router.getRouteCount(); slot++) {
+        const SequenceStats& stats = artnetNode->getUniverseStats(slot);
+        JsonObject item = universes.createNestedObject();
+        item["portAddress"] = router.getPortAddress(slot);
+        item["received"] = stats.received;
+        item["accepted"] = stats.accepted;
+        item["lost"] = stats.lost;
+        item["duplicate"] = stats.duplicate;
+        item["reordered"] = stats.reordered;
+        item["resync"] = stats.resync;
+
+        if (artnetNode->isSacnEnabled()) {
+            const E131Arbiter& arbiter = artnetNode->getSacnArbiter();
+            const E131UniverseStats& sacnStats = arbiter.getStats(slot);
+            JsonObject sacn = item.createNestedObject("sacn");
+            sacn["universe"] = E131Packet::portAddressToUniverse(router.getPortAddress(slot));
+            sacn["priority"] = arbiter.getActivePriority(slot);
+            sacn["sources"] = arbiter.getSourceCount(slot);
+            sacn["accepted"] = sacnStats.accepted;
+            sacn["lowerPriority"] = sacnStats.lowerPriority;
+            sacn["outOfSequence"] = sacnStats.outOfSequence;
+            sacn["terminated"] = sacnStats.terminated;
+            sacn["sourceLost"] = sacnStats.sourceLost;
+        }
+    }
+}
+
+void WebServer::handleStats(AsyncWebServerRequest* request) {
+    DynamicJsonDocument doc(statsJsonCapacity(artnetNode->getRouter().getRouteCount()));
+    createStatsJson(doc);
+    // 容量与字段数不一致时宁可报错，也不返回缺了宇宙的统计
+    if (doc.overflowed()) {
+        request->send(500, "application/json", "{\"error\":\"Stats too large\"}");
+        return;
+    }
+    sendJsonResponse(request, doc);
+}
+
 // 发送状态信息给WebSocket客户端
 void WebServer::sendStatus(AsyncWebSocketClient* client) {
     DynamicJsonDocument doc(1024);
@@ -733,11 +1033,12 @@ bool WebServer::saveConfigFile() {
 // 应用当前配置
 void WebServer::applyConfig() {
     if (artnetNode) {
-        ArtnetNode::Config artnetConfig;
+        ArtnetNode::Config artnetConfig = artnetNode->getConfig();
         artnetConfig.net = config.artnetNet;
         artnetConfig.subnet = config.artnetSubnet;
         artnetConfig.universe = config.artnetUniverse;
         artnetConfig.dmxStartAddress = config.dmxStartAddress;
+        artnetConfig.dhcp = config.dhcpEnabled;
         artnetNode->setConfig(artnetConfig);
     }
 
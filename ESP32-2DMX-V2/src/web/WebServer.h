@@ -25,6 +25,8 @@ public:
     void handleNetworkConfig(AsyncWebServerRequest* request, uint8_t* data, size_t len);
     void handleArtnetConfig(AsyncWebServerRequest* request, uint8_t* data, size_t len);
     void handlePixelConfig(AsyncWebServerRequest* request, uint8_t* data, size_t len);
+    void handlePatch(AsyncWebServerRequest* request);
+    void handlePatchUpdate(AsyncWebServerRequest* request, uint8_t* data, size_t len, size_t index, size_t total);
 
 
     // AP模式相关
@@ -91,6 +93,8 @@ private:
     void sendJsonResponse(AsyncWebServerRequest* request, const JsonDocument& doc);
     void parseConfig(const JsonDocument& doc);
     void createConfigJson(JsonDocument& doc);
+    void createStatsJson(JsonDocument& doc);
+    void handleStats(AsyncWebServerRequest* request);
 
     // WebSocket通信
     void sendStatus(AsyncWebSocketClient* client);
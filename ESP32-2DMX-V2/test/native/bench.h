@@ -0,0 +1,54 @@
+#pragma once
+
+// 主机端基准测试辅助函数，供 native 测试共用
+
+#include <stdint.h>
+#include <stdio.h>
+#include <chrono>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+// 主机 TSC 周期数
+inline uint64_t benchCycles() { return __rdtsc(); }
+#else
+inline uint64_t benchCycles() {
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+#endif
+
+inline uint64_t benchNowNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 防止编译器把被测代码优化掉
+inline void benchKeep(const void* p) {
+    asm volatile("" : : "g"(p) : "memory");
+}
+
+struct BenchResult {
+    double nsPerIter;
+    double cyclesPerIter;
+};
+
+// 重复执行 fn 并返回每次迭代的平均耗时
+template <typename Fn>
+BenchResult benchRun(uint32_t iterations, Fn fn) {
+    for (uint32_t i = 0; i < iterations / 10 + 1; i++) fn();  // 预热
+
+    uint64_t startNs = benchNowNs();
+    uint64_t startCycles = benchCycles();
+    for (uint32_t i = 0; i < iterations; i++) fn();
+    uint64_t cycles = benchCycles() - startCycles;
+    uint64_t ns = benchNowNs() - startNs;
+
+    BenchResult result;
+    result.nsPerIter = (double)ns / iterations;
+    result.cyclesPerIter = (double)cycles / iterations;
+    return result;
+}
+
+inline void benchReport(const char* name, const BenchResult& result) {
+    printf("[bench] %-40s %10.1f ns/iter %10.1f cycles/iter\n",
+           name, result.nsPerIter, result.cyclesPerIter);
+}
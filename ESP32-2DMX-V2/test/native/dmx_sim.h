@@ -0,0 +1,413 @@
+#pragma once
+
+// 主机端 DMX 线路时序模拟，供 native 测试共用
+//
+//   DmxWireSim     代替 ESP32DMX 下面的 UART / GPIO / RMT / esp_timer，实现 DmxTxStateMachine 的
+//                  Port 接口，在虚拟时钟上逐位记录 TX 线的电平变化（带时间戳的线路轨迹）
+//   DmxWireChecker 像逻辑分析仪一样从轨迹解码出帧，报告 Break、MAB、通道数、帧周期和抖动，
+//                  并按 DMX512-A 的发送端限值检查；mabLimitUs 可以把 MAB 限得比标准更紧
+//
+// 轨迹可以来自模拟器，也可以手工构造，用来检查解码和限值本身。
+
+#include <math.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "dmx/DmxFrameBuffer.h"
+#include "dmx/DmxTxStateMachine.h"
+#include "dmx/DmxRmtEncoder.h"
+
+// DMX512-A（ANSI E1.11）发送端时序限值，单位微秒
+#define DMX_LIMIT_BREAK_MIN_US 92
+#define DMX_LIMIT_RX_BREAK_MIN_US 88        // 接收端判定为 Break 的最短低电平
+#define DMX_LIMIT_MAB_MIN_US 12
+#define DMX_LIMIT_MARK_MAX_US 1000000       // MAB、通道间 Mark、帧间 Mark 都小于 1 秒
+#define DMX_LIMIT_PERIOD_MIN_US 1204        // Break 到 Break
+#define DMX_LIMIT_PERIOD_MAX_US 1000000
+#define DMX_LIMIT_MAX_SLOTS 512
+
+struct DmxEdge {
+    uint32_t us;        // 从此刻起线路为 level，直到下一个边沿
+    uint8_t level;
+};
+
+// 电平轨迹：时间单调，相同电平合并。初始为空闲（高）
+class DmxLineTrace {
+public:
+    std::vector<DmxEdge> edges;
+
+    void set(uint32_t us, uint8_t level) {
+        if (!edges.empty() && edges.back().us == us) {
+            edges.back().level = level;
+            if (edges.size() > 1 && edges[edges.size() - 2].level == level) edges.pop_back();
+            return;
+        }
+        if (levelAtEnd() == level) return;
+        edges.push_back({us, level});
+    }
+
+    // 保持 level 时长 us，返回结束时刻
+    uint32_t hold(uint32_t startUs, uint8_t level, uint32_t us) {
+        set(startUs, level);
+        return startUs + us;
+    }
+
+    uint8_t levelAtEnd() const { return edges.empty() ? 1 : edges.back().level; }
+    void clear() { edges.clear(); }
+
+    // 按 UART 的位序列发送一个字节：起始位、LSB 先的 8 个数据位、2 个停止位
+    uint32_t byte(uint32_t startUs, uint8_t value) {
+        uint32_t t = hold(startUs, 0, DMX_TX_BIT_US);
+        for (int b = 0; b < 8; b++) t = hold(t, (value >> b) & 1, DMX_TX_BIT_US);
+        t = hold(t, 1, 2 * DMX_TX_BIT_US);
+        return t;
+    }
+};
+
+// 两条轨迹逐时刻异或：UART 输出电平 ^ 反相控制
+inline DmxLineTrace dmxTraceXor(const DmxLineTrace& a, const DmxLineTrace& b) {
+    DmxLineTrace out;
+    size_t i = 0, j = 0;
+    uint8_t la = 1, lb = 0;
+    while (i < a.edges.size() || j < b.edges.size()) {
+        uint32_t ta = i < a.edges.size() ? a.edges[i].us : UINT32_MAX;
+        uint32_t tb = j < b.edges.size() ? b.edges[j].us : UINT32_MAX;
+        uint32_t t = ta < tb ? ta : tb;
+        if (ta == t) la = a.edges[i++].level;
+        if (tb == t) lb = b.edges[j++].level;
+        out.set(t, la ^ lb);
+    }
+    return out;
+}
+
+// 模拟的 DMX 输出硬件。frames / minSlots 与 ESP32DMX 相同
+class DmxWireSim {
+public:
+    DmxFrameBuffer frames;
+    uint16_t minSlots;
+    uint32_t idleBits;              // uart_set_tx_idle_num
+    uint32_t timerJitterUs;         // 定时器回调在 [0, timerJitterUs] 内随机推迟
+    uint32_t slotGapUs;             // 每个通道后的额外 Mark（模拟 FIFO 续填不及时）
+    uint32_t now;
+    uint32_t wakeups;
+
+    DmxWireSim()
+        : minSlots(DMX_SLOT_COUNT)
+        , idleBits(3)
+        , timerJitterUs(0)
+        , slotGapUs(0)
+        , now(0)
+        , wakeups(0)
+        , armed(false)
+        , timerAt(0)
+        , txEndUs(0)
+        , jitterSeed(12345)
+        , mode(DMX_BREAK_TIMER) {}
+
+    // 按状态机的 Break 模式选择模拟的硬件：TIMER / UART 用 UART 模型，ENCODED 用 RMT 模型
+    void attach(DmxTxStateMachine& tx) {
+        mode = tx.getBreakMode();
+        idleBits = tx.getMabBits();
+        encoder.setTiming(tx.getBreakUs(), tx.getMabUs());
+        encoder.invalidate();
+    }
+
+    void writeSlots(const uint8_t* data, uint16_t length) {
+        frames.writeSlots(data, length);
+        frames.commit();
+    }
+
+    // 在当前时刻提交一帧新数据，按调度策略提前等待中的定时器（ESP32DMX::commitFrame 的做法）
+    void input(DmxTxStateMachine& tx, const uint8_t* data, uint16_t length) {
+        writeSlots(data, length);
+        if (tx.onInput(now) && armed) {
+            timerAt = now + tx.armDelay(timerAt - now, now);
+        }
+    }
+
+    // 推进虚拟时钟到 endUs，期间按定时器触发状态机
+    void run(DmxTxStateMachine& tx, uint32_t endUs) {
+        while (armed && (int32_t)(timerAt - endUs) <= 0) {
+            armed = false;
+            now = timerAt;
+            wakeups++;
+            tx.onTimer(*this, now);
+        }
+        now = endUs;
+    }
+
+    // TX 线的电平轨迹
+    DmxLineTrace line() const { return dmxTraceXor(uartLine, invert); }
+
+    // ---- Port 接口 ----
+    bool txIdle() { return (int32_t)(now - txEndUs) >= 0; }
+    void breakBegin() { invert.set(now, 1); }
+    void breakEnd() { invert.set(now, 0); }
+
+    uint16_t sendFrame() {
+        uint16_t bytes = takeFrame();
+        shiftOut(bytes);
+        return bytes;
+    }
+
+    uint16_t sendFrameWithBreak(uint32_t breakBits) {
+        uint16_t bytes = takeFrame();
+        if (mode == DMX_BREAK_ENCODED) {
+            encoder.encode(frameData, bytes);
+            playItems();
+            return bytes;
+        }
+        uint32_t t = shiftOut(bytes);
+        t = uartLine.hold(t, 0, breakBits * DMX_TX_BIT_US);
+        uartLine.set(t, 1);
+        txEndUs = t;
+        return bytes;
+    }
+
+    void arm(uint32_t us) {
+        armed = true;
+        timerAt = now + us + nextJitter();
+    }
+
+private:
+    bool armed;
+    uint32_t timerAt;
+    uint32_t txEndUs;               // UART / RMT 发完的时刻
+    uint32_t jitterSeed;
+    DmxBreakMode mode;
+    DmxLineTrace uartLine;          // UART / RMT 输出
+    DmxLineTrace invert;            // 1 = TX 反相（软件 Break）
+    DmxRmtEncoder encoder;
+    uint8_t frameData[DMX_SLOT_COUNT + 1];
+
+    uint16_t takeFrame() {
+        frames.acquire();
+        const DmxFrame& frame = frames.front();
+        uint16_t bytes = frame.activeSlots(minSlots) + 1;
+        memcpy(frameData, frame.data, bytes);
+        return bytes;
+    }
+
+    // UART 上一次发送结束后至少空闲 idleBits 位才开始下一次
+    uint32_t shiftOut(uint16_t bytes) {
+        uint32_t t = txEndUs + idleBits * DMX_TX_BIT_US;
+        if ((int32_t)(now - t) > 0) t = now;
+        for (uint16_t i = 0; i < bytes; i++) {
+            t = uartLine.byte(t, frameData[i]);
+            if (slotGapUs && i + 1 < bytes) t += slotGapUs;
+        }
+        txEndUs = t;
+        return t;
+    }
+
+    // RMT：按 item 逐段输出，时长为 0 的一段结束，之后保持空闲电平（高）
+    void playItems() {
+        uint32_t t = now;
+        const uint32_t* items = encoder.items();
+        for (uint16_t i = 0; i < encoder.itemCount(); i++) {
+            uint32_t parts[2] = {items[i] & 0xFFFF, items[i] >> 16};
+            for (uint32_t part : parts) {
+                uint32_t duration = part & DmxRmtEncoder::MAX_DURATION;
+                if (duration == 0) {
+                    uartLine.set(t, 1);
+                    txEndUs = t;
+                    return;
+                }
+                t = uartLine.hold(t, (part >> 15) & 1, duration);
+            }
+        }
+        uartLine.set(t, 1);
+        txEndUs = t;
+    }
+
+    uint32_t nextJitter() {
+        if (!timerJitterUs) return 0;
+        jitterSeed = jitterSeed * 1103515245 + 12345;
+        return (jitterSeed >> 16) % (timerJitterUs + 1);
+    }
+};
+
+// 解码出的一帧
+struct DmxFrameTiming {
+    uint32_t breakStartUs;
+    uint32_t breakUs;
+    uint32_t mabUs;
+    uint32_t periodUs;              // 到下一帧 Break 起点
+    uint32_t maxSlotMarkUs;         // 通道间最长的额外 Mark
+    uint16_t slots;                 // 不含起始码
+    uint8_t startCode;
+    bool framingError;              // 停止位不是高电平，或低电平既不是数据也不够 Break
+};
+
+// DMX512-A 违规计数
+struct DmxViolations {
+    uint32_t breakShort;
+    uint32_t mabShort;
+    uint32_t mabLong;           // 超过 DmxWireChecker::mabLimitUs
+    uint32_t markLong;
+    uint32_t periodShort;
+    uint32_t periodLong;
+    uint32_t slotsOver;
+    uint32_t framingErrors;
+
+    uint32_t total() const {
+        return breakShort + mabShort + mabLong + markLong + periodShort + periodLong + slotsOver + framingErrors;
+    }
+};
+
+struct DmxTimingReport {
+    uint32_t frames;                // 完整帧（后面跟着下一帧的 Break）
+    uint32_t minBreakUs, maxBreakUs;
+    uint32_t minMabUs, maxMabUs;
+    uint32_t minPeriodUs, maxPeriodUs;
+    float meanPeriodUs;
+    float jitterUs;                 // 帧周期的标准差
+    uint32_t jitterPeakUs;          // 帧周期 max - min
+    float refreshHz;
+    uint16_t minSlots, maxSlots;
+    uint32_t maxSlotMarkUs;
+    DmxViolations violations;
+
+    bool compliant() const { return frames > 0 && violations.total() == 0; }
+};
+
+class DmxWireChecker {
+public:
+    std::vector<DmxFrameTiming> frames;
+    std::vector<std::vector<uint8_t>> data;     // 每帧解码出的字节（含起始码）
+    uint32_t mabLimitUs;                        // MAB 上限，默认只按标准的 1 秒
+
+    DmxWireChecker() : mabLimitUs(DMX_LIMIT_MARK_MAX_US) {}
+
+    // 解码整条轨迹。只有后面跟着 Break 的帧才完整，轨迹末尾未发完的帧不计入
+    DmxTimingReport analyze(const DmxLineTrace& trace) {
+        frames.clear();
+        data.clear();
+        const std::vector<DmxEdge>& e = trace.edges;
+
+        size_t i = 0;
+        bool inFrame = false;
+        DmxFrameTiming current = {};
+        std::vector<uint8_t> bytes;
+        uint32_t slotEndUs = 0;
+
+        while (i < e.size()) {
+            if (e[i].level != 0) { i++; continue; }
+            uint32_t lowStart = e[i].us;
+            uint32_t lowLen = segmentLength(e, i);
+            if (lowLen == UINT32_MAX) break;        // 末尾一直为低，不完整
+
+            if (lowLen >= DMX_LIMIT_RX_BREAK_MIN_US) {
+                if (inFrame) {
+                    current.periodUs = lowStart - current.breakStartUs;
+                    finish(current, bytes);
+                }
+                current = DmxFrameTiming();
+                bytes.clear();
+                current.breakStartUs = lowStart;
+                current.breakUs = lowLen;
+                uint32_t mab = i + 1 < e.size() ? segmentLength(e, i + 1) : UINT32_MAX;
+                if (mab == UINT32_MAX) break;
+                current.mabUs = mab;
+                slotEndUs = 0;
+                inFrame = true;
+                i += 2;
+                continue;
+            }
+
+            if (!inFrame) { i++; continue; }
+
+            // 一个字节：在每位中点采样
+            if (lowLen > 9 * DMX_TX_BIT_US) current.framingError = true;
+            uint8_t value = 0;
+            for (int b = 0; b < 8; b++) {
+                value |= levelAt(e, i, lowStart + (1 + b) * DMX_TX_BIT_US + DMX_TX_BIT_US / 2) << b;
+            }
+            if (!levelAt(e, i, lowStart + 9 * DMX_TX_BIT_US + DMX_TX_BIT_US / 2) ||
+                !levelAt(e, i, lowStart + 10 * DMX_TX_BIT_US + DMX_TX_BIT_US / 2)) {
+                current.framingError = true;
+            }
+            if (!bytes.empty()) {
+                uint32_t mark = lowStart - slotEndUs;
+                if (mark > current.maxSlotMarkUs) current.maxSlotMarkUs = mark;
+            }
+            bytes.push_back(value);
+            slotEndUs = lowStart + 11 * DMX_TX_BIT_US;
+
+            // 跳到这个字节之后的第一个下降沿
+            while (i < e.size() && (e[i].us < slotEndUs || e[i].level != 0)) i++;
+        }
+        return report();
+    }
+
+    void print(const char* name, const DmxTimingReport& r) const {
+        printf("[timing] %-28s frames %4u  break %3u-%-3u us  MAB %3u-%-4u us  slots %3u-%-3u  "
+               "period %5u-%-5u us  mean %8.1f us  jitter %6.1f us (pk %4u)  %6.1f Hz  violations %u\n",
+               name, r.frames, r.minBreakUs, r.maxBreakUs, r.minMabUs, r.maxMabUs,
+               r.minSlots, r.maxSlots, r.minPeriodUs, r.maxPeriodUs, r.meanPeriodUs,
+               r.jitterUs, r.jitterPeakUs, r.refreshHz, r.violations.total());
+    }
+
+private:
+    static uint32_t segmentLength(const std::vector<DmxEdge>& e, size_t i) {
+        return i + 1 < e.size() ? e[i + 1].us - e[i].us : UINT32_MAX;
+    }
+
+    // 从边沿 i 开始向后找 t 时刻的电平
+    static uint8_t levelAt(const std::vector<DmxEdge>& e, size_t i, uint32_t t) {
+        while (i + 1 < e.size() && e[i + 1].us <= t) i++;
+        return e[i].level;
+    }
+
+    void finish(DmxFrameTiming& frame, const std::vector<uint8_t>& bytes) {
+        if (!bytes.empty()) {
+            frame.startCode = bytes[0];
+            frame.slots = bytes.size() - 1;
+        }
+        frames.push_back(frame);
+        data.push_back(bytes);
+    }
+
+    DmxTimingReport report() const {
+        DmxTimingReport r = {};
+        r.frames = frames.size();
+        if (frames.empty()) return r;
+
+        r.minBreakUs = r.minMabUs = r.minPeriodUs = UINT32_MAX;
+        r.minSlots = 0xFFFF;
+        double sum = 0;
+        for (const DmxFrameTiming& f : frames) {
+            if (f.breakUs < r.minBreakUs) r.minBreakUs = f.breakUs;
+            if (f.breakUs > r.maxBreakUs) r.maxBreakUs = f.breakUs;
+            if (f.mabUs < r.minMabUs) r.minMabUs = f.mabUs;
+            if (f.mabUs > r.maxMabUs) r.maxMabUs = f.mabUs;
+            if (f.periodUs < r.minPeriodUs) r.minPeriodUs = f.periodUs;
+            if (f.periodUs > r.maxPeriodUs) r.maxPeriodUs = f.periodUs;
+            if (f.slots < r.minSlots) r.minSlots = f.slots;
+            if (f.slots > r.maxSlots) r.maxSlots = f.slots;
+            if (f.maxSlotMarkUs > r.maxSlotMarkUs) r.maxSlotMarkUs = f.maxSlotMarkUs;
+            sum += f.periodUs;
+
+            DmxViolations& v = r.violations;
+            if (f.breakUs < DMX_LIMIT_BREAK_MIN_US) v.breakShort++;
+            if (f.mabUs < DMX_LIMIT_MAB_MIN_US) v.mabShort++;
+            if (f.mabUs > mabLimitUs) v.mabLong++;
+            if (f.mabUs >= DMX_LIMIT_MARK_MAX_US || f.maxSlotMarkUs >= DMX_LIMIT_MARK_MAX_US) v.markLong++;
+            if (f.periodUs < DMX_LIMIT_PERIOD_MIN_US) v.periodShort++;
+            if (f.periodUs > DMX_LIMIT_PERIOD_MAX_US) v.periodLong++;
+            if (f.slots > DMX_LIMIT_MAX_SLOTS) v.slotsOver++;
+            if (f.framingError) v.framingErrors++;
+        }
+        r.meanPeriodUs = sum / frames.size();
+        double var = 0;
+        for (const DmxFrameTiming& f : frames) {
+            double d = f.periodUs - r.meanPeriodUs;
+            var += d * d;
+        }
+        r.jitterUs = frames.size() > 1 ? sqrt(var / frames.size()) : 0;
+        r.jitterPeakUs = r.maxPeriodUs - r.minPeriodUs;
+        r.refreshHz = 1e6f / r.meanPeriodUs;
+        return r;
+    }
+};
@@ -0,0 +1,150 @@
+#pragma once
+
+// 主机端 lwIP 模拟层，供 native 测试共用
+//
+// 只模拟 Art-Net 接收路径用到的部分：
+//   pbuf 链和 pbuf_copy_partial()，与 lwIP 的签名一致
+//   一个 "tcpip 线程"：按注入顺序把数据报交给 udp_recv 回调
+//   任务通知：xTaskNotifyGive / ulTaskNotifyTake 的计数语义
+
+#include <stdint.h>
+#include <string.h>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+struct pbuf {
+    struct pbuf* next;
+    void* payload;
+    uint16_t tot_len;
+    uint16_t len;
+};
+
+inline uint16_t pbuf_copy_partial(const struct pbuf* p, void* dataptr, uint16_t len, uint16_t offset) {
+    uint8_t* dst = (uint8_t*)dataptr;
+    uint16_t copied = 0;
+    for (; p && copied < len; p = p->next) {
+        if (offset >= p->len) {
+            offset -= p->len;
+            continue;
+        }
+        uint16_t chunk = p->len - offset;
+        if (chunk > len - copied) chunk = len - copied;
+        memcpy(dst + copied, (const uint8_t*)p->payload + offset, chunk);
+        copied += chunk;
+        offset = 0;
+    }
+    return copied;
+}
+
+inline uint32_t lwipSimNowUs() {
+    return (uint32_t)std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 把一个数据报切成若干段 pbuf，模拟 WiFi 驱动交上来的链
+class PbufChain {
+public:
+    PbufChain(const uint8_t* data, uint16_t length, uint16_t segment) : bytes(data, data + length) {
+        for (uint16_t offset = 0; offset < length; offset += segment) {
+            pbuf p;
+            p.next = nullptr;
+            p.payload = &bytes[offset];
+            p.len = (length - offset < segment) ? length - offset : segment;
+            p.tot_len = length - offset;
+            links.push_back(p);
+        }
+        for (size_t i = 0; i + 1 < links.size(); i++) {
+            links[i].next = &links[i + 1];
+        }
+    }
+
+    const pbuf* head() const { return links.empty() ? nullptr : &links[0]; }
+
+private:
+    std::vector<uint8_t> bytes;
+    std::vector<pbuf> links;
+};
+
+// 任务通知：give 累加计数，take 等待计数非零后清零
+class TaskNotifySim {
+public:
+    TaskNotifySim() : count(0) {}
+
+    void give() {
+        std::lock_guard<std::mutex> lock(mutex);
+        count++;
+        cond.notify_one();
+    }
+
+    uint32_t take(uint32_t timeoutMs) {
+        std::unique_lock<std::mutex> lock(mutex);
+        cond.wait_for(lock, std::chrono::milliseconds(timeoutMs), [this] { return count > 0; });
+        uint32_t value = count;
+        count = 0;
+        return value;
+    }
+
+private:
+    std::mutex mutex;
+    std::condition_variable cond;
+    uint32_t count;
+};
+
+// tcpip 线程：数据报到达时调用回调，回调签名与 udp_recv 的用法对应
+class LwipSim {
+public:
+    typedef void (*RecvFn)(void* arg, const pbuf* p, uint32_t ip, uint16_t port);
+
+    LwipSim(RecvFn fn, void* fnArg, uint16_t segment = 256)
+        : recv(fn), arg(fnArg), segmentSize(segment), running(true), thread(&LwipSim::run, this) {}
+
+    ~LwipSim() {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            running = false;
+            cond.notify_one();
+        }
+        thread.join();
+    }
+
+    void inject(const uint8_t* data, uint16_t length, uint32_t ip, uint16_t port) {
+        std::lock_guard<std::mutex> lock(mutex);
+        pending.push_back(Datagram{std::vector<uint8_t>(data, data + length), ip, port});
+        cond.notify_one();
+    }
+
+private:
+    struct Datagram {
+        std::vector<uint8_t> bytes;
+        uint32_t ip;
+        uint16_t port;
+    };
+
+    RecvFn recv;
+    void* arg;
+    uint16_t segmentSize;
+    bool running;
+    std::mutex mutex;
+    std::condition_variable cond;
+    std::deque<Datagram> pending;
+    std::thread thread;
+
+    void run() {
+        for (;;) {
+            Datagram datagram;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                cond.wait(lock, [this] { return !running || !pending.empty(); });
+                if (!running && pending.empty()) return;
+                datagram = std::move(pending.front());
+                pending.pop_front();
+            }
+            PbufChain chain(datagram.bytes.data(), (uint16_t)datagram.bytes.size(), segmentSize);
+            recv(arg, chain.head(), datagram.ip, datagram.port);
+        }
+    }
+};
@@ -0,0 +1,241 @@
+#include <unity.h>
+#include <string.h>
+#include "artnet/ArtPollReplyBuilder.h"
+#include "artnet/UniverseRouter.h"
+#include "../bench.h"
+
+static UniverseRouter router;
+static ArtPollReplyBuilder* builder;
+static ArtPollReplyInfo info;
+
+static const uint8_t NODE_IP[4] = {2, 0, 0, 10};
+static const uint8_t NODE_MAC[6] = {0x24, 0x6F, 0x28, 0x01, 0x02, 0x03};
+
+// 与 ArtnetNode::rebuildRoutes 相同：基准宇宙起 2 路 DMX，随后每段像素一个宇宙
+static void addDefaultRoutes(uint16_t base, uint8_t pixelSegments) {
+    router.clear();
+    router.addRoute(base++, OUTPUT_DMX, 0);
+    router.addRoute(base++, OUTPUT_DMX, 1);
+    for (uint8_t segment = 0; segment < pixelSegments; segment++) {
+        router.addRoute(base++, OUTPUT_PIXEL, segment);
+    }
+}
+
+void setUp() {
+    builder = new ArtPollReplyBuilder();
+    memcpy(info.ip, NODE_IP, 4);
+    memcpy(info.mac, NODE_MAC, 6);
+    info.firmware = 0x0102;
+    info.oem = 0x1234;
+    info.estaMan = 0x7FF0;
+    info.status1 = 0x80;
+    info.status2 = STATUS2_PORT_ADDRESS_15BIT;
+    info.shortName = "ESP32 ArtNode";
+    info.longName = "ESP32 Art-Net Node";
+}
+
+void tearDown() {
+    delete builder;
+}
+
+void test_single_reply_fields() {
+    addDefaultRoutes(0x0123, 1);
+    TEST_ASSERT_TRUE(builder->isDirty());
+    builder->rebuild(info, router);
+    TEST_ASSERT_FALSE(builder->isDirty());
+    TEST_ASSERT_EQUAL_UINT8(1, builder->getReplyCount());
+
+    const uint8_t* reply = builder->prepare(0, nullptr);
+    TEST_ASSERT_EQUAL_MEMORY(ArtnetPacket::ID, reply, 8);
+    TEST_ASSERT_EQUAL_HEX8(0x00, reply[8]);
+    TEST_ASSERT_EQUAL_HEX8(0x21, reply[9]);
+    TEST_ASSERT_EQUAL_MEMORY(NODE_IP, reply + ApIp, 4);
+
+    // 端口 0x1936 低字节在前
+    TEST_ASSERT_EQUAL_HEX8(0x36, reply[ApPort]);
+    TEST_ASSERT_EQUAL_HEX8(0x19, reply[ApPort + 1]);
+
+    TEST_ASSERT_EQUAL_HEX8(0x01, reply[ApVersInfoH]);
+    TEST_ASSERT_EQUAL_HEX8(0x02, reply[ApVersInfoH + 1]);
+    TEST_ASSERT_EQUAL_HEX8(0x01, reply[ApNetSwitch]);
+    TEST_ASSERT_EQUAL_HEX8(0x02, reply[ApSubSwitch]);
+    TEST_ASSERT_EQUAL_HEX8(0x12, reply[ApOemHi]);
+    TEST_ASSERT_EQUAL_HEX8(0x34, reply[ApOemHi + 1]);
+    TEST_ASSERT_EQUAL_HEX8(0xF0, reply[ApEstaManLo]);
+    TEST_ASSERT_EQUAL_HEX8(0x7F, reply[ApEstaManLo + 1]);
+    TEST_ASSERT_EQUAL_STRING("ESP32 ArtNode", (const char*)reply + ApShortName);
+    TEST_ASSERT_EQUAL_STRING("ESP32 Art-Net Node", (const char*)reply + ApLongName);
+
+    TEST_ASSERT_EQUAL_UINT8(0, reply[ApNumPortsHi]);
+    TEST_ASSERT_EQUAL_UINT8(3, reply[ApNumPortsHi + 1]);
+    const uint8_t swOut[4] = {0x3, 0x4, 0x5, 0x0};
+    const uint8_t portTypes[4] = {0x80, 0x80, 0x80, 0x00};
+    TEST_ASSERT_EQUAL_MEMORY(swOut, reply + ApSwOut, 4);
+    TEST_ASSERT_EQUAL_MEMORY(portTypes, reply + ApPortTypes, 4);
+
+    TEST_ASSERT_EQUAL_MEMORY(NODE_MAC, reply + ApMac, 6);
+    TEST_ASSERT_EQUAL_MEMORY(NODE_IP, reply + ApBindIp, 4);
+    TEST_ASSERT_EQUAL_UINT8(1, reply[ApBindIndex]);
+    TEST_ASSERT_EQUAL_HEX8(STATUS2_PORT_ADDRESS_15BIT, reply[ApStatus2]);
+}
+
+void test_more_than_four_universes_use_bind_indexes() {
+    addDefaultRoutes(0x0000, 8);   // 10 个宇宙
+    builder->rebuild(info, router);
+    TEST_ASSERT_EQUAL_UINT8(3, builder->getReplyCount());
+
+    const uint8_t expectedPorts[3] = {4, 4, 2};
+    for (uint8_t i = 0; i < 3; i++) {
+        const uint8_t* reply = builder->prepare(i, nullptr);
+        TEST_ASSERT_EQUAL_UINT8(i + 1, reply[ApBindIndex]);
+        TEST_ASSERT_EQUAL_UINT8(expectedPorts[i], reply[ApNumPortsHi + 1]);
+        TEST_ASSERT_EQUAL_UINT8(i * 4, reply[ApSwOut]);
+    }
+
+    // ArtAddress 按同样的 BindIndex 分组找到路由
+    TEST_ASSERT_EQUAL_INT16(0, builder->slotOf(1, 0));
+    TEST_ASSERT_EQUAL_INT16(5, builder->slotOf(2, 1));
+    TEST_ASSERT_EQUAL_INT16(9, builder->slotOf(3, 1));
+    TEST_ASSERT_EQUAL_INT16(-1, builder->slotOf(3, 2));
+    TEST_ASSERT_EQUAL_INT16(-1, builder->slotOf(4, 0));
+    // BindIndex 0 视为根设备
+    TEST_ASSERT_EQUAL_INT16(1, builder->slotOf(0, 1));
+}
+
+void test_universes_crossing_subnet_get_separate_replies() {
+    addDefaultRoutes(0x000E, 2);   // 0x0E 0x0F | 0x10 0x11
+    builder->rebuild(info, router);
+    TEST_ASSERT_EQUAL_UINT8(2, builder->getReplyCount());
+
+    const uint8_t* first = builder->prepare(0, nullptr);
+    TEST_ASSERT_EQUAL_UINT8(0, first[ApSubSwitch]);
+    TEST_ASSERT_EQUAL_UINT8(2, first[ApNumPortsHi + 1]);
+    TEST_ASSERT_EQUAL_UINT8(0x0E, first[ApSwOut]);
+
+    const uint8_t* second = builder->prepare(1, nullptr);
+    TEST_ASSERT_EQUAL_UINT8(1, second[ApSubSwitch]);
+    TEST_ASSERT_EQUAL_UINT8(2, second[ApNumPortsHi + 1]);
+    TEST_ASSERT_EQUAL_UINT8(0x00, second[ApSwOut]);
+    TEST_ASSERT_EQUAL_UINT8(0x01, second[ApSwOut + 1]);
+}
+
+void test_node_report_counter_and_good_output() {
+    addDefaultRoutes(0x0000, 1);
+    builder->rebuild(info, router);
+
+    uint8_t goodOutput[UniverseRouter::MAX_ROUTES] = {0};
+    goodOutput[0] = GOOD_OUTPUT_DATA;
+    goodOutput[2] = GOOD_OUTPUT_DATA | GOOD_OUTPUT_MERGING;
+
+    const uint8_t* reply = builder->prepare(0, goodOutput);
+    TEST_ASSERT_EQUAL_STRING("#0001 [0000] OK", (const char*)reply + ApNodeReport);
+    TEST_ASSERT_EQUAL_HEX8(GOOD_OUTPUT_DATA, reply[ApGoodOutput]);
+    TEST_ASSERT_EQUAL_HEX8(0, reply[ApGoodOutput + 1]);
+    TEST_ASSERT_EQUAL_HEX8(GOOD_OUTPUT_DATA | GOOD_OUTPUT_MERGING, reply[ApGoodOutput + 2]);
+
+    reply = builder->prepare(0, goodOutput);
+    TEST_ASSERT_EQUAL_STRING("#0001 [0001] OK", (const char*)reply + ApNodeReport);
+
+    // 重建模板不影响计数器
+    builder->invalidate();
+    builder->rebuild(info, router);
+    reply = builder->prepare(0, goodOutput);
+    TEST_ASSERT_EQUAL_STRING("#0001 [0002] OK", (const char*)reply + ApNodeReport);
+}
+
+// DMX 输入端口作为输入端口列出：PortTypes 0x40、SwIn 为发送用的宇宙，GoodInput 发送时写入
+void test_input_ports_are_listed() {
+    router.clear();
+    router.addRoute(0x0123, OUTPUT_DMX, 0);
+    router.addRoute(0x0125, OUTPUT_PIXEL, 0);
+    const uint16_t inputs[2] = {0x0124, 0x0130};     // 第二个输入在另一个 SubNet
+    builder->rebuild(info, router, inputs, 2);
+    TEST_ASSERT_EQUAL_UINT8(2, builder->getReplyCount());
+
+    uint8_t goodOutput[UniverseRouter::MAX_ROUTES] = {0};
+    goodOutput[0] = GOOD_OUTPUT_DATA;
+    const uint8_t goodInput[2] = {GOOD_INPUT_DATA, 0};
+    const uint8_t* reply = builder->prepare(0, goodOutput, goodInput);
+    TEST_ASSERT_EQUAL_UINT8(3, reply[ApNumPortsHi + 1]);
+    const uint8_t portTypes[4] = {PORT_TYPE_OUTPUT, PORT_TYPE_OUTPUT, PORT_TYPE_INPUT, 0x00};
+    const uint8_t swOut[4] = {0x3, 0x5, 0x0, 0x0};
+    const uint8_t swIn[4] = {0x0, 0x0, 0x4, 0x0};
+    const uint8_t good[4] = {GOOD_INPUT_DISABLED, GOOD_INPUT_DISABLED, GOOD_INPUT_DATA, 0x00};
+    TEST_ASSERT_EQUAL_MEMORY(portTypes, reply + ApPortTypes, 4);
+    TEST_ASSERT_EQUAL_MEMORY(swOut, reply + ApSwOut, 4);
+    TEST_ASSERT_EQUAL_MEMORY(swIn, reply + ApSwIn, 4);
+    TEST_ASSERT_EQUAL_MEMORY(good, reply + ApGoodInput, 4);
+    TEST_ASSERT_EQUAL_HEX8(GOOD_OUTPUT_DATA, reply[ApGoodOutput]);
+    TEST_ASSERT_EQUAL_HEX8(0, reply[ApGoodOutput + 2]);
+
+    reply = builder->prepare(1, goodOutput, goodInput);
+    TEST_ASSERT_EQUAL_UINT8(3, reply[ApSubSwitch]);
+    TEST_ASSERT_EQUAL_UINT8(1, reply[ApNumPortsHi + 1]);
+    TEST_ASSERT_EQUAL_HEX8(PORT_TYPE_INPUT, reply[ApPortTypes]);
+    TEST_ASSERT_EQUAL_HEX8(0x0, reply[ApSwIn]);
+    TEST_ASSERT_EQUAL_HEX8(0, reply[ApGoodInput]);
+
+    // 定向 ArtPoll 也覆盖输入端口；ArtAddress 的合并命令不作用于输入端口
+    TEST_ASSERT_TRUE(builder->matchesTarget(0, 0x0124, 0x0124));
+    TEST_ASSERT_TRUE(builder->matchesTarget(1, 0x0130, 0x0130));
+    TEST_ASSERT_EQUAL_INT16(1, builder->slotOf(1, 1));
+    TEST_ASSERT_EQUAL_INT16(-1, builder->slotOf(1, 2));
+    TEST_ASSERT_EQUAL_INT16(-1, builder->slotOf(2, 0));
+}
+
+void test_targeted_poll_matches_port_range() {
+    addDefaultRoutes(0x0000, 8);
+    builder->rebuild(info, router);
+
+    // 只覆盖第二个绑定中的宇宙 5
+    TEST_ASSERT_FALSE(builder->matchesTarget(0, 5, 5));
+    TEST_ASSERT_TRUE(builder->matchesTarget(1, 5, 5));
+    TEST_ASSERT_FALSE(builder->matchesTarget(2, 5, 5));
+    TEST_ASSERT_TRUE(builder->matchesTarget(2, 0, 0x7FFF));
+}
+
+void test_reply_address_policy() {
+    // 网络字节序：首个八位组在最低字节
+    uint32_t node = 2 | (0 << 8) | (0 << 16) | (10u << 24);          // 2.0.0.10
+    uint32_t mask = 0xFF;                                              // 255.0.0.0
+    uint32_t console = 2 | (1 << 8) | (2 << 16) | (3u << 24);         // 2.1.2.3
+    uint32_t remote = 10 | (0 << 8) | (0 << 16) | (5u << 24);         // 10.0.0.5
+
+    uint32_t directed = 2 | 0xFFFFFF00;                                // 2.255.255.255
+    TEST_ASSERT_EQUAL_HEX32(directed, ArtPollReplyBuilder::replyAddress(console, node, mask));
+    TEST_ASSERT_EQUAL_HEX32(remote, ArtPollReplyBuilder::replyAddress(remote, node, mask));
+}
+
+void test_bench_poll_reply() {
+    addDefaultRoutes(0x0000, 8);
+    uint8_t goodOutput[UniverseRouter::MAX_ROUTES] = {0};
+
+    // 旧方式：每次 ArtPoll 都重建；新方式：只写入计数器和端口状态
+    BenchResult rebuild = benchRun(20000, [&] {
+        builder->rebuild(info, router);
+        for (uint8_t i = 0; i < builder->getReplyCount(); i++) {
+            benchKeep(builder->prepare(i, goodOutput));
+        }
+    });
+    builder->rebuild(info, router);
+    BenchResult cached = benchRun(20000, [&] {
+        for (uint8_t i = 0; i < builder->getReplyCount(); i++) {
+            benchKeep(builder->prepare(i, goodOutput));
+        }
+    });
+    benchReport("ArtPoll -> 3 replies, rebuild each time", rebuild);
+    benchReport("ArtPoll -> 3 replies, cached template", cached);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_single_reply_fields);
+    RUN_TEST(test_more_than_four_universes_use_bind_indexes);
+    RUN_TEST(test_universes_crossing_subnet_get_separate_replies);
+    RUN_TEST(test_node_report_counter_and_good_output);
+    RUN_TEST(test_input_ports_are_listed);
+    RUN_TEST(test_targeted_poll_matches_port_range);
+    RUN_TEST(test_reply_address_policy);
+    RUN_TEST(test_bench_poll_reply);
+    return UNITY_END();
+}
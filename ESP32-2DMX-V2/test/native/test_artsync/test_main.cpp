@@ -0,0 +1,96 @@
+#include <unity.h>
+#include "artnet/SyncController.h"
+
+// 输出掩码：两路 DMX + 像素
+#define DMX_A 0x01
+#define DMX_B 0x02
+#define PIXELS 0x80000000UL
+
+static const uint32_t CONSOLE_IP = 0x0A00000A;   // 10.0.0.10
+static const uint32_t OTHER_IP = 0x0A00000B;
+
+static SyncController sync;
+
+void setUp() {
+    sync.reset();
+}
+
+void tearDown() {
+}
+
+void test_immediate_mode_commits_each_universe() {
+    TEST_ASSERT_FALSE(sync.isSyncMode());
+    TEST_ASSERT_EQUAL_HEX32(DMX_A, sync.onArtDmx(CONSOLE_IP, DMX_A, 0));
+    TEST_ASSERT_EQUAL_HEX32(PIXELS, sync.onArtDmx(CONSOLE_IP, PIXELS, 1));
+    TEST_ASSERT_EQUAL_HEX32(0, sync.getPendingMask());
+}
+
+void test_sync_mode_latches_all_outputs_together() {
+    sync.onArtSync(CONSOLE_IP, 0);
+    TEST_ASSERT_TRUE(sync.isSyncMode());
+
+    // 一帧内的 10 个宇宙：全部暂存，没有任何输出被提前提交
+    uint32_t now = 25;
+    TEST_ASSERT_EQUAL_HEX32(0, sync.onArtDmx(CONSOLE_IP, DMX_A, now));
+    TEST_ASSERT_EQUAL_HEX32(0, sync.onArtDmx(CONSOLE_IP, DMX_B, now));
+    for (int i = 0; i < 8; i++) {
+        TEST_ASSERT_EQUAL_HEX32(0, sync.onArtDmx(CONSOLE_IP, PIXELS, now));
+    }
+
+    // ArtSync 一次提交全部输出，像素只出现一次
+    TEST_ASSERT_EQUAL_HEX32(DMX_A | DMX_B | PIXELS, sync.onArtSync(CONSOLE_IP, now + 1));
+    TEST_ASSERT_EQUAL_HEX32(0, sync.getPendingMask());
+    TEST_ASSERT_EQUAL_HEX32(0, sync.onArtSync(CONSOLE_IP, now + 2));
+}
+
+void test_sync_from_other_source_is_ignored() {
+    sync.onArtSync(CONSOLE_IP, 0);
+    sync.onArtDmx(CONSOLE_IP, DMX_A, 10);
+
+    TEST_ASSERT_EQUAL_HEX32(0, sync.onArtSync(OTHER_IP, 11));
+    TEST_ASSERT_EQUAL_HEX32(DMX_A, sync.getPendingMask());
+    TEST_ASSERT_EQUAL_HEX32(DMX_A, sync.onArtSync(CONSOLE_IP, 12));
+}
+
+void test_falls_back_to_immediate_after_timeout() {
+    sync.onArtSync(CONSOLE_IP, 1000);
+    sync.onArtDmx(CONSOLE_IP, DMX_B, 1020);
+
+    // 4 秒内保持同步模式
+    TEST_ASSERT_EQUAL_HEX32(0, sync.poll(1000 + SyncController::SYNC_TIMEOUT_MS - 1));
+    TEST_ASSERT_TRUE(sync.isSyncMode());
+
+    // 超时：回到非同步模式并放出滞留数据
+    TEST_ASSERT_EQUAL_HEX32(DMX_B, sync.poll(1000 + SyncController::SYNC_TIMEOUT_MS));
+    TEST_ASSERT_FALSE(sync.isSyncMode());
+    TEST_ASSERT_EQUAL(1, sync.getTimeoutCount());
+    TEST_ASSERT_EQUAL_HEX32(DMX_A, sync.onArtDmx(CONSOLE_IP, DMX_A, 5100));
+}
+
+void test_timeout_detected_on_next_artdmx() {
+    sync.onArtSync(CONSOLE_IP, 0);
+    sync.onArtDmx(CONSOLE_IP, DMX_A, 100);
+
+    // 没有调用 poll()，超时后的下一个 ArtDmx 也会放出滞留数据
+    TEST_ASSERT_EQUAL_HEX32(DMX_A | DMX_B, sync.onArtDmx(CONSOLE_IP, DMX_B, 4100));
+    TEST_ASSERT_FALSE(sync.isSyncMode());
+}
+
+void test_millis_wraparound() {
+    uint32_t start = 0xFFFFF000;
+    sync.onArtSync(CONSOLE_IP, start);
+    TEST_ASSERT_EQUAL_HEX32(0, sync.onArtDmx(CONSOLE_IP, DMX_A, start + 0x100));
+    TEST_ASSERT_TRUE(sync.isSyncMode());
+    TEST_ASSERT_EQUAL_HEX32(DMX_A, sync.poll(start + SyncController::SYNC_TIMEOUT_MS));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_immediate_mode_commits_each_universe);
+    RUN_TEST(test_sync_mode_latches_all_outputs_together);
+    RUN_TEST(test_sync_from_other_source_is_ignored);
+    RUN_TEST(test_falls_back_to_immediate_after_timeout);
+    RUN_TEST(test_timeout_detected_on_next_artdmx);
+    RUN_TEST(test_millis_wraparound);
+    return UNITY_END();
+}
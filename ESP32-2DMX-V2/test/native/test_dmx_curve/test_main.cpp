@@ -0,0 +1,257 @@
+#include <unity.h>
+#include <string.h>
+#include "dmx/DmxFrameBuffer.h"
+#include "dmx/DmxOutputTransform.h"
+#include "../bench.h"
+
+static DmxOutputTransform transform;
+static DmxFrameBuffer* frames = nullptr;
+static uint8_t universe[512];
+
+void setUp() {
+    transform.clear();
+    delete frames;
+    frames = new DmxFrameBuffer();
+    for (uint16_t i = 0; i < sizeof(universe); i++) universe[i] = (uint8_t)(i * 13 + 5);
+}
+
+void tearDown() {}
+
+// 写入并发布一帧，返回 DMX 任务看到的帧
+static const DmxFrame& writeFrame(const uint8_t* data, uint16_t length, uint16_t start = 0) {
+    frames->writeSlots(data, length, start, transform);
+    frames->commit(transform);
+    frames->acquire();
+    return frames->front();
+}
+
+void test_curve_endpoints_and_monotonic() {
+    for (uint8_t curve = 0; curve < DMX_CURVE_COUNT; curve++) {
+        TEST_ASSERT_EQUAL(0, transform.value16((DmxCurve)curve, 0));
+        TEST_ASSERT_EQUAL(65535, transform.value16((DmxCurve)curve, 255));
+        TEST_ASSERT_EQUAL(0, transform.value8((DmxCurve)curve, 0));
+        TEST_ASSERT_EQUAL(255, transform.value8((DmxCurve)curve, 255));
+        for (uint16_t v = 1; v < 256; v++) {
+            TEST_ASSERT_TRUE(transform.value16((DmxCurve)curve, v) >= transform.value16((DmxCurve)curve, v - 1));
+        }
+    }
+    // 平方律中点约为 1/4，反平方约为 3/4，S 曲线过中点
+    TEST_ASSERT_INT_WITHIN(300, 16448, transform.value16(DMX_CURVE_SQUARE, 128));
+    TEST_ASSERT_INT_WITHIN(300, 65535 - 16320, transform.value16(DMX_CURVE_INV_SQUARE, 128));
+    TEST_ASSERT_INT_WITHIN(500, 32768, transform.value16(DMX_CURVE_S, 128));
+    TEST_ASSERT_EQUAL(128 * 257, transform.value16(DMX_CURVE_LINEAR, 128));
+}
+
+void test_identity_is_plain_copy() {
+    TEST_ASSERT_TRUE(transform.isIdentity());
+    const DmxFrame& frame = writeFrame(universe, 512);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(universe, frame.slots(), 512);
+    TEST_ASSERT_EQUAL(512, frame.length);
+}
+
+// 曲线区间查表，其余通道原样拷贝
+void test_curve_runs_apply_in_write_pass() {
+    TEST_ASSERT_TRUE(transform.setCurve(10, 20, DMX_CURVE_SQUARE));
+    TEST_ASSERT_TRUE(transform.setCurve(100, 50, DMX_CURVE_S));
+    TEST_ASSERT_EQUAL(2, transform.getRunCount());
+
+    const DmxFrame& frame = writeFrame(universe, 512);
+    for (uint16_t slot = 0; slot < 512; slot++) {
+        uint8_t expected = universe[slot];
+        if (slot >= 10 && slot < 30) expected = transform.value8(DMX_CURVE_SQUARE, universe[slot]);
+        if (slot >= 100 && slot < 150) expected = transform.value8(DMX_CURVE_S, universe[slot]);
+        TEST_ASSERT_EQUAL_UINT8(expected, frame.slots()[slot]);
+    }
+}
+
+// 部分写入：区间只作用于写入范围内的通道，目标位置按帧中的通道号计算
+void test_partial_write_uses_frame_slots() {
+    transform.setCurve(200, 10, DMX_CURVE_SQUARE);
+    uint8_t data[8];
+    memset(data, 200, sizeof(data));
+    const DmxFrame& frame = writeFrame(data, 8, 196);
+    TEST_ASSERT_EQUAL(200, frame.slots()[199]);
+    TEST_ASSERT_EQUAL(transform.value8(DMX_CURVE_SQUARE, 200), frame.slots()[200]);
+    TEST_ASSERT_EQUAL(transform.value8(DMX_CURVE_SQUARE, 200), frame.slots()[203]);
+    TEST_ASSERT_EQUAL(204, frame.length);
+}
+
+// 后设置的覆盖前面的；恢复线性后区间合并消失
+void test_curve_override_and_reset() {
+    transform.setCurve(0, 512, DMX_CURVE_SQUARE);
+    transform.setCurve(100, 100, DMX_CURVE_LINEAR);
+    TEST_ASSERT_EQUAL(2, transform.getRunCount());
+    TEST_ASSERT_EQUAL(DMX_CURVE_LINEAR, transform.getCurve(150));
+    TEST_ASSERT_EQUAL(DMX_CURVE_SQUARE, transform.getCurve(200));
+
+    transform.setCurve(0, 512, DMX_CURVE_LINEAR);
+    TEST_ASSERT_EQUAL(0, transform.getRunCount());
+    TEST_ASSERT_TRUE(transform.isIdentity());
+}
+
+void test_too_many_runs_rejected() {
+    for (uint8_t i = 0; i < DmxOutputTransform::MAX_RUNS; i++) {
+        TEST_ASSERT_TRUE(transform.setCurve(i * 2, 1, DMX_CURVE_SQUARE));
+    }
+    TEST_ASSERT_FALSE(transform.setCurve(200, 1, DMX_CURVE_SQUARE));
+    TEST_ASSERT_EQUAL(DMX_CURVE_LINEAR, transform.getCurve(200));
+    TEST_ASSERT_EQUAL(DmxOutputTransform::MAX_RUNS, transform.getRunCount());
+}
+
+// 细调通道：粗调 / 细调为曲线 16 位结果的高低字节，输入中的细调通道被忽略
+void test_fine_channel_from_curve() {
+    transform.setCurve(0, 512, DMX_CURVE_SQUARE);
+    TEST_ASSERT_TRUE(transform.addFineChannel(20, false));
+    uint8_t data[24];
+    memset(data, 0x77, sizeof(data));
+    data[20] = 100;
+    const DmxFrame& frame = writeFrame(data, 21);
+    uint16_t expected = transform.value16(DMX_CURVE_SQUARE, 100);
+    TEST_ASSERT_EQUAL(expected >> 8, frame.slots()[20]);
+    TEST_ASSERT_EQUAL(expected & 0xFF, frame.slots()[21]);
+    TEST_ASSERT_EQUAL(22, frame.length);
+
+    TEST_ASSERT_FALSE(transform.addFineChannel(511, false));
+}
+
+// 慢速渐变：粗调每 4 帧变化一级，细调值从上一级向当前级均匀推进
+void test_fine_interpolates_slow_fade() {
+    transform.addFineChannel(0, true);
+    uint8_t data[2] = {0, 0};
+    uint16_t previous = 0;
+    bool strictlyRising = true;
+    for (uint16_t frame = 0; frame < 40; frame++) {
+        data[0] = (uint8_t)(10 + frame / 4);
+        const DmxFrame& out = writeFrame(data, 2);
+        uint16_t value = out.slots()[0] << 8 | out.slots()[1];
+        // 第二级起已知间隔，每帧都应上升
+        if (frame >= 8 && value <= previous) strictlyRising = false;
+        previous = value;
+    }
+    TEST_ASSERT_TRUE(strictlyRising);
+
+    // 帧 40 = 第 20 级的第 0 帧：从第 19 级开始；第 2 帧在两级中间
+    data[0] = 20;
+    const DmxFrame& step = writeFrame(data, 2);
+    TEST_ASSERT_EQUAL(19 * 257, step.slots()[0] << 8 | step.slots()[1]);
+    writeFrame(data, 2);
+    const DmxFrame& mid = writeFrame(data, 2);
+    TEST_ASSERT_EQUAL(19 * 257 + 257 / 2, mid.slots()[0] << 8 | mid.slots()[1]);
+}
+
+// 渐变停在某一级：输出只会接近、不会越过控台的值，之后停在该级而不是回跳
+void test_fine_never_passes_console_value() {
+    transform.addFineChannel(0, true);
+    uint8_t data[2] = {100, 0};
+    for (uint16_t frame = 0; frame < 24; frame++) {
+        data[0] = (uint8_t)(100 + frame / 4);
+        writeFrame(data, 2);
+    }
+    uint16_t previous = 0;
+    for (uint8_t frame = 0; frame < 10; frame++) {
+        const DmxFrame& out = writeFrame(data, 2);
+        uint16_t value = out.slots()[0] << 8 | out.slots()[1];
+        TEST_ASSERT_TRUE(value <= 105 * 257);
+        TEST_ASSERT_TRUE(value >= previous);
+        previous = value;
+    }
+    TEST_ASSERT_EQUAL(105 * 257, previous);
+}
+
+// 同一帧分几段写入：插值状态只在 commit 时推进一次
+void test_fine_ramp_advances_once_per_frame() {
+    transform.addFineChannel(0, true);
+    uint8_t data[2] = {30, 0};
+    for (uint16_t frame = 0; frame < 12; frame++) {
+        data[0] = (uint8_t)(30 + frame / 4);
+        writeFrame(data, 2);
+    }
+    // 帧 12 为第 33 级的第 0 帧，写三次再发布，结果仍是第 0 帧的值
+    data[0] = 33;
+    frames->writeSlots(data, 2, 0, transform);
+    frames->writeSlots(data, 2, 0, transform);
+    frames->writeSlots(data, 2, 0, transform);
+    frames->commit(transform);
+    frames->acquire();
+    TEST_ASSERT_EQUAL(32 * 257, frames->front().slots()[0] << 8 | frames->front().slots()[1]);
+    const DmxFrame& next = writeFrame(data, 2);
+    TEST_ASSERT_EQUAL(32 * 257 + 257 / 4, next.slots()[0] << 8 | next.slots()[1]);
+}
+
+// 渐变停止后超过上一级的间隔回到当前级；跳变不插值
+void test_fine_settles_after_fade_stops_and_on_jump() {
+    transform.addFineChannel(0, true);
+    uint8_t data[2] = {50, 0};
+    for (uint8_t v = 50; v < 55; v++) {
+        data[0] = v;
+        writeFrame(data, 2);
+        writeFrame(data, 2);
+    }
+    data[0] = 54;
+    const DmxFrame& settled = writeFrame(data, 2);
+    TEST_ASSERT_EQUAL(54 * 257, settled.slots()[0] << 8 | settled.slots()[1]);
+
+    data[0] = 200;
+    const DmxFrame& jumped = writeFrame(data, 2);
+    TEST_ASSERT_EQUAL(200 * 257, jumped.slots()[0] << 8 | jumped.slots()[1]);
+    const DmxFrame& held = writeFrame(data, 2);
+    TEST_ASSERT_EQUAL(200 * 257, held.slots()[0] << 8 | held.slots()[1]);
+}
+
+// 不插值时细调只反映曲线精度
+void test_fine_without_interpolation_holds() {
+    transform.addFineChannel(0, false);
+    uint8_t data[2] = {10, 0};
+    writeFrame(data, 2);
+    writeFrame(data, 2);
+    data[0] = 11;
+    writeFrame(data, 2);
+    const DmxFrame& frame = writeFrame(data, 2);
+    TEST_ASSERT_EQUAL(11 * 257, frame.slots()[0] << 8 | frame.slots()[1]);
+}
+
+// 对照：先拷贝整帧，再单独一遍查表
+static void copyThenLut(DmxFrame& frame, const uint8_t* data, const uint8_t* table) {
+    frame.writeSlots(data, 512);
+    for (uint16_t i = 0; i < 512; i++) frame.slots()[i] = table[frame.slots()[i]];
+}
+
+void test_write_cost() {
+    static DmxFrame frame;
+    frame.clear();
+    uint8_t table[256];
+    for (uint16_t i = 0; i < 256; i++) table[i] = transform.value8(DMX_CURVE_SQUARE, i);
+
+    BenchResult plain = benchRun(100000, [] { transform.write(frame, universe, 512, 0); benchKeep(&frame); });
+    transform.setCurve(0, 512, DMX_CURVE_SQUARE);
+    BenchResult fused = benchRun(100000, [] { transform.write(frame, universe, 512, 0); benchKeep(&frame); });
+    BenchResult separate = benchRun(100000, [&table] { copyThenLut(frame, universe, table); benchKeep(&frame); });
+    transform.clear();
+    transform.setCurve(0, 24, DMX_CURVE_SQUARE);
+    for (uint8_t i = 0; i < 8; i++) transform.addFineChannel(100 + i * 2, true);
+    BenchResult mixed = benchRun(100000, [] { transform.write(frame, universe, 512, 0); benchKeep(&frame); });
+
+    benchReport("512 slots, linear copy", plain);
+    benchReport("512 slots, curve fused in write", fused);
+    benchReport("512 slots, copy then LUT pass", separate);
+    benchReport("24 curved + 8 fine pairs", mixed);
+    TEST_ASSERT_TRUE(plain.nsPerIter > 0 && fused.nsPerIter > 0 && mixed.nsPerIter > 0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_curve_endpoints_and_monotonic);
+    RUN_TEST(test_identity_is_plain_copy);
+    RUN_TEST(test_curve_runs_apply_in_write_pass);
+    RUN_TEST(test_partial_write_uses_frame_slots);
+    RUN_TEST(test_curve_override_and_reset);
+    RUN_TEST(test_too_many_runs_rejected);
+    RUN_TEST(test_fine_channel_from_curve);
+    RUN_TEST(test_fine_interpolates_slow_fade);
+    RUN_TEST(test_fine_never_passes_console_value);
+    RUN_TEST(test_fine_ramp_advances_once_per_frame);
+    RUN_TEST(test_fine_settles_after_fade_stops_and_on_jump);
+    RUN_TEST(test_fine_without_interpolation_holds);
+    RUN_TEST(test_write_cost);
+    return UNITY_END();
+}
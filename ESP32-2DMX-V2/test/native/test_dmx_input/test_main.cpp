@@ -0,0 +1,406 @@
+#include <unity.h>
+#include <string.h>
+#include "dmx/DmxRxFramer.h"
+#include "DmxInputSender.h"
+#include "../dmx_sim.h"
+#include "../bench.h"
+
+static DmxRxFramer* framer;
+static DmxInputSender* sender;
+static uint8_t frame[DMX_SLOT_COUNT + 1];
+
+static void fillFrame(uint16_t slots, uint8_t seed) {
+    frame[0] = DMX_START_CODE;
+    for (uint16_t i = 1; i <= slots; i++) frame[i] = (uint8_t)(i * 3 + seed);
+}
+
+void setUp(void) {
+    framer = new DmxRxFramer();
+    sender = new DmxInputSender();
+    sender->setPortAddress(0x0012);
+    sender->setPhysical(1);
+}
+
+void tearDown(void) {
+    delete framer;
+    delete sender;
+}
+
+// ---- 分帧 ----
+
+// 第一个 Break 之前的数据不完整，丢弃；之后每个 Break 发布上一帧
+void test_framer_publishes_on_break(void) {
+    fillFrame(512, 1);
+    framer->onData(frame + 100, 50);
+    framer->onBreak(0);
+    TEST_ASSERT_FALSE(framer->hasNewFrame());
+
+    framer->onData(frame, 200);
+    framer->onData(frame + 200, 313);
+    TEST_ASSERT_FALSE(framer->hasNewFrame());
+    framer->onBreak(22760);
+
+    TEST_ASSERT_TRUE(framer->acquire());
+    TEST_ASSERT_EQUAL_UINT16(512, framer->front().length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, framer->front().data, 513);
+    TEST_ASSERT_EQUAL_UINT32(1, framer->getStats().frames);
+    TEST_ASSERT_EQUAL_UINT16(512, framer->getStats().lastSlots);
+}
+
+// 读者拿到的帧在下一帧采集期间保持不变
+void test_framer_double_buffer(void) {
+    fillFrame(64, 1);
+    framer->onBreak(0);
+    framer->onData(frame, 65);
+    framer->onBreak(5000);
+    TEST_ASSERT_TRUE(framer->acquire());
+
+    uint8_t next[65];
+    memset(next, 0xEE, sizeof(next));
+    next[0] = DMX_START_CODE;
+    framer->onData(next, 40);
+    TEST_ASSERT_FALSE(framer->acquire());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, framer->front().data, 65);
+
+    framer->onData(next + 40, 25);
+    framer->onBreak(10000);
+    TEST_ASSERT_TRUE(framer->acquire());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(next, framer->front().data, 65);
+}
+
+// Break 的 0x00 和下一帧的开头在同一批数据里：只丢这一个字节，起始码和通道都保留
+void test_framer_drops_only_break_byte(void) {
+    fillFrame(100, 7);
+    uint8_t burst[1 + 40];
+    burst[0] = 0x00;    // Break
+    memcpy(burst + 1, frame, 40);
+
+    framer->onBreak(0);
+    framer->dropBreakByte();
+    framer->onData(burst, sizeof(burst));
+    framer->onData(frame + 40, 61);
+    framer->onBreak(5000);
+    framer->dropBreakByte();
+    TEST_ASSERT_TRUE(framer->acquire());
+    TEST_ASSERT_EQUAL_UINT16(100, framer->front().length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frame, framer->front().data, 101);
+
+    // Break 字节已经随上一帧读走时，非 0 的起始码不会被当成 Break 丢掉
+    const uint8_t rdm[] = {0xCC, 0x01, 0x18};
+    framer->onData(rdm, sizeof(rdm));
+    framer->onBreak(10000);
+    TEST_ASSERT_EQUAL_UINT32(1, framer->getStats().alternateFrames);
+    TEST_ASSERT_EQUAL_UINT32(0, framer->getStats().emptyBreaks);
+}
+
+void test_framer_skips_empty_and_alternate_frames(void) {
+    framer->onBreak(0);
+    framer->onBreak(1000);
+    TEST_ASSERT_EQUAL_UINT32(1, framer->getStats().emptyBreaks);
+
+    uint8_t rdm[24] = {0xCC, 0x01, 0x18};
+    framer->onData(rdm, sizeof(rdm));
+    framer->onBreak(2000);
+    TEST_ASSERT_FALSE(framer->hasNewFrame());
+    TEST_ASSERT_EQUAL_UINT32(1, framer->getStats().alternateFrames);
+    TEST_ASSERT_EQUAL_UINT32(0, framer->getStats().frames);
+}
+
+void test_framer_truncates_overlong_frame(void) {
+    fillFrame(512, 2);
+    framer->onBreak(0);
+    framer->onData(frame, 513);
+    framer->onData(frame, 20);
+    framer->onBreak(30000);
+    TEST_ASSERT_TRUE(framer->acquire());
+    TEST_ASSERT_EQUAL_UINT16(512, framer->front().length);
+    TEST_ASSERT_EQUAL_UINT32(1, framer->getStats().overlong);
+}
+
+// 帧中的错误丢弃整帧；Break 本身产生的帧错误（还没有数据）不算
+void test_framer_errors(void) {
+    fillFrame(100, 3);
+    framer->onBreak(0);
+    framer->onError();
+    framer->onData(frame, 101);
+    framer->onBreak(5000);
+    TEST_ASSERT_TRUE(framer->acquire());
+    TEST_ASSERT_EQUAL_UINT32(0, framer->getStats().errors);
+
+    framer->onData(frame, 50);
+    framer->onError();
+    framer->onData(frame + 50, 51);
+    framer->onBreak(10000);
+    TEST_ASSERT_FALSE(framer->hasNewFrame());
+    TEST_ASSERT_EQUAL_UINT32(1, framer->getStats().errors);
+
+    // 下一个 Break 之后恢复
+    framer->onData(frame, 101);
+    framer->onBreak(15000);
+    TEST_ASSERT_TRUE(framer->acquire());
+    TEST_ASSERT_EQUAL_UINT32(2, framer->getStats().frames);
+}
+
+void test_framer_measures_refresh_rate(void) {
+    fillFrame(512, 4);
+    uint32_t t = 0;
+    for (int i = 0; i < 50; i++) {
+        framer->onBreak(t);
+        framer->onData(frame, 513);
+        t += (i & 1) ? 22700 : 22820;       // 平均 22760 us
+    }
+    const DmxRxStats& stats = framer->getStats();
+    TEST_ASSERT_EQUAL_UINT32(22700, stats.minPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(22820, stats.maxPeriodUs);
+    TEST_ASSERT_FLOAT_WITHIN(0.2f, 1e6f / 22760, framer->refreshHz());
+}
+
+// 收到与上一帧一样多的字节后才打开 Break 测量
+void test_framer_capture_complete(void) {
+    fillFrame(24, 5);
+    framer->onBreak(0);
+    framer->onData(frame, 25);
+    TEST_ASSERT_FALSE(framer->captureComplete());   // 还不知道帧长
+    framer->onBreak(1300);
+    framer->onData(frame, 20);
+    TEST_ASSERT_FALSE(framer->captureComplete());
+    framer->onData(frame + 20, 5);
+    TEST_ASSERT_TRUE(framer->captureComplete());
+}
+
+// ---- Break / MAB 测量 ----
+
+void test_sniffer_measures_break_and_mab(void) {
+    DmxBreakSniffer sniffer;
+    uint32_t breakUs, mabUs;
+    TEST_ASSERT_FALSE(sniffer.isArmed());
+    sniffer.arm();
+
+    // 帧尾的数据位：低电平太短，不是 Break
+    TEST_ASSERT_FALSE(sniffer.onEdge(0, 1000));
+    TEST_ASSERT_FALSE(sniffer.onEdge(1, 1036));
+    TEST_ASSERT_FALSE(sniffer.take(breakUs, mabUs));
+
+    TEST_ASSERT_FALSE(sniffer.onEdge(0, 1100));
+    TEST_ASSERT_FALSE(sniffer.onEdge(1, 1276));
+    TEST_ASSERT_TRUE(sniffer.onEdge(0, 1292));
+    TEST_ASSERT_FALSE(sniffer.isArmed());
+
+    TEST_ASSERT_TRUE(sniffer.take(breakUs, mabUs));
+    TEST_ASSERT_EQUAL_UINT32(176, breakUs);
+    TEST_ASSERT_EQUAL_UINT32(16, mabUs);
+    TEST_ASSERT_FALSE(sniffer.take(breakUs, mabUs));
+}
+
+// 端到端：模拟的发送端产生线路波形，按固件的方式喂给分帧和 Break 测量
+void test_input_from_simulated_line(void) {
+    DmxWireSim sim;
+    DmxTxStateMachine tx;
+    uint8_t slots[DMX_SLOT_COUNT];
+    for (uint16_t i = 0; i < DMX_SLOT_COUNT; i++) slots[i] = (uint8_t)(i ^ 0x5A);
+    sim.writeSlots(slots, 300);
+    sim.minSlots = 300;
+    tx.setTiming(120, 20);
+    tx.setBreakMode(DMX_BREAK_UART);
+    tx.setRefreshRate(30);
+    sim.attach(tx);
+    tx.start(sim, 0);
+    sim.run(tx, 1000000);
+
+    DmxLineTrace line = sim.line();
+    DmxWireChecker checker;
+    checker.analyze(line);
+    TEST_ASSERT_TRUE(checker.frames.size() > 20);
+
+    DmxBreakSniffer sniffer;
+    size_t edge = 0;
+    for (size_t f = 0; f < checker.frames.size(); f++) {
+        uint32_t breakUs, mabUs;
+        if (sniffer.take(breakUs, mabUs)) {
+            // 测得的是本帧的 Break / MAB，与检查器解码的一致
+            TEST_ASSERT_EQUAL_UINT32(checker.frames[f].breakUs, breakUs);
+            TEST_ASSERT_EQUAL_UINT32(checker.frames[f].mabUs, mabUs);
+            framer->onTiming(breakUs, mabUs);
+        }
+        framer->onBreak(checker.frames[f].breakStartUs);
+        framer->onData(checker.data[f].data(), checker.data[f].size());
+
+        // 数据收齐后打开边沿中断，直到测完下一帧的 Break / MAB
+        if (framer->captureComplete()) {
+            sniffer.arm();
+            uint32_t dataEndUs = checker.frames[f].breakStartUs + checker.frames[f].breakUs +
+                                 checker.frames[f].mabUs + checker.data[f].size() * DMX_TX_BYTE_US;
+            while (edge < line.edges.size() && line.edges[edge].us < dataEndUs) edge++;
+            while (edge < line.edges.size() && !sniffer.onEdge(line.edges[edge].level, line.edges[edge].us)) edge++;
+        }
+    }
+
+    const DmxRxStats& stats = framer->getStats();
+    TEST_ASSERT_EQUAL_UINT32(checker.frames.size() - 1, stats.frames);
+    TEST_ASSERT_TRUE(stats.timedFrames >= stats.frames - 2);
+    // UART 硬件 Break 在数据之后发出，低于满速时帧间的空闲都落在 MAB 里
+    TEST_ASSERT_EQUAL_UINT32(120, stats.breakUs);
+    TEST_ASSERT_EQUAL_UINT32(120, stats.minBreakUs);
+    TEST_ASSERT_TRUE(stats.minMabUs >= 20);
+    TEST_ASSERT_FLOAT_WITHIN(0.1f, 30.0f, framer->refreshHz());
+    TEST_ASSERT_TRUE(framer->acquire());
+    TEST_ASSERT_EQUAL_UINT16(300, framer->front().length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(slots, framer->front().slots(), 300);
+}
+
+// ---- ArtDmx 发送 ----
+
+void test_sender_first_frame_and_packet(void) {
+    fillFrame(511, 6);
+    uint16_t length = sender->onFrame(frame + 1, 511, 0);
+    TEST_ASSERT_EQUAL_UINT16(ART_DMX_HEADER_SIZE + 512, length);   // 奇数补成偶数
+
+    ArtDmxPacket packet;
+    TEST_ASSERT_TRUE(ArtnetPacket::hasValidId(sender->packet(), length));
+    TEST_ASSERT_EQUAL_UINT16(OpDmx, ArtnetPacket::getOpCode(sender->packet()));
+    TEST_ASSERT_TRUE(ArtnetPacket::parseArtDmx(sender->packet(), length, packet));
+    TEST_ASSERT_EQUAL_UINT16(0x0012, packet.portAddress);
+    TEST_ASSERT_EQUAL_UINT8(1, packet.physical);
+    TEST_ASSERT_EQUAL_UINT8(1, packet.sequence);
+    TEST_ASSERT_EQUAL_UINT16(512, packet.length);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(frame + 1, packet.data, 511);
+    TEST_ASSERT_EQUAL_UINT8(0, packet.data[511]);
+}
+
+void test_sender_only_on_change_plus_keepalive(void) {
+    fillFrame(512, 7);
+    TEST_ASSERT_TRUE(sender->onFrame(frame + 1, 512, 0) > 0);
+
+    // 44 Hz 的相同帧：keepalive 之前都不发
+    uint32_t now = 0;
+    for (int i = 0; i < 43; i++) {
+        now += 23;
+        TEST_ASSERT_EQUAL_UINT16(0, sender->onFrame(frame + 1, 512, now));
+    }
+    now = 1000;
+    TEST_ASSERT_TRUE(sender->onFrame(frame + 1, 512, now) > 0);
+    TEST_ASSERT_EQUAL_UINT32(1, sender->getStats().keepalives);
+
+    // 内容变化立即发送
+    frame[100] ^= 0xFF;
+    now += 30;
+    TEST_ASSERT_TRUE(sender->onFrame(frame + 1, 512, now) > 0);
+    // 帧长变化也算变化
+    now += 30;
+    TEST_ASSERT_TRUE(sender->onFrame(frame + 1, 256, now) > 0);
+    TEST_ASSERT_EQUAL_UINT32(3, sender->getStats().changes);
+    TEST_ASSERT_EQUAL_UINT32(4, sender->getStats().sent);
+}
+
+// ArtPollReply 的 GoodInput：最近收到过输入帧才算有信号
+void test_sender_receiving_times_out(void) {
+    TEST_ASSERT_FALSE(sender->isReceiving(0));
+    fillFrame(16, 1);
+    sender->onFrame(frame + 1, 16, 5000);
+    TEST_ASSERT_TRUE(sender->isReceiving(5000 + DmxInputSender::RECEIVE_TIMEOUT_MS - 1));
+    TEST_ASSERT_FALSE(sender->isReceiving(5000 + DmxInputSender::RECEIVE_TIMEOUT_MS));
+    sender->reset();
+    TEST_ASSERT_FALSE(sender->isReceiving(5001));
+}
+
+// 最小间隔内的变化推迟，poll() 发出最新的内容
+void test_sender_min_interval_defers_latest(void) {
+    sender->setMinInterval(20);
+    fillFrame(16, 8);
+    sender->onFrame(frame + 1, 16, 0);
+
+    frame[1] = 1;
+    TEST_ASSERT_EQUAL_UINT16(0, sender->onFrame(frame + 1, 16, 5));
+    frame[1] = 2;
+    TEST_ASSERT_EQUAL_UINT16(0, sender->onFrame(frame + 1, 16, 10));
+    TEST_ASSERT_TRUE(sender->hasPending());
+    TEST_ASSERT_EQUAL_UINT16(0, sender->poll(15));
+
+    uint16_t length = sender->poll(20);
+    TEST_ASSERT_TRUE(length > 0);
+    TEST_ASSERT_FALSE(sender->hasPending());
+    TEST_ASSERT_EQUAL_UINT8(2, sender->packet()[ART_DMX_HEADER_SIZE]);
+    TEST_ASSERT_EQUAL_UINT32(2, sender->getStats().deferred);
+
+    // 改回已发出的内容：不再有待发的变化
+    frame[1] = 3;
+    sender->onFrame(frame + 1, 16, 25);
+    frame[1] = 2;
+    sender->onFrame(frame + 1, 16, 30);
+    TEST_ASSERT_FALSE(sender->hasPending());
+}
+
+void test_sender_sequence_skips_zero(void) {
+    sender->setMinInterval(0);
+    fillFrame(2, 0);
+    for (int i = 0; i < 256; i++) {
+        frame[1] = (uint8_t)i;
+        TEST_ASSERT_TRUE(sender->onFrame(frame + 1, 2, i) > 0);
+        TEST_ASSERT_TRUE(sender->packet()[12] != 0);
+    }
+    TEST_ASSERT_EQUAL_UINT8(1, sender->packet()[12]);
+}
+
+// 输入 44 Hz、偶尔变化时发出的包数，以及每帧的判断开销
+void test_bench_input_sender(void) {
+    fillFrame(512, 9);
+    uint32_t now = 0;
+    for (int i = 0; i < 44 * 10; i++) {
+        if (i % 40 == 0) frame[1 + (i % 512)] ^= 0x10;     // 约每秒一次变化
+        uint16_t length = sender->onFrame(frame + 1, 512, now);
+        if (!length) sender->poll(now);
+        now += 23;
+    }
+    const DmxInputSenderStats& stats = sender->getStats();
+    printf("[bench] dmx input 10 s @44 Hz: %u frames -> %u ArtDmx (%u changes, %u keepalives)\n",
+           stats.frames, stats.sent, stats.changes, stats.keepalives);
+    TEST_ASSERT_TRUE(stats.sent < stats.frames / 10);
+
+    uint32_t t = 0;
+    BenchResult unchanged = benchRun(100000, [&]() {
+        benchKeep(frame);
+        sender->onFrame(frame + 1, 512, t);
+    });
+    benchReport("input sender unchanged 512", unchanged);
+
+    sender->setMinInterval(0);
+    uint8_t n = 0;
+    BenchResult changed = benchRun(100000, [&]() {
+        frame[200] = n++;
+        benchKeep(frame);
+        sender->onFrame(frame + 1, 512, t);
+    });
+    benchReport("input sender changed 512", changed);
+
+    BenchResult capture = benchRun(100000, [&]() {
+        framer->onBreak(t);
+        framer->onData(frame, 128);
+        framer->onData(frame + 128, 128);
+        framer->onData(frame + 256, 128);
+        framer->onData(frame + 384, 129);
+        t += 22760;
+        benchKeep(framer);
+    });
+    benchReport("rx framer 513 bytes", capture);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_framer_publishes_on_break);
+    RUN_TEST(test_framer_double_buffer);
+    RUN_TEST(test_framer_drops_only_break_byte);
+    RUN_TEST(test_framer_skips_empty_and_alternate_frames);
+    RUN_TEST(test_framer_truncates_overlong_frame);
+    RUN_TEST(test_framer_errors);
+    RUN_TEST(test_framer_measures_refresh_rate);
+    RUN_TEST(test_framer_capture_complete);
+    RUN_TEST(test_sniffer_measures_break_and_mab);
+    RUN_TEST(test_input_from_simulated_line);
+    RUN_TEST(test_sender_first_frame_and_packet);
+    RUN_TEST(test_sender_only_on_change_plus_keepalive);
+    RUN_TEST(test_sender_receiving_times_out);
+    RUN_TEST(test_sender_min_interval_defers_latest);
+    RUN_TEST(test_sender_sequence_skips_zero);
+    RUN_TEST(test_bench_input_sender);
+    return UNITY_END();
+}
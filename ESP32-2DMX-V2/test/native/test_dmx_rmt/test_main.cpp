@@ -0,0 +1,274 @@
+#include <unity.h>
+#include <string.h>
+#include <stdlib.h>
+#include <vector>
+#include "dmx/DmxRmtEncoder.h"
+#include "dmx/DmxTxStateMachine.h"
+#include "../bench.h"
+
+// RMT item 展开成每微秒一个电平的波形，与按 DMX512-A 定义逐位生成的参考波形逐位比较。
+// 时长为 0 的一段是结束标记，之后线路保持空闲电平（高）
+
+static std::vector<uint8_t> expandItems(const uint32_t* items, uint16_t count, bool& ended) {
+    std::vector<uint8_t> wave;
+    ended = true;
+    for (uint16_t i = 0; i < count; i++) {
+        for (int half = 0; half < 2; half++) {
+            uint32_t part = half ? items[i] >> 16 : items[i] & 0xFFFF;
+            uint32_t duration = part & DmxRmtEncoder::MAX_DURATION;
+            uint8_t level = (part >> 15) & 1;
+            if (duration == 0) return wave;
+            wave.insert(wave.end(), duration, level);
+        }
+    }
+    ended = false;
+    return wave;
+}
+
+// 参考波形：Break 低，MAB 高，每字节 起始位(低) + 8 数据位(LSB 先) + 2 停止位(高)，每位 4 us
+static std::vector<uint8_t> referenceWave(const uint8_t* data, uint16_t bytes,
+                                          uint32_t breakUs, uint32_t mabUs) {
+    std::vector<uint8_t> wave;
+    wave.insert(wave.end(), breakUs, 0);
+    wave.insert(wave.end(), mabUs, 1);
+    for (uint16_t i = 0; i < bytes; i++) {
+        uint8_t bits[11];
+        bits[0] = 0;
+        for (int b = 0; b < 8; b++) bits[1 + b] = (data[i] >> b) & 1;
+        bits[9] = 1;
+        bits[10] = 1;
+        for (int b = 0; b < 11; b++) wave.insert(wave.end(), 4, bits[b]);
+    }
+    return wave;
+}
+
+static void fillRandom(uint8_t* data, uint16_t bytes, uint32_t seed) {
+    srand(seed);
+    data[0] = 0;
+    for (uint16_t i = 1; i < bytes; i++) data[i] = rand() & 0xFF;
+}
+
+static void assertWave(const DmxRmtEncoder& encoder, const uint8_t* data, uint16_t bytes,
+                       uint32_t breakUs, uint32_t mabUs) {
+    std::vector<uint8_t> expected = referenceWave(data, bytes, breakUs, mabUs);
+    bool ended;
+    std::vector<uint8_t> actual = expandItems(encoder.items(), encoder.itemCount(), ended);
+    TEST_ASSERT_TRUE(ended);
+    TEST_ASSERT_EQUAL_UINT32(expected.size(), actual.size());
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected.data(), actual.data(), expected.size());
+}
+
+static void assertSameItems(const DmxRmtEncoder& a, const DmxRmtEncoder& b) {
+    TEST_ASSERT_EQUAL_UINT16(b.itemCount(), a.itemCount());
+    TEST_ASSERT_EQUAL_MEMORY(b.items(), a.items(), b.itemCount() * sizeof(uint32_t));
+}
+
+static DmxRmtEncoder encoder;
+static DmxRmtEncoder fresh;
+static uint8_t frame[DmxRmtEncoder::MAX_BYTES];
+
+void setUp(void) {
+    encoder = DmxRmtEncoder();
+    fresh = DmxRmtEncoder();
+    memset(frame, 0, sizeof(frame));
+}
+
+void tearDown(void) {}
+
+// 整帧 513 字节与参考波形逐位一致
+void test_full_frame_matches_reference(void) {
+    fillRandom(frame, 513, 1);
+    TEST_ASSERT_EQUAL_UINT16(513, encoder.encode(frame, 513));
+    assertWave(encoder, frame, 513, 176, 12);
+    TEST_ASSERT_EQUAL_UINT16(DmxRmtEncoder::MAX_ITEMS, encoder.itemCount());
+}
+
+// 全 0 和全 0xFF 的边界位型
+void test_extreme_values_match_reference(void) {
+    memset(frame, 0xFF, sizeof(frame));
+    frame[0] = 0;
+    encoder.encode(frame, 513);
+    assertWave(encoder, frame, 513, 176, 12);
+
+    memset(frame, 0, sizeof(frame));
+    encoder.invalidate();
+    encoder.encode(frame, 513);
+    assertWave(encoder, frame, 513, 176, 12);
+}
+
+// 奇数和偶数字节数：结束标记的位置不同，波形都不多发一位
+void test_odd_and_even_lengths(void) {
+    fillRandom(frame, 26, 2);
+    encoder.encode(frame, 25);
+    assertWave(encoder, frame, 25, 176, 12);
+    TEST_ASSERT_EQUAL_UINT16(1 + 12 * 11 + 6, encoder.itemCount());
+
+    encoder.invalidate();
+    encoder.encode(frame, 26);
+    assertWave(encoder, frame, 26, 176, 12);
+    TEST_ASSERT_EQUAL_UINT16(1 + 13 * 11 + 1, encoder.itemCount());
+    TEST_ASSERT_EQUAL_UINT32(0, encoder.items()[encoder.itemCount() - 1]);
+}
+
+void test_break_and_mab_timing(void) {
+    fillRandom(frame, 25, 3);
+    encoder.setTiming(100, 20);
+    encoder.encode(frame, 25);
+    assertWave(encoder, frame, 25, 100, 20);
+
+    // 只改 Break / MAB，数据不必重新编码
+    encoder.setTiming(200, 16);
+    TEST_ASSERT_EQUAL_UINT16(0, encoder.encode(frame, 25));
+    assertWave(encoder, frame, 25, 200, 16);
+}
+
+// 只重新编码变化的字节，结果与整帧编码完全相同
+void test_incremental_encodes_only_changed_slots(void) {
+    fillRandom(frame, 513, 4);
+    encoder.encode(frame, 513);
+
+    TEST_ASSERT_EQUAL_UINT16(0, encoder.encode(frame, 513));
+
+    frame[1] ^= 0x55;
+    frame[2] ^= 0x01;
+    frame[300] ^= 0x80;
+    frame[512] ^= 0xFF;
+    TEST_ASSERT_EQUAL_UINT16(4, encoder.encode(frame, 513));
+
+    fresh.encode(frame, 513);
+    assertSameItems(encoder, fresh);
+    assertWave(encoder, frame, 513, 176, 12);
+}
+
+// 帧长变化（自适应有效通道数）时重写帧尾和结束标记
+void test_length_change_rewrites_tail(void) {
+    fillRandom(frame, 513, 5);
+    const uint16_t lengths[] = {513, 25, 24, 101, 100, 513, 1, 2};
+    for (uint16_t bytes : lengths) {
+        frame[bytes / 2] ^= 0x3C;
+        encoder.encode(frame, bytes);
+        fresh.invalidate();
+        fresh.encode(frame, bytes);
+        assertSameItems(encoder, fresh);
+        assertWave(encoder, frame, bytes, 176, 12);
+    }
+}
+
+// item 的位布局与 rmt_item32_t 一致
+void test_item_layout(void) {
+    uint32_t item = DmxRmtEncoder::makeItem(0, 176, 1, 12);
+    TEST_ASSERT_EQUAL_UINT32(176, item & 0x7FFF);
+    TEST_ASSERT_EQUAL_UINT32(0, (item >> 15) & 1);
+    TEST_ASSERT_EQUAL_UINT32(12, (item >> 16) & 0x7FFF);
+    TEST_ASSERT_EQUAL_UINT32(1, item >> 31);
+
+    encoder.encode(frame, 25);
+    TEST_ASSERT_EQUAL_UINT32(item, encoder.items()[0]);
+}
+
+// 状态机驱动 RMT 后端：Break 在波形内，第一帧也不需要软件 Break，每帧唤醒一次
+struct RmtPort {
+    DmxRmtEncoder& encoder;
+    const uint8_t* data;
+    uint16_t bytes;
+    uint32_t breaks;
+    uint32_t writes;
+    uint32_t armUs;
+    bool txIdle() { return true; }
+    void breakBegin() { breaks++; }
+    void breakEnd() {}
+    uint16_t sendFrame() { return 0; }
+    uint16_t sendFrameWithBreak(uint32_t breakBits) {
+        encoder.encode(data, bytes);
+        writes++;
+        return bytes;
+    }
+    void arm(uint32_t us) { armUs = us; }
+};
+
+void test_state_machine_encoded_break(void) {
+    fillRandom(frame, 25, 7);
+    DmxTxStateMachine tx;
+    tx.setBreakMode(DMX_BREAK_ENCODED);
+    tx.setRefreshRate(0);
+    RmtPort port = {encoder, frame, 25, 0, 0, 0};
+
+    uint32_t now = 0;
+    tx.start(port, now);
+    for (int i = 0; i < 10; i++) {
+        now += port.armUs;
+        tx.onTimer(port, now);
+    }
+    TEST_ASSERT_EQUAL_UINT32(0, port.breaks);
+    TEST_ASSERT_EQUAL_UINT32(10, port.writes);
+    TEST_ASSERT_EQUAL_UINT32(10, tx.getStats().frames);
+    // 背靠背：周期等于 Break + MAB + 数据，不按位取整
+    TEST_ASSERT_EQUAL_UINT32(176 + 12 + 25 * DMX_TX_BYTE_US, tx.getStats().lastPeriodUs);
+    assertWave(encoder, frame, 25, 176, 12);
+}
+
+// 每帧编码开销：整帧重新编码 vs 只编码变化的通道
+void test_bench_encode_cost(void) {
+    static uint8_t frames[2][DmxRmtEncoder::MAX_BYTES];
+    fillRandom(frames[0], 513, 6);
+    memcpy(frames[1], frames[0], sizeof(frames[1]));
+
+    BenchResult full = benchRun(20000, [&]() {
+        encoder.invalidate();
+        benchKeep(frames[0]);
+        encoder.encode(frames[0], 513);
+        benchKeep(encoder.items());
+    });
+    benchReport("rmt encode full 513", full);
+
+    BenchResult unchanged = benchRun(20000, [&]() {
+        benchKeep(frames[0]);
+        encoder.encode(frames[0], 513);
+        benchKeep(encoder.items());
+    });
+    benchReport("rmt encode unchanged 513", unchanged);
+
+    const uint16_t changedCounts[] = {8, 64, 512};
+    char name[48];
+    for (uint16_t changed : changedCounts) {
+        // 两帧交替，每次有 changed 个通道不同
+        memcpy(frames[1], frames[0], sizeof(frames[1]));
+        for (uint16_t i = 0; i < changed; i++) {
+            frames[1][1 + i * (512 / changed)] ^= 0xA5;
+        }
+        uint32_t n = 0;
+        BenchResult incremental = benchRun(20000, [&]() {
+            benchKeep(frames[n & 1]);
+            encoder.encode(frames[n & 1], 513);
+            benchKeep(encoder.items());
+            n++;
+        });
+        snprintf(name, sizeof(name), "rmt encode %u changed of 513", changed);
+        benchReport(name, incremental);
+    }
+
+    BenchResult shortFrame = benchRun(20000, [&]() {
+        encoder.invalidate();
+        benchKeep(frames[0]);
+        encoder.encode(frames[0], 25);
+        benchKeep(encoder.items());
+    });
+    benchReport("rmt encode full 25", shortFrame);
+
+    printf("[bench] rmt item buffer %u items (%u bytes)\n",
+           DmxRmtEncoder::MAX_ITEMS, (unsigned)(DmxRmtEncoder::MAX_ITEMS * sizeof(uint32_t)));
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_full_frame_matches_reference);
+    RUN_TEST(test_extreme_values_match_reference);
+    RUN_TEST(test_odd_and_even_lengths);
+    RUN_TEST(test_break_and_mab_timing);
+    RUN_TEST(test_incremental_encodes_only_changed_slots);
+    RUN_TEST(test_length_change_rewrites_tail);
+    RUN_TEST(test_item_layout);
+    RUN_TEST(test_state_machine_encoded_break);
+    RUN_TEST(test_bench_encode_cost);
+    return UNITY_END();
+}
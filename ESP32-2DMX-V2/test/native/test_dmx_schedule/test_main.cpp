@@ -0,0 +1,232 @@
+#include <unity.h>
+#include <string.h>
+#include "../dmx_sim.h"
+
+// 输出刷新调度：输入帧按给定间隔提交到模拟端口，检查输出帧与输入的对应关系、
+// 输入空闲时的唤醒次数和各模式下的调度统计。线路时序仍由 DmxWireChecker 检查，
+// MAB 不超过硬件 Break 允许落进 MAB 的帧间空闲（空闲后的帧改用软件 Break）
+
+static DmxWireSim* sim;
+static DmxTxStateMachine* tx;
+static DmxWireChecker checker;
+static uint8_t slots[DMX_SLOT_COUNT];
+
+static void startMode(DmxRefreshMode refreshMode, DmxBreakMode breakMode) {
+    tx->getScheduler().setMode(refreshMode);
+    tx->setBreakMode(breakMode);
+    tx->setRefreshRate(0);
+    sim->attach(*tx);
+    tx->start(*sim, sim->now);
+}
+
+// 从现在起每 intervalUs 提交一帧（内容每帧不同），共 count 帧
+static void feedInput(uint32_t intervalUs, uint32_t count, uint16_t length = DMX_SLOT_COUNT) {
+    for (uint32_t i = 0; i < count; i++) {
+        sim->run(*tx, sim->now + intervalUs);
+        slots[0]++;
+        sim->input(*tx, slots, length);
+    }
+}
+
+// 设定的 12 us MAB 加上允许落进 MAB 的空闲，再留一个字节的余量
+static const uint32_t MAB_CAP_US = 12 + DmxTxStateMachine::MAX_IDLE_MAB_US + DMX_TX_BYTE_US;
+
+void setUp(void) {
+    checker.mabLimitUs = MAB_CAP_US;
+    sim = new DmxWireSim();
+    tx = new DmxTxStateMachine();
+    for (uint16_t i = 0; i < DMX_SLOT_COUNT; i++) slots[i] = (uint8_t)i;
+    sim->writeSlots(slots, DMX_SLOT_COUNT);
+}
+
+void tearDown(void) {
+    delete sim;
+    delete tx;
+}
+
+// 跟随输入：每个输入帧都提前唤醒并发出一帧，输出帧率等于输入帧率
+void test_match_follows_input_rate(void) {
+    startMode(DMX_REFRESH_MATCH, DMX_BREAK_UART);
+    feedInput(33333, 60);                   // 30 Hz，约 2 秒
+    DmxTimingReport r = checker.analyze(sim->line());
+    checker.print("match 30 Hz input", r);
+
+    const DmxScheduleStats& s = tx->getScheduler().getStats();
+    TEST_ASSERT_TRUE(r.compliant());
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 30.0f, tx->getScheduler().inputHz());
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 30.0f, r.refreshHz);
+    TEST_ASSERT_TRUE(s.kicks >= 58);
+    TEST_ASSERT_TRUE(s.repeatFrames <= 2);
+    TEST_ASSERT_EQUAL(DMX_SCHED_MATCH, s.lastReason);
+    TEST_ASSERT_EQUAL_UINT32(0, tx->getStats().busyRetries);
+}
+
+// 每个输入帧在提交后立即开始发送（帧起点就是提交时刻）
+void test_match_is_in_phase_with_input(void) {
+    startMode(DMX_REFRESH_MATCH, DMX_BREAK_ENCODED);
+    feedInput(25000, 40);
+    sim->run(*tx, sim->now + 100000);
+    checker.analyze(sim->line());
+    TEST_ASSERT_TRUE(checker.frames.size() >= 42);
+    // 第一帧之后的每一帧都在输入提交的时刻开始
+    uint32_t inPhase = 0;
+    for (size_t f = 1; f < 40; f++) {
+        if (checker.frames[f].breakStartUs % 25000 == 0) inPhase++;
+    }
+    TEST_ASSERT_TRUE(inPhase >= 38);
+    // 发出的是提交时的最新内容，之后按 1.25 倍输入间隔重复
+    TEST_ASSERT_EQUAL_UINT8(slots[0], checker.data[40][1]);
+    TEST_ASSERT_EQUAL_UINT32(31250, checker.frames[41].breakStartUs - checker.frames[40].breakStartUs);
+}
+
+// 输入停止后降到保活频率，空闲期间每秒只有保活次数的唤醒
+void test_idle_drops_to_keepalive(void) {
+    tx->getScheduler().setKeepaliveRate(4);
+    tx->getScheduler().setIdleTimeout(500000);
+    startMode(DMX_REFRESH_MATCH, DMX_BREAK_UART);
+    feedInput(23000, 20);
+
+    uint32_t wakeups = sim->wakeups;
+    uint32_t idleStart = sim->now;
+    sim->run(*tx, idleStart + 3000000);
+    uint32_t idleWakeups = sim->wakeups - wakeups;
+    printf("[sched] idle 3 s: %u wakeups (fixed rate would be ~%u)\n", idleWakeups, 3 * 44);
+
+    const DmxScheduleStats& s = tx->getScheduler().getStats();
+    TEST_ASSERT_EQUAL(DMX_SCHED_KEEPALIVE, s.lastReason);
+    TEST_ASSERT_EQUAL_UINT32(250000, s.periodUs);
+    // 空闲超时前按输入间隔的 1.25 倍重复，之后每秒 4 次；
+    // 帧间空闲超过 MAX_IDLE_MAB_US，每帧用软件 Break（Break、MAB、数据各唤醒一次）
+    TEST_ASSERT_TRUE(idleWakeups <= 3 * (500000 / 28750 + 1 + 3 * 4));
+    TEST_ASSERT_TRUE(s.keepaliveFrames >= 10);
+
+    // UART 硬件 Break 下保活间隔不落在 MAB 中，MAB 保持设定值
+    DmxTimingReport r = checker.analyze(sim->line());
+    checker.print("match idle -> keepalive", r);
+    TEST_ASSERT_TRUE(r.compliant());
+    TEST_ASSERT_TRUE(r.maxMabUs <= MAB_CAP_US);
+}
+
+// 空闲后恢复：第一帧新数据立即发出，不等保活周期
+void test_resume_after_idle_is_immediate(void) {
+    startMode(DMX_REFRESH_MATCH, DMX_BREAK_ENCODED);
+    feedInput(23000, 5);
+    sim->run(*tx, sim->now + 2000000);
+    uint32_t submitUs = sim->now;
+    slots[1] = 0xAB;
+    sim->input(*tx, slots, DMX_SLOT_COUNT);
+    sim->run(*tx, submitUs + 30000);
+
+    checker.analyze(sim->line());
+    const DmxFrameTiming& last = checker.frames.back();
+    TEST_ASSERT_EQUAL_UINT8(0xAB, checker.data.back()[2]);
+    TEST_ASSERT_TRUE(last.breakStartUs - submitUs <= DmxTxStateMachine::MIN_FRAME_US);
+}
+
+// 只在变化时发送 + 保活：输入不规律时有变化立即发，其余时间按保活频率
+void test_keepalive_mode(void) {
+    tx->getScheduler().setKeepaliveRate(2);
+    startMode(DMX_REFRESH_KEEPALIVE, DMX_BREAK_UART);
+    sim->run(*tx, 100000);
+    const uint32_t gaps[] = {70000, 5000, 300000, 40000, 900000};
+    uint32_t expectedFresh = 0;
+    for (uint32_t gap : gaps) {
+        sim->run(*tx, sim->now + gap);
+        slots[0]++;
+        sim->input(*tx, slots, DMX_SLOT_COUNT);
+        expectedFresh++;
+    }
+    sim->run(*tx, sim->now + 1000000);
+
+    const DmxScheduleStats& s = tx->getScheduler().getStats();
+    DmxTimingReport r = checker.analyze(sim->line());
+    checker.print("keepalive 2 Hz", r);
+    TEST_ASSERT_TRUE(r.compliant());
+    // 相隔 5 ms 的两帧：第二帧要等上一帧在线上发完，两次提交合并为一帧
+    TEST_ASSERT_TRUE(s.freshFrames >= expectedFresh - 1);
+    TEST_ASSERT_TRUE(s.kicks >= expectedFresh - 1);
+    TEST_ASSERT_EQUAL_UINT32(0, s.matchFrames);
+    TEST_ASSERT_EQUAL_UINT32(500000, s.periodUs);
+    TEST_ASSERT_EQUAL_UINT8(slots[0], checker.data.back()[1]);
+}
+
+// 输入比线路快：输出背靠背，既不违反最短帧间隔，也不会在 UART 未发完时唤醒
+void test_input_faster_than_wire(void) {
+    const DmxBreakMode modes[] = {DMX_BREAK_TIMER, DMX_BREAK_UART, DMX_BREAK_ENCODED};
+    const char* names[] = {"match 200 Hz timer", "match 200 Hz uart", "match 200 Hz rmt"};
+    for (int m = 0; m < 3; m++) {
+        tearDown();
+        setUp();
+        startMode(DMX_REFRESH_MATCH, modes[m]);
+        feedInput(5000, 200);
+        DmxTimingReport r = checker.analyze(sim->line());
+        checker.print(names[m], r);
+        TEST_ASSERT_TRUE(r.compliant());
+        TEST_ASSERT_TRUE(r.refreshHz > 40.0f);
+        TEST_ASSERT_EQUAL_UINT32(0, tx->getStats().busyRetries);
+    }
+}
+
+// 短帧、输入很快：最短帧间隔 1204 us 仍然成立
+void test_short_frames_keep_minimum_period(void) {
+    tearDown();
+    sim = new DmxWireSim();
+    tx = new DmxTxStateMachine();
+    sim->minSlots = 24;
+    startMode(DMX_REFRESH_KEEPALIVE, DMX_BREAK_ENCODED);
+    feedInput(700, 300, 10);
+    DmxTimingReport r = checker.analyze(sim->line());
+    TEST_ASSERT_TRUE(r.compliant());
+    TEST_ASSERT_TRUE(r.minPeriodUs >= DMX_LIMIT_PERIOD_MIN_US);
+    TEST_ASSERT_TRUE(r.refreshHz > 700.0f);
+}
+
+// 固定模式：提交新帧不改变节奏
+void test_fixed_ignores_input_timing(void) {
+    tx->setRefreshRate(40);
+    tx->getScheduler().setMode(DMX_REFRESH_FIXED);
+    tx->setBreakMode(DMX_BREAK_UART);
+    sim->attach(*tx);
+    tx->start(*sim, 0);
+    feedInput(33333, 30);
+    DmxTimingReport r = checker.analyze(sim->line());
+    const DmxScheduleStats& s = tx->getScheduler().getStats();
+    TEST_ASSERT_TRUE(r.compliant());
+    TEST_ASSERT_EQUAL_UINT32(0, s.kicks);
+    TEST_ASSERT_EQUAL_UINT32(0, s.matchFrames + s.keepaliveFrames);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 40.0f, r.refreshHz);
+    TEST_ASSERT_EQUAL_UINT32(25000, r.maxPeriodUs);
+}
+
+// 保活频率的上下限
+void test_keepalive_rate_limits(void) {
+    DmxOutputScheduler sched;
+    sched.setKeepaliveRate(0);
+    TEST_ASSERT_EQUAL_UINT32(DmxOutputScheduler::MAX_KEEPALIVE_US, sched.getKeepaliveUs());
+    sched.setKeepaliveRate(1);
+    TEST_ASSERT_EQUAL_UINT32(DmxOutputScheduler::MAX_KEEPALIVE_US, sched.getKeepaliveUs());
+    sched.setKeepaliveRate(10);
+    TEST_ASSERT_EQUAL_UINT32(100000, sched.getKeepaliveUs());
+
+    // 输入比保活还慢时，跟随输入不会比保活周期更长
+    sched.setMode(DMX_REFRESH_MATCH);
+    sched.setIdleTimeout(5000000);
+    sched.onInput(0);
+    sched.onInput(2000000);
+    TEST_ASSERT_EQUAL_UINT32(100000, sched.onFrame(2000000, 0, false));
+    TEST_ASSERT_EQUAL(DMX_SCHED_MATCH, sched.getStats().lastReason);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_match_follows_input_rate);
+    RUN_TEST(test_match_is_in_phase_with_input);
+    RUN_TEST(test_idle_drops_to_keepalive);
+    RUN_TEST(test_resume_after_idle_is_immediate);
+    RUN_TEST(test_keepalive_mode);
+    RUN_TEST(test_input_faster_than_wire);
+    RUN_TEST(test_short_frames_keep_minimum_period);
+    RUN_TEST(test_fixed_ignores_input_timing);
+    RUN_TEST(test_keepalive_rate_limits);
+    return UNITY_END();
+}
@@ -0,0 +1,214 @@
+#include <unity.h>
+#include <string.h>
+#include "../dmx_sim.h"
+
+// 线路级时序回归：状态机 + 模拟 UART / RMT 产生的波形由 DmxWireChecker 解码，
+// 按 DMX512-A 检查 Break、MAB、通道数、帧周期和抖动。[timing] 行记录各模式的实测结果
+
+static DmxWireSim* sim;
+static DmxTxStateMachine* tx;
+static DmxWireChecker checker;
+static uint8_t slots[DMX_SLOT_COUNT];
+
+static void fillSlots(uint16_t length, uint8_t seed) {
+    for (uint16_t i = 0; i < length; i++) slots[i] = (uint8_t)(i * 7 + seed);
+}
+
+static void startMode(DmxBreakMode mode, uint32_t refreshHz) {
+    tx->setBreakMode(mode);
+    tx->setRefreshRate(refreshHz);
+    sim->attach(*tx);
+    tx->start(*sim, sim->now);
+}
+
+static DmxTimingReport runFor(uint32_t us) {
+    sim->run(*tx, sim->now + us);
+    return checker.analyze(sim->line());
+}
+
+void setUp(void) {
+    sim = new DmxWireSim();
+    tx = new DmxTxStateMachine();
+    fillSlots(DMX_SLOT_COUNT, 0);
+    sim->writeSlots(slots, DMX_SLOT_COUNT);
+}
+
+void tearDown(void) {
+    delete sim;
+    delete tx;
+}
+
+// 软件 Break：定时器控制的 Break / MAB 宽度与设定值一致
+void test_timer_break_full_frame(void) {
+    startMode(DMX_BREAK_TIMER, 0);
+    DmxTimingReport r = runFor(500000);
+    checker.print("timer break 512", r);
+
+    TEST_ASSERT_TRUE(r.compliant());
+    TEST_ASSERT_EQUAL_UINT32(176, r.minBreakUs);
+    TEST_ASSERT_EQUAL_UINT32(176, r.maxBreakUs);
+    TEST_ASSERT_EQUAL_UINT32(12, r.minMabUs);
+    TEST_ASSERT_EQUAL_UINT16(512, r.minSlots);
+    TEST_ASSERT_EQUAL_UINT16(512, r.maxSlots);
+    TEST_ASSERT_EQUAL_UINT32(176 + 12 + 513 * DMX_TX_BYTE_US, r.minPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(0, r.jitterPeakUs);
+}
+
+// 解码出的通道值与写入的一致
+void test_decoded_slots_match_written(void) {
+    startMode(DMX_BREAK_UART, 0);
+    runFor(100000);
+    TEST_ASSERT_TRUE(checker.data.size() > 2);
+    const std::vector<uint8_t>& frame = checker.data[1];
+    TEST_ASSERT_EQUAL_UINT32(513, frame.size());
+    TEST_ASSERT_EQUAL_UINT8(0, frame[0]);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(slots, frame.data() + 1, DMX_SLOT_COUNT);
+}
+
+// UART 硬件 Break：Break 为整数位，MAB 为 tx_idle_num 位
+void test_uart_break_full_frame(void) {
+    tx->setTiming(176, 12);
+    startMode(DMX_BREAK_UART, 0);
+    DmxTimingReport r = runFor(500000);
+    checker.print("uart break 512", r);
+
+    TEST_ASSERT_TRUE(r.compliant());
+    TEST_ASSERT_EQUAL_UINT32(176, r.minBreakUs);
+    TEST_ASSERT_EQUAL_UINT32(12, r.minMabUs);
+    TEST_ASSERT_EQUAL_UINT32(12, r.maxMabUs);
+    TEST_ASSERT_EQUAL_UINT32(tx->frameTimeUs(513), r.maxPeriodUs);
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 1e6f / tx->frameTimeUs(513), r.refreshHz);
+}
+
+// RMT：Break / MAB 精确到微秒，帧间没有定时器抖动
+void test_rmt_full_frame(void) {
+    tx->setTiming(120, 16);
+    startMode(DMX_BREAK_ENCODED, 0);
+    DmxTimingReport r = runFor(500000);
+    checker.print("rmt 512", r);
+
+    TEST_ASSERT_TRUE(r.compliant());
+    TEST_ASSERT_EQUAL_UINT32(120, r.minBreakUs);
+    TEST_ASSERT_EQUAL_UINT32(120, r.maxBreakUs);
+    TEST_ASSERT_EQUAL_UINT32(16, r.minMabUs);
+    TEST_ASSERT_EQUAL_UINT32(16, r.maxMabUs);
+    TEST_ASSERT_EQUAL_UINT32(120 + 16 + 513 * DMX_TX_BYTE_US, r.minPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(0, r.jitterPeakUs);
+}
+
+// 短帧：最少通道数和 1204 us 的最短帧间隔都不违反
+void test_short_frames_respect_minimum_period(void) {
+    const DmxBreakMode modes[] = {DMX_BREAK_TIMER, DMX_BREAK_UART, DMX_BREAK_ENCODED};
+    const char* names[] = {"timer break 24", "uart break 24", "rmt 24"};
+    for (int m = 0; m < 3; m++) {
+        tearDown();
+        sim = new DmxWireSim();
+        tx = new DmxTxStateMachine();
+        sim->minSlots = 24;
+        sim->writeSlots(slots, 10);
+        startMode(modes[m], 0);
+        DmxTimingReport r = runFor(200000);
+        checker.print(names[m], r);
+
+        TEST_ASSERT_TRUE(r.compliant());
+        TEST_ASSERT_EQUAL_UINT16(24, r.minSlots);
+        TEST_ASSERT_EQUAL_UINT16(24, r.maxSlots);
+        TEST_ASSERT_TRUE(r.minPeriodUs >= DMX_LIMIT_PERIOD_MIN_US);
+        TEST_ASSERT_TRUE(r.refreshHz > 700.0f);
+    }
+}
+
+// 定时器抖动反映在帧周期上，但周期只会变长，不会低于限值
+void test_timer_jitter_is_reported(void) {
+    sim->timerJitterUs = 200;
+    startMode(DMX_BREAK_TIMER, 40);
+    DmxTimingReport r = runFor(1000000);
+    checker.print("timer break 40 Hz jitter", r);
+
+    TEST_ASSERT_TRUE(r.compliant());
+    TEST_ASSERT_TRUE(r.jitterPeakUs > 0);
+    TEST_ASSERT_TRUE(r.jitterPeakUs <= 3 * 200);
+    TEST_ASSERT_TRUE(r.jitterUs > 0.0f);
+    // 名义周期按时间表推进，平均刷新率不受延迟影响
+    TEST_ASSERT_FLOAT_WITHIN(0.5f, 40.0f, r.refreshHz);
+}
+
+// 通道间的额外 Mark（FIFO 续填间隙）计入帧长并单独报告
+void test_inter_slot_mark(void) {
+    sim->slotGapUs = 8;
+    startMode(DMX_BREAK_UART, 0);
+    DmxTimingReport r = runFor(200000);
+    TEST_ASSERT_EQUAL_UINT32(8, r.maxSlotMarkUs);
+    TEST_ASSERT_EQUAL_UINT16(512, r.minSlots);
+    TEST_ASSERT_EQUAL_UINT32(0, r.violations.framingErrors);
+}
+
+// 检查器本身：手工构造的违规波形
+void test_checker_flags_violations(void) {
+    DmxLineTrace line;
+    uint32_t t = 1000;
+    for (int frame = 0; frame < 3; frame++) {
+        t = line.hold(t, 0, 90);        // Break 不足 92 us（但接收端仍能识别）
+        t = line.hold(t, 1, 8);         // MAB 不足 12 us
+        for (int i = 0; i < 5; i++) t = line.byte(t, 0x55);
+        t = line.hold(t, 1, 100);       // 帧太短：Break 到 Break 小于 1204 us
+    }
+    t = line.hold(t, 0, 100);
+    line.set(t, 1);
+
+    DmxTimingReport r = checker.analyze(line);
+    TEST_ASSERT_EQUAL_UINT32(3, r.frames);
+    TEST_ASSERT_FALSE(r.compliant());
+    TEST_ASSERT_EQUAL_UINT32(3, r.violations.breakShort);
+    TEST_ASSERT_EQUAL_UINT32(3, r.violations.mabShort);
+    TEST_ASSERT_EQUAL_UINT32(3, r.violations.periodShort);
+    TEST_ASSERT_EQUAL_UINT32(0, r.violations.framingErrors);
+    TEST_ASSERT_EQUAL_UINT16(4, r.maxSlots);
+    TEST_ASSERT_EQUAL_UINT32(90 + 8 + 5 * 44 + 100, r.minPeriodUs);
+}
+
+// 停止位为低、低电平介于数据和 Break 之间都算帧错误
+void test_checker_flags_framing_errors(void) {
+    DmxLineTrace line;
+    uint32_t t = 0;
+    t = line.hold(t, 0, 176);
+    t = line.hold(t, 1, 12);
+    t = line.byte(t, 0);
+    t = line.hold(t, 0, 60);            // 不够 Break，也不是一个字节
+    t = line.hold(t, 1, 2000);
+    t = line.hold(t, 0, 176);
+    line.set(t, 1);
+
+    DmxTimingReport r = checker.analyze(line);
+    TEST_ASSERT_EQUAL_UINT32(1, r.frames);
+    TEST_ASSERT_EQUAL_UINT32(1, r.violations.framingErrors);
+}
+
+// 末尾未发完的帧不计入
+void test_checker_ignores_incomplete_frame(void) {
+    DmxLineTrace line;
+    uint32_t t = 0;
+    t = line.hold(t, 0, 176);
+    t = line.hold(t, 1, 12);
+    for (int i = 0; i < 30; i++) t = line.byte(t, i);
+    line.hold(t, 0, 20);
+
+    DmxTimingReport r = checker.analyze(line);
+    TEST_ASSERT_EQUAL_UINT32(0, r.frames);
+    TEST_ASSERT_FALSE(r.compliant());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_timer_break_full_frame);
+    RUN_TEST(test_decoded_slots_match_written);
+    RUN_TEST(test_uart_break_full_frame);
+    RUN_TEST(test_rmt_full_frame);
+    RUN_TEST(test_short_frames_respect_minimum_period);
+    RUN_TEST(test_timer_jitter_is_reported);
+    RUN_TEST(test_inter_slot_mark);
+    RUN_TEST(test_checker_flags_violations);
+    RUN_TEST(test_checker_flags_framing_errors);
+    RUN_TEST(test_checker_ignores_incomplete_frame);
+    return UNITY_END();
+}
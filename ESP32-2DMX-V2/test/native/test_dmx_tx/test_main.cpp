@@ -0,0 +1,607 @@
+#include <unity.h>
+#include <string.h>
+#include <vector>
+#include "dmx/DmxFrameBuffer.h"
+#include "dmx/DmxTxStateMachine.h"
+#include "../bench.h"
+
+#define DMX_PORT_COUNT_SIM 4
+
+// 用虚拟时钟模拟 UART + 定时器，检查状态机产生的线上时序：
+//   Break / MAB 宽度、帧周期、UART 未发完时推迟、没有新帧时重复上一帧
+// 硬件 Break 模式下模拟 UART 的行为：数据后发 breakBits 位 Break，
+// 下一次发送前至少空闲 tx_idle_num 位
+
+struct LineEvent {
+    uint32_t breakUs;       // Break 开始时刻
+    uint32_t mabUs;         // Break 结束（MAB 开始）
+    uint32_t dataUs;        // 起始码开始
+    uint32_t endUs;         // 最后一个停止位结束
+    uint8_t firstSlot;
+};
+
+class SimPort {
+public:
+    uint32_t now;
+    uint32_t timerAt;
+    bool armed;
+    uint32_t txBusyUntil;
+    uint32_t extraTxUs;         // 模拟 UART 比计算值晚发完
+    uint32_t timerLatencyUs;    // 模拟定时器回调延迟
+    bool inBreak;
+    uint32_t wakeups;
+    uint16_t minSlots;          // ESP32DMX::setMinimumSlots，默认发整帧
+    uint32_t idleBits;          // uart_set_tx_idle_num
+    uint32_t lineIdleSince;     // 上一次 Break 结束的时刻
+    LineEvent pending;          // 上一帧末尾的硬件 Break，属于下一帧
+    DmxFrameBuffer frames;
+    uint8_t fifo[DMX_SLOT_COUNT + 1];
+    std::vector<LineEvent> trace;
+
+    SimPort()
+        : now(1000), timerAt(0), armed(false), txBusyUntil(0), extraTxUs(0),
+          timerLatencyUs(0), inBreak(false), wakeups(0), minSlots(DMX_SLOT_COUNT), idleBits(0), lineIdleSince(0) {
+        memset(&pending, 0, sizeof(pending));
+    }
+
+    bool txIdle() { return (int32_t)(now - txBusyUntil) >= 0; }
+
+    void breakBegin() {
+        TEST_ASSERT_TRUE(txIdle());     // Break 不能截断上一帧
+        inBreak = true;
+        LineEvent event = {now, 0, 0, 0, 0};
+        trace.push_back(event);
+    }
+
+    void breakEnd() {
+        inBreak = false;
+        trace.back().mabUs = now;
+    }
+
+    uint16_t sendFrame() {
+        frames.acquire();
+        const DmxFrame& frame = frames.front();
+        memcpy(fifo, frame.data, sizeof(frame.data));
+        benchKeep(fifo);
+        uint16_t bytes = frame.activeSlots(minSlots) + 1;
+        txBusyUntil = now + bytes * DMX_TX_BYTE_US + extraTxUs;
+        trace.back().dataUs = now;
+        trace.back().endUs = txBusyUntil;
+        trace.back().firstSlot = frame.data[1];
+        return bytes;
+    }
+
+    uint16_t sendFrameWithBreak(uint32_t breakBits) {
+        frames.acquire();
+        const DmxFrame& frame = frames.front();
+        memcpy(fifo, frame.data, sizeof(frame.data));
+        benchKeep(fifo);
+        uint16_t bytes = frame.activeSlots(minSlots) + 1;
+
+        // 软件 Break 之后的第一帧沿用已有的记录，否则上一帧末尾的 Break 就是本帧的 Break
+        if (trace.empty() || trace.back().dataUs != 0) {
+            trace.push_back(pending);
+        }
+        uint32_t start = now;
+        uint32_t earliest = lineIdleSince + idleBits * DMX_TX_BIT_US;
+        if ((int32_t)(earliest - start) > 0) start = earliest;
+
+        uint32_t dataEnd = start + bytes * DMX_TX_BYTE_US;
+        trace.back().dataUs = start;
+        trace.back().endUs = dataEnd;
+        trace.back().firstSlot = frame.data[1];
+
+        lineIdleSince = dataEnd + breakBits * DMX_TX_BIT_US;
+        txBusyUntil = lineIdleSince + extraTxUs;
+        pending.breakUs = dataEnd;
+        pending.mabUs = lineIdleSince;
+        pending.dataUs = 0;
+        return bytes;
+    }
+
+    void arm(uint32_t delayUs) {
+        TEST_ASSERT_FALSE(armed);
+        armed = true;
+        timerAt = now + delayUs + timerLatencyUs;
+    }
+
+    // 推进到 endUs，依次触发定时器
+    void run(DmxTxStateMachine& tx, uint32_t endUs) {
+        while (armed && (int32_t)(endUs - timerAt) >= 0) {
+            now = timerAt;
+            armed = false;
+            wakeups++;
+            tx.onTimer(*this, now);
+        }
+        now = endUs;
+    }
+};
+
+static void writeFrame(SimPort& port, uint8_t value) {
+    uint8_t slots[DMX_SLOT_COUNT];
+    memset(slots, value, sizeof(slots));
+    port.frames.writeSlots(slots, DMX_SLOT_COUNT);
+    port.frames.commit();
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_break_mab_and_slot_timing() {
+    SimPort port;
+    DmxTxStateMachine tx;
+    tx.start(port, port.now);
+    port.run(tx, port.now + 1000000);
+
+    TEST_ASSERT_GREATER_THAN(40, port.trace.size());
+    for (size_t i = 0; i + 1 < port.trace.size(); i++) {
+        const LineEvent& e = port.trace[i];
+        TEST_ASSERT_EQUAL_UINT32(176, e.mabUs - e.breakUs);
+        TEST_ASSERT_EQUAL_UINT32(12, e.dataUs - e.mabUs);
+        TEST_ASSERT_EQUAL_UINT32(513 * DMX_TX_BYTE_US, e.endUs - e.dataUs);
+        // 下一帧的 Break 紧接着上一帧的最后一个字节
+        TEST_ASSERT_TRUE(port.trace[i + 1].breakUs >= e.endUs);
+    }
+
+    // 44 Hz 的周期短于整帧 (176 + 12 + 513 * 44 us)，按帧长背靠背发送
+    const DmxTxStats& stats = tx.getStats();
+    TEST_ASSERT_EQUAL_UINT32(176 + 12 + 513 * DMX_TX_BYTE_US, stats.minPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(stats.minPeriodUs, stats.maxPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.busyRetries);
+}
+
+void test_lower_refresh_rate_is_exact() {
+    SimPort port;
+    DmxTxStateMachine tx;
+    tx.setRefreshRate(30);
+    tx.start(port, port.now);
+    port.run(tx, port.now + 1001000);
+
+    const DmxTxStats& stats = tx.getStats();
+    TEST_ASSERT_EQUAL_UINT32(33333, stats.minPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(33333, stats.maxPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(31, stats.frames);
+
+    // 每帧只唤醒 3 次：Break、MAB、数据
+    TEST_ASSERT_EQUAL_UINT32(stats.frames * 3, port.wakeups);
+}
+
+void test_repeats_last_frame_until_new_one() {
+    SimPort port;
+    DmxTxStateMachine tx;
+    writeFrame(port, 0x11);
+    tx.start(port, port.now);
+    port.run(tx, port.now + 200000);
+
+    size_t before = port.trace.size();
+    TEST_ASSERT_GREATER_THAN(5, before);
+    for (size_t i = 0; i < before; i++) {
+        TEST_ASSERT_EQUAL_UINT8(0x11, port.trace[i].firstSlot);
+    }
+
+    // 新帧在下一个帧边界生效
+    writeFrame(port, 0x22);
+    port.run(tx, port.now + 100000);
+    TEST_ASSERT_GREATER_THAN(before, port.trace.size());
+    TEST_ASSERT_EQUAL_UINT8(0x22, port.trace.back().firstSlot);
+}
+
+void test_waits_for_uart_to_finish() {
+    SimPort port;
+    DmxTxStateMachine tx;
+    port.extraTxUs = 100;           // FIFO 比计算值晚 100 us 发空
+    tx.start(port, port.now);
+    port.run(tx, port.now + 500000);
+
+    // breakBegin() 中已断言 UART 空闲
+    TEST_ASSERT_GREATER_THAN(0, tx.getStats().busyRetries);
+    for (size_t i = 0; i + 1 < port.trace.size(); i++) {
+        TEST_ASSERT_TRUE(port.trace[i + 1].breakUs >= port.trace[i].endUs);
+    }
+}
+
+void test_timer_latency_does_not_drift() {
+    SimPort port;
+    DmxTxStateMachine tx;
+    tx.setRefreshRate(20);
+    port.timerLatencyUs = 40;       // esp_timer 任务的调度延迟
+    tx.start(port, port.now);
+    port.run(tx, port.now + 5000000);
+
+    // 每次定时都晚 40 us，Break 和 MAB 只会变长；帧起点仍按 50 ms 推进
+    const std::vector<LineEvent>& trace = port.trace;
+    TEST_ASSERT_EQUAL_UINT32(176 + 40, trace[1].mabUs - trace[1].breakUs);
+    uint32_t span = trace.back().breakUs - trace.front().breakUs;
+    uint32_t frames = trace.size() - 1;
+    TEST_ASSERT_UINT32_WITHIN(100, frames * 50000, span);
+}
+
+void test_stop_releases_line() {
+    SimPort port;
+    DmxTxStateMachine tx;
+    tx.start(port, port.now);
+    port.run(tx, port.now + 100);       // 正在 Break 中
+    TEST_ASSERT_TRUE(port.inBreak);
+
+    tx.stop();
+    port.run(tx, port.now + 100000);
+    TEST_ASSERT_FALSE(port.inBreak);
+    TEST_ASSERT_FALSE(port.armed);
+    TEST_ASSERT_EQUAL(DMX_TX_IDLE, tx.getState());
+
+    // 可以重新启动
+    tx.start(port, port.now);
+    port.run(tx, port.now + 100000);
+    TEST_ASSERT_GREATER_THAN(1, port.trace.size());
+}
+
+// 每帧花在发送上的 CPU：三次定时器回调 + 513 字节写入发送缓冲。
+// 旧实现中 DMX 任务在 uart_wait_tx_done 上阻塞整个帧长。
+void test_bench_cpu_per_frame() {
+    SimPort port;
+    DmxTxStateMachine tx;
+    writeFrame(port, 0x55);
+    tx.start(port, port.now);
+
+    const uint32_t frames = 2000;
+    uint64_t busyNs = 0;
+    while (tx.getStats().frames < frames) {
+        port.now = port.timerAt;
+        port.armed = false;
+        uint64_t start = benchNowNs();
+        tx.onTimer(port, port.now);
+        busyNs += benchNowNs() - start;
+    }
+
+    double nsPerFrame = (double)busyNs / frames;
+    double frameUs = tx.getStats().lastPeriodUs;
+    printf("[bench] DMX TX state machine: %.0f ns CPU per frame (%u wakeups/frame)\n",
+           nsPerFrame, 3u);
+    printf("[bench]   frame period %.0f us -> %.1f Hz, CPU share %.4f%% per port\n",
+           frameUs, 1e6 / frameUs, nsPerFrame / (frameUs * 1000.0) * 100.0);
+    printf("[bench]   legacy blocking update(): task blocked %.0f us per port per frame\n", frameUs);
+}
+
+static void startHardware(SimPort& port, DmxTxStateMachine& tx) {
+    tx.setHardwareBreak(true);
+    port.idleBits = tx.getMabBits();
+    tx.start(port, port.now);
+}
+
+void test_hardware_break_frame_period() {
+    SimPort port;
+    DmxTxStateMachine tx;
+    startHardware(port, tx);
+    port.run(tx, port.now + 1000000);
+
+    const std::vector<LineEvent>& trace = port.trace;
+    TEST_ASSERT_GREATER_THAN(40, trace.size());
+    for (size_t i = 0; i + 1 < trace.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(176, trace[i].mabUs - trace[i].breakUs);
+        TEST_ASSERT_EQUAL_UINT32(12, trace[i].dataUs - trace[i].mabUs);
+        TEST_ASSERT_EQUAL_UINT32(513 * DMX_TX_BYTE_US, trace[i].endUs - trace[i].dataUs);
+        if (i > 0) {
+            // Break 紧跟上一帧的最后一个停止位，周期没有任何空隙
+            TEST_ASSERT_EQUAL_UINT32(trace[i - 1].endUs, trace[i].breakUs);
+            TEST_ASSERT_EQUAL_UINT32(tx.frameTimeUs(513), trace[i].breakUs - trace[i - 1].breakUs);
+        }
+    }
+
+    // 除第一帧外每帧只唤醒一次；第一帧多了软件 Break + MAB
+    const DmxTxStats& stats = tx.getStats();
+    TEST_ASSERT_EQUAL_UINT32(stats.frames + 2, port.wakeups);
+    TEST_ASSERT_EQUAL_UINT32(tx.frameTimeUs(513), stats.minPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(tx.frameTimeUs(513), stats.lastPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.busyRetries);
+}
+
+void test_hardware_break_configurable_per_port() {
+    SimPort portA;
+    SimPort portB;
+    DmxTxStateMachine txA;
+    DmxTxStateMachine txB;
+    txA.setTiming(100, 20);
+    txB.setTiming(101, 8);      // 向上取整到 104 us；MAB 提高到下限 12 us
+    // 帧比 44 Hz 周期短时，多出的空闲会加到 MAB 上；这里按帧长背靠背发送
+    txA.setRefreshRate(100);
+    txB.setRefreshRate(100);
+    startHardware(portA, txA);
+    startHardware(portB, txB);
+    portA.run(txA, portA.now + 200000);
+    portB.run(txB, portB.now + 200000);
+
+    TEST_ASSERT_EQUAL_UINT32(25, txA.getBreakBits());
+    TEST_ASSERT_EQUAL_UINT32(5, txA.getMabBits());
+    TEST_ASSERT_EQUAL_UINT32(26, txB.getBreakBits());
+    TEST_ASSERT_EQUAL_UINT32(3, txB.getMabBits());
+
+    const LineEvent& a = portA.trace[3];
+    TEST_ASSERT_EQUAL_UINT32(100, a.mabUs - a.breakUs);
+    TEST_ASSERT_EQUAL_UINT32(20, a.dataUs - a.mabUs);
+    const LineEvent& b = portB.trace[3];
+    TEST_ASSERT_EQUAL_UINT32(104, b.mabUs - b.breakUs);
+    TEST_ASSERT_EQUAL_UINT32(12, b.dataUs - b.mabUs);
+
+    TEST_ASSERT_EQUAL_UINT32(100 + 20 + 513 * DMX_TX_BYTE_US, txA.getStats().lastPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(104 + 12 + 513 * DMX_TX_BYTE_US, txB.getStats().lastPeriodUs);
+}
+
+void test_hardware_break_ignores_timer_latency() {
+    SimPort port;
+    DmxTxStateMachine tx;
+    port.timerLatencyUs = 40;
+    startHardware(port, tx);
+    port.run(tx, port.now + 1000000);
+
+    // Break / MAB 由 UART 按位时间生成，回调晚到只影响帧间空闲
+    for (size_t i = 1; i + 1 < port.trace.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(176, port.trace[i].mabUs - port.trace[i].breakUs);
+        TEST_ASSERT_TRUE(port.trace[i].dataUs - port.trace[i].mabUs >= 12);
+    }
+}
+
+// 旧实现：把波特率改为 1e6 / breakUs 发一个 0 字节当 Break。
+// 一个字节是 1 起始位 + 8 数据位（低电平）+ 2 停止位（高电平），每位 breakUs，
+// 再加上 sendMAB() 的 12 us 延时
+static uint32_t legacyFrameUs(uint16_t bytes) {
+    const uint32_t breakBitUs = 176;
+    return 9 * breakBitUs + 2 * breakBitUs + 12 + bytes * DMX_TX_BYTE_US;
+}
+
+void test_timing_model_max_refresh_rate() {
+    DmxTxStateMachine tx;
+    tx.setHardwareBreak(true);
+
+    // 旧实现的 Break 实际有 1584 us，远超设定的 176 us
+    TEST_ASSERT_EQUAL_UINT32(24520, legacyFrameUs(513));
+    TEST_ASSERT_EQUAL_UINT32(22760, tx.frameTimeUs(513));
+
+    const uint16_t sizes[] = {513, 257, 129, 25};
+    for (uint8_t i = 0; i < sizeof(sizes) / sizeof(sizes[0]); i++) {
+        uint32_t legacy = legacyFrameUs(sizes[i]);
+        uint32_t hardware = tx.frameTimeUs(sizes[i]);
+        TEST_ASSERT_TRUE(hardware < legacy);
+        printf("[bench] %3u slots: baud-switch break %6u us (%6.1f Hz)  hardware break %6u us (%6.1f Hz)\n",
+               sizes[i] - 1, legacy, 1e6 / legacy, hardware, 1e6 / hardware);
+    }
+}
+
+// 多个端口共用一个定时器任务（esp_timer 任务按到期顺序串行执行回调），
+// 每次回调占用 callbackUs；到期时任务正忙则顺延，记为一次冲突
+struct MultiPortSim {
+    SimPort* ports[DMX_PORT_COUNT_SIM];
+    DmxTxStateMachine* tx[DMX_PORT_COUNT_SIM];
+    uint8_t count;
+    uint32_t callbackUs;
+    uint32_t busyUntil;
+    int8_t busyPort;
+    uint32_t collisions;        // 被其他端口的回调推迟的次数
+
+    MultiPortSim(uint32_t cost) : count(0), callbackUs(cost), busyUntil(0), busyPort(-1), collisions(0) {}
+
+    void add(SimPort& port, DmxTxStateMachine& machine) {
+        ports[count] = &port;
+        tx[count] = &machine;
+        count++;
+    }
+
+    void run(uint32_t endUs) {
+        for (;;) {
+            int8_t next = -1;
+            for (uint8_t i = 0; i < count; i++) {
+                if (!ports[i]->armed) continue;
+                if (next < 0 || (int32_t)(ports[i]->timerAt - ports[next]->timerAt) < 0) next = i;
+            }
+            if (next < 0 || (int32_t)(endUs - ports[next]->timerAt) < 0) break;
+
+            SimPort& port = *ports[next];
+            uint32_t at = port.timerAt;
+            if ((int32_t)(busyUntil - at) > 0) {
+                at = busyUntil;
+                if (busyPort != next) collisions++;
+            }
+            port.now = at;
+            port.armed = false;
+            port.wakeups++;
+            tx[next]->onTimer(port, at);
+            busyUntil = at + callbackUs;
+            busyPort = next;
+        }
+    }
+};
+
+// 从第二帧起统计（硬件 Break 模式的第一帧用软件 Break）
+static double achievedHz(const SimPort& port) {
+    const std::vector<LineEvent>& trace = port.trace;
+    return (trace.size() - 2) * 1e6 / (trace.back().breakUs - trace[1].breakUs);
+}
+
+void test_ports_refresh_in_parallel() {
+    SimPort portA;
+    SimPort portB;
+    DmxTxStateMachine txA;
+    DmxTxStateMachine txB;
+    txB.setPhaseOffset(1000000 / DMX_TX_DEFAULT_REFRESH_HZ / 2);
+    startHardware(portA, txA);
+    startHardware(portB, txB);
+
+    MultiPortSim sim(20);
+    sim.add(portA, txA);
+    sim.add(portB, txB);
+    sim.run(portA.now + 2000000);
+
+    // 两个端口同时达到单端口的满速刷新
+    double fullSpeed = 1e6 / txA.frameTimeUs(513);
+    double legacy = 1e6 / (2.0 * legacyFrameUs(513));
+    TEST_ASSERT_FLOAT_WITHIN(0.1, fullSpeed, achievedHz(portA));
+    TEST_ASSERT_FLOAT_WITHIN(0.1, fullSpeed, achievedHz(portB));
+    TEST_ASSERT_EQUAL_UINT32(0, sim.collisions);
+    printf("[bench] 2 ports: %.1f Hz + %.1f Hz in parallel, serial blocking update(): %.1f Hz each\n",
+           achievedHz(portA), achievedHz(portB), legacy);
+}
+
+void test_phase_offset_avoids_callback_collisions() {
+    // 软件 Break：每帧三次回调，两个端口同相位时回调互相推迟，Break 被拉长
+    SimPort portA;
+    SimPort portB;
+    DmxTxStateMachine txA;
+    DmxTxStateMachine txB;
+    txA.setRefreshRate(40);
+    txB.setRefreshRate(40);
+    txA.start(portA, portA.now);
+    txB.start(portB, portB.now);
+    MultiPortSim inPhase(30);
+    inPhase.add(portA, txA);
+    inPhase.add(portB, txB);
+    inPhase.run(portA.now + 1000000);
+    TEST_ASSERT_GREATER_THAN(0, inPhase.collisions);
+
+    // 错开半个周期后互不干扰，两个端口的 Break / MAB 都精确
+    SimPort portC;
+    SimPort portD;
+    DmxTxStateMachine txC;
+    DmxTxStateMachine txD;
+    txC.setRefreshRate(40);
+    txD.setRefreshRate(40);
+    txD.setPhaseOffset(12500);
+    txC.start(portC, portC.now);
+    txD.start(portD, portD.now);
+    MultiPortSim offset(30);
+    offset.add(portC, txC);
+    offset.add(portD, txD);
+    offset.run(portC.now + 1000000);
+    TEST_ASSERT_EQUAL_UINT32(0, offset.collisions);
+    TEST_ASSERT_EQUAL_UINT32(12500, portD.trace[0].breakUs - portC.trace[0].breakUs);
+    for (size_t i = 0; i < portD.trace.size() - 1; i++) {
+        TEST_ASSERT_EQUAL_UINT32(176, portC.trace[i].mabUs - portC.trace[i].breakUs);
+        TEST_ASSERT_EQUAL_UINT32(176, portD.trace[i].mabUs - portD.trace[i].breakUs);
+    }
+}
+
+void test_per_port_refresh_rate() {
+    SimPort portA;
+    SimPort portB;
+    DmxTxStateMachine txA;
+    DmxTxStateMachine txB;
+    txA.setRefreshRate(30);
+    txB.setRefreshRate(25);
+    txB.setPhaseOffset(5000);
+    startHardware(portA, txA);
+    startHardware(portB, txB);
+    MultiPortSim sim(20);
+    sim.add(portA, txA);
+    sim.add(portB, txB);
+    sim.run(portA.now + 2000000);
+
+    TEST_ASSERT_FLOAT_WITHIN(0.05, 30.0, achievedHz(portA));
+    TEST_ASSERT_FLOAT_WITHIN(0.05, 25.0, achievedHz(portB));
+}
+
+static void writeSlots(SimPort& port, uint16_t start, uint16_t count) {
+    uint8_t slots[DMX_SLOT_COUNT];
+    memset(slots, 0x7F, sizeof(slots));
+    port.frames.writeSlots(slots, count, start);
+    port.frames.commit();
+}
+
+void test_active_slots_follow_highest_received() {
+    DmxFrameBuffer frames;
+    uint8_t slots[DMX_SLOT_COUNT] = {0};
+
+    // 还没有数据时按最少通道数发送
+    TEST_ASSERT_EQUAL_UINT16(24, frames.front().activeSlots(24));
+
+    frames.writeSlots(slots, 64);
+    frames.commit();
+    frames.acquire();
+    TEST_ASSERT_EQUAL_UINT16(64, frames.front().activeSlots(24));
+
+    // 后续较短的包不会截掉已经收到过的通道
+    frames.writeSlots(slots, 10);
+    frames.commit();
+    frames.acquire();
+    TEST_ASSERT_EQUAL_UINT16(64, frames.front().activeSlots(24));
+
+    // 从中间开始写入的包按结束通道计
+    frames.writeSlots(slots, 5, 100);
+    frames.commit();
+    frames.acquire();
+    TEST_ASSERT_EQUAL_UINT16(105, frames.front().activeSlots(24));
+    TEST_ASSERT_EQUAL_UINT16(DMX_SLOT_COUNT, frames.front().activeSlots(DMX_SLOT_COUNT));
+
+    // 不足最少通道数时补足
+    DmxFrameBuffer shortFrames;
+    shortFrames.writeSlots(slots, 10);
+    shortFrames.commit();
+    shortFrames.acquire();
+    TEST_ASSERT_EQUAL_UINT16(24, shortFrames.front().activeSlots(24));
+}
+
+void test_short_universe_refreshes_faster() {
+    SimPort port;
+    DmxTxStateMachine tx;
+    port.minSlots = 24;
+    tx.setRefreshRate(0);
+    writeSlots(port, 0, 64);
+    startHardware(port, tx);
+    port.run(tx, port.now + 1000000);
+
+    // 64 通道：176 + 12 + 65 * 44 = 3048 us，约 328 Hz
+    const uint32_t frameUs = 176 + 12 + 65 * DMX_TX_BYTE_US;
+    TEST_ASSERT_EQUAL_UINT32(frameUs, tx.getStats().lastPeriodUs);
+    TEST_ASSERT_EQUAL_UINT16(65, tx.getStats().lastBytes);
+    TEST_ASSERT_FLOAT_WITHIN(0.5, 1e6 / frameUs, achievedHz(port));
+    TEST_ASSERT_FLOAT_WITHIN(0.01, (float)tx.frameTimeUs(513) / frameUs, tx.refreshGain());
+    for (size_t i = 1; i + 1 < port.trace.size(); i++) {
+        TEST_ASSERT_EQUAL_UINT32(65 * DMX_TX_BYTE_US, port.trace[i].endUs - port.trace[i].dataUs);
+    }
+
+    // 收到整帧后帧长随之变长
+    writeSlots(port, 0, DMX_SLOT_COUNT);
+    port.run(tx, port.now + 100000);
+    TEST_ASSERT_EQUAL_UINT16(513, tx.getStats().lastBytes);
+    TEST_ASSERT_FLOAT_WITHIN(0.01, 1.0, tx.refreshGain());
+
+    printf("[bench] 64-slot universe: %.1f Hz vs %.1f Hz at 512 slots (gain %.2fx)\n",
+           1e6 / frameUs, 1e6 / tx.frameTimeUs(513), (float)tx.frameTimeUs(513) / frameUs);
+}
+
+void test_minimum_break_to_break_time() {
+    // 只有 1 个通道、最短 Break 时帧长只有 192 us，仍按 DMX512-A 的 1204 us 间隔发送
+    SimPort port;
+    DmxTxStateMachine tx;
+    port.minSlots = 1;
+    tx.setTiming(92, 12);
+    tx.setRefreshRate(0);
+    startHardware(port, tx);
+    port.run(tx, port.now + 100000);
+
+    TEST_ASSERT_EQUAL_UINT32(DmxTxStateMachine::MIN_FRAME_US, tx.getStats().minPeriodUs);
+    TEST_ASSERT_EQUAL_UINT32(DmxTxStateMachine::MIN_FRAME_US, tx.getStats().maxPeriodUs);
+    TEST_ASSERT_FLOAT_WITHIN(1.0, 1e6 / DmxTxStateMachine::MIN_FRAME_US, tx.maxRefreshHz());
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_break_mab_and_slot_timing);
+    RUN_TEST(test_lower_refresh_rate_is_exact);
+    RUN_TEST(test_repeats_last_frame_until_new_one);
+    RUN_TEST(test_waits_for_uart_to_finish);
+    RUN_TEST(test_timer_latency_does_not_drift);
+    RUN_TEST(test_stop_releases_line);
+    RUN_TEST(test_bench_cpu_per_frame);
+    RUN_TEST(test_hardware_break_frame_period);
+    RUN_TEST(test_hardware_break_configurable_per_port);
+    RUN_TEST(test_hardware_break_ignores_timer_latency);
+    RUN_TEST(test_timing_model_max_refresh_rate);
+    RUN_TEST(test_ports_refresh_in_parallel);
+    RUN_TEST(test_phase_offset_avoids_callback_collisions);
+    RUN_TEST(test_per_port_refresh_rate);
+    RUN_TEST(test_active_slots_follow_highest_received);
+    RUN_TEST(test_short_universe_refreshes_faster);
+    RUN_TEST(test_minimum_break_to_break_time);
+    return UNITY_END();
+}
@@ -0,0 +1,387 @@
+#include <unity.h>
+#include <string.h>
+#include "artnet/UniverseRouter.h"
+#include "artnet/MergeEngine.h"
+#include "sacn/E131Packet.h"
+#include "sacn/E131RxFilter.h"
+#include "sacn/E131Arbiter.h"
+#include "../bench.h"
+
+// 按 E1.31-2018 逐字节构造的数据包 / 同步包，与控台抓包的布局一致
+
+static const uint8_t CID_A[16] = {
+    0x5a, 0x1e, 0x0d, 0x72, 0x3c, 0x44, 0x4b, 0x0c, 0x9a, 0x01, 0x6e, 0x52, 0x11, 0x8f, 0x20, 0xa1
+};
+static const uint8_t CID_B[16] = {
+    0xc3, 0x07, 0x91, 0x4e, 0x28, 0xb5, 0x4f, 0x60, 0x83, 0x2d, 0x19, 0xe4, 0x7a, 0x05, 0xd2, 0x3b
+};
+
+static uint8_t packet[E131_MAX_PACKET_SIZE];
+static UniverseRouter router;
+
+static void put16(uint8_t* p, uint16_t value) {
+    p[0] = value >> 8;
+    p[1] = value & 0xFF;
+}
+
+static void put32(uint8_t* p, uint32_t value) {
+    put16(p, value >> 16);
+    put16(p + 2, value & 0xFFFF);
+}
+
+// Flags & Length：高 4 位 0x7，低 12 位为本层及之后的长度
+static void putFlagsLength(uint8_t* p, uint16_t length) {
+    put16(p, 0x7000 | length);
+}
+
+static uint16_t buildData(uint8_t* p, const uint8_t* cid, uint16_t universe, uint8_t priority,
+                          uint8_t sequence, uint8_t options, uint16_t slots, uint16_t syncAddress = 0) {
+    uint16_t size = E131_DATA_HEADER_SIZE + slots;
+    memset(p, 0, size);
+    memcpy(p, E131Packet::ROOT_PREAMBLE, sizeof(E131Packet::ROOT_PREAMBLE));
+    putFlagsLength(p + 16, size - 16);
+    put32(p + E131_ROOT_VECTOR, VECTOR_ROOT_E131_DATA);
+    memcpy(p + E131_CID, cid, 16);
+
+    putFlagsLength(p + 38, size - 38);
+    put32(p + E131_FRAMING_VECTOR, VECTOR_E131_DATA_PACKET);
+    strcpy((char*)p + E131_SOURCE_NAME, "Console");
+    p[E131_PRIORITY] = priority;
+    put16(p + E131_SYNC_ADDRESS, syncAddress);
+    p[E131_SEQUENCE] = sequence;
+    p[E131_OPTIONS] = options;
+    put16(p + E131_UNIVERSE, universe);
+
+    putFlagsLength(p + 115, size - 115);
+    p[E131_DMP_VECTOR] = VECTOR_DMP_SET_PROPERTY;
+    p[E131_ADDRESS_TYPE] = 0xA1;
+    put16(p + 121, 1);                              // Address Increment
+    put16(p + E131_PROPERTY_COUNT, slots + 1);
+    p[E131_START_CODE] = 0x00;
+    for (uint16_t i = 0; i < slots; i++) {
+        p[E131_DATA_HEADER_SIZE + i] = (uint8_t)(universe + i);
+    }
+    return size;
+}
+
+static uint16_t buildSync(uint8_t* p, const uint8_t* cid, uint16_t syncAddress, uint8_t sequence) {
+    memset(p, 0, E131_SYNC_PACKET_SIZE);
+    memcpy(p, E131Packet::ROOT_PREAMBLE, sizeof(E131Packet::ROOT_PREAMBLE));
+    putFlagsLength(p + 16, E131_SYNC_PACKET_SIZE - 16);
+    put32(p + E131_ROOT_VECTOR, VECTOR_ROOT_E131_EXTENDED);
+    memcpy(p + E131_CID, cid, 16);
+    putFlagsLength(p + 38, E131_SYNC_PACKET_SIZE - 38);
+    put32(p + E131_FRAMING_VECTOR, VECTOR_E131_EXTENDED_SYNCHRONIZATION);
+    p[E131_SYNC_SEQUENCE] = sequence;
+    put16(p + E131_SYNC_UNIVERSE, syncAddress);
+    return E131_SYNC_PACKET_SIZE;
+}
+
+void setUp() {
+    router.clear();
+    router.addRoute(0, OUTPUT_DMX, 0);       // sACN 宇宙 1
+    router.addRoute(1, OUTPUT_DMX, 1);       // sACN 宇宙 2
+    router.addRoute(0x10, OUTPUT_PIXEL, 0);  // sACN 宇宙 17
+}
+
+void tearDown() {
+}
+
+void test_parse_data_packet() {
+    uint16_t size = buildData(packet, CID_A, 17, 150, 42, E131_OPT_FORCE_SYNC, 512, 7);
+    TEST_ASSERT_EQUAL(E131_DATA, E131Packet::classify(packet, size));
+
+    E131DataPacket data;
+    TEST_ASSERT_TRUE(E131Packet::parseData(packet, size, data));
+    TEST_ASSERT_EQUAL_MEMORY(CID_A, data.cid, 16);
+    TEST_ASSERT_EQUAL_UINT8(150, data.priority);
+    TEST_ASSERT_EQUAL_UINT16(7, data.syncAddress);
+    TEST_ASSERT_EQUAL_UINT8(42, data.sequence);
+    TEST_ASSERT_EQUAL_UINT8(E131_OPT_FORCE_SYNC, data.options);
+    TEST_ASSERT_EQUAL_UINT16(17, data.universe);
+    TEST_ASSERT_EQUAL_UINT8(0, data.startCode);
+    TEST_ASSERT_EQUAL_UINT16(512, data.length);
+    TEST_ASSERT_EQUAL_PTR(packet + E131_DATA_HEADER_SIZE, data.data);
+
+    uint16_t portAddress;
+    TEST_ASSERT_TRUE(E131Packet::universeToPortAddress(data.universe, portAddress));
+    TEST_ASSERT_EQUAL_UINT16(0x10, portAddress);
+    TEST_ASSERT_EQUAL_UINT16(17, E131Packet::portAddressToUniverse(portAddress));
+}
+
+void test_parse_short_and_invalid_packets() {
+    E131DataPacket data;
+
+    // 通道数少于 512
+    uint16_t size = buildData(packet, CID_A, 1, 100, 0, 0, 24);
+    TEST_ASSERT_TRUE(E131Packet::parseData(packet, size, data));
+    TEST_ASSERT_EQUAL_UINT16(24, data.length);
+
+    // Property Count 声称的长度超过实际数据报时按数据报截断
+    TEST_ASSERT_TRUE(E131Packet::parseData(packet, size - 4, data));
+    TEST_ASSERT_EQUAL_UINT16(20, data.length);
+
+    // 宇宙 0 和超过 200 的优先级都不合法
+    size = buildData(packet, CID_A, 0, 100, 0, 0, 24);
+    TEST_ASSERT_FALSE(E131Packet::parseData(packet, size, data));
+    size = buildData(packet, CID_A, 1, 201, 0, 0, 24);
+    TEST_ASSERT_FALSE(E131Packet::parseData(packet, size, data));
+
+    // 包标识错误、向量错误
+    size = buildData(packet, CID_A, 1, 100, 0, 0, 24);
+    packet[4] = 'X';
+    TEST_ASSERT_EQUAL(E131_INVALID, E131Packet::classify(packet, size));
+    size = buildData(packet, CID_A, 1, 100, 0, 0, 24);
+    put32(packet + E131_FRAMING_VECTOR, 0x00000003);
+    TEST_ASSERT_EQUAL(E131_INVALID, E131Packet::classify(packet, size));
+
+    // 包头不完整
+    size = buildData(packet, CID_A, 1, 100, 0, 0, 0);
+    TEST_ASSERT_EQUAL(E131_INVALID, E131Packet::classify(packet, E131_DATA_HEADER_SIZE - 1));
+}
+
+void test_parse_sync_packet() {
+    uint16_t size = buildSync(packet, CID_B, 7, 200);
+    TEST_ASSERT_EQUAL(E131_SYNC, E131Packet::classify(packet, size));
+
+    E131SyncPacket sync;
+    TEST_ASSERT_TRUE(E131Packet::parseSync(packet, size, sync));
+    TEST_ASSERT_EQUAL_MEMORY(CID_B, sync.cid, 16);
+    TEST_ASSERT_EQUAL_UINT8(200, sync.sequence);
+    TEST_ASSERT_EQUAL_UINT16(7, sync.syncAddress);
+
+    // 截断的同步包
+    TEST_ASSERT_FALSE(E131Packet::parseSync(packet, size - 1, sync));
+    TEST_ASSERT_FALSE(E131Packet::parseSync(nullptr, size, sync));
+}
+
+void test_multicast_address() {
+    // 239.255.0.1 和 239.255.1.0，网络字节序
+    const uint8_t* bytes;
+    uint32_t address = E131Packet::multicastAddress(1);
+    bytes = (const uint8_t*)&address;
+    TEST_ASSERT_EQUAL_UINT8(239, bytes[0]);
+    TEST_ASSERT_EQUAL_UINT8(255, bytes[1]);
+    TEST_ASSERT_EQUAL_UINT8(0, bytes[2]);
+    TEST_ASSERT_EQUAL_UINT8(1, bytes[3]);
+
+    address = E131Packet::multicastAddress(256);
+    TEST_ASSERT_EQUAL_UINT8(1, bytes[2]);
+    TEST_ASSERT_EQUAL_UINT8(0, bytes[3]);
+}
+
+void test_filter_uses_router_subscriptions() {
+    E131RxFilter filter(router);
+
+    uint16_t size = buildData(packet, CID_A, 2, 100, 0, 0, 512);
+    TEST_ASSERT_TRUE(filter(packet, size));
+    size = buildData(packet, CID_A, 17, 100, 0, 0, 512);
+    TEST_ASSERT_TRUE(filter(packet, size));
+    size = buildData(packet, CID_A, 3, 100, 0, 0, 512);
+    TEST_ASSERT_FALSE(filter(packet, size));
+
+    // 预览数据和非零 Start Code
+    size = buildData(packet, CID_A, 1, 100, 0, E131_OPT_PREVIEW, 512);
+    TEST_ASSERT_FALSE(filter(packet, size));
+    size = buildData(packet, CID_A, 1, 100, 0, 0, 512);
+    packet[E131_START_CODE] = 0xDD;
+    TEST_ASSERT_FALSE(filter(packet, size));
+
+    // 同步包总是保留
+    size = buildSync(packet, CID_A, 9, 0);
+    TEST_ASSERT_TRUE(filter(packet, size));
+}
+
+void test_higher_priority_wins() {
+    E131Arbiter arbiter;
+
+    TEST_ASSERT_EQUAL(E131_ACCEPT, arbiter.process(0, CID_A, 100, 0, 0, 0));
+    TEST_ASSERT_EQUAL(E131_ACCEPT, arbiter.process(0, CID_B, 150, 0, 0, 10));
+    TEST_ASSERT_EQUAL_UINT8(150, arbiter.getActivePriority(0));
+
+    // 低优先级源继续发送，但数据被丢弃
+    TEST_ASSERT_EQUAL(E131_LOWER_PRIORITY, arbiter.process(0, CID_A, 100, 1, 0, 20));
+    TEST_ASSERT_EQUAL(E131_ACCEPT, arbiter.process(0, CID_B, 150, 1, 0, 30));
+    TEST_ASSERT_EQUAL_UINT8(2, arbiter.getSourceCount(0));
+    TEST_ASSERT_EQUAL_UINT32(1, arbiter.getStats(0).lowerPriority);
+
+    // 同为最高优先级时都接受，交给合并引擎
+    TEST_ASSERT_EQUAL(E131_ACCEPT, arbiter.process(1, CID_A, 100, 0, 0, 0));
+    TEST_ASSERT_EQUAL(E131_ACCEPT, arbiter.process(1, CID_B, 100, 0, 0, 0));
+
+    // 其他宇宙互不影响
+    TEST_ASSERT_EQUAL_UINT8(100, arbiter.getActivePriority(1));
+}
+
+void test_lower_priority_takes_over_after_timeout() {
+    E131Arbiter arbiter;
+    arbiter.process(0, CID_B, 150, 0, 0, 0);
+    TEST_ASSERT_EQUAL(E131_LOWER_PRIORITY, arbiter.process(0, CID_A, 100, 0, 0, 100));
+
+    // 高优先级源 2.5 秒没有数据后移除
+    TEST_ASSERT_EQUAL(E131_LOWER_PRIORITY,
+                      arbiter.process(0, CID_A, 100, 1, 0, E131Arbiter::SOURCE_TIMEOUT_MS - 1));
+    TEST_ASSERT_EQUAL(E131_ACCEPT, arbiter.process(0, CID_A, 100, 2, 0, E131Arbiter::SOURCE_TIMEOUT_MS));
+    TEST_ASSERT_EQUAL_UINT8(100, arbiter.getActivePriority(0));
+    TEST_ASSERT_EQUAL_UINT32(1, arbiter.getStats(0).sourceLost);
+}
+
+// 与 ArtnetNode::handleE131Data 相同的顺序：选源，移除落选的源，按 CID 的键进入合并
+static const uint8_t* sacnOutput(E131Arbiter& arbiter, MergeEngine& merger, const uint8_t* cid,
+                                 uint8_t priority, uint8_t sequence, uint8_t options,
+                                 const uint8_t* frame, uint32_t now) {
+    E131ArbiterResult result = arbiter.process(0, cid, priority, sequence, options, now);
+    for (uint8_t source = 0; source < E131Arbiter::MAX_SOURCES; source++) {
+        if (!arbiter.isSelected(0, source)) merger.removeSource(0, E131Arbiter::mergeKey(source));
+    }
+    if (result != E131_ACCEPT) return nullptr;
+    uint16_t length = 512;
+    return merger.process(0, E131Arbiter::mergeKey(arbiter.getLastSource()), frame, length, now);
+}
+
+void test_stream_terminated_releases_universe() {
+    E131Arbiter arbiter;
+    MergeEngine merger;
+    uint8_t frame[512];
+    memset(frame, 0x40, sizeof(frame));
+
+    sacnOutput(arbiter, merger, CID_A, 100, 0, 0, frame, 0);
+    sacnOutput(arbiter, merger, CID_B, 100, 0, 0, frame, 0);
+    TEST_ASSERT_TRUE(merger.isMerging(0));
+
+    // 源 B 结束：立即移除，不等 2.5 秒
+    TEST_ASSERT_NULL(sacnOutput(arbiter, merger, CID_B, 100, 1, E131_OPT_TERMINATED, frame, 10));
+    TEST_ASSERT_EQUAL_UINT32(1, arbiter.getStats(0).terminated);
+    TEST_ASSERT_EQUAL_UINT8(1, arbiter.getSourceCount(0));
+    TEST_ASSERT_EQUAL_UINT8(1, merger.getSourceCount(0));
+    TEST_ASSERT_FALSE(merger.isMerging(0));
+
+    // 剩下的源单独输出
+    TEST_ASSERT_EQUAL_PTR(frame, sacnOutput(arbiter, merger, CID_A, 100, 1, 0, frame, 20));
+}
+
+// 同一台主机上的两个 sACN 源（同一 IP、不同 CID）按两个源合并
+void test_sources_merge_by_cid() {
+    E131Arbiter arbiter;
+    MergeEngine merger;
+    uint8_t frameA[512], frameB[512];
+    memset(frameA, 0x10, sizeof(frameA));
+    memset(frameB, 0x80, sizeof(frameB));
+
+    sacnOutput(arbiter, merger, CID_A, 100, 0, 0, frameA, 0);
+    const uint8_t* out = sacnOutput(arbiter, merger, CID_B, 100, 0, 0, frameB, 1);
+    TEST_ASSERT_TRUE(merger.isMerging(0));
+    TEST_ASSERT_EQUAL_HEX8(0x80, out[0]);
+}
+
+// 更高优先级的源出现后，原来的源退出合并，输出不再混入它的最后一帧
+void test_lower_priority_leaves_merge() {
+    E131Arbiter arbiter;
+    MergeEngine merger;
+    uint8_t frameA[512], frameB[512], frameC[512];
+    memset(frameA, 0xF0, sizeof(frameA));
+    memset(frameB, 0x20, sizeof(frameB));
+    memset(frameC, 0x30, sizeof(frameC));
+    uint8_t cidC[16];
+    memcpy(cidC, CID_A, sizeof(cidC));
+    cidC[15] ^= 0xFF;
+
+    sacnOutput(arbiter, merger, CID_A, 100, 0, 0, frameA, 0);
+    sacnOutput(arbiter, merger, CID_B, 100, 0, 0, frameB, 0);
+    TEST_ASSERT_TRUE(merger.isMerging(0));
+
+    // C 以 150 接管：A、B 立即退出合并，C 的数据原样输出
+    const uint8_t* out = sacnOutput(arbiter, merger, cidC, 150, 0, 0, frameC, 10);
+    TEST_ASSERT_EQUAL_PTR(frameC, out);
+    TEST_ASSERT_EQUAL_UINT8(1, merger.getSourceCount(0));
+    TEST_ASSERT_NULL(sacnOutput(arbiter, merger, CID_A, 100, 1, 0, frameA, 20));
+    TEST_ASSERT_EQUAL_UINT8(1, merger.getSourceCount(0));
+
+    // C 超时后 A 重新进入输出
+    out = sacnOutput(arbiter, merger, CID_A, 100, 2, 0, frameA, 10 + E131Arbiter::SOURCE_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL_PTR(frameA, out);
+    TEST_ASSERT_EQUAL_UINT8(1, merger.getSourceCount(0));
+}
+
+void test_sequence_rule() {
+    E131Arbiter arbiter;
+    TEST_ASSERT_EQUAL(E131_ACCEPT, arbiter.process(0, CID_A, 100, 10, 0, 0));
+
+    // 重复和 20 以内的迟到包丢弃
+    TEST_ASSERT_EQUAL(E131_OUT_OF_SEQUENCE, arbiter.process(0, CID_A, 100, 10, 0, 1));
+    TEST_ASSERT_EQUAL(E131_OUT_OF_SEQUENCE, arbiter.process(0, CID_A, 100, 247, 0, 1));
+    TEST_ASSERT_EQUAL_UINT32(2, arbiter.getStats(0).outOfSequence);
+
+    // 相差 -20 及以外视为源重启
+    TEST_ASSERT_EQUAL(E131_ACCEPT, arbiter.process(0, CID_A, 100, 11, 0, 2));
+    TEST_ASSERT_EQUAL(E131_ACCEPT, arbiter.process(0, CID_A, 100, 247, 0, 3));
+
+    // 序号回绕
+    TEST_ASSERT_EQUAL(E131_ACCEPT, arbiter.process(0, CID_A, 100, 255, 0, 4));
+    TEST_ASSERT_EQUAL(E131_ACCEPT, arbiter.process(0, CID_A, 100, 0, 0, 5));
+}
+
+void test_too_many_sources() {
+    E131Arbiter arbiter;
+    uint8_t cid[16] = {0};
+    for (uint8_t i = 0; i < E131Arbiter::MAX_SOURCES; i++) {
+        cid[0] = i + 1;
+        TEST_ASSERT_EQUAL(E131_ACCEPT, arbiter.process(0, cid, 100, 0, 0, 0));
+    }
+    cid[0] = 0xFF;
+    TEST_ASSERT_EQUAL(E131_TOO_MANY_SOURCES, arbiter.process(0, cid, 100, 0, 0, 0));
+}
+
+// 每个数据包从包头过滤到选源完成的耗时（不含合并和输出）
+void test_bench_packet_parse_cost() {
+    E131Arbiter arbiter;
+    E131RxFilter filter(router);
+    uint16_t size = buildData(packet, CID_A, 1, 100, 0, 0, 512);
+    uint8_t sequence = 0;
+    uint32_t now = 0;
+
+    BenchResult parse = benchRun(200000, [&] {
+        E131DataPacket data;
+        benchKeep(packet);
+        if (E131Packet::classify(packet, size) == E131_DATA && E131Packet::parseData(packet, size, data)) {
+            benchKeep(data.data);
+        }
+    });
+
+    BenchResult full = benchRun(200000, [&] {
+        packet[E131_SEQUENCE] = ++sequence;
+        now++;
+        benchKeep(packet);
+        if (!filter(packet, size)) return;
+        E131DataPacket data;
+        if (!E131Packet::parseData(packet, size, data)) return;
+        uint16_t portAddress;
+        if (!E131Packet::universeToPortAddress(data.universe, portAddress)) return;
+        const UniverseRoute* route = router.lookup(portAddress);
+        if (!route) return;
+        benchKeep((void*)(uintptr_t)arbiter.process(route->slot, data.cid, data.priority,
+                                                    data.sequence, data.options, now));
+    });
+
+    benchReport("E1.31 classify + parse", parse);
+    benchReport("E1.31 filter + parse + lookup + arbiter", full);
+    TEST_ASSERT_EQUAL_UINT32(0, arbiter.getStats(0).outOfSequence);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_parse_data_packet);
+    RUN_TEST(test_parse_short_and_invalid_packets);
+    RUN_TEST(test_parse_sync_packet);
+    RUN_TEST(test_multicast_address);
+    RUN_TEST(test_filter_uses_router_subscriptions);
+    RUN_TEST(test_higher_priority_wins);
+    RUN_TEST(test_lower_priority_takes_over_after_timeout);
+    RUN_TEST(test_stream_terminated_releases_universe);
+    RUN_TEST(test_sources_merge_by_cid);
+    RUN_TEST(test_lower_priority_leaves_merge);
+    RUN_TEST(test_sequence_rule);
+    RUN_TEST(test_too_many_sources);
+    RUN_TEST(test_bench_packet_parse_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,264 @@
+#include <unity.h>
+#include <atomic>
+#include <vector>
+#include "../lwip_sim.h"
+#include "artnet/ArtnetRxQueue.h"
+#include "artnet/UniverseRouter.h"
+#include "dmx/DmxFrameBuffer.h"
+
+#define ARTDMX_SIZE (ART_DMX_HEADER_SIZE + ARTNET_DMX_LENGTH)
+
+static const uint32_t CONSOLE_IP = 0x0A00000A;   // 10.0.0.10
+
+static UniverseRouter router;
+static ArtnetRxQueue* queue;
+
+// 构造 ArtDmx 包
+static uint16_t buildArtDmx(uint8_t* packet, uint16_t portAddress, uint8_t sequence, uint8_t value) {
+    memset(packet, 0, ARTDMX_SIZE);
+    memcpy(packet, ArtnetPacket::ID, 8);
+    packet[8] = OpDmx & 0xFF;
+    packet[9] = OpDmx >> 8;
+    packet[11] = ARTNET_VERSION;
+    packet[12] = sequence;
+    packet[14] = portAddress & 0xFF;
+    packet[15] = portAddress >> 8;
+    packet[16] = ARTNET_DMX_LENGTH >> 8;
+    packet[17] = ARTNET_DMX_LENGTH & 0xFF;
+    for (uint16_t i = 0; i < ARTNET_DMX_LENGTH; i++) {
+        packet[ART_DMX_HEADER_SIZE + i] = (uint8_t)(value + i);
+    }
+    return ARTDMX_SIZE;
+}
+
+static uint16_t buildOp(uint8_t* packet, uint16_t opcode) {
+    memset(packet, 0, 14);
+    memcpy(packet, ArtnetPacket::ID, 8);
+    packet[8] = opcode & 0xFF;
+    packet[9] = opcode >> 8;
+    packet[11] = ARTNET_VERSION;
+    return 14;
+}
+
+static bool offer(const uint8_t* data, uint16_t length, uint16_t segment = 256) {
+    PbufChain chain(data, length, segment);
+    return queue->offerPbuf(chain.head(), CONSOLE_IP, ARTNET_PORT, 0, router);
+}
+
+void setUp() {
+    router.clear();
+    router.addRoute(0x0000, OUTPUT_DMX, 0);
+    router.addRoute(0x0001, OUTPUT_DMX, 1);
+    queue = new ArtnetRxQueue();
+}
+
+void tearDown() {
+    delete queue;
+}
+
+void test_header_filter_keeps_only_wanted_packets() {
+    uint8_t packet[ARTDMX_SIZE];
+
+    TEST_ASSERT_TRUE(offer(packet, buildArtDmx(packet, 0x0001, 1, 0)));
+    TEST_ASSERT_FALSE(offer(packet, buildArtDmx(packet, 0x0005, 1, 0)));   // 未订阅
+    TEST_ASSERT_TRUE(offer(packet, buildOp(packet, OpPoll)));
+    TEST_ASSERT_TRUE(offer(packet, buildOp(packet, OpSync)));
+    TEST_ASSERT_FALSE(offer(packet, buildOp(packet, OpNzs)));
+
+    buildOp(packet, OpPoll);
+    packet[0] = 'X';
+    TEST_ASSERT_FALSE(offer(packet, 14));                                   // 不是 Art-Net
+
+    const ArtnetRxStats& stats = queue->getStats();
+    TEST_ASSERT_EQUAL_UINT32(6, stats.received);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.filtered);
+    TEST_ASSERT_EQUAL_UINT32(3, stats.queued);
+}
+
+void test_chained_pbuf_is_copied_intact() {
+    uint8_t packet[ARTDMX_SIZE];
+    uint16_t length = buildArtDmx(packet, 0x0000, 7, 0x40);
+
+    // 包头跨越两段 pbuf
+    TEST_ASSERT_TRUE(offer(packet, length, 10));
+
+    ArtnetRxPacket* received = queue->front();
+    TEST_ASSERT_NOT_NULL(received);
+    TEST_ASSERT_EQUAL_UINT16(length, received->length);
+    TEST_ASSERT_EQUAL_UINT32(CONSOLE_IP, received->sourceIp);
+    TEST_ASSERT_EQUAL_MEMORY(packet, received->data, length);
+    queue->pop();
+    TEST_ASSERT_NULL(queue->front());
+}
+
+void test_full_queue_counts_overflow() {
+    uint8_t packet[ARTDMX_SIZE];
+    uint16_t length = buildArtDmx(packet, 0x0000, 1, 0);
+
+    for (uint32_t i = 0; i < ArtnetRxQueue::CAPACITY; i++) {
+        TEST_ASSERT_TRUE(offer(packet, length));
+    }
+    TEST_ASSERT_FALSE(offer(packet, length));
+    TEST_ASSERT_EQUAL_UINT32(1, queue->getStats().overflow);
+
+    // 消费一个后又能入队
+    queue->pop();
+    TEST_ASSERT_TRUE(offer(packet, length));
+}
+
+// ---- 端到端：数据报到达 -> DMX 帧发布 ----
+
+static const int UNIVERSES = 8;
+static const int BURSTS = 20;
+static const uint32_t FRAME_INTERVAL_MS = 23;   // 约 44 Hz
+
+struct LatencyLog {
+    std::vector<uint32_t> samples;
+    void add(uint32_t us) { samples.push_back(us); }
+    double meanUs() const {
+        uint64_t total = 0;
+        for (uint32_t v : samples) total += v;
+        return samples.empty() ? 0 : (double)total / samples.size();
+    }
+    uint32_t maxUs() const {
+        uint32_t m = 0;
+        for (uint32_t v : samples) if (v > m) m = v;
+        return m;
+    }
+};
+
+static UniverseRouter burstRouter;
+static DmxFrameBuffer outputs[UNIVERSES];
+
+// 网络任务对一个 ArtDmx 的处理：查表、写帧、发布
+static void publish(const uint8_t* data, uint16_t length, uint32_t arrivalUs, LatencyLog& log) {
+    ArtDmxPacket packet;
+    if (!ArtnetPacket::parseArtDmx(data, length, packet)) return;
+    const UniverseRoute* route = burstRouter.lookup(packet.portAddress);
+    if (!route) return;
+    outputs[route->index].writeSlots(packet.data, packet.length);
+    outputs[route->index].commit();
+    log.add(lwipSimNowUs() - arrivalUs);
+}
+
+static void injectBursts(LwipSim& lwip) {
+    uint8_t packet[ARTDMX_SIZE];
+    for (int burst = 0; burst < BURSTS; burst++) {
+        for (int u = 0; u < UNIVERSES; u++) {
+            uint16_t length = buildArtDmx(packet, u, burst + 1, burst);
+            lwip.inject(packet, length, CONSOLE_IP, ARTNET_PORT);
+        }
+        // 同一网段上其他节点的宇宙：事件模式在回调里就被过滤
+        for (int u = 0; u < 4; u++) {
+            uint16_t length = buildArtDmx(packet, 0x0100 + u, burst + 1, burst);
+            lwip.inject(packet, length, CONSOLE_IP, ARTNET_PORT);
+        }
+        std::this_thread::sleep_for(std::chrono::milliseconds(FRAME_INTERVAL_MS));
+    }
+}
+
+// 事件模式：回调过滤入队，任务通知唤醒，一次处理完队列
+struct EventMode {
+    ArtnetRxQueue queue;
+    TaskNotifySim notify;
+};
+
+static void eventRecv(void* arg, const pbuf* p, uint32_t ip, uint16_t port) {
+    EventMode* mode = (EventMode*)arg;
+    if (mode->queue.offerPbuf(p, ip, port, lwipSimNowUs(), burstRouter)) {
+        mode->notify.give();
+    }
+}
+
+// 轮询模式：所有数据报都进入 socket 缓冲，任务每 1 ms 读一个
+struct PollMode {
+    std::mutex mutex;
+    std::deque<std::pair<std::vector<uint8_t>, uint32_t> > socket;
+};
+
+static void pollRecv(void* arg, const pbuf* p, uint32_t ip, uint16_t port) {
+    PollMode* mode = (PollMode*)arg;
+    std::vector<uint8_t> bytes(p->tot_len);
+    pbuf_copy_partial(p, bytes.data(), p->tot_len, 0);
+    std::lock_guard<std::mutex> lock(mode->mutex);
+    mode->socket.push_back(std::make_pair(std::move(bytes), lwipSimNowUs()));
+}
+
+void test_event_driven_receive_latency() {
+    burstRouter.clear();
+    for (int u = 0; u < UNIVERSES; u++) burstRouter.addRoute(u, OUTPUT_DMX, u);
+
+    // 事件模式
+    LatencyLog eventLog;
+    EventMode* event = new EventMode();
+    {
+        std::atomic<bool> done(false);
+        LwipSim lwip(eventRecv, event);
+        std::thread task([&] {
+            while (!done.load() || !event->queue.empty()) {
+                event->notify.take(10);
+                ArtnetRxPacket* packet;
+                while ((packet = event->queue.front()) != nullptr) {
+                    publish(packet->data, packet->length, packet->arrivalUs, eventLog);
+                    event->queue.pop();
+                }
+            }
+        });
+        injectBursts(lwip);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        done.store(true);
+        event->notify.give();
+        task.join();
+    }
+
+    // 轮询模式（原实现）
+    LatencyLog pollLog;
+    PollMode poll;
+    {
+        std::atomic<bool> done(false);
+        LwipSim lwip(pollRecv, &poll);
+        std::thread task([&] {
+            for (;;) {
+                std::pair<std::vector<uint8_t>, uint32_t> datagram;
+                {
+                    std::lock_guard<std::mutex> lock(poll.mutex);
+                    if (!poll.socket.empty()) {
+                        datagram = std::move(poll.socket.front());
+                        poll.socket.pop_front();
+                    } else if (done.load()) {
+                        break;
+                    }
+                }
+                if (!datagram.first.empty()) {
+                    publish(datagram.first.data(), (uint16_t)datagram.first.size(), datagram.second, pollLog);
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            }
+        });
+        injectBursts(lwip);
+        std::this_thread::sleep_for(std::chrono::milliseconds(50));
+        done.store(true);
+        task.join();
+    }
+
+    // 两种模式都必须交付全部订阅的宇宙，事件模式不把无关宇宙排进队列
+    TEST_ASSERT_EQUAL_UINT32(UNIVERSES * BURSTS, eventLog.samples.size());
+    TEST_ASSERT_EQUAL_UINT32(UNIVERSES * BURSTS, pollLog.samples.size());
+    TEST_ASSERT_EQUAL_UINT32(4 * BURSTS, event->queue.getStats().filtered);
+
+    printf("[bench] arrival -> publish, %d universes x %d bursts\n", UNIVERSES, BURSTS);
+    printf("[bench]   event (udp_recv + notify)   mean %8.1f us  max %6u us  overflow %u\n",
+           eventLog.meanUs(), eventLog.maxUs(), event->queue.getStats().overflow);
+    printf("[bench]   poll  (1 packet / 1 ms)     mean %8.1f us  max %6u us\n",
+           pollLog.meanUs(), pollLog.maxUs());
+    delete event;
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_header_filter_keeps_only_wanted_packets);
+    RUN_TEST(test_chained_pbuf_is_copied_intact);
+    RUN_TEST(test_full_queue_counts_overflow);
+    RUN_TEST(test_event_driven_receive_latency);
+    return UNITY_END();
+}
@@ -0,0 +1,216 @@
+#include <unity.h>
+#include <string.h>
+#include <stdlib.h>
+#include "artnet/MergeEngine.h"
+#include "../bench.h"
+
+static const uint32_t CONSOLE_A = 0x0A000001;
+static const uint32_t CONSOLE_B = 0x0A000002;
+static const uint32_t CONSOLE_C = 0x0A000003;
+
+static MergeEngine merger;
+static uint8_t frameA[MergeEngine::FRAME_SIZE];
+static uint8_t frameB[MergeEngine::FRAME_SIZE];
+
+// 逐字节参考实现。ESP32 没有 SIMD，关闭自动向量化使主机上的对比更接近目标平台
+__attribute__((optimize("no-tree-vectorize")))
+static void scalarHtp(uint8_t* out, const uint8_t* a, const uint8_t* b, uint16_t length) {
+    for (uint16_t i = 0; i < length; i++) {
+        out[i] = a[i] > b[i] ? a[i] : b[i];
+    }
+}
+
+void setUp() {
+    merger.setDefaultMode(MERGE_HTP);
+    merger.reset();
+    memset(frameA, 0, sizeof(frameA));
+    memset(frameB, 0, sizeof(frameB));
+}
+
+void tearDown() {
+}
+
+void test_swar_htp_matches_scalar_for_all_byte_pairs() {
+    // 覆盖全部 256 x 256 组合，每个字的 4 个字节各不相同
+    uint32_t a[64], b[64], out[64];
+    uint8_t expected[256];
+    for (uint16_t x = 0; x < 256; x++) {
+        for (uint16_t y = 0; y < 256; y++) {
+            ((uint8_t*)a)[y] = x;
+            ((uint8_t*)b)[y] = y;
+        }
+        MergeEngine::mergeHtp(out, a, b, 64);
+        scalarHtp(expected, (uint8_t*)a, (uint8_t*)b, 256);
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(expected, (uint8_t*)out, 256);
+    }
+}
+
+void test_swar_ltp_only_changed_channels() {
+    uint32_t out[2] = {0x11111111, 0x22222222};
+    uint32_t previous[2] = {0x00000000, 0x80808080};
+    uint32_t next[2] = {0x00FF0000, 0x80808081};
+    MergeEngine::mergeLtp(out, previous, next, 2);
+    TEST_ASSERT_EQUAL_HEX32(0x11FF1111, out[0]);
+    TEST_ASSERT_EQUAL_HEX32(0x22222281, out[1]);
+}
+
+void test_single_source_is_zero_copy() {
+    uint16_t length = 512;
+    const uint8_t* out = merger.process(0, CONSOLE_A, frameA, length, 0);
+    TEST_ASSERT_EQUAL_PTR(frameA, out);
+    TEST_ASSERT_FALSE(merger.isMerging(0));
+}
+
+void test_two_sources_htp() {
+    frameA[0] = 200; frameA[1] = 10; frameA[511] = 7;
+    frameB[0] = 100; frameB[1] = 90;
+
+    uint16_t length = 512;
+    merger.process(0, CONSOLE_A, frameA, length, 0);
+    length = 512;
+    merger.process(0, CONSOLE_B, frameB, length, 10);
+    TEST_ASSERT_TRUE(merger.isMerging(0));
+
+    // 两个源都进入合并缓冲后输出逐通道最大值
+    length = 512;
+    const uint8_t* out = merger.process(0, CONSOLE_A, frameA, length, 20);
+    TEST_ASSERT_NOT_NULL(out);
+    TEST_ASSERT_EQUAL(512, length);
+    TEST_ASSERT_EQUAL(200, out[0]);
+    TEST_ASSERT_EQUAL(90, out[1]);
+    TEST_ASSERT_EQUAL(7, out[511]);
+}
+
+// 第二个源加入时的第一帧就要包含先到的源：A 单独输出过的电平不能闪掉一个包
+void test_second_source_join_keeps_first_source() {
+    frameA[0] = 255; frameA[2] = 128;
+    frameB[0] = 10; frameB[1] = 60;
+
+    uint16_t length = 512;
+    merger.process(0, CONSOLE_A, frameA, length, 0);
+    length = 512;
+    const uint8_t* out = merger.process(0, CONSOLE_B, frameB, length, 10);
+    TEST_ASSERT_TRUE(merger.isMerging(0));
+    TEST_ASSERT_NOT_NULL(out);
+    TEST_ASSERT_EQUAL(512, length);
+    TEST_ASSERT_EQUAL(255, out[0]);
+    TEST_ASSERT_EQUAL(60, out[1]);
+    TEST_ASSERT_EQUAL(128, out[2]);
+}
+
+void test_ltp_follows_most_recent_change() {
+    merger.setMode(0, MERGE_LTP);
+    frameA[0] = 50; frameA[1] = 50;
+    frameB[0] = 10; frameB[1] = 10;
+
+    uint16_t length = 512;
+    merger.process(0, CONSOLE_A, frameA, length, 0);
+    merger.process(0, CONSOLE_B, frameB, length, 1);
+    merger.process(0, CONSOLE_A, frameA, length, 2);
+
+    // B 只改变通道 1：通道 1 跟随 B，通道 0 保持 B 加入时的值
+    frameB[1] = 33;
+    const uint8_t* out = merger.process(0, CONSOLE_B, frameB, length, 3);
+    TEST_ASSERT_EQUAL(33, out[1]);
+    uint8_t channel0 = out[0];
+
+    // A 改变通道 0
+    frameA[0] = 77;
+    out = merger.process(0, CONSOLE_A, frameA, length, 4);
+    TEST_ASSERT_EQUAL(77, out[0]);
+    TEST_ASSERT_EQUAL(33, out[1]);
+    TEST_ASSERT_TRUE(channel0 == 10 || channel0 == 50);
+}
+
+void test_third_source_is_ignored() {
+    uint16_t length = 512;
+    merger.process(0, CONSOLE_A, frameA, length, 0);
+    merger.process(0, CONSOLE_B, frameB, length, 0);
+    TEST_ASSERT_NULL(merger.process(0, CONSOLE_C, frameA, length, 0));
+    TEST_ASSERT_EQUAL(2, merger.getSourceCount(0));
+}
+
+void test_source_timeout_returns_to_single_source() {
+    uint16_t length = 512;
+    merger.process(0, CONSOLE_A, frameA, length, 0);
+    merger.process(0, CONSOLE_B, frameB, length, 1000);
+    TEST_ASSERT_TRUE(merger.isMerging(0));
+
+    // A 停发 10 秒后被移除，B 的数据直接输出
+    const uint8_t* out = merger.process(0, CONSOLE_B, frameB, length, MergeEngine::SOURCE_TIMEOUT_MS);
+    TEST_ASSERT_EQUAL_PTR(frameB, out);
+    TEST_ASSERT_FALSE(merger.isMerging(0));
+
+    // 空出的位置可以给新的源
+    TEST_ASSERT_NOT_NULL(merger.process(0, CONSOLE_C, frameA, length, MergeEngine::SOURCE_TIMEOUT_MS + 1));
+}
+
+// 输出状态只看最近的数据：停发超过 DATA_TIMEOUT_MS 或源被移除后不再算在输出
+void test_recent_data_expires() {
+    uint16_t length = 512;
+    TEST_ASSERT_FALSE(merger.hasRecentData(0, 0));
+    merger.process(0, CONSOLE_A, frameA, length, 1000);
+    TEST_ASSERT_TRUE(merger.hasRecentData(0, 1000 + MergeEngine::DATA_TIMEOUT_MS - 1));
+    TEST_ASSERT_FALSE(merger.hasRecentData(0, 1000 + MergeEngine::DATA_TIMEOUT_MS));
+    TEST_ASSERT_FALSE(merger.hasRecentData(1, 1000));
+
+    merger.process(0, CONSOLE_B, frameB, length, 5000);
+    TEST_ASSERT_TRUE(merger.hasRecentData(0, 5000));
+    merger.removeSource(0, CONSOLE_B);
+    TEST_ASSERT_FALSE(merger.hasRecentData(0, 5000));
+}
+
+void test_cancel_merge_keeps_next_source() {
+    uint16_t length = 512;
+    merger.process(0, CONSOLE_A, frameA, length, 0);
+    merger.process(0, CONSOLE_B, frameB, length, 0);
+    merger.cancelMerge();
+
+    const uint8_t* out = merger.process(0, CONSOLE_B, frameB, length, 1);
+    TEST_ASSERT_EQUAL_PTR(frameB, out);
+    TEST_ASSERT_EQUAL(1, merger.getSourceCount(0));
+    TEST_ASSERT_EQUAL_HEX32(CONSOLE_B, merger.getSourceIp(0, 0) | merger.getSourceIp(0, 1));
+}
+
+void test_merge_kernel_benchmark() {
+    static uint32_t a[MergeEngine::FRAME_WORDS], b[MergeEngine::FRAME_WORDS], out[MergeEngine::FRAME_WORDS];
+    srand(1);
+    for (uint16_t i = 0; i < MergeEngine::FRAME_WORDS; i++) {
+        a[i] = rand();
+        b[i] = rand();
+    }
+
+    BenchResult swar = benchRun(200000, [] {
+        MergeEngine::mergeHtp(out, a, b, MergeEngine::FRAME_WORDS);
+        benchKeep(out);
+    });
+    BenchResult scalar = benchRun(200000, [] {
+        scalarHtp((uint8_t*)out, (const uint8_t*)a, (const uint8_t*)b, MergeEngine::FRAME_SIZE);
+        benchKeep(out);
+    });
+    BenchResult ltp = benchRun(200000, [] {
+        MergeEngine::mergeLtp(out, a, b, MergeEngine::FRAME_WORDS);
+        benchKeep(out);
+    });
+
+    benchReport("HTP merge 512 slots, SWAR", swar);
+    benchReport("HTP merge 512 slots, per byte", scalar);
+    benchReport("LTP merge 512 slots, SWAR", ltp);
+    TEST_ASSERT_TRUE(swar.nsPerIter > 0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_swar_htp_matches_scalar_for_all_byte_pairs);
+    RUN_TEST(test_swar_ltp_only_changed_channels);
+    RUN_TEST(test_single_source_is_zero_copy);
+    RUN_TEST(test_two_sources_htp);
+    RUN_TEST(test_second_source_join_keeps_first_source);
+    RUN_TEST(test_ltp_follows_most_recent_change);
+    RUN_TEST(test_third_source_is_ignored);
+    RUN_TEST(test_source_timeout_returns_to_single_source);
+    RUN_TEST(test_recent_data_expires);
+    RUN_TEST(test_cancel_merge_keeps_next_source);
+    RUN_TEST(test_merge_kernel_benchmark);
+    return UNITY_END();
+}
@@ -0,0 +1,381 @@
+#include <unity.h>
+#include <string.h>
+#include "artnet/UniverseRouter.h"
+#include "artnet/PatchPlan.h"
+#include "dmx/DmxFrameBuffer.h"
+#include "../bench.h"
+
+// 模拟输出：4 路 DMX + 像素缓冲，记录每次写入的次数和字节数
+static const uint16_t PIXEL_BYTES = 1360 * 3;
+
+struct TestSink {
+    uint8_t dmx[PatchPlan::MAX_DMX_TARGETS][512];
+    uint8_t pixels[PIXEL_BYTES];
+    uint32_t writes;
+    uint32_t bytes;
+
+    void write(uint8_t target, uint16_t dest, const uint8_t* src, uint16_t length) {
+        uint8_t* out = target == PatchPlan::PIXEL_TARGET ? pixels : dmx[target];
+        memcpy(out + dest, src, length);
+        writes++;
+        bytes += length;
+    }
+};
+
+static UniverseRouter router;
+static PatchPlan plan;
+static TestSink sink;
+static uint8_t universe[512];
+
+static PatchEntry makeEntry(uint16_t portAddress, uint16_t source, uint16_t count, OutputType type,
+                            uint8_t index, uint16_t offset, uint16_t repeat = 1, uint16_t stride = 0) {
+    PatchEntry entry = {portAddress, source, count, (uint8_t)type, index, offset, repeat, stride};
+    return entry;
+}
+
+static uint8_t slotOf(uint16_t portAddress) {
+    return router.lookup(portAddress)->slot;
+}
+
+void setUp() {
+    router.clear();
+    plan.clear();
+    memset(&sink, 0, sizeof(sink));
+    for (uint16_t i = 0; i < sizeof(universe); i++) universe[i] = (uint8_t)(i * 7 + 1);
+}
+
+void tearDown() {}
+
+void test_default_patch_is_one_span_per_universe() {
+    router.addRoute(0, OUTPUT_DMX, 0);
+    router.addRoute(1, OUTPUT_DMX, 1);
+    PatchEntry entries[] = {
+        makeEntry(0, 0, 512, OUTPUT_DMX, 0, 0),
+        makeEntry(1, 0, 512, OUTPUT_DMX, 1, 0),
+    };
+    TEST_ASSERT_TRUE(plan.compile(entries, 2, router, 0x03, 0));
+    TEST_ASSERT_EQUAL(2, plan.getSpanCount());
+    TEST_ASSERT_EQUAL(1, plan.getSpanCount(slotOf(0)));
+    TEST_ASSERT_EQUAL(1024, plan.getStats().bytes);
+
+    plan.apply(slotOf(1), universe, 512, sink);
+    TEST_ASSERT_EQUAL(1, sink.writes);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(universe, sink.dmx[1], 512);
+}
+
+// dmxStartAddress：从第 N 个通道起取数据，写到输出的起点
+void test_start_address_offsets_source() {
+    router.addRoute(0, OUTPUT_DMX, 0);
+    PatchEntry entry = makeEntry(0, 99, 512 - 99, OUTPUT_DMX, 0, 0);
+    TEST_ASSERT_TRUE(plan.compile(&entry, 1, router, 0x01, 0));
+    TEST_ASSERT_EQUAL(1, plan.getSpanCount());
+
+    plan.apply(slotOf(0), universe, 512, sink);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(universe + 99, sink.dmx[0], 512 - 99);
+    TEST_ASSERT_EQUAL(0, sink.dmx[0][512 - 99]);
+}
+
+// 来源和目标都相接的几项合并成一次拷贝
+void test_adjacent_entries_coalesce() {
+    router.addRoute(5, OUTPUT_DMX, 0);
+    PatchEntry entries[] = {
+        makeEntry(5, 0, 100, OUTPUT_DMX, 0, 10),
+        makeEntry(5, 100, 50, OUTPUT_DMX, 0, 110),
+        makeEntry(5, 150, 20, OUTPUT_DMX, 0, 160),
+    };
+    TEST_ASSERT_TRUE(plan.compile(entries, 3, router, 0x01, 0));
+    TEST_ASSERT_EQUAL(1, plan.getSpanCount());
+    const PatchSpan& span = plan.getSpan(0);
+    TEST_ASSERT_EQUAL(0, span.source);
+    TEST_ASSERT_EQUAL(10, span.dest);
+    TEST_ASSERT_EQUAL(170, span.length);
+}
+
+// 后面的项覆盖前面的：被覆盖的区间拆成前后两段
+void test_later_entry_overrides() {
+    router.addRoute(0, OUTPUT_DMX, 0);
+    router.addRoute(1, OUTPUT_DMX, 0);
+    PatchEntry entries[] = {
+        makeEntry(0, 0, 512, OUTPUT_DMX, 0, 0),
+        makeEntry(1, 0, 16, OUTPUT_DMX, 0, 100),
+    };
+    TEST_ASSERT_TRUE(plan.compile(entries, 2, router, 0x01, 0));
+    TEST_ASSERT_EQUAL(2, plan.getSpanCount(slotOf(0)));
+    TEST_ASSERT_EQUAL(1, plan.getSpanCount(slotOf(1)));
+    TEST_ASSERT_EQUAL(512, plan.getStats().bytes);
+
+    uint8_t other[16];
+    memset(other, 0xEE, sizeof(other));
+    plan.apply(slotOf(0), universe, 512, sink);
+    plan.apply(slotOf(1), other, sizeof(other), sink);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(universe, sink.dmx[0], 100);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(other, sink.dmx[0] + 100, 16);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(universe + 116, sink.dmx[0] + 116, 512 - 116);
+}
+
+// 一个像素的颜色重复到整条灯带：合并成一段带间隔的重复拷贝
+void test_repeat_merges_into_one_span() {
+    router.addRoute(0, OUTPUT_PIXEL, 0);
+    PatchEntry entry = makeEntry(0, 0, 3, OUTPUT_PIXEL, 0, 0, 300);
+    TEST_ASSERT_TRUE(plan.compile(&entry, 1, router, 0, PIXEL_BYTES));
+    TEST_ASSERT_EQUAL(1, plan.getSpanCount());
+    const PatchSpan& span = plan.getSpan(0);
+    TEST_ASSERT_EQUAL(3, span.length);
+    TEST_ASSERT_EQUAL(3, span.stride);
+    TEST_ASSERT_EQUAL(300, span.repeat);
+
+    plan.apply(slotOf(0), universe, 512, sink);
+    for (uint16_t i = 0; i < 300; i++) {
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(universe, sink.pixels + i * 3, 3);
+    }
+    TEST_ASSERT_EQUAL(0, sink.pixels[900]);
+}
+
+// 带间隔的重复：目标之间留空的部分不写
+void test_repeat_with_stride() {
+    router.addRoute(0, OUTPUT_DMX, 2);
+    PatchEntry entry = makeEntry(0, 10, 4, OUTPUT_DMX, 2, 0, 8, 16);
+    TEST_ASSERT_TRUE(plan.compile(&entry, 1, router, 0x04, 0));
+    TEST_ASSERT_EQUAL(1, plan.getSpanCount());
+
+    plan.apply(slotOf(0), universe, 512, sink);
+    for (uint16_t r = 0; r < 8; r++) {
+        TEST_ASSERT_EQUAL_UINT8_ARRAY(universe + 10, sink.dmx[2] + r * 16, 4);
+        TEST_ASSERT_EQUAL(0, sink.dmx[2][r * 16 + 4]);
+    }
+}
+
+// 像素缓冲大于一个窗口：跨窗口边界的连续拷贝仍是一段，超出像素数的部分裁掉
+void test_pixel_segments_span_windows() {
+    router.addRoute(0, OUTPUT_PIXEL, 0);
+    router.addRoute(1, OUTPUT_PIXEL, 1);
+    router.addRoute(2, OUTPUT_PIXEL, 2);
+    PatchEntry entries[] = {
+        makeEntry(0, 0, 510, OUTPUT_PIXEL, 0, 0),
+        makeEntry(1, 0, 510, OUTPUT_PIXEL, 1, 0),
+        makeEntry(2, 0, 510, OUTPUT_PIXEL, 2, 0),
+    };
+    uint16_t pixelBytes = 400 * 3;
+    TEST_ASSERT_TRUE(plan.compile(entries, 3, router, 0, pixelBytes));
+    TEST_ASSERT_EQUAL(3, plan.getSpanCount());
+    TEST_ASSERT_EQUAL(1, plan.getSpanCount(slotOf(1)));
+    TEST_ASSERT_EQUAL(510, plan.getSpan(1).length);
+    TEST_ASSERT_EQUAL(pixelBytes - 1020, plan.getSpan(2).length);
+    TEST_ASSERT_EQUAL(pixelBytes, plan.getStats().bytes);
+
+    plan.apply(slotOf(1), universe, 512, sink);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(universe, sink.pixels + 510, 510);
+}
+
+// 短包只拷贝实际收到的通道
+void test_short_packet_is_clipped() {
+    router.addRoute(0, OUTPUT_DMX, 0);
+    PatchEntry entries[] = {
+        makeEntry(0, 0, 64, OUTPUT_DMX, 0, 0),
+        makeEntry(0, 200, 64, OUTPUT_DMX, 0, 300),
+    };
+    TEST_ASSERT_TRUE(plan.compile(entries, 2, router, 0x01, 0));
+
+    plan.apply(slotOf(0), universe, 24, sink);
+    TEST_ASSERT_EQUAL(1, sink.writes);
+    TEST_ASSERT_EQUAL(24, sink.bytes);
+    TEST_ASSERT_EQUAL(0, sink.dmx[0][300]);
+}
+
+// 未订阅的宇宙、不存在的输出、空项都跳过
+void test_invalid_entries_are_skipped() {
+    router.addRoute(0, OUTPUT_DMX, 0);
+    PatchEntry entries[] = {
+        makeEntry(9, 0, 512, OUTPUT_DMX, 0, 0),
+        makeEntry(0, 0, 512, OUTPUT_DMX, 1, 0),
+        makeEntry(0, 0, 0, OUTPUT_DMX, 0, 0),
+        makeEntry(0, 0, 16, OUTPUT_PIXEL, 0, 0),
+        makeEntry(0, 0, 16, OUTPUT_DMX, 0, 0),
+    };
+    TEST_ASSERT_TRUE(plan.compile(entries, 5, router, 0x01, 0));
+    TEST_ASSERT_EQUAL(1, plan.getStats().entries);
+    TEST_ASSERT_EQUAL(4, plan.getStats().skipped);
+    TEST_ASSERT_EQUAL(1, plan.getSpanCount());
+    TEST_ASSERT_EQUAL(0x01, plan.targetMask(slotOf(0)));
+}
+
+// 一个宇宙写到多个输出：目标位图决定提交哪些输出
+void test_target_mask() {
+    router.addRoute(0, OUTPUT_DMX, 0);
+    router.addRoute(1, OUTPUT_PIXEL, 0);
+    PatchEntry entries[] = {
+        makeEntry(0, 0, 512, OUTPUT_DMX, 0, 0),
+        makeEntry(0, 0, 64, OUTPUT_DMX, 1, 0),
+        makeEntry(0, 0, 30, OUTPUT_PIXEL, 0, 0),
+        makeEntry(1, 0, 30, OUTPUT_PIXEL, 0, 30),
+    };
+    TEST_ASSERT_TRUE(plan.compile(entries, 4, router, 0x03, 60));
+    TEST_ASSERT_EQUAL(0x03 | 1 << PatchPlan::PIXEL_TARGET, plan.targetMask(slotOf(0)));
+    TEST_ASSERT_EQUAL(1 << PatchPlan::PIXEL_TARGET, plan.targetMask(slotOf(1)));
+}
+
+// 完全打乱的逐通道配接超出段数上限
+void test_overflow_reports_false() {
+    router.addRoute(0, OUTPUT_DMX, 0);
+    static PatchEntry entries[200];
+    for (uint8_t i = 0; i < 200; i++) {
+        entries[i] = makeEntry(0, (uint16_t)(i * 2), 1, OUTPUT_DMX, 0, i);
+    }
+    TEST_ASSERT_FALSE(plan.compile(entries, 200, router, 0x01, 0));
+    TEST_ASSERT_TRUE(plan.getStats().overflow);
+    TEST_ASSERT_EQUAL(PatchPlan::MAX_SPANS, plan.getSpanCount());
+}
+
+// 一帧分几段写入：段之间的通道沿用上一次发布的值
+void test_frame_buffer_fills_gaps_between_spans() {
+    DmxFrameBuffer buffer;
+    uint8_t full[512];
+    memset(full, 0x11, sizeof(full));
+    buffer.writeSlots(full, 512);
+    buffer.commit();
+
+    uint8_t a[10], b[10];
+    memset(a, 0xAA, sizeof(a));
+    memset(b, 0xBB, sizeof(b));
+    buffer.writeSlots(a, 10, 0);
+    buffer.writeSlots(b, 10, 100);
+    buffer.commit();
+    TEST_ASSERT_TRUE(buffer.acquire());
+    const DmxFrame& frame = buffer.front();
+    TEST_ASSERT_EQUAL(512, frame.length);
+    TEST_ASSERT_EQUAL_HEX8(0xAA, frame.data[1 + 9]);
+    TEST_ASSERT_EQUAL_HEX8(0x11, frame.data[1 + 50]);
+    TEST_ASSERT_EQUAL_HEX8(0xBB, frame.data[1 + 100]);
+    TEST_ASSERT_EQUAL_HEX8(0x11, frame.data[1 + 511]);
+}
+
+// 上一帧较短时，段之间超出其长度的通道清零
+void test_frame_buffer_zeroes_gap_past_last_length() {
+    DmxFrameBuffer buffer;
+    uint8_t a[20], b[4];
+    memset(a, 0x22, sizeof(a));
+    memset(b, 0xBB, sizeof(b));
+    buffer.writeSlots(a, 20);
+    buffer.commit();
+    buffer.writeSlots(a, 10, 0);
+    buffer.writeSlots(b, 4, 40);
+    buffer.commit();
+    TEST_ASSERT_TRUE(buffer.acquire());
+    const DmxFrame& frame = buffer.front();
+    TEST_ASSERT_EQUAL(44, frame.length);
+    TEST_ASSERT_EQUAL_HEX8(0x22, frame.data[1 + 19]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, frame.data[1 + 20]);
+    TEST_ASSERT_EQUAL_HEX8(0x00, frame.data[1 + 39]);
+    TEST_ASSERT_EQUAL_HEX8(0xBB, frame.data[1 + 40]);
+}
+
+// 对照：逐通道查表（每个输出字节一个来源下标）
+struct ChannelMap {
+    int16_t source[PatchPlan::TARGET_COUNT][PIXEL_BYTES];
+    uint16_t size[PatchPlan::TARGET_COUNT];
+};
+
+static ChannelMap channelMap;
+
+static void buildChannelMap(const PatchEntry* entries, uint8_t count, uint16_t pixelBytes) {
+    memset(channelMap.source, 0xFF, sizeof(channelMap.source));
+    for (uint8_t t = 0; t < PatchPlan::TARGET_COUNT; t++) {
+        channelMap.size[t] = t == PatchPlan::PIXEL_TARGET ? pixelBytes : 512;
+    }
+    for (uint8_t e = 0; e < count; e++) {
+        const PatchEntry& entry = entries[e];
+        uint8_t target = PatchPlan::targetOf(entry.type, entry.index);
+        uint32_t base = entry.offset;
+        if (target == PatchPlan::PIXEL_TARGET) base += entry.index * PATCH_PIXEL_SEGMENT_BYTES;
+        for (uint16_t r = 0; r < (entry.repeat ? entry.repeat : 1); r++) {
+            for (uint16_t i = 0; i < entry.count; i++) {
+                uint32_t dest = base + r * (entry.stride ? entry.stride : entry.count) + i;
+                if (dest < channelMap.size[target]) channelMap.source[target][dest] = entry.source + i;
+            }
+        }
+    }
+}
+
+static void applyChannelMap(const uint8_t* data, uint16_t length) {
+    for (uint8_t t = 0; t < PatchPlan::TARGET_COUNT; t++) {
+        uint8_t* out = t == PatchPlan::PIXEL_TARGET ? sink.pixels : sink.dmx[t];
+        for (uint16_t d = 0; d < channelMap.size[t]; d++) {
+            int16_t src = channelMap.source[t][d];
+            if (src >= 0 && src < length) out[d] = data[src];
+        }
+    }
+}
+
+// 单宇宙：2 路 DMX（从第 17 通道起）+ 8 段像素中的一段，拷贝计划与逐通道查表
+void test_apply_vs_channel_lookup() {
+    router.addRoute(0, OUTPUT_DMX, 0);
+    PatchEntry entries[] = {
+        makeEntry(0, 16, 496, OUTPUT_DMX, 0, 0),
+        makeEntry(0, 16, 496, OUTPUT_DMX, 1, 0),
+        makeEntry(0, 0, 510, OUTPUT_PIXEL, 0, 0),
+        makeEntry(0, 0, 6, OUTPUT_PIXEL, 1, 0, 85),
+    };
+    uint16_t pixelBytes = 1360 * 3;
+    TEST_ASSERT_TRUE(plan.compile(entries, 4, router, 0x03, pixelBytes));
+    buildChannelMap(entries, 4, pixelBytes);
+    uint8_t slot = slotOf(0);
+
+    // 两种方法结果相同
+    TestSink expected;
+    memset(&expected, 0, sizeof(expected));
+    applyChannelMap(universe, 512);
+    memcpy(&expected, &sink, sizeof(sink));
+    memset(&sink, 0, sizeof(sink));
+    plan.apply(slot, universe, 512, sink);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected.dmx, sink.dmx, sizeof(sink.dmx));
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(expected.pixels, sink.pixels, sizeof(sink.pixels));
+
+    BenchResult planned = benchRun(20000, [slot] { plan.apply(slot, universe, 512, sink); benchKeep(&sink); });
+    BenchResult lookup = benchRun(2000, [] { applyChannelMap(universe, 512); benchKeep(&sink); });
+    benchReport("patch plan apply", planned);
+    benchReport("per-channel lookup", lookup);
+    printf("[bench] spans %u, bytes %u\n", plan.getSpanCount(), plan.getStats().bytes);
+    TEST_ASSERT_TRUE(planned.nsPerIter > 0 && lookup.nsPerIter > 0);
+}
+
+// 打乱的配接：每 8 个通道一组逆序排列，计划段数随之增加
+void test_scrambled_patch_cost() {
+    router.addRoute(0, OUTPUT_DMX, 0);
+    PatchEntry entries[64];
+    for (uint8_t i = 0; i < 64; i++) {
+        entries[i] = makeEntry(0, (uint16_t)(i * 8), 8, OUTPUT_DMX, 0, (uint16_t)((63 - i) * 8));
+    }
+    TEST_ASSERT_TRUE(plan.compile(entries, 64, router, 0x01, 0));
+    TEST_ASSERT_EQUAL(64, plan.getSpanCount());
+
+    uint8_t slot = slotOf(0);
+    plan.apply(slot, universe, 512, sink);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(universe, sink.dmx[0] + 63 * 8, 8);
+
+    buildChannelMap(entries, 64, 0);
+    BenchResult planned = benchRun(20000, [slot] { plan.apply(slot, universe, 512, sink); benchKeep(&sink); });
+    BenchResult compile = benchRun(200, [&entries] { plan.compile(entries, 64, router, 0x01, 0); benchKeep(&plan); });
+    benchReport("scrambled patch apply", planned);
+    benchReport("scrambled patch compile", compile);
+    TEST_ASSERT_TRUE(planned.nsPerIter > 0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_default_patch_is_one_span_per_universe);
+    RUN_TEST(test_start_address_offsets_source);
+    RUN_TEST(test_adjacent_entries_coalesce);
+    RUN_TEST(test_later_entry_overrides);
+    RUN_TEST(test_repeat_merges_into_one_span);
+    RUN_TEST(test_repeat_with_stride);
+    RUN_TEST(test_pixel_segments_span_windows);
+    RUN_TEST(test_short_packet_is_clipped);
+    RUN_TEST(test_invalid_entries_are_skipped);
+    RUN_TEST(test_target_mask);
+    RUN_TEST(test_overflow_reports_false);
+    RUN_TEST(test_frame_buffer_fills_gaps_between_spans);
+    RUN_TEST(test_frame_buffer_zeroes_gap_past_last_length);
+    RUN_TEST(test_apply_vs_channel_lookup);
+    RUN_TEST(test_scrambled_patch_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,136 @@
+#include <unity.h>
+#include <string.h>
+#include "pixels/PixelFeatures.h"
+#include "../bench.h"
+
+static const uint16_t PIXELS = 1360;
+static uint8_t rgb[PIXELS * 3];
+static uint8_t expected[PIXELS * 4];
+static uint8_t wire[PIXELS * 4];
+
+// 原来的逐像素路径：每个像素检查下标、先缩放亮度再经总线接口编码并标记脏
+struct PerPixelBus {
+    virtual ~PerPixelBus() {}
+    virtual void setPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b) = 0;
+};
+
+template <typename T_FEATURE>
+struct PerPixelBusT : PerPixelBus {
+    uint8_t* pixels;
+    uint16_t count;
+    bool dirty;
+    void setPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b) override {
+        if (index >= count) return;
+        T_FEATURE::encode(pixels + index * T_FEATURE::BYTES, r, g, b);
+        dirty = true;
+    }
+};
+
+static void perPixel(PerPixelBus& bus, const uint8_t* src, uint16_t count, uint8_t brightness) {
+    for (uint16_t i = 0; i < count; i++, src += 3) {
+        uint8_t r = src[0], g = src[1], b = src[2];
+        if (brightness != PIXEL_FULL_BRIGHTNESS) {
+            r = (r * brightness) >> 8;
+            g = (g * brightness) >> 8;
+            b = (b * brightness) >> 8;
+        }
+        bus.setPixel(i, r, g, b);
+    }
+}
+
+template <typename T_FEATURE>
+static void checkMatchesPerPixel(uint16_t count, uint8_t brightness, uint16_t offset) {
+    PerPixelBusT<T_FEATURE> bus;
+    bus.pixels = expected;
+    bus.count = PIXELS;
+    memset(expected, 0xA5, sizeof(expected));
+    memset(wire, 0xA5, sizeof(wire));
+    perPixel(bus, rgb + offset * 3, count, brightness);
+    T_FEATURE::encodeRun(wire, rgb + offset * 3, count, brightness);
+    TEST_ASSERT_EQUAL_MEMORY(expected, wire, sizeof(wire));
+}
+
+void setUp() {
+    for (uint16_t i = 0; i < sizeof(rgb); i++) rgb[i] = (uint8_t)(i * 97 + (i >> 3) * 13 + 1);
+}
+
+void tearDown() {}
+
+// 按字缩放与逐字节 (c * b) >> 8 完全一致
+void test_scale_word_matches_bytes() {
+    const uint8_t levels[] = {0, 1, 2, 127, 128, 200, 254, 255};
+    for (uint8_t level : levels) {
+        for (uint32_t c = 0; c < 256; c++) {
+            uint32_t w = c | (255 - c) << 8 | (c ^ 0x5A) << 16 | ((c * 7) & 0xFF) << 24;
+            uint32_t scaled = pixelScaleWord(w, level);
+            for (uint8_t k = 0; k < 4; k++) {
+                TEST_ASSERT_EQUAL(pixelScale((w >> (8 * k)) & 0xFF, level), (scaled >> (8 * k)) & 0xFF);
+            }
+        }
+    }
+}
+
+// 各种长度（含 4 像素分组后的尾部）、亮度和起点都与逐像素写入逐字节相同
+void test_run_matches_per_pixel() {
+    const uint16_t counts[] = {0, 1, 2, 3, 4, 5, 7, 8, 170, 171, PIXELS - 1};
+    const uint8_t levels[] = {255, 254, 128, 1, 0};
+    for (uint16_t count : counts) {
+        for (uint8_t level : levels) {
+            uint16_t offset = count < PIXELS - 1 ? 1 : 0;
+            checkMatchesPerPixel<PixelFeatureGrb>(count, level, offset);
+            checkMatchesPerPixel<PixelFeatureGrbw>(count, level, offset);
+            checkMatchesPerPixel<PixelFeatureApa102>(count, level, offset);
+        }
+    }
+}
+
+// 不写超出 count 的字节
+void test_run_stays_in_bounds() {
+    memset(wire, 0xEE, sizeof(wire));
+    PixelFeatureGrb::encodeRun(wire, rgb, 5, 255);
+    TEST_ASSERT_EQUAL_HEX8(0xEE, wire[15]);
+    TEST_ASSERT_EQUAL(rgb[13], wire[12]);
+    TEST_ASSERT_EQUAL(rgb[12], wire[13]);
+    TEST_ASSERT_EQUAL(rgb[14], wire[14]);
+}
+
+template <typename T_FEATURE>
+static void benchFeature(const char* name, uint16_t count, uint8_t brightness) {
+    static PerPixelBusT<T_FEATURE> bus;
+    static uint16_t n;
+    static uint8_t level;
+    bus.pixels = expected;
+    bus.count = count;
+    n = count;
+    level = brightness;
+    PerPixelBus* base = &bus;
+    static PerPixelBus* target;
+    target = base;
+
+    const uint32_t iterations = count > 200 ? 2000 : 20000;
+    BenchResult before = benchRun(iterations, [] { perPixel(*target, rgb, n, level); benchKeep(expected); });
+    BenchResult after = benchRun(iterations, [] { T_FEATURE::encodeRun(wire, rgb, n, level); benchKeep(wire); });
+    printf("[bench] %-28s %4u px b=%3u  per-pixel %6.2f ns/px  bulk %6.2f ns/px  (%.1fx)\n",
+           name, count, brightness, before.nsPerIter / count, after.nsPerIter / count,
+           before.nsPerIter / after.nsPerIter);
+    TEST_ASSERT_TRUE(before.nsPerIter > 0 && after.nsPerIter > 0);
+}
+
+void test_bulk_cost_per_pixel() {
+    const uint16_t counts[] = {170, PIXELS};
+    for (uint16_t count : counts) {
+        benchFeature<PixelFeatureGrb>("WS2812 GRB", count, 255);
+        benchFeature<PixelFeatureGrb>("WS2812 GRB", count, 128);
+        benchFeature<PixelFeatureGrbw>("SK6812 GRBW", count, 128);
+        benchFeature<PixelFeatureApa102>("APA102", count, 128);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_scale_word_matches_bytes);
+    RUN_TEST(test_run_matches_per_pixel);
+    RUN_TEST(test_run_stays_in_bounds);
+    RUN_TEST(test_bulk_cost_per_pixel);
+    return UNITY_END();
+}
@@ -0,0 +1,105 @@
+#include <unity.h>
+#include <string.h>
+#include "pixels/PixelFeatures.h"
+#include "../bench.h"
+
+static const uint16_t PIXELS = 1360;
+static uint8_t rgb[PIXELS * 3];
+static uint8_t wire[PIXELS * 4];
+
+// 与 PixelDriver::writePixel 相同：逐像素编码进帧缓冲
+template <typename T_FEATURE>
+static void encodeStrip(uint8_t* dst, const uint8_t* src, uint16_t count) {
+    for (uint16_t i = 0; i < count; i++, src += 3, dst += T_FEATURE::BYTES) {
+        T_FEATURE::encode(dst, src[0], src[1], src[2]);
+    }
+}
+
+void setUp() {
+    for (uint16_t i = 0; i < sizeof(rgb); i++) rgb[i] = (uint8_t)(i * 31 + 7);
+    memset(wire, 0, sizeof(wire));
+}
+
+void tearDown() {}
+
+void test_grb_layout() {
+    uint8_t out[3];
+    PixelFeatureGrb::encode(out, 1, 2, 3);
+    TEST_ASSERT_EQUAL(2, out[0]);
+    TEST_ASSERT_EQUAL(1, out[1]);
+    TEST_ASSERT_EQUAL(3, out[2]);
+}
+
+// 三色共同的部分转到白光
+void test_grbw_extracts_white() {
+    uint8_t out[4];
+    PixelFeatureGrbw::encode(out, 200, 120, 90);
+    TEST_ASSERT_EQUAL(30, out[0]);
+    TEST_ASSERT_EQUAL(110, out[1]);
+    TEST_ASSERT_EQUAL(0, out[2]);
+    TEST_ASSERT_EQUAL(90, out[3]);
+
+    PixelFeatureGrbw::encode(out, 255, 255, 255);
+    TEST_ASSERT_EQUAL(0, out[0] | out[1] | out[2]);
+    TEST_ASSERT_EQUAL(255, out[3]);
+
+    PixelFeatureGrbw::encode(out, 255, 0, 0);
+    TEST_ASSERT_EQUAL(255, out[1]);
+    TEST_ASSERT_EQUAL(0, out[3]);
+}
+
+void test_apa102_layout() {
+    uint8_t out[4];
+    PixelFeatureApa102::encode(out, 1, 2, 3);
+    TEST_ASSERT_EQUAL_HEX8(0xFF, out[0]);
+    TEST_ASSERT_EQUAL(3, out[1]);
+    TEST_ASSERT_EQUAL(2, out[2]);
+    TEST_ASSERT_EQUAL(1, out[3]);
+}
+
+void test_bytes_per_type() {
+    TEST_ASSERT_EQUAL(3, pixelBytes(TYPE_WS2812));
+    TEST_ASSERT_EQUAL(4, pixelBytes(TYPE_SK6812));
+    TEST_ASSERT_EQUAL(4, pixelBytes(TYPE_APA102));
+    TEST_ASSERT_EQUAL(3, pixelBytes((PixelType)7));
+}
+
+// 一帧的线上时间：170 个 WS2812 约 5.4 ms，APA102 走 20 MHz SPI 快一个数量级以上
+void test_wire_time() {
+    TEST_ASSERT_EQUAL(5100 + PIXEL_ONEWIRE_RESET_US, pixelFrameUs(TYPE_WS2812, 170));
+    TEST_ASSERT_EQUAL(6800 + PIXEL_ONEWIRE_RESET_US, pixelFrameUs(TYPE_SK6812, 170));
+    uint32_t apa = pixelFrameUs(TYPE_APA102, 170);
+    TEST_ASSERT_EQUAL((4 + 680 + 11) * 8 / 20, apa);
+    TEST_ASSERT_TRUE(pixelFrameUs(TYPE_WS2812, 170) > apa * 10);
+    TEST_ASSERT_TRUE(pixelFrameUs(TYPE_WS2812, 1360) > pixelFrameUs(TYPE_APA102, 1360) * 10);
+}
+
+void test_encode_cost_per_pixel() {
+    const uint32_t iterations = 2000;
+    BenchResult grb = benchRun(iterations, [] { encodeStrip<PixelFeatureGrb>(wire, rgb, PIXELS); benchKeep(wire); });
+    BenchResult grbw = benchRun(iterations, [] { encodeStrip<PixelFeatureGrbw>(wire, rgb, PIXELS); benchKeep(wire); });
+    BenchResult apa = benchRun(iterations, [] { encodeStrip<PixelFeatureApa102>(wire, rgb, PIXELS); benchKeep(wire); });
+
+    // 换算成每像素
+    BenchResult results[] = {grb, grbw, apa};
+    const char* names[] = {"WS2812 GRB encode / pixel", "SK6812 GRBW encode / pixel", "APA102 encode / pixel"};
+    const PixelType types[] = {TYPE_WS2812, TYPE_SK6812, TYPE_APA102};
+    for (uint8_t i = 0; i < 3; i++) {
+        results[i].nsPerIter /= PIXELS;
+        results[i].cyclesPerIter /= PIXELS;
+        benchReport(names[i], results[i]);
+        printf("[bench] %-40s %10u us wire time for %u pixels\n", names[i], pixelFrameUs(types[i], PIXELS), PIXELS);
+    }
+    TEST_ASSERT_TRUE(grb.nsPerIter > 0 && grbw.nsPerIter > 0 && apa.nsPerIter > 0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_grb_layout);
+    RUN_TEST(test_grbw_extracts_white);
+    RUN_TEST(test_apa102_layout);
+    RUN_TEST(test_bytes_per_type);
+    RUN_TEST(test_wire_time);
+    RUN_TEST(test_encode_cost_per_pixel);
+    return UNITY_END();
+}
@@ -0,0 +1,182 @@
+#include <unity.h>
+#include "pixels/PixelFramePacer.h"
+#include "../bench.h"
+
+// 渲染节拍：虚拟时钟驱动渲染循环（等待 -> 开始一格 -> 渲染耗时 -> 结束），
+// 检查格子对齐、没有变化时跳过、迟到帧和整格错过的统计，以及混合模式的来源切换
+
+static PixelFramePacer pacer;
+static uint32_t now;
+
+static const uint32_t PERIOD_40 = 25000;
+
+// 渲染循环的一次迭代：等到格子开始（加上唤醒延迟），渲染 workUs
+static PixelRenderKind step(bool dmxFresh, bool effectDue, uint32_t workUs, uint32_t wakeLateUs = 0,
+                            uint32_t* startedAt = nullptr) {
+    now += pacer.waitUs(now) + wakeLateUs;
+    if (startedAt) *startedAt = now;
+    PixelRenderKind kind = pacer.beginFrame(now, dmxFresh, effectDue);
+    if (kind != PIXEL_RENDER_SKIP) now += workUs;
+    pacer.endFrame(now, kind);
+    return kind;
+}
+
+void setUp() {
+    pacer = PixelFramePacer();
+    pacer.setTargetFps(40);
+    now = 1000;
+    pacer.start(now);
+}
+
+void tearDown() {}
+
+void test_fps_clamped() {
+    TEST_ASSERT_EQUAL(PERIOD_40, pacer.getPeriodUs());
+    TEST_ASSERT_EQUAL(40, pacer.getTargetFps());
+    pacer.setTargetFps(0);
+    TEST_ASSERT_EQUAL(PixelFramePacer::DEFAULT_FPS, pacer.getTargetFps());
+    pacer.setTargetFps(60000);
+    TEST_ASSERT_EQUAL(1000, pacer.getPeriodUs());
+}
+
+// 唤醒有抖动时格子仍按固定间隔对齐，不累积漂移
+void test_slots_do_not_drift() {
+    uint32_t first = now;
+    for (uint32_t frame = 0; frame < 200; frame++) {
+        uint32_t started;
+        step(true, false, 3000, (frame * 7919) % 1000, &started);
+        TEST_ASSERT_TRUE(started - (first + frame * PERIOD_40) < 1000);
+    }
+    const PixelPacerStats& stats = pacer.getStats();
+    TEST_ASSERT_EQUAL(200, stats.ticks);
+    TEST_ASSERT_EQUAL(200, stats.dmxFrames);
+    TEST_ASSERT_EQUAL(0, stats.late);
+    TEST_ASSERT_EQUAL(0, stats.missed);
+    TEST_ASSERT_EQUAL(3000, stats.maxWorkUs);
+}
+
+// 没有新数据的格子跳过渲染
+void test_unchanged_slots_are_skipped() {
+    for (uint32_t frame = 0; frame < 40; frame++) {
+        PixelRenderKind kind = step(frame % 4 == 0, true, 2000);
+        TEST_ASSERT_EQUAL(frame % 4 == 0 ? PIXEL_RENDER_DMX : PIXEL_RENDER_SKIP, kind);
+    }
+    TEST_ASSERT_EQUAL(10, pacer.getStats().dmxFrames);
+    TEST_ASSERT_EQUAL(30, pacer.getStats().skipped);
+    TEST_ASSERT_EQUAL(0, pacer.getStats().effectFrames);
+}
+
+// 超出预算的帧记为迟到；下一格仍在原来的格子上，已经过去的格子不补
+void test_late_and_missed_frames() {
+    uint32_t first = now;
+    step(true, false, 2000);
+    step(true, false, 30000);              // 第 2 格超出 5 ms
+    TEST_ASSERT_EQUAL(1, pacer.getStats().late);
+    TEST_ASSERT_EQUAL(5000, pacer.getStats().lastLateUs);
+
+    // 第 3 格本应在 first + 50 ms 开始，已经过了，立即开始但不算错过整格
+    uint32_t started;
+    step(true, false, 2000, 0, &started);
+    TEST_ASSERT_EQUAL(first + 55000, started);
+    TEST_ASSERT_EQUAL(0, pacer.getStats().missed);
+    TEST_ASSERT_EQUAL(1, pacer.getStats().late);
+
+    // 第 3 格结束于 57 ms，再卡住 80 ms 到 137 ms：75 和 100 ms 两格整格错过，
+    // 这一帧落在 125 ms 的格子里，下一格重新对齐到 150 ms
+    now += 80000;
+    step(true, false, 2000, 0, &started);
+    TEST_ASSERT_EQUAL(first + 137000, started);
+    TEST_ASSERT_EQUAL(2, pacer.getStats().missed);
+    step(true, false, 2000, 0, &started);
+    TEST_ASSERT_EQUAL(first + 150000, started);
+    TEST_ASSERT_EQUAL(1, pacer.getStats().late);
+    TEST_ASSERT_EQUAL(30000, pacer.getStats().maxWorkUs);
+}
+
+void test_effect_source_ignores_dmx() {
+    pacer.setSource(PIXEL_SOURCE_EFFECT);
+    TEST_ASSERT_EQUAL(PIXEL_RENDER_SKIP, step(true, false, 1000));
+    TEST_ASSERT_EQUAL(PIXEL_RENDER_EFFECT, step(true, true, 1000));
+    TEST_ASSERT_EQUAL(PIXEL_RENDER_EFFECT, step(false, true, 1000));
+}
+
+// 混合：从未收到 DMX 时跑效果；有 DMX 时只按 DMX；空闲超时后回到效果
+void test_mixed_source_falls_back_to_effect() {
+    pacer.setSource(PIXEL_SOURCE_MIXED);
+    pacer.setDmxIdle(200000);
+    TEST_ASSERT_EQUAL(PIXEL_RENDER_EFFECT, step(false, true, 1000));
+    TEST_ASSERT_EQUAL(PIXEL_RENDER_DMX, step(true, true, 1000));
+    for (uint8_t i = 0; i < 7; i++) {
+        TEST_ASSERT_EQUAL(PIXEL_RENDER_SKIP, step(false, true, 1000));
+    }
+    TEST_ASSERT_EQUAL(PIXEL_RENDER_EFFECT, step(false, true, 1000));   // 第 8 格：200 ms 没有 DMX
+    TEST_ASSERT_EQUAL(PIXEL_RENDER_DMX, step(true, true, 1000));
+    TEST_ASSERT_TRUE(pacer.isDmxActive(now));
+}
+
+// 微秒计数回绕时格子照常推进
+void test_clock_wraparound() {
+    now = 0xFFFFFFFFu - 30000;
+    pacer.start(now);
+    uint32_t first = now;
+    for (uint32_t frame = 0; frame < 10; frame++) {
+        uint32_t started;
+        step(true, false, 2000, 0, &started);
+        TEST_ASSERT_EQUAL(first + frame * PERIOD_40, started);
+    }
+    TEST_ASSERT_EQUAL(0, pacer.getStats().late);
+    TEST_ASSERT_EQUAL(0, pacer.getStats().missed);
+}
+
+// 对照：原来效果只在收到 ArtDmx 时前进。输入 1 秒 200 包、随后静默 1 秒，
+// 原方式效果跟着包走、静默时停住；固定节拍在两段里都按 40 fps 渲染
+void test_effect_rate_independent_of_packets() {
+    pacer.setSource(PIXEL_SOURCE_EFFECT);
+    const uint32_t stepMs = 10;   // 效果速度 246 对应的步进间隔
+    uint32_t packetSteps[2] = {0, 0};
+    uint32_t lastStep = 0;
+    for (uint32_t t = 0; t < 2000; t += 5) {
+        bool packet = t < 1000;
+        if (packet && t - lastStep >= stepMs) {
+            packetSteps[t / 1000]++;
+            lastStep = t;
+        }
+    }
+
+    uint32_t pacedFrames[2] = {0, 0};
+    uint32_t start = now;
+    while (now - start < 2000000) {
+        uint32_t half = (now - start) / 1000000;
+        if (step(false, true, 1500) == PIXEL_RENDER_EFFECT && half < 2) pacedFrames[half]++;
+    }
+    printf("[bench] effect steps  per-packet: %u busy / %u idle   paced 40 fps: %u busy / %u idle\n",
+           packetSteps[0], packetSteps[1], pacedFrames[0], pacedFrames[1]);
+    TEST_ASSERT_EQUAL(0, packetSteps[1]);
+    TEST_ASSERT_INT_WITHIN(1, 40, pacedFrames[0]);
+    TEST_ASSERT_INT_WITHIN(1, 40, pacedFrames[1]);
+}
+
+void test_pacer_cost() {
+    BenchResult result = benchRun(1000000, [] {
+        PixelRenderKind kind = pacer.beginFrame(now, (now & 0x10000) != 0, true);
+        pacer.endFrame(now + 100, kind);
+        now += PERIOD_40;
+        benchKeep(&pacer);
+    });
+    benchReport("pacer begin + end frame", result);
+    TEST_ASSERT_TRUE(result.nsPerIter > 0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_fps_clamped);
+    RUN_TEST(test_slots_do_not_drift);
+    RUN_TEST(test_unchanged_slots_are_skipped);
+    RUN_TEST(test_late_and_missed_frames);
+    RUN_TEST(test_effect_source_ignores_dmx);
+    RUN_TEST(test_mixed_source_falls_back_to_effect);
+    RUN_TEST(test_clock_wraparound);
+    RUN_TEST(test_effect_rate_independent_of_packets);
+    RUN_TEST(test_pacer_cost);
+    return UNITY_END();
+}
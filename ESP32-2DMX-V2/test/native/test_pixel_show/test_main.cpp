@@ -0,0 +1,184 @@
+#include <unity.h>
+#include <string.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "pixels/PixelFeatures.h"
+#include "pixels/PixelFrameBuffer.h"
+#include "../bench.h"
+
+// 异步像素发送：网络任务写后台帧并发布，输出线程模拟 Show() 等待线路。
+// 检查部分更新、待发帧替换和无撕裂，并比较同步 / 异步两种方式下网络任务的最长阻塞
+
+static PixelFrameBuffer* frames;
+static uint8_t rgb[1360 * 3];
+
+void setUp() {
+    frames = new PixelFrameBuffer();
+    for (uint16_t i = 0; i < sizeof(rgb); i++) rgb[i] = (uint8_t)(i * 7 + 3);
+}
+
+void tearDown() {
+    delete frames;
+}
+
+// 只写一个宇宙时，其余像素沿用上一次发布的帧
+void test_partial_frame_keeps_other_pixels() {
+    frames->setLength(340 * 3);
+    pixelEncodeRun(TYPE_WS2812, frames->edit(), rgb, 340, 255);
+    TEST_ASSERT_TRUE(frames->publish());
+    TEST_ASSERT_TRUE(frames->acquire());
+
+    uint8_t second[170 * 3];
+    memset(second, 0x42, sizeof(second));
+    pixelEncodeRun(TYPE_WS2812, frames->edit() + 170 * 3, second, 170, 255);
+    TEST_ASSERT_TRUE(frames->publish());
+    TEST_ASSERT_TRUE(frames->acquire());
+
+    uint8_t expected[340 * 3];
+    PixelFeatureGrb::encodeRun(expected, rgb, 170, 255);
+    memset(expected + 170 * 3, 0x42, 170 * 3);
+    TEST_ASSERT_EQUAL_MEMORY(expected, frames->front(), sizeof(expected));
+}
+
+// 整帧重写不从上一帧补齐，同一帧内之后的 edit() 写进同一个缓冲
+void test_overwrite_skips_copy() {
+    frames->setLength(340 * 3);
+    memset(frames->edit(), 0x11, 340 * 3);
+    TEST_ASSERT_TRUE(frames->publish());
+    TEST_ASSERT_TRUE(frames->acquire());
+
+    uint8_t* back = frames->overwrite();
+    back[0] = 0x22;
+    TEST_ASSERT_EQUAL_PTR(back, frames->edit());
+    TEST_ASSERT_EQUAL(0x22, back[0]);
+    TEST_ASSERT_TRUE(back[1] != 0x11);   // 没有拷贝上一次发布的帧
+    pixelEncodeRun(TYPE_WS2812, back, rgb, 340, 255);
+    TEST_ASSERT_TRUE(frames->publish());
+    TEST_ASSERT_TRUE(frames->acquire());
+
+    uint8_t expected[340 * 3];
+    PixelFeatureGrb::encodeRun(expected, rgb, 340, 255);
+    TEST_ASSERT_EQUAL_MEMORY(expected, frames->front(), sizeof(expected));
+}
+
+// 没有写入时 show() 不发布，输出任务不会被无谓唤醒
+void test_publish_without_edit_is_noop() {
+    frames->setLength(30);
+    TEST_ASSERT_FALSE(frames->publish());
+    TEST_ASSERT_FALSE(frames->hasNewFrame());
+    frames->edit()[0] = 1;
+    TEST_ASSERT_TRUE(frames->hasUnpublished());
+    TEST_ASSERT_TRUE(frames->publish());
+    TEST_ASSERT_EQUAL(1, frames->getStats().published);
+}
+
+// 输出任务忙时新帧替换待发帧，醒来后只发最新的一帧
+void test_pending_frame_is_replaced() {
+    frames->setLength(3);
+    for (uint8_t i = 1; i <= 3; i++) {
+        frames->edit()[0] = i;
+        frames->publish();
+    }
+    TEST_ASSERT_EQUAL(3, frames->getStats().published);
+    TEST_ASSERT_EQUAL(2, frames->getStats().replaced);
+    TEST_ASSERT_TRUE(frames->acquire());
+    TEST_ASSERT_EQUAL(3, frames->front()[0]);
+    TEST_ASSERT_FALSE(frames->acquire());
+}
+
+void test_type_dispatch_matches_feature() {
+    uint8_t a[16], b[16];
+    pixelEncodeRun(TYPE_SK6812, a, rgb, 4, 200);
+    PixelFeatureGrbw::encodeRun(b, rgb, 4, 200);
+    TEST_ASSERT_EQUAL_MEMORY(b, a, 16);
+    pixelEncode(TYPE_APA102, a, 1, 2, 3);
+    PixelFeatureApa102::encode(b, 1, 2, 3);
+    TEST_ASSERT_EQUAL_MEMORY(b, a, 4);
+}
+
+struct ShowRun {
+    uint32_t maxBlockUs;
+    uint32_t published;
+    uint32_t shown;
+    uint32_t replaced;
+    bool torn;
+};
+
+// 网络线程每 intervalUs 写一整帧并 show()。同步方式在网络线程中等待线路，
+// 异步方式由输出线程等待，网络线程只发布
+static ShowRun runShow(uint16_t pixels, uint32_t wireUs, uint32_t intervalUs, bool async, uint32_t count) {
+    const uint16_t bytes = pixels * 3;
+    frames->setLength(bytes);
+    frames->resetStats();
+    std::atomic<bool> stop(false);
+    std::atomic<bool> torn(false);
+
+    auto output = [&] {
+        // 每帧所有字节相同，混入别的帧就是撕裂
+        const uint8_t* frame = frames->front();
+        for (uint16_t i = 1; i < bytes; i++) {
+            if (frame[i] != frame[0]) torn = true;
+        }
+        std::this_thread::sleep_for(std::chrono::microseconds(wireUs));
+        frames->recordOutput(wireUs);
+    };
+
+    std::thread outputThread;
+    if (async) {
+        outputThread = std::thread([&] {
+            while (!stop) {
+                if (frames->acquire()) {
+                    output();
+                } else {
+                    std::this_thread::sleep_for(std::chrono::microseconds(50));
+                }
+            }
+        });
+    }
+
+    for (uint32_t n = 1; n <= count; n++) {
+        memset(frames->edit(), (uint8_t)n, bytes);
+        uint64_t start = benchNowNs();
+        if (frames->publish() && !async && frames->acquire()) output();
+        frames->recordBlock((uint32_t)((benchNowNs() - start) / 1000));
+        std::this_thread::sleep_for(std::chrono::microseconds(intervalUs));
+    }
+    stop = true;
+    if (async) outputThread.join();
+
+    const PixelShowStats& stats = frames->getStats();
+    return {stats.maxBlockUs, stats.published, stats.shown, stats.replaced, torn.load()};
+}
+
+// 线路时间按 1/10 缩短；输入比线路快时异步方式替换待发帧，网络线程的阻塞远小于一帧
+void test_async_show_does_not_block_sender() {
+    const uint16_t sizes[] = {170, 1360};
+    for (uint16_t pixels : sizes) {
+        uint32_t wireUs = pixelFrameUs(TYPE_WS2812, pixels) / 10;
+        uint32_t intervalUs = wireUs / 2;
+        ShowRun sync = runShow(pixels, wireUs, intervalUs, false, 20);
+        ShowRun async = runShow(pixels, wireUs, intervalUs, true, 40);
+
+        printf("[bench] %4u px wire %5u us  sync max block %6u us  async max block %6u us  "
+               "(%u shown, %u replaced of %u)\n",
+               pixels, wireUs, sync.maxBlockUs, async.maxBlockUs, async.shown, async.replaced, async.published);
+        TEST_ASSERT_FALSE(sync.torn);
+        TEST_ASSERT_FALSE(async.torn);
+        TEST_ASSERT_TRUE(sync.maxBlockUs >= wireUs);
+        TEST_ASSERT_TRUE(async.maxBlockUs < wireUs);
+        TEST_ASSERT_TRUE(async.replaced > 0);
+        TEST_ASSERT_TRUE(async.shown < async.published);
+    }
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_partial_frame_keeps_other_pixels);
+    RUN_TEST(test_overwrite_skips_copy);
+    RUN_TEST(test_publish_without_edit_is_noop);
+    RUN_TEST(test_pending_frame_is_replaced);
+    RUN_TEST(test_type_dispatch_matches_feature);
+    RUN_TEST(test_async_show_does_not_block_sender);
+    return UNITY_END();
+}
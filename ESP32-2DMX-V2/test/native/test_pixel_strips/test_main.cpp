@@ -0,0 +1,130 @@
+#include <unity.h>
+#include <string.h>
+#include "pixels/PixelStripLayout.h"
+#include "../bench.h"
+
+static const uint16_t MAX_TOTAL = 1360;
+static uint8_t rgb[MAX_TOTAL * 3];
+static uint8_t wire[PIXEL_MAX_STRIPS][MAX_TOTAL * 3];
+
+static PixelStripLayout layout;
+
+// 按灯带切开全局像素，逐条编码进各自的缓冲
+static void encodeStrips(const PixelStripLayout& strips, const uint8_t* src) {
+    for (uint8_t strip = 0; strip < strips.getStripCount(); strip++) {
+        const uint8_t* in = src + strips.getStart(strip) * 3;
+        uint8_t* out = wire[strip];
+        for (uint16_t i = 0; i < strips.getCount(strip); i++, in += 3, out += PixelFeatureGrb::BYTES) {
+            PixelFeatureGrb::encode(out, in[0], in[1], in[2]);
+        }
+    }
+}
+
+void setUp() {
+    layout.clear();
+    for (uint16_t i = 0; i < sizeof(rgb); i++) rgb[i] = (uint8_t)(i * 13 + 5);
+    memset(wire, 0, sizeof(wire));
+}
+
+void tearDown() {}
+
+void test_strip_offsets() {
+    TEST_ASSERT_TRUE(layout.addStrip(100));
+    TEST_ASSERT_TRUE(layout.addStrip(170));
+    TEST_ASSERT_TRUE(layout.addStrip(30));
+    TEST_ASSERT_EQUAL(3, layout.getStripCount());
+    TEST_ASSERT_EQUAL(300, layout.getTotal());
+    TEST_ASSERT_EQUAL(0, layout.getStart(0));
+    TEST_ASSERT_EQUAL(100, layout.getStart(1));
+    TEST_ASSERT_EQUAL(270, layout.getStart(2));
+    TEST_ASSERT_EQUAL(30, layout.getCount(2));
+    TEST_ASSERT_EQUAL(0, layout.getCount(3));
+}
+
+void test_strip_of_pixel() {
+    layout.addStrip(100);
+    layout.addStrip(170);
+    TEST_ASSERT_EQUAL(0, layout.stripOf(0));
+    TEST_ASSERT_EQUAL(0, layout.stripOf(99));
+    TEST_ASSERT_EQUAL(1, layout.stripOf(100));
+    TEST_ASSERT_EQUAL(1, layout.stripOf(269));
+    TEST_ASSERT_EQUAL(2, layout.stripOf(270));
+}
+
+// 每条灯带独占自己的宇宙，不足一个宇宙的尾部也占一个
+void test_universes_per_strip() {
+    layout.addStrip(170);
+    layout.addStrip(171);
+    layout.addStrip(1);
+    TEST_ASSERT_EQUAL(1, layout.universeCount(0, 170));
+    TEST_ASSERT_EQUAL(2, layout.universeCount(1, 170));
+    TEST_ASSERT_EQUAL(1, layout.universeCount(2, 170));
+    TEST_ASSERT_EQUAL(0, layout.universeCount(3, 170));
+    TEST_ASSERT_EQUAL(0, layout.universeCount(0, 0));
+}
+
+// 总数超出时最后一条截短，之后的灯带放不下
+void test_total_clamped() {
+    for (uint8_t i = 0; i < 6; i++) TEST_ASSERT_TRUE(layout.addStrip(200, MAX_TOTAL));
+    TEST_ASSERT_TRUE(layout.addStrip(200, MAX_TOTAL));
+    TEST_ASSERT_EQUAL(MAX_TOTAL, layout.getTotal());
+    TEST_ASSERT_EQUAL(MAX_TOTAL - 1200, layout.getCount(6));
+    TEST_ASSERT_FALSE(layout.addStrip(1, MAX_TOTAL));
+    TEST_ASSERT_TRUE(layout.addStrip(1));
+    TEST_ASSERT_FALSE(layout.addStrip(1));
+    TEST_ASSERT_FALSE(layout.addStrip(0));
+}
+
+// 并行时一帧取最长的一条：8 x 170 个 WS2812 与单条 170 个相同，依次发送则是 8 倍
+void test_parallel_frame_time() {
+    for (uint8_t i = 0; i < PIXEL_MAX_STRIPS; i++) layout.addStrip(170);
+    uint32_t single = pixelFrameUs(TYPE_WS2812, 170);
+    TEST_ASSERT_EQUAL(single, layout.frameUs(TYPE_WS2812, true));
+    TEST_ASSERT_EQUAL(single * PIXEL_MAX_STRIPS, layout.frameUs(TYPE_WS2812, false));
+    TEST_ASSERT_TRUE(pixelFrameUs(TYPE_WS2812, MAX_TOTAL) > layout.frameUs(TYPE_WS2812, true) * 7);
+
+    layout.clear();
+    layout.addStrip(50);
+    layout.addStrip(120);
+    TEST_ASSERT_EQUAL(pixelFrameUs(TYPE_SK6812, 120), layout.frameUs(TYPE_SK6812, true));
+}
+
+void test_encode_keeps_strip_boundaries() {
+    layout.addStrip(3);
+    layout.addStrip(2);
+    encodeStrips(layout, rgb);
+    // 第二条灯带的第 0 个像素是全局第 3 个
+    TEST_ASSERT_EQUAL(rgb[3 * 3 + 1], wire[1][0]);
+    TEST_ASSERT_EQUAL(rgb[3 * 3 + 0], wire[1][1]);
+    TEST_ASSERT_EQUAL(rgb[3 * 3 + 2], wire[1][2]);
+    TEST_ASSERT_EQUAL(0, wire[1][2 * 3]);
+}
+
+void test_strip_frame_cost() {
+    const uint32_t iterations = 2000;
+    for (uint8_t i = 0; i < PIXEL_MAX_STRIPS; i++) layout.addStrip(170, MAX_TOTAL);
+    BenchResult eight = benchRun(iterations, [] { encodeStrips(layout, rgb); benchKeep(wire); });
+
+    static PixelStripLayout one;
+    one.clear();
+    one.addStrip(MAX_TOTAL);
+    BenchResult flat = benchRun(iterations, [] { encodeStrips(one, rgb); benchKeep(wire); });
+
+    benchReport("8 x 170 strips encode / frame", eight);
+    benchReport("1 x 1360 strip encode / frame", flat);
+    printf("[bench] %-40s %10u us wire time\n", "8 x 170 WS2812 parallel", layout.frameUs(TYPE_WS2812, true));
+    printf("[bench] %-40s %10u us wire time\n", "1 x 1360 WS2812 single pin", one.frameUs(TYPE_WS2812, false));
+    TEST_ASSERT_TRUE(eight.nsPerIter > 0 && flat.nsPerIter > 0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_strip_offsets);
+    RUN_TEST(test_strip_of_pixel);
+    RUN_TEST(test_universes_per_strip);
+    RUN_TEST(test_total_clamped);
+    RUN_TEST(test_parallel_frame_time);
+    RUN_TEST(test_encode_keeps_strip_boundaries);
+    RUN_TEST(test_strip_frame_cost);
+    return UNITY_END();
+}
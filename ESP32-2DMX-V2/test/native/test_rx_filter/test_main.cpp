@@ -0,0 +1,137 @@
+#include <unity.h>
+#include <string.h>
+#include "artnet/ArtnetPacket.h"
+#include "artnet/ArtnetRxFilter.h"
+#include "artnet/UniverseRouter.h"
+#include "../bench.h"
+
+// 控台在同一网段广播 200 个宇宙，本节点只订阅其中 10 个（2 路 DMX + 8 段像素）。
+// 对比两种处理方式花在无关宇宙上的 CPU：
+//   旧：整包读入 1024 字节接收缓冲，再校验、解析、查表
+//   新：只读 18 字节包头，查订阅位图后丢弃
+
+#define STREAM_UNIVERSES 200
+#define SUBSCRIBED 10
+#define FRAME_RATE 44
+#define PACKET_SIZE (ART_DMX_HEADER_SIZE + ARTNET_DMX_LENGTH)
+
+static uint8_t stream[STREAM_UNIVERSES][PACKET_SIZE];
+static uint8_t artnetBuffer[1024];
+static UniverseRouter router;
+
+static void buildStream() {
+    for (uint16_t u = 0; u < STREAM_UNIVERSES; u++) {
+        uint8_t* packet = stream[u];
+        memset(packet, 0, PACKET_SIZE);
+        memcpy(packet, ArtnetPacket::ID, 8);
+        packet[8] = OpDmx & 0xFF;
+        packet[9] = OpDmx >> 8;
+        packet[11] = ARTNET_VERSION;
+        packet[12] = 1;
+        // 跨越多个 Net/SubNet
+        uint16_t pa = ((u / 16) << 4) | (u % 16);
+        packet[14] = pa & 0xFF;
+        packet[15] = pa >> 8;
+        packet[16] = ARTNET_DMX_LENGTH >> 8;
+        packet[17] = ARTNET_DMX_LENGTH & 0xFF;
+        for (uint16_t i = 0; i < ARTNET_DMX_LENGTH; i++) {
+            packet[ART_DMX_HEADER_SIZE + i] = (uint8_t)(u + i);
+        }
+    }
+}
+
+// 旧方式：整包拷贝后再判断
+__attribute__((noinline)) static bool legacyReceive(const uint8_t* packet, uint16_t size) {
+    memcpy(artnetBuffer, packet, size);
+    benchKeep(artnetBuffer);
+    if (!ArtnetPacket::hasValidId(artnetBuffer, size)) return false;
+    if (ArtnetPacket::getOpCode(artnetBuffer) != OpDmx) return false;
+    ArtDmxPacket dmx;
+    if (!ArtnetPacket::parseArtDmx(artnetBuffer, size, dmx)) return false;
+    return router.lookup(dmx.portAddress) != nullptr;
+}
+
+// 新方式：只拷贝包头
+__attribute__((noinline)) static bool peekReceive(const uint8_t* packet, uint16_t size) {
+    memcpy(artnetBuffer, packet, ART_DMX_HEADER_SIZE);
+    benchKeep(artnetBuffer);
+    return artnetRxWanted(artnetBuffer, size, router);
+}
+
+void setUp() {
+    router.clear();
+    for (uint16_t pa = 0; pa < SUBSCRIBED; pa++) {
+        router.addRoute(pa, pa < 2 ? OUTPUT_DMX : OUTPUT_PIXEL, pa < 2 ? pa : pa - 2);
+    }
+}
+
+void tearDown() {
+}
+
+void test_peek_filter_matches_full_parse() {
+    uint16_t wanted = 0;
+    for (uint16_t u = 0; u < STREAM_UNIVERSES; u++) {
+        bool legacy = legacyReceive(stream[u], PACKET_SIZE);
+        TEST_ASSERT_EQUAL(legacy, peekReceive(stream[u], PACKET_SIZE));
+        if (legacy) wanted++;
+    }
+    TEST_ASSERT_EQUAL_UINT16(SUBSCRIBED, wanted);
+}
+
+void test_peek_filter_rejects_short_and_foreign_packets() {
+    uint8_t packet[PACKET_SIZE];
+    memcpy(packet, stream[0], PACKET_SIZE);
+
+    // 包头不完整的 ArtDmx
+    TEST_ASSERT_FALSE(artnetRxWanted(packet, ART_DMX_HEADER_SIZE - 1, router));
+
+    // Net 字节不同
+    packet[15] = 0x01;
+    TEST_ASSERT_FALSE(artnetRxWanted(packet, PACKET_SIZE, router));
+
+    // 控制类包总是保留
+    packet[8] = OpPoll & 0xFF;
+    packet[9] = OpPoll >> 8;
+    TEST_ASSERT_TRUE(artnetRxWanted(packet, 14, router));
+
+    packet[0] = 'a';
+    TEST_ASSERT_FALSE(artnetRxWanted(packet, 14, router));
+}
+
+void test_bench_unwanted_traffic_cost() {
+    // 只统计无关宇宙
+    const uint16_t first = SUBSCRIBED;
+    const uint16_t unwanted = STREAM_UNIVERSES - SUBSCRIBED;
+
+    BenchResult legacy = benchRun(2000, [&] {
+        for (uint16_t u = first; u < STREAM_UNIVERSES; u++) {
+            benchKeep((void*)(uintptr_t)legacyReceive(stream[u], PACKET_SIZE));
+        }
+    });
+    BenchResult peek = benchRun(2000, [&] {
+        for (uint16_t u = first; u < STREAM_UNIVERSES; u++) {
+            benchKeep((void*)(uintptr_t)peekReceive(stream[u], PACKET_SIZE));
+        }
+    });
+
+    double packetsPerSecond = (double)unwanted * FRAME_RATE;
+    double legacyNs = legacy.nsPerIter / unwanted;
+    double peekNs = peek.nsPerIter / unwanted;
+
+    benchReport("full read + parse, 190 foreign universes", legacy);
+    benchReport("18-byte peek + bitmap, 190 foreign", peek);
+    printf("[bench] %u foreign universes @ %d Hz = %.0f packets/s\n", unwanted, FRAME_RATE, packetsPerSecond);
+    printf("[bench]   full read:  %6.1f ns/packet  %8.1f us CPU per second\n",
+           legacyNs, legacyNs * packetsPerSecond / 1000.0);
+    printf("[bench]   peek:       %6.1f ns/packet  %8.1f us CPU per second\n",
+           peekNs, peekNs * packetsPerSecond / 1000.0);
+}
+
+int main(int argc, char** argv) {
+    buildStream();
+    UNITY_BEGIN();
+    RUN_TEST(test_peek_filter_matches_full_parse);
+    RUN_TEST(test_peek_filter_rejects_short_and_foreign_packets);
+    RUN_TEST(test_bench_unwanted_traffic_cost);
+    return UNITY_END();
+}
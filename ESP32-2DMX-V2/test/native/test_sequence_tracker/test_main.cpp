@@ -0,0 +1,110 @@
+#include <unity.h>
+#include "artnet/SequenceTracker.h"
+
+static const uint32_t CONSOLE_IP = 0x0A00000A;   // 10.0.0.10
+static const uint32_t OTHER_IP = 0x0A00000B;
+
+static SequenceTracker tracker;
+
+void setUp() {
+    tracker.reset();
+}
+
+void tearDown() {
+}
+
+void test_in_order_stream_has_no_loss() {
+    uint32_t now = 0;
+    for (int i = 0; i < 600; i++) {
+        uint8_t seq = (uint8_t)(i % 255 + 1);   // 1..255 循环
+        TEST_ASSERT_TRUE(tracker.check(0, CONSOLE_IP, seq, now));
+        now += 23;
+    }
+    const SequenceStats& stats = tracker.getStats(0);
+    TEST_ASSERT_EQUAL_UINT32(600, stats.received);
+    TEST_ASSERT_EQUAL_UINT32(600, stats.accepted);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.lost);
+    TEST_ASSERT_EQUAL_UINT32(0, stats.resync);
+}
+
+void test_gap_counts_lost_packets() {
+    tracker.check(0, CONSOLE_IP, 10, 0);
+    TEST_ASSERT_TRUE(tracker.check(0, CONSOLE_IP, 14, 25));
+    TEST_ASSERT_EQUAL_UINT32(3, tracker.getStats(0).lost);
+
+    // 跨越 255 -> 1 的回绕：254 之后是 2，丢了 255 和 1
+    tracker.check(1, CONSOLE_IP, 254, 0);
+    TEST_ASSERT_TRUE(tracker.check(1, CONSOLE_IP, 2, 25));
+    TEST_ASSERT_EQUAL_UINT32(2, tracker.getStats(1).lost);
+}
+
+void test_duplicate_is_rejected() {
+    tracker.check(0, CONSOLE_IP, 50, 0);
+    TEST_ASSERT_FALSE(tracker.check(0, CONSOLE_IP, 50, 1));
+    TEST_ASSERT_EQUAL_UINT32(1, tracker.getStats(0).duplicate);
+}
+
+void test_late_packet_is_rejected_and_not_counted_lost() {
+    tracker.check(0, CONSOLE_IP, 1, 0);
+    tracker.check(0, CONSOLE_IP, 3, 10);      // 2 暂时计为丢失
+    TEST_ASSERT_EQUAL_UINT32(1, tracker.getStats(0).lost);
+
+    // 2 迟到：不能覆盖更新的帧 3
+    TEST_ASSERT_FALSE(tracker.check(0, CONSOLE_IP, 2, 12));
+    TEST_ASSERT_EQUAL_UINT32(1, tracker.getStats(0).reordered);
+    TEST_ASSERT_EQUAL_UINT32(0, tracker.getStats(0).lost);
+
+    // 回绕边界上的迟到帧：当前 1，收到 255
+    tracker.check(1, CONSOLE_IP, 1, 0);
+    TEST_ASSERT_FALSE(tracker.check(1, CONSOLE_IP, 255, 1));
+}
+
+void test_zero_sequence_disables_checking() {
+    TEST_ASSERT_TRUE(tracker.check(0, CONSOLE_IP, 0, 0));
+    TEST_ASSERT_TRUE(tracker.check(0, CONSOLE_IP, 0, 1));
+    TEST_ASSERT_TRUE(tracker.check(0, CONSOLE_IP, 0, 2));
+    TEST_ASSERT_EQUAL_UINT32(0, tracker.getStats(0).duplicate);
+}
+
+void test_sources_are_tracked_independently() {
+    tracker.check(0, CONSOLE_IP, 100, 0);
+    // 另一个控台的序号与第一个无关，不算乱序
+    TEST_ASSERT_TRUE(tracker.check(0, OTHER_IP, 20, 1));
+    TEST_ASSERT_TRUE(tracker.check(0, CONSOLE_IP, 101, 2));
+    TEST_ASSERT_TRUE(tracker.check(0, OTHER_IP, 21, 3));
+    TEST_ASSERT_EQUAL_UINT32(0, tracker.getStats(0).reordered);
+    TEST_ASSERT_EQUAL_UINT32(0, tracker.getStats(0).lost);
+}
+
+void test_resync_after_idle() {
+    tracker.check(0, CONSOLE_IP, 200, 0);
+    // 控台重启后从 1 开始：看起来是落后的帧，但源已空闲超过 1 秒
+    TEST_ASSERT_TRUE(tracker.check(0, CONSOLE_IP, 180, SequenceTracker::RESYNC_IDLE_MS + 5));
+    TEST_ASSERT_EQUAL_UINT32(1, tracker.getStats(0).resync);
+}
+
+void test_resync_after_repeated_rejects() {
+    tracker.check(0, CONSOLE_IP, 200, 0);
+    uint32_t now = 1;
+    uint8_t seq = 150;
+    for (int i = 0; i < SequenceTracker::RESYNC_REJECTS; i++) {
+        TEST_ASSERT_FALSE(tracker.check(0, CONSOLE_IP, seq++, now++));
+    }
+    // 连续被拒绝后接受新序号，之后正常跟踪
+    TEST_ASSERT_TRUE(tracker.check(0, CONSOLE_IP, seq++, now++));
+    TEST_ASSERT_TRUE(tracker.check(0, CONSOLE_IP, seq++, now++));
+    TEST_ASSERT_EQUAL_UINT32(1, tracker.getStats(0).resync);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_in_order_stream_has_no_loss);
+    RUN_TEST(test_gap_counts_lost_packets);
+    RUN_TEST(test_duplicate_is_rejected);
+    RUN_TEST(test_late_packet_is_rejected_and_not_counted_lost);
+    RUN_TEST(test_zero_sequence_disables_checking);
+    RUN_TEST(test_sources_are_tracked_independently);
+    RUN_TEST(test_resync_after_idle);
+    RUN_TEST(test_resync_after_repeated_rejects);
+    return UNITY_END();
+}
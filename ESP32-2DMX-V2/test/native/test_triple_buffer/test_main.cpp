@@ -0,0 +1,163 @@
+#include <unity.h>
+#include <string.h>
+#include <atomic>
+#include <thread>
+#include "dmx/TripleBuffer.h"
+#include "dmx/DmxFrameBuffer.h"
+#include "../bench.h"
+
+// 每一帧的所有通道都写入同一个帧号，读者检查是否混入了别的帧
+
+static void fillFrame(DmxFrameBuffer& buffer, uint32_t frameNumber) {
+    uint8_t slots[DMX_SLOT_COUNT];
+    memcpy(slots, &frameNumber, sizeof(frameNumber));
+    memset(slots + 4, frameNumber & 0xFF, DMX_SLOT_COUNT - 4);
+    buffer.writeSlots(slots, DMX_SLOT_COUNT);
+}
+
+static bool frameIsConsistent(const DmxFrame& frame, uint32_t& frameNumber) {
+    memcpy(&frameNumber, frame.slots(), sizeof(frameNumber));
+    for (uint16_t i = 4; i < DMX_SLOT_COUNT; i++) {
+        if (frame.slots()[i] != (frameNumber & 0xFF)) return false;
+    }
+    return true;
+}
+
+void setUp() {
+}
+
+void tearDown() {
+}
+
+void test_reader_sees_newest_frame() {
+    TripleBuffer<int> buffer;
+    TEST_ASSERT_FALSE(buffer.consume());
+
+    // 读者未取走时，新发布的帧替换上一帧
+    buffer.writeBuffer() = 1;
+    TEST_ASSERT_FALSE(buffer.publish());
+    buffer.writeBuffer() = 2;
+    TEST_ASSERT_TRUE(buffer.publish());
+    buffer.writeBuffer() = 3;
+    TEST_ASSERT_TRUE(buffer.publish());
+
+    // 中间两帧被跳过，读者直接拿到最新的一帧
+    TEST_ASSERT_TRUE(buffer.consume());
+    TEST_ASSERT_EQUAL(3, buffer.readBuffer());
+    TEST_ASSERT_FALSE(buffer.consume());
+    TEST_ASSERT_EQUAL(3, buffer.readBuffer());
+}
+
+void test_uncommitted_frame_is_invisible() {
+    DmxFrameBuffer buffer;
+    uint8_t value = 0x42;
+    buffer.writeSlots(&value, 1);
+    TEST_ASSERT_FALSE(buffer.acquire());
+    TEST_ASSERT_TRUE(buffer.commit());
+    TEST_ASSERT_FALSE(buffer.commit());
+    TEST_ASSERT_TRUE(buffer.acquire());
+    TEST_ASSERT_EQUAL_HEX8(0x42, buffer.front().slots()[0]);
+}
+
+void test_partial_write_keeps_other_slots() {
+    DmxFrameBuffer buffer;
+    uint8_t full[DMX_SLOT_COUNT];
+    memset(full, 0x11, sizeof(full));
+    buffer.writeSlots(full, DMX_SLOT_COUNT);
+    buffer.commit();
+
+    // 连续几帧只改一个通道，其余通道必须沿用上一帧
+    for (uint8_t i = 0; i < 5; i++) {
+        uint8_t value = 0x80 + i;
+        buffer.writeSlots(&value, 1, 100);
+        buffer.commit();
+    }
+
+    TEST_ASSERT_TRUE(buffer.acquire());
+    const DmxFrame& frame = buffer.front();
+    TEST_ASSERT_EQUAL(DMX_SLOT_COUNT, frame.length);
+    TEST_ASSERT_EQUAL_HEX8(0x84, frame.slots()[100]);
+    TEST_ASSERT_EQUAL_HEX8(0x11, frame.slots()[99]);
+    TEST_ASSERT_EQUAL_HEX8(0x11, frame.slots()[101]);
+    TEST_ASSERT_EQUAL_HEX8(0x11, frame.slots()[DMX_SLOT_COUNT - 1]);
+}
+
+// 网络线程全速发布，DMX线程按帧边界读取；检查无撕裂帧、帧号单调、两端都不阻塞
+void test_two_thread_stress_no_torn_frames() {
+    static DmxFrameBuffer buffer;
+    const uint32_t frameTarget = 200000;
+
+    std::atomic<bool> done(false);
+    std::atomic<uint32_t> torn(0);
+    std::atomic<uint32_t> backwards(0);
+    std::atomic<uint32_t> framesRead(0);
+    std::atomic<uint64_t> maxWriterNs(0);
+    std::atomic<uint64_t> maxReaderNs(0);
+
+    std::thread writer([&] {
+        uint64_t worst = 0;
+        for (uint32_t n = 1; n <= frameTarget; n++) {
+            fillFrame(buffer, n);
+            uint64_t start = benchNowNs();
+            buffer.commit();
+            uint64_t elapsed = benchNowNs() - start;
+            if (elapsed > worst) worst = elapsed;
+        }
+        maxWriterNs = worst;
+        done = true;
+    });
+
+    std::thread reader([&] {
+        uint32_t last = 0;
+        uint64_t worst = 0;
+        while (!done || buffer.hasNewFrame()) {
+            uint64_t start = benchNowNs();
+            bool fresh = buffer.acquire();
+            uint64_t elapsed = benchNowNs() - start;
+            if (elapsed > worst) worst = elapsed;
+            if (!fresh) continue;
+
+            uint32_t frameNumber;
+            if (!frameIsConsistent(buffer.front(), frameNumber)) torn++;
+            if (frameNumber <= last) backwards++;
+            last = frameNumber;
+            framesRead++;
+        }
+        // 最后读到的一定是最后发布的帧
+        if (last != frameTarget) backwards++;
+        maxReaderNs = worst;
+    });
+
+    writer.join();
+    reader.join();
+
+    printf("[bench] frames published %u, frames read %u, worst commit %llu ns, worst acquire %llu ns\n",
+           frameTarget, framesRead.load(),
+           (unsigned long long)maxWriterNs.load(), (unsigned long long)maxReaderNs.load());
+
+    TEST_ASSERT_EQUAL(0, torn.load());
+    TEST_ASSERT_EQUAL(0, backwards.load());
+    TEST_ASSERT_GREATER_THAN(0, framesRead.load());
+}
+
+void test_handoff_cost() {
+    static DmxFrameBuffer buffer;
+    uint8_t value = 1;
+    BenchResult result = benchRun(1000000, [&] {
+        buffer.writeSlots(&value, 1, 0);
+        buffer.commit();
+        buffer.acquire();
+    });
+    benchReport("write 1 slot + commit + acquire", result);
+    TEST_ASSERT_TRUE(result.nsPerIter > 0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_reader_sees_newest_frame);
+    RUN_TEST(test_uncommitted_frame_is_invisible);
+    RUN_TEST(test_partial_write_keeps_other_slots);
+    RUN_TEST(test_two_thread_stress_no_torn_frames);
+    RUN_TEST(test_handoff_cost);
+    return UNITY_END();
+}
@@ -0,0 +1,201 @@
+#include <unity.h>
+#include <string.h>
+#include "artnet/ArtnetPacket.h"
+#include "artnet/UniverseRouter.h"
+#include "artnet/ArtDmxDispatch.h"
+
+// 模拟输出：2 路 DMX + 8 段像素，每个输出记录最后收到的宇宙数据
+static uint8_t dmxOut[2][ARTNET_DMX_LENGTH];
+static uint8_t pixelOut[8][ARTNET_DMX_LENGTH];
+static uint16_t dmxHits[2];
+static uint16_t pixelHits[8];
+
+static UniverseRouter router;
+static SequenceTracker sequences;
+
+// 构造 ArtDmx 包，通道数据全部填充 fill
+static uint16_t buildArtDmx(uint8_t* buf, uint16_t portAddress, uint8_t fill, uint16_t length) {
+    memset(buf, 0, ART_DMX_HEADER_SIZE + length);
+    memcpy(buf, ArtnetPacket::ID, 8);
+    buf[8] = OpDmx & 0xFF;
+    buf[9] = OpDmx >> 8;
+    buf[11] = ARTNET_VERSION;
+    buf[14] = portAddress & 0xFF;
+    buf[15] = (portAddress >> 8) & 0x7F;
+    buf[16] = length >> 8;
+    buf[17] = length & 0xFF;
+    memset(buf + ART_DMX_HEADER_SIZE, fill, length);
+    return ART_DMX_HEADER_SIZE + length;
+}
+
+// 按路由的输出类型记录收到的数据
+struct RecordingSink {
+    bool output(const UniverseRoute& route, const ArtDmxPacket& packet) {
+        if (route.type == OUTPUT_DMX) {
+            memcpy(dmxOut[route.index], packet.data, packet.length);
+            dmxHits[route.index]++;
+        } else if (route.type == OUTPUT_PIXEL) {
+            memcpy(pixelOut[route.index], packet.data, packet.length);
+            pixelHits[route.index]++;
+        }
+        return true;
+    }
+};
+
+static const uint32_t CONSOLE_IP = 0x0A000001;
+
+// 与 ArtnetNode::handleArtDmx 相同的 dispatchArtDmx()，只是输出换成记录
+static bool dispatch(const uint8_t* buf, uint16_t size, uint32_t nowMs = 0) {
+    RecordingSink sink;
+    return dispatchArtDmx(buf, size, CONSOLE_IP, nowMs, router, sequences, sink) != nullptr;
+}
+
+void setUp() {
+    router.clear();
+    sequences.reset();
+    memset(dmxOut, 0, sizeof(dmxOut));
+    memset(pixelOut, 0, sizeof(pixelOut));
+    memset(dmxHits, 0, sizeof(dmxHits));
+    memset(pixelHits, 0, sizeof(pixelHits));
+}
+
+void tearDown() {
+}
+
+void test_port_address_uses_net_byte() {
+    uint8_t buf[ART_DMX_HEADER_SIZE + 2];
+    uint16_t pa = ArtnetPacket::makePortAddress(0x12, 0x3, 0x4);
+    TEST_ASSERT_EQUAL_HEX16(0x1234, pa);
+
+    uint16_t size = buildArtDmx(buf, pa, 0, 2);
+    ArtDmxPacket packet;
+    TEST_ASSERT_TRUE(ArtnetPacket::parseArtDmx(buf, size, packet));
+    TEST_ASSERT_EQUAL_HEX16(0x1234, packet.portAddress);
+}
+
+void test_unsubscribed_universe_is_dropped() {
+    router.addRoute(0x0000, OUTPUT_DMX, 0);
+    TEST_ASSERT_NULL(router.lookup(0x0001));
+    // 只有 Net 不同也必须丢弃
+    TEST_ASSERT_NULL(router.lookup(0x0100));
+    TEST_ASSERT_NOT_NULL(router.lookup(0x0000));
+}
+
+void test_subscription_bitmap_matches_lookup() {
+    router.addRoute(0x0000, OUTPUT_DMX, 0);
+    router.addRoute(0x001F, OUTPUT_PIXEL, 0);
+    router.addRoute(0x0020, OUTPUT_PIXEL, 1);
+    router.addRoute(0x7FFF, OUTPUT_PIXEL, 2);
+
+    // 全部 32768 个 Port-Address 上位图与查表结果一致
+    for (uint32_t pa = 0; pa < UniverseRouter::PORT_ADDRESS_COUNT; pa++) {
+        TEST_ASSERT_EQUAL((router.lookup(pa) != nullptr), router.isSubscribed(pa));
+    }
+
+    router.clear();
+    TEST_ASSERT_FALSE(router.isSubscribed(0x0000));
+    TEST_ASSERT_FALSE(router.isSubscribed(0x7FFF));
+}
+
+void test_mixed_universe_traffic_lands_on_right_output() {
+    // DMX A / B 在 Net 0，像素段跨越两个 Net/SubNet 页
+    const uint16_t dmxAddress[2] = {0x0000, 0x0001};
+    const uint16_t pixelAddress[8] = {0x0002, 0x0003, 0x000E, 0x000F, 0x0010, 0x0011, 0x7F00, 0x7FFF};
+
+    for (uint8_t i = 0; i < 2; i++) {
+        TEST_ASSERT_TRUE(router.addRoute(dmxAddress[i], OUTPUT_DMX, i));
+    }
+    for (uint8_t i = 0; i < 8; i++) {
+        TEST_ASSERT_TRUE(router.addRoute(pixelAddress[i], OUTPUT_PIXEL, i));
+    }
+    TEST_ASSERT_EQUAL(10, router.getRouteCount());
+
+    // 交错发送已订阅和未订阅的宇宙
+    uint8_t buf[ART_DMX_HEADER_SIZE + ARTNET_DMX_LENGTH];
+    uint16_t accepted = 0;
+    for (uint8_t round = 0; round < 3; round++) {
+        for (uint8_t i = 0; i < 8; i++) {
+            accepted += dispatch(buf, buildArtDmx(buf, pixelAddress[i], 0x40 + i, ARTNET_DMX_LENGTH));
+            accepted += dispatch(buf, buildArtDmx(buf, 0x0100 + i, 0xEE, ARTNET_DMX_LENGTH));
+            if (i < 2) {
+                accepted += dispatch(buf, buildArtDmx(buf, dmxAddress[i], 0x10 + i, 24));
+            }
+        }
+    }
+    TEST_ASSERT_EQUAL(3 * 10, accepted);
+
+    for (uint8_t i = 0; i < 2; i++) {
+        TEST_ASSERT_EQUAL(3, dmxHits[i]);
+        TEST_ASSERT_EQUAL_HEX8(0x10 + i, dmxOut[i][0]);
+        TEST_ASSERT_EQUAL_HEX8(0x10 + i, dmxOut[i][23]);
+        TEST_ASSERT_EQUAL_HEX8(0x00, dmxOut[i][24]);
+    }
+    for (uint8_t i = 0; i < 8; i++) {
+        TEST_ASSERT_EQUAL(3, pixelHits[i]);
+        TEST_ASSERT_EQUAL_HEX8(0x40 + i, pixelOut[i][0]);
+        TEST_ASSERT_EQUAL_HEX8(0x40 + i, pixelOut[i][ARTNET_DMX_LENGTH - 1]);
+    }
+}
+
+void test_slots_follow_subscription_order() {
+    router.addRoute(0x0105, OUTPUT_DMX, 1);
+    router.addRoute(0x0003, OUTPUT_PIXEL, 0);
+    router.addRoute(0x0105, OUTPUT_DMX, 0);  // 覆盖输出，不占用新序号
+
+    TEST_ASSERT_EQUAL(2, router.getRouteCount());
+    TEST_ASSERT_EQUAL(0, router.lookup(0x0105)->slot);
+    TEST_ASSERT_EQUAL(0, router.lookup(0x0105)->index);
+    TEST_ASSERT_EQUAL(1, router.lookup(0x0003)->slot);
+    TEST_ASSERT_EQUAL_HEX16(0x0003, router.getPortAddress(1));
+}
+
+void test_capacity_limits() {
+    // 页数上限：每个 Net/SubNet 组合占用一页
+    for (uint8_t page = 0; page < UniverseRouter::MAX_PAGES; page++) {
+        TEST_ASSERT_TRUE(router.addRoute(page << 4, OUTPUT_PIXEL, page));
+    }
+    TEST_ASSERT_FALSE(router.addRoute(UniverseRouter::MAX_PAGES << 4, OUTPUT_PIXEL, 0));
+
+    // 宇宙数上限
+    router.clear();
+    for (uint8_t i = 0; i < UniverseRouter::MAX_ROUTES; i++) {
+        TEST_ASSERT_TRUE(router.addRoute(i, OUTPUT_PIXEL, i));
+    }
+    TEST_ASSERT_FALSE(router.addRoute(0x0010, OUTPUT_PIXEL, 0));
+}
+
+// 分发时按路由序号检查序号：重复帧不写入输出
+void test_duplicate_sequence_is_not_dispatched() {
+    router.addRoute(0x0000, OUTPUT_DMX, 0);
+    uint8_t buf[ART_DMX_HEADER_SIZE + 24];
+    uint16_t size = buildArtDmx(buf, 0x0000, 0x33, 24);
+    buf[12] = 7;
+    TEST_ASSERT_TRUE(dispatch(buf, size, 0));
+    TEST_ASSERT_FALSE(dispatch(buf, size, 1));
+    buf[12] = 8;
+    TEST_ASSERT_TRUE(dispatch(buf, size, 2));
+    TEST_ASSERT_EQUAL(2, dmxHits[0]);
+}
+
+void test_truncated_packet_is_clamped() {
+    uint8_t buf[ART_DMX_HEADER_SIZE + ARTNET_DMX_LENGTH];
+    buildArtDmx(buf, 0, 0x55, ARTNET_DMX_LENGTH);
+
+    ArtDmxPacket packet;
+    TEST_ASSERT_FALSE(ArtnetPacket::parseArtDmx(buf, ART_DMX_HEADER_SIZE - 1, packet));
+    TEST_ASSERT_TRUE(ArtnetPacket::parseArtDmx(buf, ART_DMX_HEADER_SIZE + 100, packet));
+    TEST_ASSERT_EQUAL(100, packet.length);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_port_address_uses_net_byte);
+    RUN_TEST(test_unsubscribed_universe_is_dropped);
+    RUN_TEST(test_subscription_bitmap_matches_lookup);
+    RUN_TEST(test_mixed_universe_traffic_lands_on_right_output);
+    RUN_TEST(test_slots_follow_subscription_order);
+    RUN_TEST(test_capacity_limits);
+    RUN_TEST(test_duplicate_sequence_is_not_dispatched);
+    RUN_TEST(test_truncated_packet_is_clamped);
+    return UNITY_END();
+}
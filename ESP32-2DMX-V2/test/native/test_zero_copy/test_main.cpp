@@ -0,0 +1,164 @@
+#include <unity.h>
+#include <string.h>
+#include "artnet/ArtnetPacket.h"
+#include "dmx/DmxFrame.h"
+#include "../bench.h"
+
+// 对比旧的多次拷贝路径和新的单次拷贝路径：
+//   旧：artnetBuffer -> dmxBuffer -> ESP32DMX::dmxBuffer / pixelBuffer -> setPixel()
+//   新：就地解析 -> 输出帧 / 像素缓冲，各写一次
+
+#define PIXEL_BYTES 510
+
+static uint8_t rxBuffer[ART_DMX_HEADER_SIZE + ARTNET_DMX_LENGTH];
+static uint16_t rxSize;
+static uint32_t bytesCopied;
+
+// 计数拷贝
+static void countedCopy(uint8_t* dst, const uint8_t* src, uint16_t length) {
+    memcpy(dst, src, length);
+    bytesCopied += length;
+}
+
+// 模拟旧版 PixelDriver::setPixel：每个像素一次校验 + 亮度 + 写入
+struct FakeStrip {
+    uint8_t pixels[PIXEL_BYTES];
+    uint16_t numPixels;
+    uint8_t brightness;
+
+    __attribute__((noinline)) void setPixel(uint16_t index, uint8_t r, uint8_t g, uint8_t b) {
+        if (index >= numPixels) return;
+        if (brightness != 255) {
+            r = (r * brightness) >> 8;
+            g = (g * brightness) >> 8;
+            b = (b * brightness) >> 8;
+        }
+        uint8_t* p = pixels + index * 3;
+        p[0] = g;
+        p[1] = r;
+        p[2] = b;
+        bytesCopied += 3;
+    }
+
+    void handleDMX(const uint8_t* data, uint16_t length) {
+        uint16_t count = length / 3;
+        for (uint16_t i = 0; i < count; i++) {
+            setPixel(i, data[i * 3], data[i * 3 + 1], data[i * 3 + 2]);
+        }
+    }
+};
+
+// 旧路径的缓冲区
+static uint8_t legacyDmxBuffer[ARTNET_DMX_LENGTH];
+static uint8_t legacyPortBuffer[ARTNET_DMX_LENGTH + 1];
+static uint8_t legacyPixelBuffer[PIXEL_BYTES];
+
+static DmxFrame frame;
+static FakeStrip strip;
+
+static void legacyPath(bool pixelUniverse) {
+    uint16_t length = (rxBuffer[16] << 8) | rxBuffer[17];
+    countedCopy(legacyDmxBuffer, &rxBuffer[18], length);
+    if (!pixelUniverse) {
+        countedCopy(legacyPortBuffer + 1, legacyDmxBuffer, length);
+    } else {
+        countedCopy(legacyPixelBuffer, legacyDmxBuffer, PIXEL_BYTES);
+        strip.handleDMX(legacyPixelBuffer, PIXEL_BYTES);
+    }
+}
+
+static void singleCopyPath(bool pixelUniverse) {
+    ArtDmxPacket packet;
+    if (!ArtnetPacket::parseArtDmx(rxBuffer, rxSize, packet)) return;
+    if (!pixelUniverse) {
+        bytesCopied += frame.writeSlots(packet.data, packet.length);
+    } else {
+        strip.handleDMX(packet.data, PIXEL_BYTES);
+    }
+}
+
+void setUp() {
+    memset(rxBuffer, 0, sizeof(rxBuffer));
+    memcpy(rxBuffer, ArtnetPacket::ID, 8);
+    rxBuffer[8] = OpDmx & 0xFF;
+    rxBuffer[9] = OpDmx >> 8;
+    rxBuffer[16] = ARTNET_DMX_LENGTH >> 8;
+    rxBuffer[17] = ARTNET_DMX_LENGTH & 0xFF;
+    for (uint16_t i = 0; i < ARTNET_DMX_LENGTH; i++) {
+        rxBuffer[ART_DMX_HEADER_SIZE + i] = i & 0xFF;
+    }
+    rxSize = sizeof(rxBuffer);
+
+    frame.clear();
+    strip.numPixels = PIXEL_BYTES / 3;
+    strip.brightness = 255;
+    bytesCopied = 0;
+}
+
+void tearDown() {
+}
+
+void test_single_copy_matches_legacy_output() {
+    legacyPath(false);
+    legacyPath(true);
+    uint8_t legacyPixels[PIXEL_BYTES];
+    memcpy(legacyPixels, strip.pixels, PIXEL_BYTES);
+
+    memset(strip.pixels, 0, PIXEL_BYTES);
+    singleCopyPath(false);
+    singleCopyPath(true);
+
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(legacyPortBuffer + 1, frame.slots(), ARTNET_DMX_LENGTH);
+    TEST_ASSERT_EQUAL_UINT8_ARRAY(legacyPixels, strip.pixels, PIXEL_BYTES);
+    TEST_ASSERT_EQUAL(ARTNET_DMX_LENGTH, frame.length);
+    TEST_ASSERT_EQUAL_HEX8(DMX_START_CODE, frame.data[0]);
+}
+
+void test_bytes_copied_per_packet() {
+    bytesCopied = 0;
+    legacyPath(false);
+    uint32_t legacyDmx = bytesCopied;
+    bytesCopied = 0;
+    legacyPath(true);
+    uint32_t legacyPixel = bytesCopied;
+
+    bytesCopied = 0;
+    singleCopyPath(false);
+    uint32_t newDmx = bytesCopied;
+    bytesCopied = 0;
+    singleCopyPath(true);
+    uint32_t newPixel = bytesCopied;
+
+    printf("[bench] bytes copied per DMX packet:   legacy %u, single-copy %u\n", legacyDmx, newDmx);
+    printf("[bench] bytes copied per pixel packet: legacy %u, single-copy %u\n", legacyPixel, newPixel);
+
+    TEST_ASSERT_EQUAL(ARTNET_DMX_LENGTH, newDmx);
+    TEST_ASSERT_EQUAL(PIXEL_BYTES, newPixel);
+    TEST_ASSERT_EQUAL(2 * ARTNET_DMX_LENGTH, legacyDmx);
+    TEST_ASSERT_EQUAL(ARTNET_DMX_LENGTH + 2 * PIXEL_BYTES, legacyPixel);
+}
+
+void test_cycles_per_packet() {
+    const uint32_t iterations = 200000;
+
+    BenchResult legacyDmx = benchRun(iterations, [] { legacyPath(false); benchKeep(legacyPortBuffer); });
+    BenchResult newDmx = benchRun(iterations, [] { singleCopyPath(false); benchKeep(frame.data); });
+    BenchResult legacyPixel = benchRun(iterations, [] { legacyPath(true); benchKeep(strip.pixels); });
+    BenchResult newPixel = benchRun(iterations, [] { singleCopyPath(true); benchKeep(strip.pixels); });
+
+    benchReport("ArtDmx -> DMX port, legacy", legacyDmx);
+    benchReport("ArtDmx -> DMX port, single copy", newDmx);
+    benchReport("ArtDmx -> pixels, legacy", legacyPixel);
+    benchReport("ArtDmx -> pixels, single copy", newPixel);
+
+    // 主机 memcpy 很快，耗时只做报告；拷贝字节数由上一个用例断言
+    TEST_ASSERT_TRUE(newDmx.nsPerIter > 0 && newPixel.nsPerIter > 0);
+}
+
+int main(int argc, char** argv) {
+    UNITY_BEGIN();
+    RUN_TEST(test_single_copy_matches_legacy_output);
+    RUN_TEST(test_bytes_copied_per_packet);
+    RUN_TEST(test_cycles_per_packet);
+    return UNITY_END();
+}